@@ -1,4 +1,6 @@
 #include "Animator.hpp"
+#include "Device.hpp"
+#include "StreamBuffer.hpp"
 #include "Tools.hpp"
 
 #include <GL/glew.h>
@@ -10,18 +12,10 @@
 
 namespace RenderIt
 {
-Animator::Animator()
+Animator::Animator() : _numBones(1), _deltaT(0.0f)
 {
     for (auto i = 0; i < ANIMATION_MAX_BONES; ++i)
         _boneMatrices[i] = glm::mat4(1.0f);
-
-    _boneSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
-    _boneSSBO->Bind();
-    glBufferData(_boneSSBO->type, ANIMATION_MAX_BONES * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
-    _boneSSBO->UnBind();
-    updateSSBO();
-
-    _deltaT = 0.0f;
 }
 
 std::shared_ptr<Animator> Animator::Instance()
@@ -46,9 +40,10 @@ void Animator::UpdateAnimation(const Model *model)
                                Tools::MessageType::WARN);
         return;
     }
-    // update animation time
-    anim->currTime += anim->ticksPerSecond * _deltaT;
-    anim->currTime = std::fmod(anim->currTime, anim->duration);
+    // update playback time of this model, animation only mirrors it for display
+    model->_animationTime += anim->ticksPerSecond * _deltaT;
+    model->_animationTime = std::fmod(model->_animationTime, anim->duration);
+    anim->currTime = model->_animationTime;
     // compute bone transforms
     std::queue<std::pair<std::shared_ptr<Animation::Node>, glm::mat4>> nodes;
     nodes.push({model->_animNodeRoot, glm::mat4(1.0f)});
@@ -66,7 +61,7 @@ void Animator::UpdateAnimation(const Model *model)
         auto bone = anim->GetBone(boneName);
         if (bone)
         {
-            bone->Update(anim->currTime);
+            bone->Update(model->_animationTime);
             nodeT = bone->matrix;
         }
         // compute current global transform
@@ -82,28 +77,30 @@ void Animator::UpdateAnimation(const Model *model)
         for (auto child : node->children)
             nodes.push({child, currT});
     }
-    updateSSBO(maxMatIdx + 1);
+    _numBones = std::max(_numBones, maxMatIdx + 1);
+    _bonesRangeValid = false;
 }
 
 void Animator::BindBones(unsigned bindingID) const
 {
-    _boneSSBO->BindBase(bindingID);
+    // fresh range after each update, so models drawn in same frame keep own matrices
+    auto stream = StreamBuffer::Instance();
+    if (!_bonesRangeValid || !_bonesRange.data || _bonesRange.frame != stream->GetFrame())
+    {
+        _bonesRange = stream->Upload(_boneMatrices.data(), _numBones * sizeof(glm::mat4));
+        _bonesRangeValid = true;
+    }
+    _bonesRange.BindRange(GL_SHADER_STORAGE_BUFFER, bindingID);
 }
 
 void Animator::UnBindBones(unsigned bindingID) const
 {
-    _boneSSBO->UnBindBase(bindingID);
+    GraphicsDevice::Get().BindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingID, 0);
 }
 
 std::array<glm::mat4, ANIMATION_MAX_BONES> &Animator::AccessBoneMatrices()
 {
+    _bonesRangeValid = false;
     return _boneMatrices;
 }
-
-void Animator::updateSSBO(unsigned size)
-{
-    _boneSSBO->Bind();
-    glBufferSubData(_boneSSBO->type, 0, size * sizeof(glm::mat4), _boneMatrices.data());
-    _boneSSBO->UnBind();
-}
 } // namespace RenderIt
@@ -7,6 +7,7 @@
 #include "Animation.hpp"
 #include "GLStructs.hpp"
 #include "Model.hpp"
+#include "StreamBuffer.hpp"
 
 /** @file */
 
@@ -28,25 +29,25 @@ class Animator
     /// Read model animation & prepare bone matrices
     void UpdateAnimation(const Model *model);
 
-    /// Bind bone matrices uniform buffer
+    /// Bind bone matrices, uploaded to stream buffer once per frame or after they changed
     void BindBones(unsigned bindingID = 0) const;
 
-    /// UnBind uniform buffer
+    /// UnBind bone matrices
     void UnBindBones(unsigned bindingID = 0) const;
 
-    /// Get reference to bone matrices
+    /// Get reference to bone matrices, uploaded again on next bind
     std::array<glm::mat4, ANIMATION_MAX_BONES> &AccessBoneMatrices();
 
   public:
     const std::string LOGNAME = "Animator";
 
-  private:
-    /// Update shader storage buffer
-    void updateSSBO(unsigned size = ANIMATION_MAX_BONES);
-
   private:
     std::array<glm::mat4, ANIMATION_MAX_BONES> _boneMatrices;
-    std::unique_ptr<SBuffer> _boneSSBO;
+    // highest number of bones updated so far, uploaded on bind
+    unsigned _numBones;
+    // range of bone matrices uploaded in current frame, reused by binds until matrices change
+    mutable StreamAllocation _bonesRange;
+    mutable bool _bonesRangeValid = false;
 
     float _deltaT;
 };
@@ -0,0 +1,385 @@
+#include "BVH.hpp"
+#include "SIMD.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+namespace RenderIt
+{
+
+static float surface_area(const glm::vec3 &bmin, const glm::vec3 &bmax)
+{
+    auto d = glm::max(bmax - bmin, glm::vec3(0.0f));
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+MeshBVH::MeshBVH() : useSIMD(true), _buildMs(0.0), _ready(false), _jobs(JobSystem::Instance())
+{
+}
+
+MeshBVH::~MeshBVH()
+{
+    _jobs->Wait(_pending);
+}
+
+void MeshBVH::Build(const std::vector<glm::vec3> &positions, const std::vector<unsigned> &indices)
+{
+    _jobs->Wait(_pending);
+    build(positions, indices);
+}
+
+void MeshBVH::BuildAsync(std::vector<glm::vec3> positions, std::vector<unsigned> indices)
+{
+    _jobs->Wait(_pending);
+    _ready = false;
+    _pending = _jobs->Run([this, positions = std::move(positions), indices = std::move(indices)]() {
+        build(positions, indices);
+    });
+}
+
+bool MeshBVH::IsReady() const
+{
+    if (_pending && !_pending->IsDone())
+        return false;
+    return _ready;
+}
+
+bool MeshBVH::Intersect(const Ray &ray, RayHit &hit) const
+{
+    if (!IsReady() || _nodes.empty())
+        return false;
+    auto invDir = 1.0f / ray.direction;
+    bool found = false;
+
+    thread_local std::vector<int> stack;
+    stack.clear();
+    stack.push_back(0);
+    while (!stack.empty())
+    {
+        const auto &node = _nodes[stack.back()];
+        stack.pop_back();
+        float tNear[4];
+        int mask = intersectNode(node, ray.origin, invDir, hit.distance, tNear);
+        if (!mask)
+            continue;
+
+        // test leaves now, push inner nodes far to near so nearest is popped first
+        std::array<int, 4> inner;
+        int numInner = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!(mask & (1 << i)))
+                continue;
+            if (node.child[i] >= 0)
+            {
+                inner[numInner++] = i;
+                continue;
+            }
+            for (auto t = node.first[i]; t < node.first[i] + node.count[i]; ++t)
+            {
+                const auto &tri = _triangles[t];
+                auto p = glm::cross(ray.direction, tri.e2);
+                float det = glm::dot(tri.e1, p);
+                if (std::abs(det) < 1e-12f)
+                    continue;
+                float detInv = 1.0f / det;
+                auto s = ray.origin - tri.v0;
+                float u = glm::dot(s, p) * detInv;
+                if (u < 0.0f || u > 1.0f)
+                    continue;
+                auto q = glm::cross(s, tri.e1);
+                float v = glm::dot(ray.direction, q) * detInv;
+                if (v < 0.0f || u + v > 1.0f)
+                    continue;
+                float dist = glm::dot(tri.e2, q) * detInv;
+                if (dist <= 0.0f || dist >= hit.distance)
+                    continue;
+                hit.distance = dist;
+                hit.triangle = _triIndices[t];
+                hit.barycentric = glm::vec2(u, v);
+                found = true;
+            }
+        }
+        std::sort(inner.begin(), inner.begin() + numInner, [&](int a, int b) { return tNear[a] > tNear[b]; });
+        for (int i = 0; i < numInner; ++i)
+            if (tNear[inner[i]] < hit.distance)
+                stack.push_back(node.child[inner[i]]);
+    }
+    return found;
+}
+
+size_t MeshBVH::GetNumTriangles() const
+{
+    return IsReady() ? _triangles.size() : 0;
+}
+
+size_t MeshBVH::GetNumNodes() const
+{
+    return IsReady() ? _nodes.size() : 0;
+}
+
+double MeshBVH::GetBuildTime() const
+{
+    return IsReady() ? _buildMs : 0.0;
+}
+
+void MeshBVH::build(const std::vector<glm::vec3> &positions, const std::vector<unsigned> &indices)
+{
+    auto start = std::chrono::steady_clock::now();
+    _nodes.clear();
+    _triangles.clear();
+    _triIndices.clear();
+
+    auto numTriangles = indices.size() / 3;
+    std::vector<glm::vec3> centroids(numTriangles), triMin(numTriangles), triMax(numTriangles);
+    for (size_t i = 0; i < numTriangles; ++i)
+    {
+        const auto &a = positions[indices[i * 3]];
+        const auto &b = positions[indices[i * 3 + 1]];
+        const auto &c = positions[indices[i * 3 + 2]];
+        triMin[i] = glm::min(a, glm::min(b, c));
+        triMax[i] = glm::max(a, glm::max(b, c));
+        centroids[i] = (a + b + c) / 3.0f;
+        _triIndices.push_back(static_cast<unsigned>(i));
+    }
+
+    if (numTriangles)
+    {
+        std::vector<BuildNode> nodes;
+        buildBinary(centroids, triMin, triMax, nodes);
+        collapse(nodes, 0);
+
+        // store triangles in leaf order
+        _triangles.resize(numTriangles);
+        for (size_t i = 0; i < numTriangles; ++i)
+        {
+            auto t = _triIndices[i];
+            const auto &v0 = positions[indices[t * 3]];
+            _triangles[i] = {v0, positions[indices[t * 3 + 1]] - v0, positions[indices[t * 3 + 2]] - v0};
+        }
+    }
+
+    _buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    _ready = true;
+}
+
+void MeshBVH::buildBinary(const std::vector<glm::vec3> &centroids, const std::vector<glm::vec3> &triMin,
+                          const std::vector<glm::vec3> &triMax, std::vector<BuildNode> &nodes)
+{
+    struct Bin
+    {
+        glm::vec3 bmin = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 bmax = glm::vec3(-std::numeric_limits<float>::max());
+        unsigned count = 0;
+    };
+
+    BuildNode root{glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max()), 0,
+                   0, 0, static_cast<unsigned>(_triIndices.size())};
+    for (auto t : _triIndices)
+    {
+        root.bmin = glm::min(root.bmin, triMin[t]);
+        root.bmax = glm::max(root.bmax, triMax[t]);
+    }
+    nodes.reserve(_triIndices.size() / BVH_MAX_LEAF_SIZE * 2 + 1);
+    nodes.push_back(root);
+
+    std::vector<unsigned> todo{0u};
+    while (!todo.empty())
+    {
+        auto idx = todo.back();
+        todo.pop_back();
+        auto node = nodes[idx];
+        if (node.count <= BVH_MAX_LEAF_SIZE)
+            continue;
+        auto begin = _triIndices.begin() + node.first;
+        auto end = begin + node.count;
+
+        // bin centroids along longest axis of centroid bounds
+        glm::vec3 cmin(std::numeric_limits<float>::max()), cmax(-std::numeric_limits<float>::max());
+        for (auto it = begin; it != end; ++it)
+        {
+            cmin = glm::min(cmin, centroids[*it]);
+            cmax = glm::max(cmax, centroids[*it]);
+        }
+        auto extent = cmax - cmin;
+        int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        if (extent[axis] <= 0.0f)
+            continue;
+        float scale = BVH_NUM_BINS / extent[axis];
+        auto binOf = [&](unsigned t) {
+            return std::min(BVH_NUM_BINS - 1, static_cast<int>((centroids[t][axis] - cmin[axis]) * scale));
+        };
+        std::array<Bin, BVH_NUM_BINS> bins;
+        for (auto it = begin; it != end; ++it)
+        {
+            auto &bin = bins[binOf(*it)];
+            bin.bmin = glm::min(bin.bmin, triMin[*it]);
+            bin.bmax = glm::max(bin.bmax, triMax[*it]);
+            ++bin.count;
+        }
+
+        // sweep for split planes between bins
+        std::array<float, BVH_NUM_BINS - 1> leftCost, rightCost;
+        Bin left, right;
+        for (int i = 0; i < BVH_NUM_BINS - 1; ++i)
+        {
+            left.bmin = glm::min(left.bmin, bins[i].bmin);
+            left.bmax = glm::max(left.bmax, bins[i].bmax);
+            left.count += bins[i].count;
+            leftCost[i] = left.count ? left.count * surface_area(left.bmin, left.bmax) : 0.0f;
+            auto &r = bins[BVH_NUM_BINS - 1 - i];
+            right.bmin = glm::min(right.bmin, r.bmin);
+            right.bmax = glm::max(right.bmax, r.bmax);
+            right.count += r.count;
+            rightCost[BVH_NUM_BINS - 2 - i] = right.count ? right.count * surface_area(right.bmin, right.bmax) : 0.0f;
+        }
+        int bestSplit = 0;
+        float bestCost = std::numeric_limits<float>::max();
+        for (int i = 0; i < BVH_NUM_BINS - 1; ++i)
+        {
+            float cost = leftCost[i] + rightCost[i];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestSplit = i;
+            }
+        }
+        // keep as leaf if splitting costs more than testing every triangle
+        float leafCost = node.count * surface_area(node.bmin, node.bmax);
+        if (bestCost >= leafCost && node.count <= BVH_MAX_LEAF_SIZE * 4)
+            continue;
+
+        auto mid = std::partition(begin, end, [&](unsigned t) { return binOf(t) <= bestSplit; });
+        if (mid == begin || mid == end)
+            continue;
+
+        auto makeChild = [&](std::vector<unsigned>::iterator b, std::vector<unsigned>::iterator e) {
+            BuildNode child{glm::vec3(std::numeric_limits<float>::max()),
+                            glm::vec3(-std::numeric_limits<float>::max()),
+                            0,
+                            0,
+                            static_cast<unsigned>(b - _triIndices.begin()),
+                            static_cast<unsigned>(e - b)};
+            for (auto it = b; it != e; ++it)
+            {
+                child.bmin = glm::min(child.bmin, triMin[*it]);
+                child.bmax = glm::max(child.bmax, triMax[*it]);
+            }
+            nodes.push_back(child);
+            todo.push_back(static_cast<unsigned>(nodes.size() - 1));
+            return static_cast<unsigned>(nodes.size() - 1);
+        };
+        auto leftIdx = makeChild(begin, mid);
+        auto rightIdx = makeChild(mid, end);
+        nodes[idx].left = leftIdx;
+        nodes[idx].right = rightIdx;
+        nodes[idx].count = 0;
+    }
+}
+
+int MeshBVH::collapse(const std::vector<BuildNode> &nodes, unsigned idx)
+{
+    // pull grandchildren up until node has 4 children, largest inner child first
+    std::vector<unsigned> children;
+    if (nodes[idx].count)
+        children.push_back(idx);
+    else
+        children = {nodes[idx].left, nodes[idx].right};
+    while (children.size() < 4)
+    {
+        int best = -1;
+        float bestArea = -1.0f;
+        for (size_t i = 0; i < children.size(); ++i)
+        {
+            const auto &c = nodes[children[i]];
+            float area = surface_area(c.bmin, c.bmax);
+            if (!c.count && area > bestArea)
+            {
+                best = static_cast<int>(i);
+                bestArea = area;
+            }
+        }
+        if (best < 0)
+            break;
+        auto c = children[best];
+        children[best] = nodes[c].left;
+        children.push_back(nodes[c].right);
+    }
+
+    int nodeIdx = static_cast<int>(_nodes.size());
+    _nodes.emplace_back();
+    Node4 node;
+    for (int i = 0; i < 4; ++i)
+    {
+        // empty slots get bounds no ray can enter
+        node.minX[i] = node.minY[i] = node.minZ[i] = std::numeric_limits<float>::infinity();
+        node.maxX[i] = node.maxY[i] = node.maxZ[i] = std::numeric_limits<float>::infinity();
+        node.child[i] = -1;
+        node.first[i] = node.count[i] = 0;
+    }
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+        const auto &c = nodes[children[i]];
+        node.minX[i] = c.bmin.x;
+        node.minY[i] = c.bmin.y;
+        node.minZ[i] = c.bmin.z;
+        node.maxX[i] = c.bmax.x;
+        node.maxY[i] = c.bmax.y;
+        node.maxZ[i] = c.bmax.z;
+        if (c.count)
+        {
+            node.first[i] = c.first;
+            node.count[i] = c.count;
+        }
+        else
+            node.child[i] = collapse(nodes, children[i]);
+    }
+    _nodes[nodeIdx] = node;
+    return nodeIdx;
+}
+
+int MeshBVH::intersectNode(const Node4 &node, const glm::vec3 &origin, const glm::vec3 &invDir, float tMax,
+                           float tNear[4]) const
+{
+#ifdef RENDERIT_SIMD_SSE
+    if (useSIMD)
+    {
+        auto slab = [](const float *bmin, const float *bmax, float o, float inv, __m128 &tEnter, __m128 &tExit) {
+            auto ov = _mm_set1_ps(o);
+            auto iv = _mm_set1_ps(inv);
+            auto t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bmin), ov), iv);
+            auto t2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bmax), ov), iv);
+            tEnter = _mm_max_ps(tEnter, _mm_min_ps(t1, t2));
+            tExit = _mm_min_ps(tExit, _mm_max_ps(t1, t2));
+        };
+        __m128 tEnter = _mm_setzero_ps();
+        __m128 tExit = _mm_set1_ps(tMax);
+        slab(node.minX, node.maxX, origin.x, invDir.x, tEnter, tExit);
+        slab(node.minY, node.maxY, origin.y, invDir.y, tEnter, tExit);
+        slab(node.minZ, node.maxZ, origin.z, invDir.z, tEnter, tExit);
+        _mm_storeu_ps(tNear, tEnter);
+        return _mm_movemask_ps(_mm_cmple_ps(tEnter, tExit));
+    }
+#endif
+    int mask = 0;
+    const float *bmin[3] = {node.minX, node.minY, node.minZ};
+    const float *bmax[3] = {node.maxX, node.maxY, node.maxZ};
+    for (int i = 0; i < 4; ++i)
+    {
+        float tEnter = 0.0f, tExit = tMax;
+        for (int a = 0; a < 3; ++a)
+        {
+            float t1 = (bmin[a][i] - origin[a]) * invDir[a];
+            float t2 = (bmax[a][i] - origin[a]) * invDir[a];
+            tEnter = std::max(tEnter, std::min(t1, t2));
+            tExit = std::min(tExit, std::max(t1, t2));
+        }
+        tNear[i] = tEnter;
+        if (tEnter <= tExit)
+            mask |= 1 << i;
+    }
+    return mask;
+}
+
+} // namespace RenderIt
@@ -0,0 +1,127 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Jobs.hpp"
+
+#define BVH_NUM_BINS 16
+#define BVH_MAX_LEAF_SIZE 4
+
+/** @file */
+
+namespace RenderIt
+{
+
+class Mesh;
+class Model;
+
+/// Ray with origin & direction, direction need not be normalized
+struct Ray
+{
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+/// Closest hit of a ray query
+struct RayHit
+{
+    const Model *model = nullptr;
+    const Mesh *mesh = nullptr;
+    unsigned triangle = 0;
+    // weights of 2nd & 3rd vertex of triangle
+    glm::vec2 barycentric = glm::vec2(0.0f);
+    // distance in units of ray direction length
+    float distance = std::numeric_limits<float>::max();
+};
+
+/// Triangle BVH of a mesh, kept on CPU for ray queries
+/// Built with binned SAH, then collapsed into 4-wide nodes tested with SSE
+class MeshBVH
+{
+  public:
+    MeshBVH();
+
+    ~MeshBVH();
+
+    /// Build from triangle list
+    void Build(const std::vector<glm::vec3> &positions, const std::vector<unsigned> &indices);
+
+    /// Build on job system, queries return no hit until ready
+    void BuildAsync(std::vector<glm::vec3> positions, std::vector<unsigned> indices);
+
+    /// Whether BVH is built
+    bool IsReady() const;
+
+    /// Find closest hit with distance below hit.distance, updates hit if found
+    bool Intersect(const Ray &ray, RayHit &hit) const;
+
+    /// Get number of triangles
+    size_t GetNumTriangles() const;
+
+    /// Get number of 4-wide nodes
+    size_t GetNumNodes() const;
+
+    /// Get last build time in milliseconds
+    double GetBuildTime() const;
+
+  public:
+    const std::string LOGNAME = "MeshBVH";
+    // disable to run scalar ray-box tests
+    bool useSIMD;
+
+  private:
+    /// Build BVH on calling thread
+    void build(const std::vector<glm::vec3> &positions, const std::vector<unsigned> &indices);
+
+    /// Binary node used during build
+    struct BuildNode
+    {
+        glm::vec3 bmin, bmax;
+        unsigned left, right;
+        unsigned first, count;
+    };
+
+    /// 4-wide node, bounds stored per axis for SIMD tests
+    /// child >= 0 is an inner node, child < 0 is a leaf with triangles [first, first + count)
+    struct alignas(16) Node4
+    {
+        float minX[4], minY[4], minZ[4];
+        float maxX[4], maxY[4], maxZ[4];
+        int child[4];
+        unsigned first[4];
+        unsigned count[4];
+    };
+
+    /// Triangle prepared for intersection
+    struct Triangle
+    {
+        glm::vec3 v0, e1, e2;
+    };
+
+    /// Build binary BVH over _triIndices
+    void buildBinary(const std::vector<glm::vec3> &centroids, const std::vector<glm::vec3> &triMin,
+                     const std::vector<glm::vec3> &triMax, std::vector<BuildNode> &nodes);
+
+    /// Collapse binary subtree into 4-wide nodes, returns node index
+    int collapse(const std::vector<BuildNode> &nodes, unsigned idx);
+
+    /// Test ray against 4 boxes, returns hit mask and entry distances
+    int intersectNode(const Node4 &node, const glm::vec3 &origin, const glm::vec3 &invDir, float tMax,
+                      float tNear[4]) const;
+
+  private:
+    std::vector<Node4> _nodes;
+    std::vector<Triangle> _triangles;
+    // original triangle index of each sorted triangle
+    std::vector<unsigned> _triIndices;
+    double _buildMs;
+    bool _ready;
+    std::shared_ptr<JobSystem> _jobs;
+    std::shared_ptr<JobCounter> _pending;
+};
+
+} // namespace RenderIt
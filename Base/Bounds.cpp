@@ -1,9 +1,20 @@
 #include "Bounds.hpp"
 #include "GLMIOStream.hpp"
+#include "SIMD.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 namespace RenderIt
 {
 
+BoundingSphere BoundingSphere::Transform(const glm::mat4 &mat) const
+{
+    float scale = std::max({glm::length(glm::vec3(mat[0])), glm::length(glm::vec3(mat[1])),
+                            glm::length(glm::vec3(mat[2]))});
+    return {glm::vec3(mat * glm::vec4(center, 1.0f)), radius * scale};
+}
+
 Bounds::Bounds() : max(std::numeric_limits<float>::min()), min(std::numeric_limits<float>::max()), center(0.0f)
 {
 }
@@ -15,6 +26,36 @@ void Bounds::Merge(const Bounds &other)
     center = (max + min) * 0.5f;
 }
 
+void Bounds::Merge(const Bounds *others, size_t count)
+{
+    size_t i = 0;
+#ifdef RENDERIT_SIMD_SSE
+    // 4th lane reads next member of Bounds and is ignored
+    auto mn = _mm_setr_ps(min.x, min.y, min.z, 0.0f);
+    auto mx = _mm_setr_ps(max.x, max.y, max.z, 0.0f);
+    for (; i < count; ++i)
+    {
+        if (!others[i].IsValid())
+            continue;
+        mn = _mm_min_ps(mn, _mm_loadu_ps(&others[i].min.x));
+        mx = _mm_max_ps(mx, _mm_loadu_ps(&others[i].max.x));
+    }
+    float lo[4], hi[4];
+    _mm_storeu_ps(lo, mn);
+    _mm_storeu_ps(hi, mx);
+    min = glm::vec3(lo[0], lo[1], lo[2]);
+    max = glm::vec3(hi[0], hi[1], hi[2]);
+#endif
+    for (; i < count; ++i)
+    {
+        if (!others[i].IsValid())
+            continue;
+        min = glm::min(min, others[i].min);
+        max = glm::max(max, others[i].max);
+    }
+    center = (max + min) * 0.5f;
+}
+
 void Bounds::Update(const glm::vec3 &v)
 {
     max = glm::max(v, max);
@@ -22,6 +63,145 @@ void Bounds::Update(const glm::vec3 &v)
     center = (max + min) * 0.5f;
 }
 
+void Bounds::Update(const glm::vec3 *points, size_t count)
+{
+    if (!count)
+        return;
+    const float *data = &points[0].x;
+    glm::vec3 bmin = min, bmax = max;
+    size_t i = 0;
+    // every block holds a whole number of points, so each lane always sees the same component
+    // lane j of the stored block belongs to component j % 3
+#if defined(RENDERIT_SIMD_AVX)
+    if (count >= 8)
+    {
+        __m256 mn[3], mx[3];
+        for (int k = 0; k < 3; ++k)
+            mn[k] = mx[k] = _mm256_loadu_ps(data + 8 * k);
+        for (i = 8; i + 8 <= count; i += 8)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                auto v = _mm256_loadu_ps(data + i * 3 + 8 * k);
+                mn[k] = _mm256_min_ps(mn[k], v);
+                mx[k] = _mm256_max_ps(mx[k], v);
+            }
+        }
+        float lo[24], hi[24];
+        for (int k = 0; k < 3; ++k)
+        {
+            _mm256_storeu_ps(lo + 8 * k, mn[k]);
+            _mm256_storeu_ps(hi + 8 * k, mx[k]);
+        }
+        for (int j = 0; j < 24; ++j)
+        {
+            bmin[j % 3] = std::min(bmin[j % 3], lo[j]);
+            bmax[j % 3] = std::max(bmax[j % 3], hi[j]);
+        }
+    }
+#elif defined(RENDERIT_SIMD_SSE)
+    if (count >= 4)
+    {
+        __m128 mn[3], mx[3];
+        for (int k = 0; k < 3; ++k)
+            mn[k] = mx[k] = _mm_loadu_ps(data + 4 * k);
+        for (i = 4; i + 4 <= count; i += 4)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                auto v = _mm_loadu_ps(data + i * 3 + 4 * k);
+                mn[k] = _mm_min_ps(mn[k], v);
+                mx[k] = _mm_max_ps(mx[k], v);
+            }
+        }
+        float lo[12], hi[12];
+        for (int k = 0; k < 3; ++k)
+        {
+            _mm_storeu_ps(lo + 4 * k, mn[k]);
+            _mm_storeu_ps(hi + 4 * k, mx[k]);
+        }
+        for (int j = 0; j < 12; ++j)
+        {
+            bmin[j % 3] = std::min(bmin[j % 3], lo[j]);
+            bmax[j % 3] = std::max(bmax[j % 3], hi[j]);
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        bmin = glm::min(bmin, points[i]);
+        bmax = glm::max(bmax, points[i]);
+    }
+    min = bmin;
+    max = bmax;
+    center = (max + min) * 0.5f;
+}
+
+void Bounds::Update(const void *points, size_t count, size_t stride)
+{
+    if (stride == sizeof(glm::vec3))
+    {
+        Update(static_cast<const glm::vec3 *>(points), count);
+        return;
+    }
+    auto bytes = static_cast<const unsigned char *>(points);
+    glm::vec3 bmin = min, bmax = max;
+    size_t i = 0;
+#ifdef RENDERIT_SIMD_SSE
+    // 4th lane reads past the position, only done when it stays inside the element
+    if (stride >= 4 * sizeof(float))
+    {
+        auto mn = _mm_setr_ps(bmin.x, bmin.y, bmin.z, 0.0f);
+        auto mx = _mm_setr_ps(bmax.x, bmax.y, bmax.z, 0.0f);
+        for (; i < count; ++i)
+        {
+            auto v = _mm_loadu_ps(reinterpret_cast<const float *>(bytes + i * stride));
+            mn = _mm_min_ps(mn, v);
+            mx = _mm_max_ps(mx, v);
+        }
+        float lo[4], hi[4];
+        _mm_storeu_ps(lo, mn);
+        _mm_storeu_ps(hi, mx);
+        bmin = glm::vec3(lo[0], lo[1], lo[2]);
+        bmax = glm::vec3(hi[0], hi[1], hi[2]);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        glm::vec3 p;
+        std::memcpy(&p, bytes + i * stride, sizeof(p));
+        bmin = glm::min(bmin, p);
+        bmax = glm::max(bmax, p);
+    }
+    min = bmin;
+    max = bmax;
+    center = (max + min) * 0.5f;
+}
+
+Bounds Bounds::Transform(const glm::mat4 &mat) const
+{
+    Bounds b;
+    if (!IsValid())
+        return b;
+    // center goes through matrix, half extents through absolute linear part
+    auto c = (max + min) * 0.5f;
+    auto e = (max - min) * 0.5f;
+    auto newCenter = glm::vec3(mat * glm::vec4(c, 1.0f));
+    auto newExtent = glm::abs(glm::vec3(mat[0])) * e.x + glm::abs(glm::vec3(mat[1])) * e.y +
+                     glm::abs(glm::vec3(mat[2])) * e.z;
+    b.min = newCenter - newExtent;
+    b.max = newCenter + newExtent;
+    b.center = newCenter;
+    return b;
+}
+
+BoundingSphere Bounds::GetSphere() const
+{
+    if (!IsValid())
+        return {};
+    return {(max + min) * 0.5f, glm::length(max - min) * 0.5f};
+}
+
 float Bounds::Diagonal() const
 {
     if (!IsValid())
@@ -2,6 +2,7 @@
 
 #include <glm/glm.hpp>
 
+#include <cstddef>
 #include <iostream>
 
 /** @file */
@@ -9,6 +10,16 @@
 namespace RenderIt
 {
 
+/// Bounding sphere
+struct BoundingSphere
+{
+    /// Transform sphere, radius scaled by largest axis scale
+    BoundingSphere Transform(const glm::mat4 &mat) const;
+
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+};
+
 /// Bounding box (AABB)
 struct Bounds
 {
@@ -17,9 +28,24 @@ struct Bounds
     /// Merge with other bounding box
     void Merge(const Bounds &other);
 
+    /// Merge with array of bounding boxes, invalid boxes are skipped
+    void Merge(const Bounds *others, size_t count);
+
     /// Update bounding box by position
     void Update(const glm::vec3 &v);
 
+    /// Update bounding box by packed positions
+    void Update(const glm::vec3 *points, size_t count);
+
+    /// Update bounding box by positions at byte stride (e.g. position of Vertex array)
+    void Update(const void *points, size_t count, size_t stride);
+
+    /// Bounding box of this box under affine transform (Arvo)
+    Bounds Transform(const glm::mat4 &mat) const;
+
+    /// Bounding sphere enclosing box
+    BoundingSphere GetSphere() const;
+
     /// Compute bounding box diagonal length
     float Diagonal() const;
 
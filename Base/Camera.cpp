@@ -1,4 +1,7 @@
 #include "Camera.hpp"
+#include "CameraPath.hpp"
+#include "Device.hpp"
+#include "FrameConstants.hpp"
 
 #include <GL/glew.h>
 #include <glm/gtx/transform.hpp>
@@ -12,10 +15,9 @@ Camera::Camera()
     : clearColor(0.0f, 0.0f, 0.0f, 1.0f), computeShadowData(false), _posVec(0.0f, 0.0f, -1.0f), _centerVec(0.0f),
       _upVec(0.0f), _frontVec(0.0f), _rightVec(0.0f), _worldUpVec(0.0f, 1.0f, 0.0f), _dist(0.0f), _projMat(1.0f),
       _viewMat(1.0f), _projMatInv(1.0f), _viewMatInv(1.0f), _viewType(CameraViewType::Persp), _fov(45.0f),
-      _aspect(1.0f), _viewNear(0.1f), _viewFar(1000.0f), _updated(false), _csmNearFar(0.01f, 2.0f),
-      _omniNearFarOffset(0.1f, 25.0f, 0.005f)
+      _aspect(1.0f), _viewNear(0.1f), _viewFar(1000.0f), _updated(false),
+      _flythrough(CameraPath::FromEnvironment()), _csmNearFar(0.01f, 2.0f), _omniNearFarOffset(0.1f, 25.0f, 0.005f)
 {
-    setupCSMBuffer();
     updateCSMDists();
     updateOmniData();
 }
@@ -28,10 +30,15 @@ std::shared_ptr<Camera> Camera::Instance()
 
 void Camera::PrepareFrame(unsigned clearMask)
 {
-    glClear(static_cast<GLbitfield>(clearMask));
-    glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    auto &device = GraphicsDevice::Get();
+    device.Clear(static_cast<GLbitfield>(clearMask));
+    device.ClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    stepFlythrough();
     if (!_updated)
         update();
+    auto constants = FrameConstants::Instance();
+    constants->SetCamera(_viewMat, _projMat, _viewMatInv, _projMatInv, _posVec);
+    constants->Bind();
 }
 
 const glm::mat4 &Camera::GetView()
@@ -66,6 +73,16 @@ void Camera::SetCenter(const glm::vec3 &center)
     _updated = false;
 }
 
+void Camera::SetFlythrough(std::shared_ptr<CameraPath> path)
+{
+    _flythrough = path;
+}
+
+std::shared_ptr<CameraPath> Camera::GetFlythrough()
+{
+    return _flythrough;
+}
+
 void Camera::SetWorldUp(const glm::vec3 &up)
 {
     _worldUpVec = up;
@@ -134,6 +151,22 @@ float Camera::GetFov()
     return _fov;
 }
 
+Ray Camera::ScreenToRay(float x, float y, int width, int height)
+{
+    glm::vec2 ndc(2.0f * x / std::max(width, 1) - 1.0f, 1.0f - 2.0f * y / std::max(height, 1));
+    auto projViewInv = GetViewInv() * GetProjInv();
+    auto nearPos = projViewInv * glm::vec4(ndc, -1.0f, 1.0f);
+    auto farPos = projViewInv * glm::vec4(ndc, 1.0f, 1.0f);
+    nearPos /= nearPos.w;
+    farPos /= farPos.w;
+    return {glm::vec3(nearPos), glm::normalize(glm::vec3(farPos - nearPos))};
+}
+
+bool Camera::stepFlythrough()
+{
+    return _flythrough && _flythrough->Step(*this);
+}
+
 void Camera::update()
 {
     _frontVec = _centerVec - _posVec;
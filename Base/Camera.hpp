@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 
+#include "BVH.hpp"
 #include "GLStructs.hpp"
 
 #define SHADOW_CSM_COUNT 4
@@ -14,6 +15,8 @@
 namespace RenderIt
 {
 
+class CameraPath;
+
 /// Defines camera view types
 enum class CameraViewType
 {
@@ -32,7 +35,7 @@ class Camera
     /// Get singleton
     static std::shared_ptr<Camera> Instance();
 
-    /// Prepare frame, called before rendering
+    /// Prepare frame & bind frame constants, called before rendering
     void PrepareFrame(unsigned clearMask);
 
     /// Get view matrix
@@ -91,6 +94,18 @@ class Camera
 
     const glm::vec3 &GetOmniShadowData();
 
+    /// Set cascaded shadow near and far, recomputes cascade splits
+    void SetShadowNearFar(float near, float far);
+
+    /// Get world space ray through window position (origin at top left)
+    Ray ScreenToRay(float x, float y, int width, int height);
+
+    /// Set flythrough path, camera follows path instead of input while playing
+    void SetFlythrough(std::shared_ptr<CameraPath> path);
+
+    /// Get flythrough path
+    std::shared_ptr<CameraPath> GetFlythrough();
+
     /// UI calls
     void UI();
 
@@ -103,10 +118,11 @@ class Camera
     /// Internal update
     void update();
 
+    /// Follow flythrough path, returns false if not playing
+    bool stepFlythrough();
+
   private:
 #pragma region cascaded_shadow
-    void setupCSMBuffer();
-
     void updateCSMDists();
 
     void updateCSMData();
@@ -131,13 +147,14 @@ class Camera
 
     bool _updated;
 
+    std::shared_ptr<CameraPath> _flythrough;
+
   private:
 #pragma region cascaded_shadow
     glm::vec2 _csmNearFar;
     std::array<glm::vec2, SHADOW_CSM_COUNT> _csmDistData;
     std::array<glm::vec4, SHADOW_CSM_COUNT> _csmSphereData;
     std::array<glm::vec3[8], SHADOW_CSM_COUNT> _csmFrustumData;
-    std::unique_ptr<SBuffer> _csmDataSSBO;
 #pragma endregion cascaded_shadow
 
 #pragma region omnidirectional_shadow
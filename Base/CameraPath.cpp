@@ -0,0 +1,280 @@
+#include "CameraPath.hpp"
+#include "Camera.hpp"
+#include "Context.hpp"
+#include "Tools.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace RenderIt
+{
+
+/// Uniform Catmull-Rom interpolation between p1 & p2
+static glm::vec3 catmull_rom(const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2, const glm::vec3 &p3,
+                             float u)
+{
+    auto u2 = u * u;
+    auto u3 = u2 * u;
+    return 0.5f * (2.0f * p1 + (p2 - p0) * u + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u2 +
+                   (3.0f * p1 - p0 - 3.0f * p2 + p3) * u3);
+}
+
+CameraPath::CameraPath()
+    : closeOnFinish(false), _step(CAMERA_PATH_DEFAULT_STEP), _time(0.0f), _playing(false), _finished(false),
+      _lastFrame(0), _hasFrame(false)
+{
+}
+
+std::shared_ptr<CameraPath> CameraPath::FromEnvironment()
+{
+    static auto path = []() -> std::shared_ptr<CameraPath> {
+        auto file = std::getenv("RENDERIT_FLYTHROUGH");
+        if (!file || !*file)
+            return nullptr;
+        auto path = std::make_shared<CameraPath>();
+        if (!path->Load(file))
+            return nullptr;
+        auto step = std::getenv("RENDERIT_FLYTHROUGH_STEP");
+        auto report = std::getenv("RENDERIT_FLYTHROUGH_REPORT");
+        path->reportPath = report ? report : "";
+        path->closeOnFinish = true;
+        path->Play(step ? std::strtof(step, nullptr) : CAMERA_PATH_DEFAULT_STEP);
+        return path;
+    }();
+    return path;
+}
+
+bool CameraPath::Load(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        Tools::display_message(LOGNAME, "Failed to load camera path " + path, Tools::MessageType::WARN);
+        return false;
+    }
+    _keyframes.clear();
+    std::string line;
+    while (std::getline(file, line))
+    {
+        line = line.substr(0, line.find('#'));
+        std::stringstream tokens(line);
+        CameraKeyframe keyframe;
+        if (!(tokens >> keyframe.time >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z >>
+              keyframe.center.x >> keyframe.center.y >> keyframe.center.z))
+            continue;
+        tokens >> std::ws;
+        std::getline(tokens, keyframe.name);
+        AddKeyframe(keyframe);
+    }
+    if (_keyframes.empty())
+    {
+        Tools::display_message(LOGNAME, "No keyframes in camera path " + path, Tools::MessageType::WARN);
+        return false;
+    }
+    _sourcePath = path;
+    return true;
+}
+
+bool CameraPath::Save(const std::string &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        Tools::display_message(LOGNAME, "Failed to save camera path " + path, Tools::MessageType::WARN);
+        return false;
+    }
+    file << "# time px py pz cx cy cz [name]\n";
+    for (const auto &keyframe : _keyframes)
+    {
+        file << keyframe.time << " " << keyframe.position.x << " " << keyframe.position.y << " "
+             << keyframe.position.z << " " << keyframe.center.x << " " << keyframe.center.y << " "
+             << keyframe.center.z;
+        if (!keyframe.name.empty())
+            file << " " << keyframe.name;
+        file << "\n";
+    }
+    return true;
+}
+
+void CameraPath::AddKeyframe(const CameraKeyframe &keyframe)
+{
+    auto iter = std::upper_bound(_keyframes.begin(), _keyframes.end(), keyframe.time,
+                                 [](float time, const CameraKeyframe &other) { return time < other.time; });
+    _keyframes.insert(iter, keyframe);
+}
+
+const std::vector<CameraKeyframe> &CameraPath::GetKeyframes() const
+{
+    return _keyframes;
+}
+
+float CameraPath::GetDuration() const
+{
+    return _keyframes.empty() ? 0.0f : _keyframes.back().time;
+}
+
+void CameraPath::Evaluate(float time, glm::vec3 &position, glm::vec3 &center) const
+{
+    if (_keyframes.empty())
+        return;
+    auto last = _keyframes.size() - 1;
+    if (time <= _keyframes.front().time || !last)
+    {
+        position = _keyframes.front().position;
+        center = _keyframes.front().center;
+        return;
+    }
+    if (time >= _keyframes.back().time)
+    {
+        position = _keyframes.back().position;
+        center = _keyframes.back().center;
+        return;
+    }
+    auto i = segmentAt(time);
+    const auto &k0 = _keyframes[i ? i - 1 : 0];
+    const auto &k1 = _keyframes[i];
+    const auto &k2 = _keyframes[i + 1];
+    const auto &k3 = _keyframes[(std::min)(i + 2, last)];
+    auto span = k2.time - k1.time;
+    auto u = span > 0.0f ? (time - k1.time) / span : 1.0f;
+    position = catmull_rom(k0.position, k1.position, k2.position, k3.position, u);
+    center = catmull_rom(k0.center, k1.center, k2.center, k3.center, u);
+}
+
+void CameraPath::Play(float step)
+{
+    _step = step > 0.0f ? step : CAMERA_PATH_DEFAULT_STEP;
+    _time = _keyframes.empty() ? 0.0f : _keyframes.front().time;
+    _playing = !_keyframes.empty();
+    _finished = false;
+    _hasFrame = false;
+    _segments.clear();
+    auto numSegments = _keyframes.size() > 1 ? _keyframes.size() - 1 : _keyframes.size();
+    for (size_t i = 0; i < numSegments; ++i)
+    {
+        const auto &begin = _keyframes[i];
+        const auto &end = _keyframes[(std::min)(i + 1, _keyframes.size() - 1)];
+        auto &segment = _segments.emplace_back();
+        segment.name = begin.name.empty() ? "Segment " + std::to_string(i) : begin.name;
+        segment.start = begin.time;
+        segment.end = end.time;
+        // every frame of segment is kept
+        segment.frameTimes.SetCapacity(static_cast<size_t>(std::ceil((end.time - begin.time) / _step)) + 2);
+    }
+}
+
+void CameraPath::Stop()
+{
+    _playing = false;
+}
+
+bool CameraPath::IsPlaying() const
+{
+    return _playing;
+}
+
+bool CameraPath::IsFinished() const
+{
+    return _finished;
+}
+
+bool CameraPath::Step(Camera &camera)
+{
+    if (!_playing)
+        return false;
+    auto app = AppContext::Instance();
+    auto frame = app->GetFrameCount();
+    if (!_hasFrame || frame != _lastFrame)
+    {
+        if (_hasFrame)
+        {
+            // previous frame rendered pose at current time
+            auto times = app->GetFrameTimes().GetFrameTimes(1);
+            auto segment = segmentAt(_time);
+            if (!times.empty() && segment < _segments.size())
+                _segments[segment].frameTimes.Push(times.front() * 1e-3f);
+            _time += _step;
+        }
+        _hasFrame = true;
+        _lastFrame = frame;
+        if (_time > GetDuration())
+        {
+            finish();
+            return false;
+        }
+    }
+    glm::vec3 position(0.0f), center(0.0f);
+    Evaluate(_time, position, center);
+    camera.SetPosition(position);
+    camera.SetCenter(center);
+    return true;
+}
+
+const std::vector<CameraPathSegment> &CameraPath::GetSegments() const
+{
+    return _segments;
+}
+
+std::string CameraPath::ToJSON() const
+{
+    std::stringstream out;
+    out << "{\"source\": \"" << _sourcePath << "\", \"step\": " << _step << ", \"segments\": [";
+    for (size_t i = 0; i < _segments.size(); ++i)
+    {
+        const auto &segment = _segments[i];
+        auto summary = segment.frameTimes.Summarize();
+        out << (i ? ",\n  " : "\n  ") << "{\"name\": \"" << segment.name << "\", \"start\": " << segment.start
+            << ", \"end\": " << segment.end << ", \"frames\": " << summary.frames << ", \"mean\": " << summary.mean
+            << ", \"p50\": " << summary.p50 << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99
+            << ", \"max\": " << summary.max << ", \"hitches\": " << summary.hitches << "}";
+    }
+    out << "\n]}";
+    return out.str();
+}
+
+bool CameraPath::WriteReport(const std::string &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        Tools::display_message(LOGNAME, "Failed to write flythrough report to " + path, Tools::MessageType::WARN);
+        return false;
+    }
+    file << ToJSON() << "\n";
+    return true;
+}
+
+size_t CameraPath::segmentAt(float time) const
+{
+    auto iter = std::upper_bound(_keyframes.begin(), _keyframes.end(), time,
+                                 [](float time, const CameraKeyframe &other) { return time < other.time; });
+    auto idx = static_cast<size_t>((std::max)(std::distance(_keyframes.begin(), iter), ptrdiff_t(1)) - 1);
+    // last keyframe belongs to last segment
+    return (std::min)(idx, _keyframes.size() > 1 ? _keyframes.size() - 2 : size_t(0));
+}
+
+void CameraPath::finish()
+{
+    _playing = false;
+    _finished = true;
+    for (const auto &segment : _segments)
+    {
+        auto summary = segment.frameTimes.Summarize();
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "%s: %d frames, mean %.2f, p50 %.2f, p95 %.2f, p99 %.2f, max %.2f ms, %d hitches",
+                      segment.name.c_str(), static_cast<int>(summary.frames), summary.mean, summary.p50,
+                      summary.p95, summary.p99, summary.max, static_cast<int>(summary.hitches));
+        Tools::display_message(LOGNAME, line, Tools::MessageType::INFO);
+    }
+    if (!reportPath.empty())
+        WriteReport(reportPath);
+    if (closeOnFinish)
+        AppContext::Instance()->RequestClose();
+}
+
+} // namespace RenderIt
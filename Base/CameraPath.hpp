@@ -0,0 +1,121 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FrameTimes.hpp"
+
+#define CAMERA_PATH_DEFAULT_STEP (1.0f / 60.0f)
+
+/** @file */
+
+namespace RenderIt
+{
+
+class Camera;
+
+/// Camera pose at path time
+struct CameraKeyframe
+{
+    float time = 0.0f;
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 center = glm::vec3(0.0f);
+    /// Name of segment starting at this keyframe
+    std::string name;
+};
+
+/// Frame times of frames rendered between two keyframes
+struct CameraPathSegment
+{
+    std::string name;
+    float start = 0.0f;
+    float end = 0.0f;
+    FrameTimes frameTimes;
+};
+
+/// Flythrough of camera keyframes, interpolated by Catmull-Rom spline
+/// Path time advances by fixed step per frame, frame times are kept per segment
+/// Text file of keyframes, one per line: "time px py pz cx cy cz [name]", '#' starts comment
+/// Started from environment by RENDERIT_FLYTHROUGH=path, with
+/// RENDERIT_FLYTHROUGH_STEP=seconds & RENDERIT_FLYTHROUGH_REPORT=path of JSON report
+class CameraPath
+{
+  public:
+    CameraPath();
+
+    /// Get path of RENDERIT_FLYTHROUGH, shared by all cameras, null if not set
+    static std::shared_ptr<CameraPath> FromEnvironment();
+
+    /// Load keyframes from file, returns false if failed
+    bool Load(const std::string &path);
+
+    /// Save keyframes to file, returns false if failed
+    bool Save(const std::string &path) const;
+
+    /// Add keyframe, kept sorted by time
+    void AddKeyframe(const CameraKeyframe &keyframe);
+
+    /// Get keyframes
+    const std::vector<CameraKeyframe> &GetKeyframes() const;
+
+    /// Get time of last keyframe
+    float GetDuration() const;
+
+    /// Get pose at path time
+    void Evaluate(float time, glm::vec3 &position, glm::vec3 &center) const;
+
+    /// Play from start with fixed step (seconds of path time per frame)
+    void Play(float step = CAMERA_PATH_DEFAULT_STEP);
+
+    /// Stop playing, keeps recorded stats
+    void Stop();
+
+    /// Whether playing
+    bool IsPlaying() const;
+
+    /// Whether played to end
+    bool IsFinished() const;
+
+    /// Move camera to pose of current frame, returns false if not playing
+    /// Records time of previous frame, advances once per AppContext frame
+    bool Step(Camera &camera);
+
+    /// Get frame time stats of segments
+    const std::vector<CameraPathSegment> &GetSegments() const;
+
+    /// Get per-segment summary as JSON object
+    std::string ToJSON() const;
+
+    /// Write per-segment summary as JSON, returns false if failed
+    bool WriteReport(const std::string &path) const;
+
+    /// UI calls
+    void UI(Camera &camera);
+
+  public:
+    const std::string LOGNAME = "CameraPath";
+    /// Close app after last keyframe
+    bool closeOnFinish;
+    /// Report written after last keyframe, empty for none
+    std::string reportPath;
+
+  private:
+    /// Get index of segment (starting keyframe) at path time
+    size_t segmentAt(float time) const;
+
+    /// Log per-segment summary, write report & close app
+    void finish();
+
+  private:
+    std::vector<CameraKeyframe> _keyframes;
+    std::vector<CameraPathSegment> _segments;
+    std::string _sourcePath;
+    float _step, _time;
+    bool _playing, _finished;
+    unsigned _lastFrame;
+    bool _hasFrame;
+};
+
+} // namespace RenderIt
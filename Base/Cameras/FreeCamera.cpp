@@ -1,4 +1,5 @@
 #include "Cameras/FreeCamera.hpp"
+#include "Device.hpp"
 #include "Input.hpp"
 #include "Tools.hpp"
 
@@ -21,11 +22,15 @@ std::shared_ptr<FreeCamera> FreeCamera::Instance()
 
 void FreeCamera::PrepareFrame(unsigned clearMask)
 {
-    glClear(static_cast<GLbitfield>(clearMask));
-    glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
-    // update by input
-    processMouseMovements();
-    processWASDKeys();
+    auto &device = GraphicsDevice::Get();
+    device.Clear(static_cast<GLbitfield>(clearMask));
+    device.ClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    // update by input, unless following flythrough
+    if (!stepFlythrough())
+    {
+        processMouseMovements();
+        processWASDKeys();
+    }
     if (!_updated)
         update();
 }
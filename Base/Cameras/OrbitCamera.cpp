@@ -1,4 +1,5 @@
 #include "Cameras/OrbitCamera.hpp"
+#include "Device.hpp"
 #include "Input.hpp"
 
 #include <GL/glew.h>
@@ -21,12 +22,16 @@ std::shared_ptr<OrbitCamera> OrbitCamera::Instance()
 
 void OrbitCamera::PrepareFrame(unsigned clearMask)
 {
-    glClear(static_cast<GLbitfield>(clearMask));
-    glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
-    // update by input
-    processMouseMovements();
-    processMouseWheel();
-    processWASDKeys();
+    auto &device = GraphicsDevice::Get();
+    device.Clear(static_cast<GLbitfield>(clearMask));
+    device.ClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    // update by input, unless following flythrough
+    if (!stepFlythrough())
+    {
+        processMouseMovements();
+        processMouseWheel();
+        processWASDKeys();
+    }
     if (!_updated)
         update();
 }
@@ -0,0 +1,345 @@
+#include "CommandList.hpp"
+#include "Device.hpp"
+#include "Materials.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+
+namespace RenderIt
+{
+
+void CommandList::Reset()
+{
+    _commands.clear();
+    _payload.clear();
+    _callbacks.clear();
+    _materials.clear();
+    _names.clear();
+    _shader = nullptr;
+}
+
+void CommandList::Execute() const
+{
+    auto &device = GraphicsDevice::Get();
+    const Shader *shader = nullptr;
+    bool materialsBound = false;
+    // draws of shader still compiling are skipped
+    bool skipDraws = false;
+    // saved blend & cull face states
+    std::vector<std::pair<bool, bool>> states;
+    // uniforms of programs with variants or still compiling are resolved by name against bound program
+    auto uniform = [&](const Command &cmd, UniformType type, const void *data) {
+        if (skipDraws)
+            return;
+        if (cmd.args[0] < 0)
+            shader->Uniform(_names[cmd.args[1]], type, data);
+        else
+            device.Uniform(cmd.args[0], type, data);
+    };
+    for (const auto &cmd : _commands)
+    {
+        const auto *payload = _payload.data() + cmd.data;
+        switch (cmd.type)
+        {
+        case CommandType::BindProgram: {
+            shader = cmd.shader;
+            if (shader)
+                shader->Bind();
+            else
+                device.UseProgram(0);
+            materialsBound = false;
+            skipDraws = shader && !shader->IsCompiled();
+            break;
+        }
+        case CommandType::BindBufferBase: {
+            device.BindBufferBase(static_cast<GLenum>(cmd.args[0]), static_cast<GLuint>(cmd.args[1]),
+                                  static_cast<GLuint>(cmd.args[2]));
+            break;
+        }
+        case CommandType::BindTexture: {
+            device.BindTextureUnit(static_cast<GLuint>(cmd.args[0]), static_cast<GLuint>(cmd.args[1]));
+            break;
+        }
+        case CommandType::BindVertexArray: {
+            device.BindVertexArray(static_cast<GLuint>(cmd.args[0]));
+            break;
+        }
+        case CommandType::BindFramebuffer: {
+            device.BindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(cmd.args[0]));
+            break;
+        }
+        case CommandType::SetEnabled: {
+            device.SetEnabled(static_cast<GLenum>(cmd.args[0]), cmd.args[1] != 0);
+            break;
+        }
+        case CommandType::PushState: {
+            states.push_back({device.IsEnabled(GL_BLEND), device.IsEnabled(GL_CULL_FACE)});
+            break;
+        }
+        case CommandType::PopState: {
+            if (states.empty())
+                break;
+            auto [hasBlend, hasCullFace] = states.back();
+            states.pop_back();
+            device.SetEnabled(GL_BLEND, hasBlend);
+            device.SetEnabled(GL_CULL_FACE, hasCullFace);
+            break;
+        }
+        case CommandType::CullFace: {
+            device.CullFace(static_cast<GLenum>(cmd.args[0]));
+            break;
+        }
+        case CommandType::PolygonOffset: {
+            float offsets[2];
+            std::memcpy(offsets, payload, sizeof(offsets));
+            device.PolygonOffset(offsets[0], offsets[1]);
+            break;
+        }
+        case CommandType::Viewport: {
+            device.Viewport(cmd.args[0], cmd.args[1], cmd.args[2], cmd.args[3]);
+            break;
+        }
+        case CommandType::Clear: {
+            device.Clear(static_cast<GLbitfield>(cmd.args[0]));
+            break;
+        }
+        case CommandType::ConfigMaterial: {
+            if (!shader)
+                break;
+            const auto &mat = _materials[cmd.data];
+            if (shader->UsesMaterialBuffer())
+            {
+                auto materials = MaterialManager::Instance();
+                auto slot = materials->Sync(mat);
+                if (!materialsBound)
+                {
+                    materials->BindMaterials();
+                    materialsBound = true;
+                }
+                shader->ConfigMaterialBuffer(mat.get(), slot);
+            }
+            else
+                shader->ConfigMaterialTextures(mat.get());
+            break;
+        }
+        case CommandType::Callback: {
+            _callbacks[cmd.data]();
+            break;
+        }
+        case CommandType::DrawElements: {
+            if (skipDraws)
+                break;
+            device.DrawElements(static_cast<GLenum>(cmd.args[0]), cmd.args[1], GL_UNSIGNED_INT, 0, cmd.args[2]);
+            break;
+        }
+        case CommandType::UniformInt: {
+            uniform(cmd, UniformType::Int, payload);
+            break;
+        }
+        case CommandType::UniformUInt: {
+            uniform(cmd, UniformType::UInt, payload);
+            break;
+        }
+        case CommandType::UniformFloat: {
+            uniform(cmd, UniformType::Float, payload);
+            break;
+        }
+        case CommandType::UniformVec2: {
+            uniform(cmd, UniformType::Vec2, payload);
+            break;
+        }
+        case CommandType::UniformVec3: {
+            uniform(cmd, UniformType::Vec3, payload);
+            break;
+        }
+        case CommandType::UniformVec4: {
+            uniform(cmd, UniformType::Vec4, payload);
+            break;
+        }
+        case CommandType::UniformMat3: {
+            uniform(cmd, UniformType::Mat3, payload);
+            break;
+        }
+        case CommandType::UniformMat4: {
+            uniform(cmd, UniformType::Mat4, payload);
+            break;
+        }
+        }
+    }
+}
+
+size_t CommandList::GetNumCommands() const
+{
+    return _commands.size();
+}
+
+const Shader *CommandList::GetShader() const
+{
+    return _shader;
+}
+
+void CommandList::BindProgram(const Shader *shader)
+{
+    // readiness is checked on replay, program may finish compiling in between
+    _shader = shader;
+    push(CommandType::BindProgram).shader = _shader;
+}
+
+void CommandList::BindBufferBase(GLenum target, unsigned binding, GLuint buffer)
+{
+    push(CommandType::BindBufferBase, static_cast<GLint>(target), static_cast<GLint>(binding),
+         static_cast<GLint>(buffer));
+}
+
+void CommandList::BindTexture(unsigned unit, GLuint texture)
+{
+    push(CommandType::BindTexture, static_cast<GLint>(unit), static_cast<GLint>(texture));
+}
+
+void CommandList::BindVertexArray(GLuint vao)
+{
+    push(CommandType::BindVertexArray, static_cast<GLint>(vao));
+}
+
+void CommandList::BindFramebuffer(GLuint fbo)
+{
+    push(CommandType::BindFramebuffer, static_cast<GLint>(fbo));
+}
+
+void CommandList::SetEnabled(GLenum cap, bool enabled)
+{
+    push(CommandType::SetEnabled, static_cast<GLint>(cap), enabled ? 1 : 0);
+}
+
+void CommandList::PushState()
+{
+    push(CommandType::PushState);
+}
+
+void CommandList::PopState()
+{
+    push(CommandType::PopState);
+}
+
+void CommandList::CullFace(GLenum face)
+{
+    push(CommandType::CullFace, static_cast<GLint>(face));
+}
+
+void CommandList::PolygonOffset(float factor, float units)
+{
+    float offsets[2]{factor, units};
+    push(CommandType::PolygonOffset).data = _payload.size();
+    _payload.insert(_payload.end(), reinterpret_cast<const unsigned char *>(offsets),
+                    reinterpret_cast<const unsigned char *>(offsets) + sizeof(offsets));
+}
+
+void CommandList::Viewport(int x, int y, int width, int height)
+{
+    push(CommandType::Viewport, x, y, width, height);
+}
+
+void CommandList::Clear(GLbitfield mask)
+{
+    push(CommandType::Clear, static_cast<GLint>(mask));
+}
+
+void CommandList::ConfigMaterial(const std::shared_ptr<Material> &mat)
+{
+    if (!mat)
+        return;
+    push(CommandType::ConfigMaterial).data = _materials.size();
+    _materials.push_back(mat);
+}
+
+void CommandList::Callback(std::function<void()> func)
+{
+    if (!func)
+        return;
+    push(CommandType::Callback).data = _callbacks.size();
+    _callbacks.push_back(std::move(func));
+}
+
+void CommandList::DrawElements(GLenum mode, size_t count, size_t instances)
+{
+    if (!count)
+        return;
+    push(CommandType::DrawElements, static_cast<GLint>(mode), static_cast<GLint>(count),
+         static_cast<GLint>(instances));
+}
+
+void CommandList::UniformBool(const std::string &name, bool val)
+{
+    int v = static_cast<int>(val);
+    pushUniform(CommandType::UniformInt, name, &v, sizeof(v));
+}
+
+void CommandList::UniformInt(const std::string &name, int val)
+{
+    pushUniform(CommandType::UniformInt, name, &val, sizeof(val));
+}
+
+void CommandList::UniformUInt(const std::string &name, unsigned val)
+{
+    pushUniform(CommandType::UniformUInt, name, &val, sizeof(val));
+}
+
+void CommandList::UniformFloat(const std::string &name, float val)
+{
+    pushUniform(CommandType::UniformFloat, name, &val, sizeof(val));
+}
+
+void CommandList::UniformVec2(const std::string &name, const glm::vec2 &val)
+{
+    pushUniform(CommandType::UniformVec2, name, glm::value_ptr(val), sizeof(val));
+}
+
+void CommandList::UniformVec3(const std::string &name, const glm::vec3 &val)
+{
+    pushUniform(CommandType::UniformVec3, name, glm::value_ptr(val), sizeof(val));
+}
+
+void CommandList::UniformVec4(const std::string &name, const glm::vec4 &val)
+{
+    pushUniform(CommandType::UniformVec4, name, glm::value_ptr(val), sizeof(val));
+}
+
+void CommandList::UniformMat3(const std::string &name, const glm::mat3 &val)
+{
+    pushUniform(CommandType::UniformMat3, name, glm::value_ptr(val), sizeof(val));
+}
+
+void CommandList::UniformMat4(const std::string &name, const glm::mat4 &val)
+{
+    pushUniform(CommandType::UniformMat4, name, glm::value_ptr(val), sizeof(val));
+}
+
+CommandList::Command &CommandList::push(CommandType type, GLint a0, GLint a1, GLint a2, GLint a3)
+{
+    return _commands.emplace_back(Command{type, {a0, a1, a2, a3}, 0, nullptr});
+}
+
+void CommandList::pushUniform(CommandType type, const std::string &name, const void *val, size_t size)
+{
+    if (!_shader)
+        return;
+    GLint location = -1, nameIdx = 0;
+    // uniform may only be active in variants, base location is not enough
+    if (_shader->IsCompiled() && !_shader->HasFeatures())
+    {
+        location = _shader->GetUniformLocation(name);
+        if (location < 0)
+            return;
+    }
+    else
+    {
+        nameIdx = static_cast<GLint>(_names.size());
+        _names.push_back(name);
+    }
+    push(type, location, nameIdx).data = _payload.size();
+    auto bytes = static_cast<const unsigned char *>(val);
+    _payload.insert(_payload.end(), bytes, bytes + size);
+}
+
+} // namespace RenderIt
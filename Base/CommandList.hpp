@@ -0,0 +1,170 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Material.hpp"
+#include "Shader.hpp"
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Recorded render commands
+/// Recording does not call GL, so lists of independent passes can be filled on worker threads
+/// Execute replays the commands in order on the GL thread
+class CommandList
+{
+  public:
+    /// Clear recorded commands, keeps capacity
+    void Reset();
+
+    /// Replay commands, must be called on GL thread
+    void Execute() const;
+
+    /// Get number of recorded commands
+    size_t GetNumCommands() const;
+
+    /// Get program of last BindProgram
+    const Shader *GetShader() const;
+
+#pragma region state_commands
+
+    /// Use program, following uniforms are resolved against its location cache
+    /// Draws are skipped on replay while program is still compiling
+    /// Uniforms of such program or of program with variants are resolved by name on replay
+    void BindProgram(const Shader *shader);
+
+    /// Bind buffer to indexed target (uniform block, storage block)
+    void BindBufferBase(GLenum target, unsigned binding, GLuint buffer);
+
+    /// Bind texture to unit
+    void BindTexture(unsigned unit, GLuint texture);
+
+    /// Bind vertex array
+    void BindVertexArray(GLuint vao);
+
+    /// Bind framebuffer
+    void BindFramebuffer(GLuint fbo);
+
+    /// Enable or disable capability
+    void SetEnabled(GLenum cap, bool enabled);
+
+    /// Push blend & face culling states, restored by PopState
+    void PushState();
+
+    /// Restore states saved by PushState
+    void PopState();
+
+    /// Set culled face
+    void CullFace(GLenum face);
+
+    /// Set polygon offset
+    void PolygonOffset(float factor, float units);
+
+    /// Set viewport
+    void Viewport(int x, int y, int width, int height);
+
+    /// Clear bound framebuffer
+    void Clear(GLbitfield mask);
+
+    /// Configure material of following draws, material constants are synced on replay
+    void ConfigMaterial(const std::shared_ptr<Material> &mat);
+
+    /// Run function on replay, for work that cannot be recorded
+    void Callback(std::function<void()> func);
+
+#pragma endregion state_commands
+
+#pragma region draw_commands
+
+    /// Draw indexed primitives of bound vertex array, instanced if instances > 0
+    void DrawElements(GLenum mode, size_t count, size_t instances = 0);
+
+#pragma endregion draw_commands
+
+#pragma region uniform_commands
+
+    void UniformBool(const std::string &name, bool val);
+
+    void UniformInt(const std::string &name, int val);
+
+    void UniformUInt(const std::string &name, unsigned val);
+
+    void UniformFloat(const std::string &name, float val);
+
+    void UniformVec2(const std::string &name, const glm::vec2 &val);
+
+    void UniformVec3(const std::string &name, const glm::vec3 &val);
+
+    void UniformVec4(const std::string &name, const glm::vec4 &val);
+
+    void UniformMat3(const std::string &name, const glm::mat3 &val);
+
+    void UniformMat4(const std::string &name, const glm::mat4 &val);
+
+#pragma endregion uniform_commands
+
+  public:
+    const std::string LOGNAME = "CommandList";
+
+  private:
+    enum class CommandType
+    {
+        BindProgram,
+        BindBufferBase,
+        BindTexture,
+        BindVertexArray,
+        BindFramebuffer,
+        SetEnabled,
+        PushState,
+        PopState,
+        CullFace,
+        PolygonOffset,
+        Viewport,
+        Clear,
+        ConfigMaterial,
+        Callback,
+        DrawElements,
+        UniformInt,
+        UniformUInt,
+        UniformFloat,
+        UniformVec2,
+        UniformVec3,
+        UniformVec4,
+        UniformMat3,
+        UniformMat4,
+    };
+
+    struct Command
+    {
+        CommandType type;
+        // command arguments, or uniform location in args[0] (-1 if resolved on replay) & name index in args[1]
+        GLint args[4];
+        // offset into payload, callbacks or materials
+        size_t data;
+        const Shader *shader;
+    };
+
+    /// Append command
+    Command &push(CommandType type, GLint a0 = 0, GLint a1 = 0, GLint a2 = 0, GLint a3 = 0);
+
+    /// Append uniform command with value copied to payload, skipped if uniform is inactive
+    /// Name is kept if location is only known on replay
+    void pushUniform(CommandType type, const std::string &name, const void *val, size_t size);
+
+  private:
+    std::vector<Command> _commands;
+    std::vector<unsigned char> _payload;
+    std::vector<std::function<void()>> _callbacks;
+    std::vector<std::shared_ptr<Material>> _materials;
+    std::vector<std::string> _names;
+    const Shader *_shader = nullptr;
+};
+
+} // namespace RenderIt
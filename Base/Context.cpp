@@ -1,28 +1,49 @@
 #include "Context.hpp"
 #include "Camera.hpp"
+#include "Device.hpp"
+#include "FrameConstants.hpp"
 #include "Input.hpp"
+#include "Jobs.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
+#include "Shader.hpp"
+#include "ShaderCache.hpp"
+#include "StreamBuffer.hpp"
 #include "Tools.hpp"
 
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
 #include <algorithm>
-#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
+#include <fstream>
+#include <stdexcept>
 
 namespace fs = std::filesystem;
 
 namespace RenderIt
 {
 
-AppContext::AppContext() : displayUI(true), _winW(800), _winH(600), _winTitle("RenderIt"), _tDelta(0.0f)
+AppContext::AppContext()
+    : displayUI(true), _winW(800), _winH(600), _winTitle("RenderIt"), _tDelta(0.0f), _headless(false), _numFrames(0),
+      _maxFrames(0), _fixedDelta(0.0f), _tFrameStart(0.0), _tStartup(0.0)
 {
+    readEnvironment();
     initializeLocal();
     initializeGlobal();
 }
 
 AppContext::~AppContext()
 {
+    if (!_statsPath.empty())
+        WriteFrameStats(_statsPath);
+    if (!_statsCSVPath.empty())
+        _frameTimes.WriteCSV(_statsCSVPath);
+    if (!_tracePath.empty())
+        Profiler::Instance()->ExportChromeTrace(_tracePath);
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -40,7 +61,8 @@ std::shared_ptr<AppContext> AppContext::Instance()
 
 void AppContext::SetWindowSize(int width, int height)
 {
-    if (!_window)
+    // offscreen framebuffer size is fixed
+    if (!_window || _headless)
         return;
     _winW = (std::max)(50, width);
     _winH = (std::max)(50, height);
@@ -61,25 +83,66 @@ void AppContext::SetWindowTitle(const std::string &title)
 
 bool AppContext::WindowShouldClose() const
 {
+    if (_maxFrames && _numFrames >= _maxFrames)
+        return true;
+    if (_inputRecorder.IsReplayFinished())
+        return true;
     return _window ? glfwWindowShouldClose(_window) : true;
 }
 
+void AppContext::RequestClose()
+{
+    if (_window)
+        glfwSetWindowShouldClose(_window, GLFW_TRUE);
+}
+
 void AppContext::LoopEndFrame(std::function<void()> callUI)
 {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
-    if (displayUI && callUI)
-        callUI();
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    {
+        RENDER_PASS("UI");
+        ImGui::NewFrame();
+        if (displayUI && callUI)
+            callUI();
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
 
     glfwSwapBuffers(_window);
+    GraphicsDevice::Get().EndFrame();
+    StreamBuffer::EndFrameAll();
+    Shader::PollPending();
+    RenderStats::Instance()->EndFrame();
+    Profiler::Instance()->EndFrame();
     glfwPollEvents();
-
-    auto tCurr = static_cast<float>(glfwGetTime());
-    _tDelta = tCurr - _tPrev;
-    _tPrev = tCurr;
+    JobSystem::Instance()->ProcessMainThread();
+
+    auto tFrameEnd = glfwGetTime();
+    _frameTimes.Push(static_cast<float>(tFrameEnd - _tFrameStart));
+    _tFrameStart = tFrameEnd;
+    ++_numFrames;
+
+    double tReplayEnd = 0.0;
+    if (_inputRecorder.ReplayFrame(_tDelta, tReplayEnd))
+    {
+        // recorded input & time replace live ones
+        _tPrev = static_cast<float>(tReplayEnd);
+    }
+    else if (_fixedDelta > 0.0f)
+    {
+        // simulated time, so runs are reproducible
+        _tDelta = _fixedDelta;
+        _tPrev += _fixedDelta;
+    }
+    else
+    {
+        auto tCurr = static_cast<float>(tFrameEnd);
+        _tDelta = tCurr - _tPrev;
+        _tPrev = tCurr;
+    }
+    _inputRecorder.RecordFrame(_tDelta, _tPrev);
+    updateFrameConstants();
 }
 
 void AppContext::EnableCommonGLFeatures() const
@@ -103,9 +166,23 @@ void AppContext::SetVsync(bool enable) const
 
 void AppContext::Start()
 {
-    glfwShowWindow(_window);
-    glfwFocusWindow(_window);
-    _tPrev = static_cast<float>(glfwGetTime());
+    if (!_headless)
+    {
+        glfwShowWindow(_window);
+        glfwFocusWindow(_window);
+    }
+    _tFrameStart = glfwGetTime();
+    _tPrev = static_cast<float>(_inputRecorder.IsReplaying() ? _inputRecorder.GetStartTime() : _tFrameStart);
+    updateFrameConstants();
+
+    // GLFW time starts at init, so startup covers context creation & all setup before Start
+    _tStartup = _tFrameStart;
+    const auto &cache = ShaderCache::Instance()->GetStats();
+    Tools::display_message(LOGNAME,
+                           "Startup " + std::to_string(_tStartup) + " s, programs cached " +
+                               std::to_string(cache.hits) + " (" + std::to_string(cache.loadMs) + " ms), compiled " +
+                               std::to_string(cache.misses) + " (" + std::to_string(cache.compileMs) + " ms)",
+                           Tools::MessageType::INFO);
 }
 
 float AppContext::GetDeltaTime() const
@@ -118,12 +195,90 @@ float AppContext::GetFrameEndTime() const
     return _tPrev;
 }
 
+bool AppContext::IsHeadless() const
+{
+    return _headless;
+}
+
+unsigned AppContext::GetFrameCount() const
+{
+    return _numFrames;
+}
+
+double AppContext::GetStartupTime() const
+{
+    return _tStartup;
+}
+
+InputRecorder &AppContext::GetInputRecorder()
+{
+    return _inputRecorder;
+}
+
+FrameTimes &AppContext::GetFrameTimes()
+{
+    return _frameTimes;
+}
+
+bool AppContext::WriteFrameStats(const std::string &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        Tools::display_message(LOGNAME, "Failed to write frame stats to " + path, Tools::MessageType::WARN);
+        return false;
+    }
+    auto summary = _frameTimes.Summarize();
+    double total = 0.0;
+    for (auto t : _frameTimes.GetFrameTimes())
+        total += t * 1e-3;
+
+    file << "{\n";
+    file << "  \"app\": \"" << _winTitle << "\",\n";
+    file << "  \"renderer\": \"" << _rendererInfo << "\",\n";
+    file << "  \"headless\": " << (_headless ? "true" : "false") << ",\n";
+    file << "  \"width\": " << _winW << ",\n";
+    file << "  \"height\": " << _winH << ",\n";
+    file << "  \"frames\": " << summary.frames << ",\n";
+    file << "  \"fixed_dt\": " << _fixedDelta << ",\n";
+    file << "  \"total_s\": " << total << ",\n";
+    file << "  \"startup_s\": " << _tStartup << ",\n";
+    file << "  \"shader_cache\": " << ShaderCache::Instance()->ToJSON() << ",\n";
+    file << "  \"frame_ms\": {";
+    file << "\"mean\": " << summary.mean << ", ";
+    file << "\"min\": " << summary.min << ", ";
+    file << "\"max\": " << summary.max << ", ";
+    file << "\"p50\": " << summary.p50 << ", ";
+    file << "\"p95\": " << summary.p95 << ", ";
+    file << "\"p99\": " << summary.p99 << "},\n";
+    file << "  \"frame_times\": " << _frameTimes.ToJSON() << ",\n";
+    file << "  \"render\": " << RenderStats::Instance()->ToJSON() << "\n";
+    file << "}\n";
+    return true;
+}
+
 void AppContext::initializeLocal()
 {
     glfwSetErrorCallback(AppContext::glfw_error_callback);
+    if (_headless)
+    {
+#if defined(GLFW_PLATFORM_NULL)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+        throw std::runtime_error("Headless mode requires GLFW 3.4!");
+#endif
+    }
     if (!glfwInit())
         throw std::runtime_error("Failed to init GLFW!");
     glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    if (_headless)
+    {
+        // OSMesa keeps default framebuffer in memory, so passes writing to FBO 0 work unchanged
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_COMPAT_PROFILE);
+    }
     _window = glfwCreateWindow(_winW, _winH, _winTitle.c_str(), nullptr, nullptr);
     if (!_window)
         throw std::runtime_error("Failed to create GLFW window!");
@@ -137,10 +292,18 @@ void AppContext::initializeLocal()
     glfwSetWindowSizeCallback(_window, AppContext::glfw_window_size_callback);
 
     glewExperimental = GL_TRUE;
-    if (glewInit() != GLEW_OK)
+    auto glewStatus = glewInit();
+#if defined(GLEW_ERROR_NO_GLX_DISPLAY)
+    // entry points are loaded before GLX check, which fails without X display
+    if (_headless && glewStatus == GLEW_ERROR_NO_GLX_DISPLAY)
+        glewStatus = GLEW_OK;
+#endif
+    if (glewStatus != GLEW_OK)
         throw std::runtime_error("Failed to init GLEW!");
     _vendorInfo = reinterpret_cast<const char *>(glGetString(GL_VENDOR));
     _rendererInfo = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+    // let driver compile submitted programs on all its threads
+    GraphicsDevice::Get().SetCompilerThreads(0xFFFFFFFFu);
 
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -159,6 +322,56 @@ void AppContext::initializeGlobal()
     InputManager::Instance();
 }
 
+void AppContext::readEnvironment()
+{
+    auto read = [](const char *name) -> std::string {
+        auto value = std::getenv(name);
+        return value ? value : "";
+    };
+    auto headless = read("RENDERIT_HEADLESS");
+    _headless = !headless.empty() && headless != "0";
+    if (_headless)
+    {
+        int w = 0, h = 0;
+        auto resolution = read("RENDERIT_RESOLUTION");
+        if (std::sscanf(resolution.c_str(), "%dx%d", &w, &h) == 2)
+        {
+            _winW = (std::max)(50, w);
+            _winH = (std::max)(50, h);
+        }
+    }
+    auto frames = read("RENDERIT_FRAMES");
+    if (!frames.empty())
+        _maxFrames = static_cast<unsigned>((std::max)(0L, std::strtol(frames.c_str(), nullptr, 10)));
+    auto fixedDelta = read("RENDERIT_FIXED_DT");
+    if (!fixedDelta.empty())
+        _fixedDelta = (std::max)(0.0f, std::strtof(fixedDelta.c_str(), nullptr));
+    _statsPath = read("RENDERIT_STATS_JSON");
+    _statsCSVPath = read("RENDERIT_STATS_CSV");
+    auto hitch = read("RENDERIT_HITCH_MS");
+    if (!hitch.empty())
+        _frameTimes.SetHitchThreshold(std::strtof(hitch.c_str(), nullptr));
+    auto replayPath = read("RENDERIT_REPLAY_INPUT");
+    auto recordPath = read("RENDERIT_RECORD_INPUT");
+    if (!replayPath.empty())
+        _inputRecorder.StartReplay(replayPath);
+    else if (!recordPath.empty())
+        _inputRecorder.StartRecording(recordPath);
+    _tracePath = read("RENDERIT_TRACE_JSON");
+    if (!_tracePath.empty())
+        Profiler::Instance()->Capture(_maxFrames ? _maxFrames : 300);
+    // keep whole run for stats
+    if (_maxFrames > _frameTimes.GetCapacity())
+        _frameTimes.SetCapacity(_maxFrames);
+}
+
+void AppContext::updateFrameConstants() const
+{
+    auto constants = FrameConstants::Instance();
+    constants->SetTime(_tPrev, _tDelta, _numFrames);
+    constants->SetScreenSize(_winW, _winH);
+}
+
 void AppContext::glfw_error_callback(int error, const char *description)
 {
     Tools::display_message("GLFW", std::string(description), Tools::MessageType::WARN);
@@ -174,6 +387,9 @@ void AppContext::glfw_window_size_callback(GLFWwindow *window, int width, int he
 void AppContext::glfw_key_callback(GLFWwindow *window, int key, int scancode, int action, int mods)
 {
     auto ctx = reinterpret_cast<AppContext *>(glfwGetWindowUserPointer(window));
+    // replayed input only
+    if (ctx->_inputRecorder.IsReplaying())
+        return;
     auto input = InputManager::Instance();
     input->handle_glfw_key(key, action);
 }
@@ -181,6 +397,9 @@ void AppContext::glfw_key_callback(GLFWwindow *window, int key, int scancode, in
 void AppContext::glfw_mousepos_callback(GLFWwindow *window, double posX, double posY)
 {
     auto ctx = reinterpret_cast<AppContext *>(glfwGetWindowUserPointer(window));
+    // replayed input only
+    if (ctx->_inputRecorder.IsReplaying())
+        return;
     auto input = InputManager::Instance();
     input->handle_glfw_mouse_pos(posX, posY);
 }
@@ -188,6 +407,9 @@ void AppContext::glfw_mousepos_callback(GLFWwindow *window, double posX, double
 void AppContext::glfw_mouseclick_callback(GLFWwindow *window, int button, int action, int mods)
 {
     auto ctx = reinterpret_cast<AppContext *>(glfwGetWindowUserPointer(window));
+    // replayed input only
+    if (ctx->_inputRecorder.IsReplaying())
+        return;
     auto input = InputManager::Instance();
     input->handle_glfw_mouse_click(button, action);
 }
@@ -195,6 +417,9 @@ void AppContext::glfw_mouseclick_callback(GLFWwindow *window, int button, int ac
 void AppContext::glfw_wheel_callback(GLFWwindow *window, double xoffset, double yoffset)
 {
     auto ctx = reinterpret_cast<AppContext *>(glfwGetWindowUserPointer(window));
+    // replayed input only
+    if (ctx->_inputRecorder.IsReplaying())
+        return;
     auto input = InputManager::Instance();
     input->handle_glfw_wheel(xoffset, yoffset);
 }
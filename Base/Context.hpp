@@ -2,9 +2,13 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include "FrameTimes.hpp"
+#include "InputRecorder.hpp"
+
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 /** @file */
 
@@ -12,6 +16,18 @@ namespace RenderIt
 {
 
 /// Application Context
+/// Startup is configured by environment variables:
+/// RENDERIT_HEADLESS=1 renders offscreen without display (GLFW null platform & OSMesa)
+/// RENDERIT_RESOLUTION=WxH sets fixed framebuffer size in headless mode
+/// RENDERIT_FRAMES=N closes window after N frames
+/// RENDERIT_FIXED_DT=seconds replaces measured delta time
+/// RENDERIT_STATS_JSON=path writes frame timing stats on exit
+/// RENDERIT_STATS_CSV=path writes recorded frame times on exit
+/// RENDERIT_HITCH_MS=ms sets frame time counted as hitch
+/// RENDERIT_RECORD_INPUT=path records input & frame times of every frame
+/// RENDERIT_REPLAY_INPUT=path replays recorded input & frame times, closes window at end of record
+/// RENDERIT_TRACE_JSON=path profiles frames (RENDERIT_FRAMES or 300) & writes Chrome trace on exit
+/// RENDERIT_SHADER_CACHE=directory sets program binary cache directory, 0 disables cache (see ShaderCache)
 class AppContext
 {
   public:
@@ -34,6 +50,9 @@ class AppContext
     /// Whether window should close
     bool WindowShouldClose() const;
 
+    /// Close window after current frame
+    void RequestClose();
+
     /// Swap frame buffers, call after rendering
     void LoopEndFrame(std::function<void()> callUI = nullptr);
 
@@ -52,6 +71,24 @@ class AppContext
     /// Get the end time of previous frame
     float GetFrameEndTime() const;
 
+    /// Whether running without window
+    bool IsHeadless() const;
+
+    /// Get number of finished frames
+    unsigned GetFrameCount() const;
+
+    /// Get seconds from context creation to Start, includes shader compilation
+    double GetStartupTime() const;
+
+    /// Get frame time recorder
+    FrameTimes &GetFrameTimes();
+
+    /// Get input recorder
+    InputRecorder &GetInputRecorder();
+
+    /// Write frame timing stats as JSON, returns false if failed
+    bool WriteFrameStats(const std::string &path) const;
+
     /// UI calls
     void UI();
 
@@ -66,6 +103,12 @@ class AppContext
     /// Initialize global variables
     void initializeGlobal();
 
+    /// Read startup configs from environment
+    void readEnvironment();
+
+    /// Pass time & window size of next frame to frame constants
+    void updateFrameConstants() const;
+
 #pragma region glfw_callbacks
 
     static void glfw_error_callback(int error, const char *description);
@@ -90,6 +133,17 @@ class AppContext
     std::string _imguiFilePath;
     GLFWwindow *_window;
     float _tPrev, _tDelta;
+
+    bool _headless;
+    unsigned _numFrames, _maxFrames;
+    float _fixedDelta;
+    double _tFrameStart;
+    double _tStartup;
+    std::string _statsPath;
+    std::string _statsCSVPath;
+    std::string _tracePath;
+    FrameTimes _frameTimes;
+    InputRecorder _inputRecorder;
 };
 
 } // namespace RenderIt
@@ -0,0 +1,829 @@
+#include "Device.hpp"
+#include "Devices/OpenGLDevice.hpp"
+#include "Tools.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace RenderIt
+{
+
+/// Triangles drawn by one instance of a draw call
+static size_t triangle_count(GLenum mode, size_t count)
+{
+    switch (mode)
+    {
+    case GL_TRIANGLES:
+        return count / 3;
+    case GL_TRIANGLE_STRIP:
+    case GL_TRIANGLE_FAN:
+        return count > 2 ? count - 2 : 0;
+    default:
+        return 0;
+    }
+}
+
+/// Bytes per texel of client pixel data
+static size_t texel_size(GLenum format, GLenum type)
+{
+    size_t components = 4;
+    switch (format)
+    {
+    case GL_RED:
+    case GL_RED_INTEGER:
+    case GL_DEPTH_COMPONENT:
+        components = 1;
+        break;
+    case GL_RG:
+    case GL_RG_INTEGER:
+        components = 2;
+        break;
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGB_INTEGER:
+        components = 3;
+        break;
+    default:
+        break;
+    }
+    switch (type)
+    {
+    case GL_UNSIGNED_BYTE:
+    case GL_BYTE:
+        return components;
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_HALF_FLOAT:
+        return components * 2;
+    default:
+        return components * 4;
+    }
+}
+
+/// Bytes per texel as stored by driver, unsized formats fall back to client pixel data
+static size_t internal_format_size(GLenum internalFormat, GLenum format, GLenum type)
+{
+    // three component formats are usually padded to four
+    switch (internalFormat)
+    {
+    case GL_RED:
+    case GL_R8:
+    case GL_R8I:
+    case GL_R8UI:
+    case GL_STENCIL_INDEX8:
+        return 1;
+    case GL_RG:
+    case GL_RG8:
+    case GL_R16:
+    case GL_R16F:
+    case GL_R16I:
+    case GL_R16UI:
+    case GL_DEPTH_COMPONENT16:
+        return 2;
+    case GL_RGB:
+    case GL_RGBA:
+    case GL_RGB8:
+    case GL_RGBA8:
+    case GL_SRGB8:
+    case GL_SRGB8_ALPHA8:
+    case GL_RG16:
+    case GL_RG16F:
+    case GL_R32F:
+    case GL_R32I:
+    case GL_R32UI:
+    case GL_R11F_G11F_B10F:
+    case GL_RGB10_A2:
+    case GL_DEPTH_COMPONENT:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32:
+    case GL_DEPTH_COMPONENT32F:
+    case GL_DEPTH_STENCIL:
+    case GL_DEPTH24_STENCIL8:
+        return 4;
+    case GL_RGB16:
+    case GL_RGBA16:
+    case GL_RGB16F:
+    case GL_RGBA16F:
+    case GL_RG32F:
+    case GL_DEPTH32F_STENCIL8:
+        return 8;
+    case GL_RGB32F:
+    case GL_RGBA32F:
+        return 16;
+    default:
+        return texel_size(format, type);
+    }
+}
+
+/// Key of tracked object
+static uint64_t memory_key(DeviceObject type, GLuint id)
+{
+    return (static_cast<uint64_t>(type) << 32) | id;
+}
+
+/// Format bytes with unit
+static std::string format_bytes(size_t bytes)
+{
+    char text[32];
+    if (bytes >= (size_t(1) << 20))
+        std::snprintf(text, sizeof(text), "%.2f MB", bytes / double(1 << 20));
+    else
+        std::snprintf(text, sizeof(text), "%.2f KB", bytes / 1024.0);
+    return text;
+}
+
+static std::shared_ptr<GraphicsDevice> &active_device()
+{
+    static std::shared_ptr<GraphicsDevice> device;
+    return device;
+}
+
+GraphicsDevice &GraphicsDevice::Get()
+{
+    auto &device = active_device();
+    if (!device)
+        device = std::make_shared<OpenGLDevice>();
+    return *device;
+}
+
+void GraphicsDevice::Set(std::shared_ptr<GraphicsDevice> device)
+{
+    active_device() = std::move(device);
+}
+
+GraphicsDevice::~GraphicsDevice()
+{
+    ReportLeaks();
+}
+
+const DeviceStats &GraphicsDevice::GetStats() const
+{
+    return _stats;
+}
+
+void GraphicsDevice::ResetStats()
+{
+    _stats = DeviceStats();
+}
+
+const DeviceStats &GraphicsDevice::GetFrameStats() const
+{
+    return _frameStats;
+}
+
+void GraphicsDevice::EndFrame()
+{
+    _frameStats = _stats;
+    _stats = DeviceStats();
+}
+
+const MemoryStats &GraphicsDevice::GetMemoryStats(MemoryCategory category) const
+{
+    return _memoryStats[static_cast<size_t>(category)];
+}
+
+MemoryStats GraphicsDevice::GetTotalMemory() const
+{
+    MemoryStats total;
+    for (const auto &stats : _memoryStats)
+    {
+        total.bytes += stats.bytes;
+        total.peak += stats.peak;
+        total.allocations += stats.allocations;
+    }
+    return total;
+}
+
+std::vector<MemoryAllocation> GraphicsDevice::GetAllocations() const
+{
+    std::vector<MemoryAllocation> allocations;
+    allocations.reserve(_memory.size());
+    for (const auto &[key, tracked] : _memory)
+        if (tracked.allocation.bytes)
+            allocations.push_back(tracked.allocation);
+    std::sort(allocations.begin(), allocations.end(),
+              [](const MemoryAllocation &a, const MemoryAllocation &b) { return a.bytes > b.bytes; });
+    return allocations;
+}
+
+size_t GraphicsDevice::ReportLeaks() const
+{
+    auto allocations = GetAllocations();
+    if (allocations.empty())
+        return 0;
+    size_t total = 0;
+    for (const auto &allocation : allocations)
+        total += allocation.bytes;
+    Tools::display_message(LOGNAME,
+                           std::to_string(allocations.size()) + " GPU allocations never deleted (" +
+                               format_bytes(total) + ")",
+                           Tools::MessageType::WARN);
+    const char *typeNames[] = {"vertex array", "buffer", "texture", "framebuffer", "renderbuffer", "query"};
+    for (const auto &allocation : allocations)
+        Tools::display_message(LOGNAME,
+                               "  " + std::to_string(allocation.category) + " " +
+                                   (allocation.owner ? allocation.owner : "(no scope)") + " " +
+                                   typeNames[static_cast<size_t>(allocation.type)] + " " +
+                                   std::to_string(allocation.id) + ": " + format_bytes(allocation.bytes),
+                               Tools::MessageType::WARN);
+    return allocations.size();
+}
+
+DeviceStats &DeviceStats::operator+=(const DeviceStats &other)
+{
+    drawCalls += other.drawCalls;
+    instances += other.instances;
+    triangles += other.triangles;
+    instancesUpperBound += other.instancesUpperBound;
+    trianglesUpperBound += other.trianglesUpperBound;
+    dispatches += other.dispatches;
+    vertexArrayBinds += other.vertexArrayBinds;
+    bufferBinds += other.bufferBinds;
+    textureBinds += other.textureBinds;
+    programBinds += other.programBinds;
+    framebufferBinds += other.framebufferBinds;
+    stateChanges += other.stateChanges;
+    uniforms += other.uniforms;
+    uploads += other.uploads;
+    bufferBytes += other.bufferBytes;
+    textureBytes += other.textureBytes;
+    objectsCreated += other.objectsCreated;
+    objectsDeleted += other.objectsDeleted;
+    return *this;
+}
+
+DeviceStats DeviceStats::operator-(const DeviceStats &other) const
+{
+    DeviceStats result;
+    result.drawCalls = drawCalls - other.drawCalls;
+    result.instances = instances - other.instances;
+    result.triangles = triangles - other.triangles;
+    result.instancesUpperBound = instancesUpperBound - other.instancesUpperBound;
+    result.trianglesUpperBound = trianglesUpperBound - other.trianglesUpperBound;
+    result.dispatches = dispatches - other.dispatches;
+    result.vertexArrayBinds = vertexArrayBinds - other.vertexArrayBinds;
+    result.bufferBinds = bufferBinds - other.bufferBinds;
+    result.textureBinds = textureBinds - other.textureBinds;
+    result.programBinds = programBinds - other.programBinds;
+    result.framebufferBinds = framebufferBinds - other.framebufferBinds;
+    result.stateChanges = stateChanges - other.stateChanges;
+    result.uniforms = uniforms - other.uniforms;
+    result.uploads = uploads - other.uploads;
+    result.bufferBytes = bufferBytes - other.bufferBytes;
+    result.textureBytes = textureBytes - other.textureBytes;
+    result.objectsCreated = objectsCreated - other.objectsCreated;
+    result.objectsDeleted = objectsDeleted - other.objectsDeleted;
+    return result;
+}
+
+void GraphicsDevice::CreateObjects(DeviceObject type, GLsizei count, GLuint *ids)
+{
+    _stats.objectsCreated += static_cast<size_t>(count);
+    createObjects(type, count, ids);
+}
+
+void GraphicsDevice::DeleteObjects(DeviceObject type, GLsizei count, const GLuint *ids)
+{
+    _stats.objectsDeleted += static_cast<size_t>(count);
+    releaseMemory(type, count, ids);
+    deleteObjects(type, count, ids);
+}
+
+void GraphicsDevice::BindVertexArray(GLuint vao)
+{
+    ++_stats.vertexArrayBinds;
+    bindVertexArray(vao);
+}
+
+void GraphicsDevice::BindBuffer(GLenum target, GLuint buffer)
+{
+    ++_stats.bufferBinds;
+    _boundBuffers[target] = buffer;
+    bindBuffer(target, buffer);
+}
+
+void GraphicsDevice::BindBufferBase(GLenum target, GLuint binding, GLuint buffer)
+{
+    ++_stats.bufferBinds;
+    // also binds generic target
+    _boundBuffers[target] = buffer;
+    bindBufferBase(target, binding, buffer);
+}
+
+void GraphicsDevice::BindBufferRange(GLenum target, GLuint binding, GLuint buffer, size_t offset, size_t size)
+{
+    ++_stats.bufferBinds;
+    _boundBuffers[target] = buffer;
+    bindBufferRange(target, binding, buffer, offset, size);
+}
+
+void GraphicsDevice::BindTexture(GLenum target, GLuint texture)
+{
+    ++_stats.textureBinds;
+    _boundTextures[target] = texture;
+    bindTexture(target, texture);
+}
+
+void GraphicsDevice::BindTextureUnit(GLuint unit, GLuint texture)
+{
+    ++_stats.textureBinds;
+    bindTextureUnit(unit, texture);
+}
+
+void GraphicsDevice::BindFramebuffer(GLenum target, GLuint fbo)
+{
+    ++_stats.framebufferBinds;
+    bindFramebuffer(target, fbo);
+}
+
+void GraphicsDevice::BindRenderbuffer(GLuint rbo)
+{
+    _boundRenderbuffer = rbo;
+    bindRenderbuffer(rbo);
+}
+
+bool GraphicsDevice::IsFramebufferComplete(GLuint fbo)
+{
+    return isFramebufferComplete(fbo);
+}
+
+void GraphicsDevice::BufferData(GLenum target, size_t size, const void *data, GLenum usage)
+{
+    if (data)
+    {
+        ++_stats.uploads;
+        _stats.bufferBytes += size;
+    }
+    auto geometry = target == GL_ARRAY_BUFFER || target == GL_ELEMENT_ARRAY_BUFFER;
+    trackMemory(DeviceObject::Buffer, boundObject(DeviceObject::Buffer, target), 0, size,
+                geometry ? MemoryCategory::Geometry : MemoryCategory::Storage);
+    bufferData(target, size, data, usage);
+}
+
+void GraphicsDevice::BufferStorage(GLenum target, size_t size, const void *data, GLbitfield flags)
+{
+    if (data)
+    {
+        ++_stats.uploads;
+        _stats.bufferBytes += size;
+    }
+    auto geometry = target == GL_ARRAY_BUFFER || target == GL_ELEMENT_ARRAY_BUFFER;
+    trackMemory(DeviceObject::Buffer, boundObject(DeviceObject::Buffer, target), 0, size,
+                geometry ? MemoryCategory::Geometry : MemoryCategory::Storage);
+    bufferStorage(target, size, data, flags);
+}
+
+void GraphicsDevice::BufferSubData(GLenum target, size_t offset, size_t size, const void *data)
+{
+    ++_stats.uploads;
+    _stats.bufferBytes += size;
+    bufferSubData(target, offset, size, data);
+}
+
+void GraphicsDevice::CopyBufferSubData(GLuint src, GLuint dst, size_t srcOffset, size_t dstOffset, size_t size)
+{
+    copyBufferSubData(src, dst, srcOffset, dstOffset, size);
+}
+
+void GraphicsDevice::ClearBufferData(GLuint buffer, GLenum internalFormat, GLenum format, GLenum type,
+                                     const void *data)
+{
+    clearBufferData(buffer, internalFormat, format, type, data);
+}
+
+void GraphicsDevice::GetBufferSubData(GLuint buffer, size_t offset, size_t size, void *data)
+{
+    getBufferSubData(buffer, offset, size, data);
+}
+
+void *GraphicsDevice::MapBuffer(GLuint buffer, GLenum access)
+{
+    // mapped size is unknown, only counted
+    if (access != GL_READ_ONLY)
+        ++_stats.uploads;
+    return mapBuffer(buffer, access);
+}
+
+void *GraphicsDevice::MapBufferRange(GLuint buffer, size_t offset, size_t size, GLbitfield access)
+{
+    if (access & GL_MAP_WRITE_BIT)
+    {
+        ++_stats.uploads;
+        _stats.bufferBytes += size;
+    }
+    return mapBufferRange(buffer, offset, size, access);
+}
+
+void GraphicsDevice::UnmapBuffer(GLuint buffer)
+{
+    unmapBuffer(buffer);
+}
+
+void GraphicsDevice::VertexAttribute(GLuint index, GLint size, GLenum type, bool integer, GLsizei stride, size_t offset)
+{
+    vertexAttribute(index, size, type, integer, stride, offset);
+}
+
+void GraphicsDevice::TexParameter(GLenum target, GLenum name, GLint value)
+{
+    texParameter(target, name, value);
+}
+
+void GraphicsDevice::TexImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format,
+                                GLenum type, const void *data)
+{
+    if (data)
+    {
+        ++_stats.uploads;
+        _stats.textureBytes += static_cast<size_t>(width) * height * texel_size(format, type);
+    }
+    // cubemap faces are allocated separately
+    auto isFace = target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z;
+    trackMemory(DeviceObject::Texture, boundObject(DeviceObject::Texture, target),
+                isFace ? target - GL_TEXTURE_CUBE_MAP_POSITIVE_X : 0,
+                static_cast<size_t>(width) * height * internal_format_size(internalFormat, format, type),
+                MemoryCategory::Other);
+    texImage2D(target, internalFormat, width, height, format, type, data);
+}
+
+void GraphicsDevice::CopyTexSubImage2D(GLenum target, GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    copyTexSubImage2D(target, x, y, width, height);
+}
+
+void GraphicsDevice::TexImage3D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth,
+                                GLenum format, GLenum type, const void *data)
+{
+    auto texels = static_cast<size_t>(width) * height * depth;
+    if (data)
+    {
+        ++_stats.uploads;
+        _stats.textureBytes += texels * texel_size(format, type);
+    }
+    trackMemory(DeviceObject::Texture, boundObject(DeviceObject::Texture, target), 0,
+                texels * internal_format_size(internalFormat, format, type), MemoryCategory::Other);
+    texImage3D(target, internalFormat, width, height, depth, format, type, data);
+}
+
+void GraphicsDevice::TexStorage2D(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height)
+{
+    size_t texels = 0;
+    for (GLsizei level = 0; level < levels; ++level)
+        texels += static_cast<size_t>((std::max)(1, width >> level)) * (std::max)(1, height >> level);
+    if (target == GL_TEXTURE_CUBE_MAP)
+        texels *= 6;
+    trackMemory(DeviceObject::Texture, boundObject(DeviceObject::Texture, target), 0,
+                texels * internal_format_size(internalFormat, GL_RGBA, GL_UNSIGNED_BYTE), MemoryCategory::Other);
+    texStorage2D(target, levels, internalFormat, width, height);
+}
+
+void GraphicsDevice::TexImage2DMultisample(GLenum target, GLsizei samples, GLenum internalFormat, GLsizei width,
+                                           GLsizei height)
+{
+    trackMemory(DeviceObject::Texture, boundObject(DeviceObject::Texture, target), 0,
+                static_cast<size_t>(width) * height * (std::max)(1, samples) *
+                    internal_format_size(internalFormat, GL_RGBA, GL_UNSIGNED_BYTE),
+                MemoryCategory::RenderTargets);
+    texImage2DMultisample(target, samples, internalFormat, width, height);
+}
+
+void GraphicsDevice::RenderbufferStorage(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei samples)
+{
+    trackMemory(DeviceObject::Renderbuffer, _boundRenderbuffer, 0,
+                static_cast<size_t>(width) * height * (std::max)(1, samples) *
+                    internal_format_size(internalFormat, GL_RGBA, GL_UNSIGNED_BYTE),
+                MemoryCategory::RenderTargets);
+    renderbufferStorage(internalFormat, width, height, samples);
+}
+
+void GraphicsDevice::GenerateMipmap(GLenum target)
+{
+    auto iter = _memory.find(memory_key(DeviceObject::Texture, boundObject(DeviceObject::Texture, target)));
+    if (iter != _memory.end() && !iter->second.mipmaps)
+    {
+        iter->second.mipmaps = true;
+        updateMemory(iter->second, iter->second.allocation.category);
+    }
+    generateMipmap(target);
+}
+
+void GraphicsDevice::BindImageTexture(GLuint unit, GLuint texture, GLint level, GLenum access, GLenum format)
+{
+    ++_stats.textureBinds;
+    bindImageTexture(unit, texture, level, access, format);
+}
+
+GLuint GraphicsDevice::CompileShader(GLenum type, const std::string &source, std::string &log)
+{
+    auto shader = submitShader(type, source);
+    if (getShaderStatus(shader, log))
+        return shader;
+    deleteShader(shader);
+    return 0;
+}
+
+GLuint GraphicsDevice::LinkProgram(const std::vector<GLuint> &shaders, std::string &log, bool retrievable)
+{
+    auto program = submitProgram(shaders, retrievable);
+    if (getProgramStatus(program, log))
+        return program;
+    deleteProgram(program);
+    return 0;
+}
+
+void GraphicsDevice::SetCompilerThreads(unsigned count)
+{
+    if (HasParallelCompile())
+        setCompilerThreads(count);
+}
+
+GLuint GraphicsDevice::SubmitShader(GLenum type, const std::string &source)
+{
+    return submitShader(type, source);
+}
+
+GLuint GraphicsDevice::SubmitProgram(const std::vector<GLuint> &shaders, bool retrievable)
+{
+    return submitProgram(shaders, retrievable);
+}
+
+bool GraphicsDevice::IsProgramReady(GLuint program)
+{
+    // status query of unfinished link would block
+    return !HasParallelCompile() || isProgramReady(program);
+}
+
+bool GraphicsDevice::GetShaderStatus(GLuint shader, std::string &log)
+{
+    return getShaderStatus(shader, log);
+}
+
+bool GraphicsDevice::GetProgramStatus(GLuint program, std::string &log)
+{
+    return getProgramStatus(program, log);
+}
+
+bool GraphicsDevice::GetProgramBinary(GLuint program, GLenum &format, std::vector<unsigned char> &binary)
+{
+    return getProgramBinary(program, format, binary);
+}
+
+GLuint GraphicsDevice::ProgramBinary(GLenum format, const std::vector<unsigned char> &binary)
+{
+    return programBinary(format, binary);
+}
+
+void GraphicsDevice::DeleteShader(GLuint shader)
+{
+    deleteShader(shader);
+}
+
+void GraphicsDevice::DeleteProgram(GLuint program)
+{
+    deleteProgram(program);
+}
+
+void GraphicsDevice::UseProgram(GLuint program)
+{
+    ++_stats.programBinds;
+    useProgram(program);
+}
+
+void GraphicsDevice::GetUniformLocations(GLuint program, std::unordered_map<std::string, GLint> &locations)
+{
+    getUniformLocations(program, locations);
+}
+
+GLuint GraphicsDevice::GetResourceIndex(GLuint program, GLenum interface, const std::string &name)
+{
+    return getResourceIndex(program, interface, name);
+}
+
+void GraphicsDevice::BlockBinding(GLuint program, GLenum interface, GLuint index, GLuint binding)
+{
+    blockBinding(program, interface, index, binding);
+}
+
+void GraphicsDevice::Uniform(GLint location, UniformType type, const void *data)
+{
+    ++_stats.uniforms;
+    uniform(location, type, data);
+}
+
+void GraphicsDevice::SetEnabled(GLenum cap, bool enabled)
+{
+    ++_stats.stateChanges;
+    setEnabled(cap, enabled);
+}
+
+bool GraphicsDevice::IsEnabled(GLenum cap)
+{
+    return isEnabled(cap);
+}
+
+void GraphicsDevice::CullFace(GLenum face)
+{
+    ++_stats.stateChanges;
+    cullFace(face);
+}
+
+void GraphicsDevice::PolygonOffset(float factor, float units)
+{
+    ++_stats.stateChanges;
+    polygonOffset(factor, units);
+}
+
+void GraphicsDevice::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    ++_stats.stateChanges;
+    viewport(x, y, width, height);
+}
+
+void GraphicsDevice::Clear(GLbitfield mask)
+{
+    clear(mask);
+}
+
+void GraphicsDevice::ClearColor(float r, float g, float b, float a)
+{
+    ++_stats.stateChanges;
+    clearColor(r, g, b, a);
+}
+
+void GraphicsDevice::DrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset, GLsizei instances)
+{
+    auto numInstances = instances ? static_cast<size_t>(instances) : 1u;
+    ++_stats.drawCalls;
+    _stats.instances += numInstances;
+    _stats.triangles += triangle_count(mode, count) * numInstances;
+    drawElements(mode, count, type, offset, instances);
+}
+
+void GraphicsDevice::DrawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+{
+    auto numInstances = instances ? static_cast<size_t>(instances) : 1u;
+    ++_stats.drawCalls;
+    _stats.instances += numInstances;
+    _stats.triangles += triangle_count(mode, count) * numInstances;
+    drawArrays(mode, first, count, instances);
+}
+
+void GraphicsDevice::BlitFramebuffer(GLint srcWidth, GLint srcHeight, GLint dstWidth, GLint dstHeight,
+                                     GLbitfield mask, GLenum filter)
+{
+    blitFramebuffer(srcWidth, srcHeight, dstWidth, dstHeight, mask, filter);
+}
+
+void GraphicsDevice::DispatchCompute(GLuint x, GLuint y, GLuint z)
+{
+    ++_stats.dispatches;
+    dispatchCompute(x, y, z);
+}
+
+void GraphicsDevice::Barrier(GLbitfield barriers)
+{
+    barrier(barriers);
+}
+
+void GraphicsDevice::MultiDrawElementsIndirect(GLenum mode, GLenum type, size_t offset, GLsizei drawCount,
+                                               size_t indices, size_t instances)
+{
+    ++_stats.drawCalls;
+    _stats.instances += instances;
+    _stats.triangles += triangle_count(mode, indices);
+    multiDrawElementsIndirect(mode, type, offset, drawCount);
+}
+
+void GraphicsDevice::MultiDrawElementsIndirectCount(GLenum mode, GLenum type, size_t offset, size_t countOffset,
+                                                    GLsizei maxDrawCount, size_t indices, size_t instances)
+{
+    ++_stats.drawCalls;
+    _stats.instancesUpperBound += instances;
+    _stats.trianglesUpperBound += triangle_count(mode, indices);
+    multiDrawElementsIndirectCount(mode, type, offset, countOffset, maxDrawCount);
+}
+
+void GraphicsDevice::QueryTimestamp(GLuint query)
+{
+    queryTimestamp(query);
+}
+
+bool GraphicsDevice::GetQueryResult(GLuint query, GLuint64 &result)
+{
+    return getQueryResult(query, result);
+}
+
+GLuint64 GraphicsDevice::GetTimestamp()
+{
+    return getTimestamp();
+}
+
+GLsync GraphicsDevice::FenceSync()
+{
+    return fenceSync();
+}
+
+bool GraphicsDevice::ClientWaitSync(GLsync sync, GLuint64 timeout)
+{
+    return sync ? clientWaitSync(sync, timeout) : true;
+}
+
+void GraphicsDevice::DeleteSync(GLsync sync)
+{
+    if (sync)
+        deleteSync(sync);
+}
+
+GLuint GraphicsDevice::boundObject(DeviceObject type, GLenum target) const
+{
+    if (type == DeviceObject::Renderbuffer)
+        return _boundRenderbuffer;
+    const auto &bound = type == DeviceObject::Buffer ? _boundBuffers : _boundTextures;
+    if (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z)
+        target = GL_TEXTURE_CUBE_MAP;
+    auto iter = bound.find(target);
+    return iter == bound.end() ? 0 : iter->second;
+}
+
+void GraphicsDevice::trackMemory(DeviceObject type, GLuint id, size_t layer, size_t bytes, MemoryCategory fallback)
+{
+    if (!id)
+        return;
+    auto &tracked = _memory[memory_key(type, id)];
+    auto category = tracked.allocation.id ? tracked.allocation.category : fallback;
+    tracked.allocation.type = type;
+    tracked.allocation.id = id;
+    // reallocation outside of scopes keeps category
+    if (_memoryScope)
+    {
+        category = _memoryScope->_category;
+        tracked.allocation.owner = _memoryScope->_owner;
+    }
+    tracked.layers[layer] = bytes;
+    updateMemory(tracked, category);
+}
+
+void GraphicsDevice::updateMemory(TrackedMemory &tracked, MemoryCategory category)
+{
+    auto &allocation = tracked.allocation;
+    if (allocation.bytes)
+    {
+        auto &previous = _memoryStats[static_cast<size_t>(allocation.category)];
+        previous.bytes -= allocation.bytes;
+        --previous.allocations;
+    }
+    size_t bytes = 0;
+    for (auto layer : tracked.layers)
+        bytes += layer;
+    // full mip chain adds a third
+    if (tracked.mipmaps)
+        bytes += bytes / 3;
+    allocation.bytes = bytes;
+    allocation.category = category;
+    if (bytes)
+    {
+        auto &stats = _memoryStats[static_cast<size_t>(category)];
+        stats.bytes += bytes;
+        stats.peak = (std::max)(stats.peak, stats.bytes);
+        ++stats.allocations;
+    }
+}
+
+void GraphicsDevice::releaseMemory(DeviceObject type, GLsizei count, const GLuint *ids)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        auto iter = _memory.find(memory_key(type, ids[i]));
+        if (iter != _memory.end())
+        {
+            iter->second.layers.fill(0);
+            updateMemory(iter->second, iter->second.allocation.category);
+            _memory.erase(iter);
+        }
+        // deleted objects are unbound, names may be reused
+        auto unbind = [id = ids[i]](std::unordered_map<GLenum, GLuint> &bound) {
+            for (auto &[target, object] : bound)
+                if (object == id)
+                    object = 0;
+        };
+        if (type == DeviceObject::Buffer)
+            unbind(_boundBuffers);
+        else if (type == DeviceObject::Texture)
+            unbind(_boundTextures);
+        else if (type == DeviceObject::Renderbuffer && _boundRenderbuffer == ids[i])
+            _boundRenderbuffer = 0;
+    }
+}
+
+MemoryScope::MemoryScope(MemoryCategory category, const char *owner)
+    : _category(category), _owner(owner), _parent(GraphicsDevice::Get()._memoryScope)
+{
+    GraphicsDevice::Get()._memoryScope = this;
+}
+
+MemoryScope::~MemoryScope()
+{
+    GraphicsDevice::Get()._memoryScope = _parent;
+}
+
+} // namespace RenderIt
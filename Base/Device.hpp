@@ -0,0 +1,573 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define DEVICE_MEMORY_CATEGORIES 7
+#define DEVICE_CONCAT_IMPL(a, b) a##b
+#define DEVICE_CONCAT(a, b) DEVICE_CONCAT_IMPL(a, b)
+
+/// Account GPU allocations of scope to category, owner must be a string literal
+#define GPU_MEMORY_SCOPE(category, owner)                                                                              \
+    RenderIt::MemoryScope DEVICE_CONCAT(_memoryScope, __LINE__)(RenderIt::MemoryCategory::category, owner)
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Kinds of objects created by a device
+enum class DeviceObject
+{
+    VertexArray,
+    Buffer,
+    Texture,
+    Framebuffer,
+    Renderbuffer,
+    Query,
+};
+
+/// Categories of GPU memory, see GPU_MEMORY_SCOPE
+/// Allocations outside of scopes are Geometry (vertex & index buffers), Storage (other buffers), RenderTargets
+/// (renderbuffers & multisampled textures) or Other
+enum class MemoryCategory
+{
+    Geometry,
+    MaterialTextures,
+    RenderTargets,
+    ShadowMaps,
+    IBL,
+    Storage,
+    Other,
+};
+
+/// GPU memory of one category in bytes, sizes computed from formats & dimensions
+struct MemoryStats
+{
+    size_t bytes = 0;
+    size_t peak = 0;
+    size_t allocations = 0;
+};
+
+/// Live GPU allocation of one object
+struct MemoryAllocation
+{
+    DeviceObject type = DeviceObject::Buffer;
+    GLuint id = 0;
+    MemoryCategory category = MemoryCategory::Other;
+    /// Scope that allocated object, null if outside of scopes
+    const char *owner = nullptr;
+    size_t bytes = 0;
+};
+
+/// Value types of uniforms
+enum class UniformType
+{
+    Int,
+    UInt,
+    Float,
+    Vec2,
+    Vec3,
+    Vec4,
+    IVec2,
+    IVec3,
+    IVec4,
+    UVec2,
+    UVec3,
+    UVec4,
+    Mat2,
+    Mat3,
+    Mat4,
+};
+
+/// Counters of device calls
+struct DeviceStats
+{
+    size_t drawCalls = 0;
+    size_t instances = 0;
+    /// Triangles of direct draws & indirect draws with totals given by caller
+    size_t triangles = 0;
+    /// Instances & triangles of indirect draws with GPU written counts
+    /// Upper bound, as culled commands are not read back
+    size_t instancesUpperBound = 0;
+    size_t trianglesUpperBound = 0;
+    size_t dispatches = 0;
+    size_t vertexArrayBinds = 0;
+    size_t bufferBinds = 0;
+    size_t textureBinds = 0;
+    size_t programBinds = 0;
+    /// Framebuffer switches
+    size_t framebufferBinds = 0;
+    size_t stateChanges = 0;
+    size_t uniforms = 0;
+    size_t uploads = 0;
+    size_t bufferBytes = 0;
+    size_t textureBytes = 0;
+    size_t objectsCreated = 0;
+    size_t objectsDeleted = 0;
+
+    DeviceStats &operator+=(const DeviceStats &other);
+
+    DeviceStats operator-(const DeviceStats &other) const;
+
+    /// Visit counters with their names
+    template <typename Func> void ForEach(Func &&func) const
+    {
+        func("drawCalls", drawCalls);
+        func("instances", instances);
+        func("triangles", triangles);
+        func("instancesUpperBound", instancesUpperBound);
+        func("trianglesUpperBound", trianglesUpperBound);
+        func("dispatches", dispatches);
+        func("vertexArrayBinds", vertexArrayBinds);
+        func("bufferBinds", bufferBinds);
+        func("textureBinds", textureBinds);
+        func("programBinds", programBinds);
+        func("framebufferBinds", framebufferBinds);
+        func("stateChanges", stateChanges);
+        func("uniforms", uniforms);
+        func("uploads", uploads);
+        func("bufferBytes", bufferBytes);
+        func("textureBytes", textureBytes);
+        func("objectsCreated", objectsCreated);
+        func("objectsDeleted", objectsDeleted);
+    }
+};
+
+class MemoryScope;
+
+/// Graphics calls made by GL structures, shaders, meshes & draws
+/// Public calls are counted into stats, then forwarded to the backend
+/// Storage allocations are tracked per object & category until deleted
+/// Only call from GL thread
+class GraphicsDevice
+{
+    friend class MemoryScope;
+
+  public:
+    /// Reports allocations never deleted
+    virtual ~GraphicsDevice();
+
+    /// Get active device, OpenGL unless replaced
+    static GraphicsDevice &Get();
+
+    /// Replace active device, call before any resource is created
+    static void Set(std::shared_ptr<GraphicsDevice> device);
+
+    /// Get backend name
+    virtual std::string GetName() const = 0;
+
+    /// Whether calls reach a GL context
+    virtual bool HasContext() const = 0;
+
+    /// Get vendor, renderer & version of driver, program binaries are only valid for same driver
+    virtual std::string GetDriverInfo() const = 0;
+
+    /// Whether driver compiles & links in background threads (KHR_parallel_shader_compile)
+    virtual bool HasParallelCompile() const = 0;
+
+    /// Whether multi-draw count can be read from parameter buffer (GL 4.6 or ARB_indirect_parameters)
+    virtual bool HasIndirectCount() const = 0;
+
+    /// Whether shaders can read gl_BaseInstanceARB (ARB_shader_draw_parameters)
+    virtual bool HasShaderDrawParameters() const = 0;
+
+    /// Get call counters
+    const DeviceStats &GetStats() const;
+
+    /// Reset call counters
+    void ResetStats();
+
+    /// Get call counters of last finished frame
+    const DeviceStats &GetFrameStats() const;
+
+    /// Keep counters as last frame stats & reset, called by AppContext
+    void EndFrame();
+
+    /// Get live GPU memory of category
+    const MemoryStats &GetMemoryStats(MemoryCategory category) const;
+
+    /// Get live GPU memory of all categories, peak is sum of category peaks
+    MemoryStats GetTotalMemory() const;
+
+    /// Get live allocations, largest first
+    std::vector<MemoryAllocation> GetAllocations() const;
+
+    /// Log live allocations as leaks, returns number of allocations
+    size_t ReportLeaks() const;
+
+    /// UI calls
+    void UI();
+
+#pragma region objects
+
+    void CreateObjects(DeviceObject type, GLsizei count, GLuint *ids);
+
+    void DeleteObjects(DeviceObject type, GLsizei count, const GLuint *ids);
+
+    void BindVertexArray(GLuint vao);
+
+    void BindBuffer(GLenum target, GLuint buffer);
+
+    void BindBufferBase(GLenum target, GLuint binding, GLuint buffer);
+
+    /// Bind range of buffer to indexed target, offset aligned to target offset alignment
+    void BindBufferRange(GLenum target, GLuint binding, GLuint buffer, size_t offset, size_t size);
+
+    void BindTexture(GLenum target, GLuint texture);
+
+    void BindTextureUnit(GLuint unit, GLuint texture);
+
+    void BindFramebuffer(GLenum target, GLuint fbo);
+
+    void BindRenderbuffer(GLuint rbo);
+
+    bool IsFramebufferComplete(GLuint fbo);
+
+#pragma endregion objects
+
+#pragma region resources
+
+    /// Allocate buffer bound to target, data may be null
+    void BufferData(GLenum target, size_t size, const void *data, GLenum usage);
+
+    /// Allocate immutable storage of buffer bound to target, flags are GL_*_BIT storage flags
+    void BufferStorage(GLenum target, size_t size, const void *data, GLbitfield flags);
+
+    /// Upload range of buffer bound to target
+    void BufferSubData(GLenum target, size_t offset, size_t size, const void *data);
+
+    void CopyBufferSubData(GLuint src, GLuint dst, size_t srcOffset, size_t dstOffset, size_t size);
+
+    /// Fill whole buffer with one value of format & type, stored as internal format
+    void ClearBufferData(GLuint buffer, GLenum internalFormat, GLenum format, GLenum type, const void *data);
+
+    void GetBufferSubData(GLuint buffer, size_t offset, size_t size, void *data);
+
+    void *MapBuffer(GLuint buffer, GLenum access);
+
+    /// Map range of buffer, access is a GL_MAP_*_BIT mask
+    void *MapBufferRange(GLuint buffer, size_t offset, size_t size, GLbitfield access);
+
+    void UnmapBuffer(GLuint buffer);
+
+    /// Enable & describe attribute of bound VAO, integer attributes are not normalized to float
+    void VertexAttribute(GLuint index, GLint size, GLenum type, bool integer, GLsizei stride, size_t offset);
+
+    void TexParameter(GLenum target, GLenum name, GLint value);
+
+    void TexImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type,
+                    const void *data);
+
+    /// Copy region of read framebuffer into origin of level 0 of texture bound to target
+    void CopyTexSubImage2D(GLenum target, GLint x, GLint y, GLsizei width, GLsizei height);
+
+    /// Allocate layers of array or 3D texture bound to target
+    void TexImage3D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLenum format,
+                    GLenum type, const void *data);
+
+    /// Allocate immutable storage with mip levels for texture bound to target
+    void TexStorage2D(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height);
+
+    /// Allocate multisampled storage for texture bound to target
+    void TexImage2DMultisample(GLenum target, GLsizei samples, GLenum internalFormat, GLsizei width, GLsizei height);
+
+    /// Allocate storage of bound renderbuffer, multisampled if samples > 0
+    void RenderbufferStorage(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei samples = 0);
+
+    void GenerateMipmap(GLenum target);
+
+    void BindImageTexture(GLuint unit, GLuint texture, GLint level, GLenum access, GLenum format);
+
+#pragma endregion resources
+
+#pragma region programs
+
+    /// Compile shader stage, returns 0 and fills log on failure
+    GLuint CompileShader(GLenum type, const std::string &source, std::string &log);
+
+    /// Link shader stages, returns 0 and fills log on failure
+    /// Binary of retrievable program can be read by GetProgramBinary
+    GLuint LinkProgram(const std::vector<GLuint> &shaders, std::string &log, bool retrievable = false);
+
+    /// Set number of background compiler threads, 0xFFFFFFFF for driver maximum
+    void SetCompilerThreads(unsigned count);
+
+    /// Start compile of shader stage without waiting, status is read by GetShaderStatus
+    GLuint SubmitShader(GLenum type, const std::string &source);
+
+    /// Start link of submitted stages without waiting, status is read by GetProgramStatus
+    GLuint SubmitProgram(const std::vector<GLuint> &shaders, bool retrievable = false);
+
+    /// Whether submitted link completed, so status is read without blocking
+    /// Always true without parallel compile
+    bool IsProgramReady(GLuint program);
+
+    /// Get compile status of submitted stage, waits for compile & fills log on failure
+    bool GetShaderStatus(GLuint shader, std::string &log);
+
+    /// Get link status of submitted program, waits for link & fills log on failure
+    bool GetProgramStatus(GLuint program, std::string &log);
+
+    /// Get binary of linked program, false if not available
+    bool GetProgramBinary(GLuint program, GLenum &format, std::vector<unsigned char> &binary);
+
+    /// Create program from binary, returns 0 if rejected by driver
+    GLuint ProgramBinary(GLenum format, const std::vector<unsigned char> &binary);
+
+    void DeleteShader(GLuint shader);
+
+    void DeleteProgram(GLuint program);
+
+    void UseProgram(GLuint program);
+
+    /// Get locations of active uniforms, array elements included
+    void GetUniformLocations(GLuint program, std::unordered_map<std::string, GLint> &locations);
+
+    /// Get index of named resource in program interface, GL_INVALID_INDEX if not active
+    GLuint GetResourceIndex(GLuint program, GLenum interface, const std::string &name);
+
+    /// Set binding of uniform or shader storage block
+    void BlockBinding(GLuint program, GLenum interface, GLuint index, GLuint binding);
+
+    /// Set uniform of program in use
+    void Uniform(GLint location, UniformType type, const void *data);
+
+#pragma endregion programs
+
+#pragma region states_draws
+
+    void SetEnabled(GLenum cap, bool enabled);
+
+    bool IsEnabled(GLenum cap);
+
+    void CullFace(GLenum face);
+
+    void PolygonOffset(float factor, float units);
+
+    void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    void Clear(GLbitfield mask);
+
+    void ClearColor(float r, float g, float b, float a);
+
+    /// Draw indexed primitives, instanced if instances > 0
+    void DrawElements(GLenum mode, GLsizei count, GLenum type, size_t offset, GLsizei instances = 0);
+
+    /// Draw primitives, instanced if instances > 0
+    void DrawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instances = 0);
+
+    /// Copy rectangle of read framebuffer into draw framebuffer
+    void BlitFramebuffer(GLint srcWidth, GLint srcHeight, GLint dstWidth, GLint dstHeight, GLbitfield mask,
+                         GLenum filter);
+
+    void DispatchCompute(GLuint x, GLuint y, GLuint z);
+
+    /// Order incoherent shader writes before later commands
+    void Barrier(GLbitfield barriers);
+
+    /// Draw commands of bound indirect buffer
+    /// Commands are not read back, indices (index count x instance count) & instances are CPU-side totals for stats
+    void MultiDrawElementsIndirect(GLenum mode, GLenum type, size_t offset, GLsizei drawCount, size_t indices = 0,
+                                   size_t instances = 0);
+
+    /// Draw commands of bound indirect buffer, count read from bound parameter buffer
+    /// Totals of all commands are counted as upper bound, as GPU decides how many are drawn
+    /// Only call if HasIndirectCount
+    void MultiDrawElementsIndirectCount(GLenum mode, GLenum type, size_t offset, size_t countOffset,
+                                        GLsizei maxDrawCount, size_t indices = 0, size_t instances = 0);
+
+#pragma endregion states_draws
+
+#pragma region queries
+
+    /// Write GPU timestamp into query once previous commands complete
+    void QueryTimestamp(GLuint query);
+
+    /// Get query result in nanoseconds without waiting, false if not available yet
+    bool GetQueryResult(GLuint query, GLuint64 &result);
+
+    /// Get current GPU time in nanoseconds
+    GLuint64 GetTimestamp();
+
+#pragma endregion queries
+
+#pragma region sync
+
+    /// Insert fence signaled once previous commands complete
+    GLsync FenceSync();
+
+    /// Wait for fence up to timeout (nanoseconds, 0 to poll), true if signaled
+    bool ClientWaitSync(GLsync sync, GLuint64 timeout);
+
+    void DeleteSync(GLsync sync);
+
+#pragma endregion sync
+
+  public:
+    const std::string LOGNAME = "GraphicsDevice";
+
+  protected:
+    virtual void createObjects(DeviceObject type, GLsizei count, GLuint *ids) = 0;
+    virtual void deleteObjects(DeviceObject type, GLsizei count, const GLuint *ids) = 0;
+    virtual void bindVertexArray(GLuint vao) = 0;
+    virtual void bindBuffer(GLenum target, GLuint buffer) = 0;
+    virtual void bindBufferBase(GLenum target, GLuint binding, GLuint buffer) = 0;
+    virtual void bindBufferRange(GLenum target, GLuint binding, GLuint buffer, size_t offset, size_t size) = 0;
+    virtual void bindTexture(GLenum target, GLuint texture) = 0;
+    virtual void bindTextureUnit(GLuint unit, GLuint texture) = 0;
+    virtual void bindFramebuffer(GLenum target, GLuint fbo) = 0;
+    virtual void bindRenderbuffer(GLuint rbo) = 0;
+    virtual bool isFramebufferComplete(GLuint fbo) = 0;
+
+    virtual void bufferData(GLenum target, size_t size, const void *data, GLenum usage) = 0;
+    virtual void bufferStorage(GLenum target, size_t size, const void *data, GLbitfield flags) = 0;
+    virtual void bufferSubData(GLenum target, size_t offset, size_t size, const void *data) = 0;
+    virtual void copyBufferSubData(GLuint src, GLuint dst, size_t srcOffset, size_t dstOffset, size_t size) = 0;
+    virtual void clearBufferData(GLuint buffer, GLenum internalFormat, GLenum format, GLenum type,
+                                 const void *data) = 0;
+    virtual void getBufferSubData(GLuint buffer, size_t offset, size_t size, void *data) = 0;
+    virtual void *mapBuffer(GLuint buffer, GLenum access) = 0;
+    virtual void *mapBufferRange(GLuint buffer, size_t offset, size_t size, GLbitfield access) = 0;
+    virtual void unmapBuffer(GLuint buffer) = 0;
+    virtual void vertexAttribute(GLuint index, GLint size, GLenum type, bool integer, GLsizei stride,
+                                 size_t offset) = 0;
+    virtual void texParameter(GLenum target, GLenum name, GLint value) = 0;
+    virtual void texImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format,
+                            GLenum type, const void *data) = 0;
+    virtual void copyTexSubImage2D(GLenum target, GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+    virtual void texImage3D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth,
+                            GLenum format, GLenum type, const void *data) = 0;
+    virtual void texStorage2D(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width,
+                              GLsizei height) = 0;
+    virtual void texImage2DMultisample(GLenum target, GLsizei samples, GLenum internalFormat, GLsizei width,
+                                       GLsizei height) = 0;
+    virtual void renderbufferStorage(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei samples) = 0;
+    virtual void generateMipmap(GLenum target) = 0;
+    virtual void bindImageTexture(GLuint unit, GLuint texture, GLint level, GLenum access, GLenum format) = 0;
+
+    virtual void setCompilerThreads(unsigned count) = 0;
+    virtual GLuint submitShader(GLenum type, const std::string &source) = 0;
+    virtual GLuint submitProgram(const std::vector<GLuint> &shaders, bool retrievable) = 0;
+    virtual bool isProgramReady(GLuint program) = 0;
+    virtual bool getShaderStatus(GLuint shader, std::string &log) = 0;
+    virtual bool getProgramStatus(GLuint program, std::string &log) = 0;
+    virtual bool getProgramBinary(GLuint program, GLenum &format, std::vector<unsigned char> &binary) = 0;
+    virtual GLuint programBinary(GLenum format, const std::vector<unsigned char> &binary) = 0;
+    virtual void deleteShader(GLuint shader) = 0;
+    virtual void deleteProgram(GLuint program) = 0;
+    virtual void useProgram(GLuint program) = 0;
+    virtual void getUniformLocations(GLuint program, std::unordered_map<std::string, GLint> &locations) = 0;
+    virtual GLuint getResourceIndex(GLuint program, GLenum interface, const std::string &name) = 0;
+    virtual void blockBinding(GLuint program, GLenum interface, GLuint index, GLuint binding) = 0;
+    virtual void uniform(GLint location, UniformType type, const void *data) = 0;
+
+    virtual void setEnabled(GLenum cap, bool enabled) = 0;
+    virtual bool isEnabled(GLenum cap) = 0;
+    virtual void cullFace(GLenum face) = 0;
+    virtual void polygonOffset(float factor, float units) = 0;
+    virtual void viewport(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+    virtual void clear(GLbitfield mask) = 0;
+    virtual void clearColor(float r, float g, float b, float a) = 0;
+    virtual void drawElements(GLenum mode, GLsizei count, GLenum type, size_t offset, GLsizei instances) = 0;
+    virtual void drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instances) = 0;
+    virtual void blitFramebuffer(GLint srcWidth, GLint srcHeight, GLint dstWidth, GLint dstHeight, GLbitfield mask,
+                                 GLenum filter) = 0;
+    virtual void dispatchCompute(GLuint x, GLuint y, GLuint z) = 0;
+    virtual void barrier(GLbitfield barriers) = 0;
+    virtual void multiDrawElementsIndirect(GLenum mode, GLenum type, size_t offset, GLsizei drawCount) = 0;
+    virtual void multiDrawElementsIndirectCount(GLenum mode, GLenum type, size_t offset, size_t countOffset,
+                                                GLsizei maxDrawCount) = 0;
+    virtual void queryTimestamp(GLuint query) = 0;
+    virtual bool getQueryResult(GLuint query, GLuint64 &result) = 0;
+    virtual GLuint64 getTimestamp() = 0;
+    virtual GLsync fenceSync() = 0;
+    virtual bool clientWaitSync(GLsync sync, GLuint64 timeout) = 0;
+    virtual void deleteSync(GLsync sync) = 0;
+
+  private:
+    /// Allocation of object, layers are cubemap faces
+    struct TrackedMemory
+    {
+        MemoryAllocation allocation;
+        std::array<size_t, 6> layers{};
+        bool mipmaps = false;
+    };
+
+    /// Get object bound to target, 0 if none
+    GLuint boundObject(DeviceObject type, GLenum target) const;
+
+    /// Set bytes of object layer, category of scope or fallback
+    void trackMemory(DeviceObject type, GLuint id, size_t layer, size_t bytes, MemoryCategory fallback);
+
+    /// Recompute bytes of object & update category stats
+    void updateMemory(TrackedMemory &tracked, MemoryCategory category);
+
+    /// Remove allocations of deleted objects
+    void releaseMemory(DeviceObject type, GLsizei count, const GLuint *ids);
+
+  protected:
+    DeviceStats _stats;
+    DeviceStats _frameStats;
+
+  private:
+    std::unordered_map<GLenum, GLuint> _boundBuffers, _boundTextures;
+    GLuint _boundRenderbuffer = 0;
+    std::unordered_map<uint64_t, TrackedMemory> _memory;
+    std::array<MemoryStats, DEVICE_MEMORY_CATEGORIES> _memoryStats;
+    // innermost GPU_MEMORY_SCOPE
+    const MemoryScope *_memoryScope = nullptr;
+};
+
+/// Scope accounting allocations of active device to category, see GPU_MEMORY_SCOPE
+class MemoryScope
+{
+    friend class GraphicsDevice;
+
+  public:
+    MemoryScope(MemoryCategory category, const char *owner);
+
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope &) = delete;
+
+    MemoryScope &operator=(const MemoryScope &) = delete;
+
+  private:
+    MemoryCategory _category;
+    const char *_owner;
+    const MemoryScope *_parent;
+};
+
+} // namespace RenderIt
+
+namespace std
+{
+inline string to_string(const RenderIt::MemoryCategory &category)
+{
+    switch (category)
+    {
+    case RenderIt::MemoryCategory::Geometry:
+        return "Geometry";
+    case RenderIt::MemoryCategory::MaterialTextures:
+        return "MaterialTextures";
+    case RenderIt::MemoryCategory::RenderTargets:
+        return "RenderTargets";
+    case RenderIt::MemoryCategory::ShadowMaps:
+        return "ShadowMaps";
+    case RenderIt::MemoryCategory::IBL:
+        return "IBL";
+    case RenderIt::MemoryCategory::Storage:
+        return "Storage";
+    case RenderIt::MemoryCategory::Other:
+    default:
+        return "Other";
+    }
+}
+} // namespace std
@@ -0,0 +1,520 @@
+#include "Devices/NullDevice.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// binary format of programs, binary is stripped source text
+#define NULL_PROGRAM_BINARY_FORMAT 0x4E554C4C
+
+namespace RenderIt
+{
+
+/// Remove comments & preprocessor lines from GLSL source
+static std::string strip_source(const std::string &source)
+{
+    std::string code;
+    code.reserve(source.size());
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        if (source.compare(i, 2, "//") == 0)
+            i = std::min(source.find('\n', i), source.size()) - 1;
+        else if (source.compare(i, 2, "/*") == 0)
+            i = std::min(source.find("*/", i), source.size() - 2) + 1;
+        else
+            code.push_back(source[i]);
+    }
+    std::string result;
+    std::stringstream lines(code);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        auto first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] != '#')
+            result += line + "\n";
+    }
+    return result;
+}
+
+/// Trim whitespaces of both ends
+static std::string trim(const std::string &str)
+{
+    auto begin = str.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+        return "";
+    auto end = str.find_last_not_of(" \t\r\n");
+    return str.substr(begin, end - begin + 1);
+}
+
+std::string NullDevice::GetName() const
+{
+    return "Null";
+}
+
+bool NullDevice::HasContext() const
+{
+    return false;
+}
+
+std::string NullDevice::GetDriverInfo() const
+{
+    return "Null\n";
+}
+
+bool NullDevice::HasParallelCompile() const
+{
+    return false;
+}
+
+bool NullDevice::HasIndirectCount() const
+{
+    return true;
+}
+
+bool NullDevice::HasShaderDrawParameters() const
+{
+    return true;
+}
+
+size_t NullDevice::GetBufferMemory() const
+{
+    size_t bytes = 0;
+    for (const auto &[id, data] : _buffers)
+        bytes += data.size();
+    return bytes;
+}
+
+void NullDevice::createObjects(DeviceObject type, GLsizei count, GLuint *ids)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        ids[i] = _nextID++;
+        if (type == DeviceObject::Buffer)
+            _buffers[ids[i]];
+    }
+}
+
+void NullDevice::deleteObjects(DeviceObject type, GLsizei count, const GLuint *ids)
+{
+    if (type != DeviceObject::Buffer)
+        return;
+    for (GLsizei i = 0; i < count; ++i)
+        _buffers.erase(ids[i]);
+}
+
+void NullDevice::bindVertexArray(GLuint)
+{
+}
+
+void NullDevice::bindBuffer(GLenum target, GLuint buffer)
+{
+    _boundBuffers[target] = buffer;
+}
+
+void NullDevice::bindBufferBase(GLenum target, GLuint, GLuint buffer)
+{
+    // also binds generic target, as in GL
+    _boundBuffers[target] = buffer;
+}
+
+void NullDevice::bindBufferRange(GLenum target, GLuint, GLuint buffer, size_t, size_t)
+{
+    _boundBuffers[target] = buffer;
+}
+
+void NullDevice::bindTexture(GLenum, GLuint)
+{
+}
+
+void NullDevice::bindTextureUnit(GLuint, GLuint)
+{
+}
+
+void NullDevice::bindFramebuffer(GLenum, GLuint)
+{
+}
+
+void NullDevice::bindRenderbuffer(GLuint)
+{
+}
+
+bool NullDevice::isFramebufferComplete(GLuint)
+{
+    return true;
+}
+
+void NullDevice::bufferData(GLenum target, size_t size, const void *data, GLenum)
+{
+    auto buffer = boundBuffer(target);
+    if (!buffer)
+        return;
+    buffer->assign(size, 0);
+    if (data)
+        std::memcpy(buffer->data(), data, size);
+}
+
+void NullDevice::bufferStorage(GLenum target, size_t size, const void *data, GLbitfield)
+{
+    // storage stays in place, so persistent maps remain valid
+    bufferData(target, size, data, GL_DYNAMIC_DRAW);
+}
+
+void NullDevice::bufferSubData(GLenum target, size_t offset, size_t size, const void *data)
+{
+    auto buffer = boundBuffer(target);
+    if (!buffer || !data || offset + size > buffer->size())
+        return;
+    std::memcpy(buffer->data() + offset, data, size);
+}
+
+void NullDevice::copyBufferSubData(GLuint src, GLuint dst, size_t srcOffset, size_t dstOffset, size_t size)
+{
+    auto srcIter = _buffers.find(src);
+    auto dstIter = _buffers.find(dst);
+    if (srcIter == _buffers.end() || dstIter == _buffers.end())
+        return;
+    if (srcOffset + size > srcIter->second.size() || dstOffset + size > dstIter->second.size())
+        return;
+    std::memmove(dstIter->second.data() + dstOffset, srcIter->second.data() + srcOffset, size);
+}
+
+void NullDevice::clearBufferData(GLuint buffer, GLenum, GLenum format, GLenum type, const void *data)
+{
+    auto iter = _buffers.find(buffer);
+    if (iter == _buffers.end())
+        return;
+    auto &bytes = iter->second;
+    // single 4 byte values (counters) are repeated, other formats are cleared to zero
+    bool word = (format == GL_RED || format == GL_RED_INTEGER) &&
+                (type == GL_UNSIGNED_INT || type == GL_INT || type == GL_FLOAT);
+    if (!data || !word)
+    {
+        std::fill(bytes.begin(), bytes.end(), static_cast<unsigned char>(0));
+        return;
+    }
+    for (size_t i = 0; i + 4 <= bytes.size(); i += 4)
+        std::memcpy(bytes.data() + i, data, 4);
+}
+
+void NullDevice::getBufferSubData(GLuint buffer, size_t offset, size_t size, void *data)
+{
+    auto iter = _buffers.find(buffer);
+    if (iter == _buffers.end() || offset + size > iter->second.size())
+        return;
+    std::memcpy(data, iter->second.data() + offset, size);
+}
+
+void *NullDevice::mapBuffer(GLuint buffer, GLenum)
+{
+    auto iter = _buffers.find(buffer);
+    if (iter == _buffers.end() || iter->second.empty())
+        return nullptr;
+    return iter->second.data();
+}
+
+void *NullDevice::mapBufferRange(GLuint buffer, size_t offset, size_t size, GLbitfield)
+{
+    auto iter = _buffers.find(buffer);
+    if (iter == _buffers.end() || offset + size > iter->second.size())
+        return nullptr;
+    return iter->second.data() + offset;
+}
+
+void NullDevice::unmapBuffer(GLuint)
+{
+}
+
+void NullDevice::vertexAttribute(GLuint, GLint, GLenum, bool, GLsizei, size_t)
+{
+}
+
+void NullDevice::texParameter(GLenum, GLenum, GLint)
+{
+}
+
+void NullDevice::texImage2D(GLenum, GLint, GLsizei, GLsizei, GLenum, GLenum, const void *)
+{
+}
+
+void NullDevice::copyTexSubImage2D(GLenum, GLint, GLint, GLsizei, GLsizei)
+{
+}
+
+void NullDevice::texImage3D(GLenum, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, const void *)
+{
+}
+
+void NullDevice::texStorage2D(GLenum, GLsizei, GLenum, GLsizei, GLsizei)
+{
+}
+
+void NullDevice::texImage2DMultisample(GLenum, GLsizei, GLenum, GLsizei, GLsizei)
+{
+}
+
+void NullDevice::renderbufferStorage(GLenum, GLsizei, GLsizei, GLsizei)
+{
+}
+
+void NullDevice::generateMipmap(GLenum)
+{
+}
+
+void NullDevice::bindImageTexture(GLuint, GLuint, GLint, GLenum, GLenum)
+{
+}
+
+void NullDevice::setCompilerThreads(unsigned)
+{
+}
+
+GLuint NullDevice::submitShader(GLenum, const std::string &source)
+{
+    auto shader = _nextID++;
+    _sources[shader] = strip_source(source);
+    return shader;
+}
+
+GLuint NullDevice::submitProgram(const std::vector<GLuint> &shaders, bool)
+{
+    auto program = _nextID++;
+    auto &source = _sources[program];
+    for (auto shader : shaders)
+    {
+        auto iter = _sources.find(shader);
+        if (iter != _sources.end())
+            source += iter->second + "\n";
+    }
+    return program;
+}
+
+bool NullDevice::isProgramReady(GLuint)
+{
+    return true;
+}
+
+bool NullDevice::getShaderStatus(GLuint, std::string &)
+{
+    return true;
+}
+
+bool NullDevice::getProgramStatus(GLuint, std::string &)
+{
+    return true;
+}
+
+bool NullDevice::getProgramBinary(GLuint program, GLenum &format, std::vector<unsigned char> &binary)
+{
+    auto iter = _sources.find(program);
+    if (iter == _sources.end())
+        return false;
+    format = NULL_PROGRAM_BINARY_FORMAT;
+    binary.assign(iter->second.begin(), iter->second.end());
+    return true;
+}
+
+GLuint NullDevice::programBinary(GLenum format, const std::vector<unsigned char> &binary)
+{
+    if (format != NULL_PROGRAM_BINARY_FORMAT)
+        return 0;
+    auto program = _nextID++;
+    _sources[program].assign(binary.begin(), binary.end());
+    return program;
+}
+
+void NullDevice::deleteShader(GLuint shader)
+{
+    _sources.erase(shader);
+}
+
+void NullDevice::deleteProgram(GLuint program)
+{
+    _sources.erase(program);
+}
+
+void NullDevice::useProgram(GLuint)
+{
+}
+
+void NullDevice::getUniformLocations(GLuint program, std::unordered_map<std::string, GLint> &locations)
+{
+    locations.clear();
+    auto iter = _sources.find(program);
+    if (iter == _sources.end())
+        return;
+    // declarations outside of blocks, "layout(...) uniform type name[N] = value, ..."
+    GLint nextLocation = 0;
+    std::stringstream statements(iter->second);
+    std::string statement;
+    while (std::getline(statements, statement, ';'))
+    {
+        // drop function bodies & block openings before declaration
+        auto brace = statement.find_last_of("{}");
+        if (brace != std::string::npos)
+            statement = statement.substr(brace + 1);
+        statement = trim(statement);
+        if (statement.rfind("layout", 0) == 0)
+        {
+            auto close = statement.find(')');
+            statement = close == std::string::npos ? "" : trim(statement.substr(close + 1));
+        }
+        if (statement.size() < 8 || statement.rfind("uniform", 0) != 0 ||
+            !std::isspace(static_cast<unsigned char>(statement[7])))
+            continue;
+        std::stringstream tokens(statement.substr(8));
+        std::string type, declarator;
+        tokens >> type;
+        // skip precision qualifiers
+        while (type == "highp" || type == "mediump" || type == "lowp")
+            tokens >> type;
+        while (std::getline(tokens, declarator, ','))
+        {
+            declarator = trim(declarator.substr(0, declarator.find('=')));
+            if (declarator.empty())
+                continue;
+            auto bracket = declarator.find('[');
+            auto name = trim(declarator.substr(0, bracket));
+            if (name.empty() || locations.count(name))
+                continue;
+            GLint arraySize = 1;
+            if (bracket != std::string::npos)
+                arraySize = std::max(1, std::atoi(declarator.c_str() + bracket + 1));
+            locations[name] = nextLocation;
+            if (bracket != std::string::npos)
+                for (GLint i = 0; i < arraySize; ++i)
+                    locations[name + "[" + std::to_string(i) + "]"] = nextLocation + i;
+            nextLocation += arraySize;
+        }
+    }
+}
+
+GLuint NullDevice::getResourceIndex(GLuint program, GLenum, const std::string &name)
+{
+    auto iter = _sources.find(program);
+    if (iter == _sources.end())
+        return GL_INVALID_INDEX;
+    // treat block as active if its name appears as whole word
+    const auto &source = iter->second;
+    for (auto pos = source.find(name); pos != std::string::npos; pos = source.find(name, pos + 1))
+    {
+        auto before = pos ? source[pos - 1] : ' ';
+        auto after = pos + name.size() < source.size() ? source[pos + name.size()] : ' ';
+        auto isWord = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+        if (!isWord(before) && !isWord(after))
+            return 0;
+    }
+    return GL_INVALID_INDEX;
+}
+
+void NullDevice::blockBinding(GLuint, GLenum, GLuint, GLuint)
+{
+}
+
+void NullDevice::uniform(GLint, UniformType, const void *)
+{
+}
+
+void NullDevice::setEnabled(GLenum cap, bool enabled)
+{
+    if (enabled)
+        _enabled.insert(cap);
+    else
+        _enabled.erase(cap);
+}
+
+bool NullDevice::isEnabled(GLenum cap)
+{
+    return _enabled.count(cap) > 0;
+}
+
+void NullDevice::cullFace(GLenum)
+{
+}
+
+void NullDevice::polygonOffset(float, float)
+{
+}
+
+void NullDevice::viewport(GLint, GLint, GLsizei, GLsizei)
+{
+}
+
+void NullDevice::clear(GLbitfield)
+{
+}
+
+void NullDevice::clearColor(float, float, float, float)
+{
+}
+
+void NullDevice::drawElements(GLenum, GLsizei, GLenum, size_t, GLsizei)
+{
+}
+
+void NullDevice::drawArrays(GLenum, GLint, GLsizei, GLsizei)
+{
+}
+
+void NullDevice::blitFramebuffer(GLint, GLint, GLint, GLint, GLbitfield, GLenum)
+{
+}
+
+void NullDevice::dispatchCompute(GLuint, GLuint, GLuint)
+{
+}
+
+void NullDevice::barrier(GLbitfield)
+{
+}
+
+void NullDevice::multiDrawElementsIndirect(GLenum, GLenum, size_t, GLsizei)
+{
+}
+
+void NullDevice::multiDrawElementsIndirectCount(GLenum, GLenum, size_t, size_t, GLsizei)
+{
+}
+
+void NullDevice::queryTimestamp(GLuint)
+{
+}
+
+bool NullDevice::getQueryResult(GLuint, GLuint64 &result)
+{
+    result = 0;
+    return true;
+}
+
+GLuint64 NullDevice::getTimestamp()
+{
+    return 0;
+}
+
+GLsync NullDevice::fenceSync()
+{
+    // commands complete immediately, handle only has to be non-null
+    return reinterpret_cast<GLsync>(static_cast<uintptr_t>(_nextID++));
+}
+
+bool NullDevice::clientWaitSync(GLsync, GLuint64)
+{
+    return true;
+}
+
+void NullDevice::deleteSync(GLsync)
+{
+}
+
+std::vector<unsigned char> *NullDevice::boundBuffer(GLenum target)
+{
+    auto bound = _boundBuffers.find(target);
+    if (bound == _boundBuffers.end())
+        return nullptr;
+    auto iter = _buffers.find(bound->second);
+    return iter == _buffers.end() ? nullptr : &iter->second;
+}
+
+} // namespace RenderIt
@@ -0,0 +1,580 @@
+#include "Devices/OpenGLDevice.hpp"
+
+namespace RenderIt
+{
+
+std::string OpenGLDevice::GetName() const
+{
+    return "OpenGL";
+}
+
+bool OpenGLDevice::HasContext() const
+{
+    return true;
+}
+
+std::string OpenGLDevice::GetDriverInfo() const
+{
+    std::string info;
+    for (auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+    {
+        auto str = glGetString(name);
+        info += (str ? reinterpret_cast<const char *>(str) : "") + std::string("\n");
+    }
+    return info;
+}
+
+bool OpenGLDevice::HasParallelCompile() const
+{
+    return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
+
+bool OpenGLDevice::HasIndirectCount() const
+{
+    return GLEW_VERSION_4_6 || GLEW_ARB_indirect_parameters;
+}
+
+bool OpenGLDevice::HasShaderDrawParameters() const
+{
+    return GLEW_ARB_shader_draw_parameters;
+}
+
+void OpenGLDevice::createObjects(DeviceObject type, GLsizei count, GLuint *ids)
+{
+    switch (type)
+    {
+    case DeviceObject::VertexArray:
+        glGenVertexArrays(count, ids);
+        break;
+    case DeviceObject::Buffer:
+        glGenBuffers(count, ids);
+        break;
+    case DeviceObject::Texture:
+        glGenTextures(count, ids);
+        break;
+    case DeviceObject::Framebuffer:
+        glGenFramebuffers(count, ids);
+        break;
+    case DeviceObject::Renderbuffer:
+        glGenRenderbuffers(count, ids);
+        break;
+    case DeviceObject::Query:
+        glGenQueries(count, ids);
+        break;
+    }
+}
+
+void OpenGLDevice::deleteObjects(DeviceObject type, GLsizei count, const GLuint *ids)
+{
+    switch (type)
+    {
+    case DeviceObject::VertexArray:
+        glDeleteVertexArrays(count, ids);
+        break;
+    case DeviceObject::Buffer:
+        glDeleteBuffers(count, ids);
+        break;
+    case DeviceObject::Texture:
+        glDeleteTextures(count, ids);
+        break;
+    case DeviceObject::Framebuffer:
+        glDeleteFramebuffers(count, ids);
+        break;
+    case DeviceObject::Renderbuffer:
+        glDeleteRenderbuffers(count, ids);
+        break;
+    case DeviceObject::Query:
+        glDeleteQueries(count, ids);
+        break;
+    }
+}
+
+void OpenGLDevice::bindVertexArray(GLuint vao)
+{
+    glBindVertexArray(vao);
+}
+
+void OpenGLDevice::bindBuffer(GLenum target, GLuint buffer)
+{
+    glBindBuffer(target, buffer);
+}
+
+void OpenGLDevice::bindBufferBase(GLenum target, GLuint binding, GLuint buffer)
+{
+    glBindBufferBase(target, binding, buffer);
+}
+
+void OpenGLDevice::bindBufferRange(GLenum target, GLuint binding, GLuint buffer, size_t offset, size_t size)
+{
+    glBindBufferRange(target, binding, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+}
+
+void OpenGLDevice::bindTexture(GLenum target, GLuint texture)
+{
+    glBindTexture(target, texture);
+}
+
+void OpenGLDevice::bindTextureUnit(GLuint unit, GLuint texture)
+{
+    glBindTextureUnit(unit, texture);
+}
+
+void OpenGLDevice::bindFramebuffer(GLenum target, GLuint fbo)
+{
+    glBindFramebuffer(target, fbo);
+}
+
+void OpenGLDevice::bindRenderbuffer(GLuint rbo)
+{
+    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+}
+
+bool OpenGLDevice::isFramebufferComplete(GLuint fbo)
+{
+    return glCheckNamedFramebufferStatus(fbo, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void OpenGLDevice::bufferData(GLenum target, size_t size, const void *data, GLenum usage)
+{
+    glBufferData(target, static_cast<GLsizeiptr>(size), data, usage);
+}
+
+void OpenGLDevice::bufferStorage(GLenum target, size_t size, const void *data, GLbitfield flags)
+{
+    glBufferStorage(target, static_cast<GLsizeiptr>(size), data, flags);
+}
+
+void OpenGLDevice::bufferSubData(GLenum target, size_t offset, size_t size, const void *data)
+{
+    glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+}
+
+void OpenGLDevice::copyBufferSubData(GLuint src, GLuint dst, size_t srcOffset, size_t dstOffset, size_t size)
+{
+    glCopyNamedBufferSubData(src, dst, static_cast<GLintptr>(srcOffset), static_cast<GLintptr>(dstOffset),
+                             static_cast<GLsizeiptr>(size));
+}
+
+void OpenGLDevice::clearBufferData(GLuint buffer, GLenum internalFormat, GLenum format, GLenum type,
+                                   const void *data)
+{
+    glClearNamedBufferData(buffer, internalFormat, format, type, data);
+}
+
+void OpenGLDevice::getBufferSubData(GLuint buffer, size_t offset, size_t size, void *data)
+{
+    glGetNamedBufferSubData(buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+}
+
+void *OpenGLDevice::mapBuffer(GLuint buffer, GLenum access)
+{
+    return glMapNamedBuffer(buffer, access);
+}
+
+void *OpenGLDevice::mapBufferRange(GLuint buffer, size_t offset, size_t size, GLbitfield access)
+{
+    return glMapNamedBufferRange(buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), access);
+}
+
+void OpenGLDevice::unmapBuffer(GLuint buffer)
+{
+    glUnmapNamedBuffer(buffer);
+}
+
+void OpenGLDevice::vertexAttribute(GLuint index, GLint size, GLenum type, bool integer, GLsizei stride,
+                                   size_t offset)
+{
+    glEnableVertexAttribArray(index);
+    if (integer)
+        glVertexAttribIPointer(index, size, type, stride, reinterpret_cast<void *>(offset));
+    else
+        glVertexAttribPointer(index, size, type, GL_FALSE, stride, reinterpret_cast<void *>(offset));
+}
+
+void OpenGLDevice::texParameter(GLenum target, GLenum name, GLint value)
+{
+    glTexParameteri(target, name, value);
+}
+
+void OpenGLDevice::texImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format,
+                              GLenum type, const void *data)
+{
+    glTexImage2D(target, 0, internalFormat, width, height, 0, format, type, data);
+}
+
+void OpenGLDevice::copyTexSubImage2D(GLenum target, GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    glCopyTexSubImage2D(target, 0, 0, 0, x, y, width, height);
+}
+
+void OpenGLDevice::texImage3D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth,
+                              GLenum format, GLenum type, const void *data)
+{
+    glTexImage3D(target, 0, internalFormat, width, height, depth, 0, format, type, data);
+}
+
+void OpenGLDevice::texStorage2D(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height)
+{
+    glTexStorage2D(target, levels, internalFormat, width, height);
+}
+
+void OpenGLDevice::texImage2DMultisample(GLenum target, GLsizei samples, GLenum internalFormat, GLsizei width,
+                                         GLsizei height)
+{
+    glTexImage2DMultisample(target, samples, internalFormat, width, height, GL_TRUE);
+}
+
+void OpenGLDevice::renderbufferStorage(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei samples)
+{
+    if (samples > 0)
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, internalFormat, width, height);
+    else
+        glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, width, height);
+}
+
+void OpenGLDevice::generateMipmap(GLenum target)
+{
+    glGenerateMipmap(target);
+}
+
+void OpenGLDevice::bindImageTexture(GLuint unit, GLuint texture, GLint level, GLenum access, GLenum format)
+{
+    glBindImageTexture(unit, texture, level, GL_FALSE, 0, access, format);
+}
+
+void OpenGLDevice::setCompilerThreads(unsigned count)
+{
+    if (GLEW_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(count);
+    else
+        glMaxShaderCompilerThreadsARB(count);
+}
+
+GLuint OpenGLDevice::submitShader(GLenum type, const std::string &source)
+{
+    GLuint shader = glCreateShader(type);
+    const char *content = source.c_str();
+    glShaderSource(shader, 1, &content, nullptr);
+    glCompileShader(shader);
+    return shader;
+}
+
+GLuint OpenGLDevice::submitProgram(const std::vector<GLuint> &shaders, bool retrievable)
+{
+    GLuint program = glCreateProgram();
+    for (auto &shader : shaders)
+        glAttachShader(program, shader);
+    if (retrievable)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+    return program;
+}
+
+bool OpenGLDevice::isProgramReady(GLuint program)
+{
+    // same enum for ARB & KHR extensions
+    GLint completed{GL_FALSE};
+    glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
+
+bool OpenGLDevice::getShaderStatus(GLuint shader, std::string &log)
+{
+    GLint success{0};
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success)
+    {
+        GLint infoLen{0};
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
+        std::vector<GLchar> infoLog(infoLen + 1);
+        glGetShaderInfoLog(shader, infoLen, nullptr, infoLog.data());
+        log = infoLog.data();
+    }
+    return success == GL_TRUE;
+}
+
+bool OpenGLDevice::getProgramStatus(GLuint program, std::string &log)
+{
+    GLint success{0};
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        GLint infoLen{0};
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLen);
+        std::vector<GLchar> infoLog(infoLen + 1);
+        glGetProgramInfoLog(program, infoLen, nullptr, infoLog.data());
+        log = infoLog.data();
+    }
+    return success == GL_TRUE;
+}
+
+bool OpenGLDevice::getProgramBinary(GLuint program, GLenum &format, std::vector<unsigned char> &binary)
+{
+    GLint length{0};
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+    binary.resize(static_cast<size_t>(length));
+    GLsizei written{0};
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    binary.resize(written > 0 ? static_cast<size_t>(written) : 0);
+    return !binary.empty();
+}
+
+GLuint OpenGLDevice::programBinary(GLenum format, const std::vector<unsigned char> &binary)
+{
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+    // fails if driver changed or binary is corrupted
+    GLint success{0};
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void OpenGLDevice::deleteShader(GLuint shader)
+{
+    glDeleteShader(shader);
+}
+
+void OpenGLDevice::deleteProgram(GLuint program)
+{
+    glDeleteProgram(program);
+}
+
+void OpenGLDevice::useProgram(GLuint program)
+{
+    glUseProgram(program);
+}
+
+void OpenGLDevice::getUniformLocations(GLuint program, std::unordered_map<std::string, GLint> &locations)
+{
+    locations.clear();
+    GLint numUniforms{0}, maxNameLen{0};
+    glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &numUniforms);
+    glGetProgramInterfaceiv(program, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLen);
+    std::vector<GLchar> nameData(static_cast<size_t>(maxNameLen) + 1);
+    const GLenum props[] = {GL_LOCATION, GL_ARRAY_SIZE};
+    for (GLint i = 0; i < numUniforms; ++i)
+    {
+        GLint values[2]{-1, 0};
+        glGetProgramResourceiv(program, GL_UNIFORM, static_cast<GLuint>(i), 2, props, 2, nullptr, values);
+        // members of uniform blocks have no location
+        if (values[0] < 0)
+            continue;
+        glGetProgramResourceName(program, GL_UNIFORM, static_cast<GLuint>(i), maxNameLen, nullptr, nameData.data());
+        std::string name(nameData.data());
+        locations[name] = values[0];
+        // arrays are reported as "name[0]", also accept plain name & other elements
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+        {
+            auto base = name.substr(0, name.size() - 3);
+            locations[base] = values[0];
+            for (GLint j = 1; j < values[1]; ++j)
+            {
+                auto element = base + "[" + std::to_string(j) + "]";
+                locations[element] = glGetUniformLocation(program, element.c_str());
+            }
+        }
+    }
+}
+
+GLuint OpenGLDevice::getResourceIndex(GLuint program, GLenum interface, const std::string &name)
+{
+    return glGetProgramResourceIndex(program, interface, name.c_str());
+}
+
+void OpenGLDevice::blockBinding(GLuint program, GLenum interface, GLuint index, GLuint binding)
+{
+    if (interface == GL_UNIFORM_BLOCK)
+        glUniformBlockBinding(program, index, binding);
+    else
+        glShaderStorageBlockBinding(program, index, binding);
+}
+
+void OpenGLDevice::uniform(GLint location, UniformType type, const void *data)
+{
+    auto i = static_cast<const GLint *>(data);
+    auto u = static_cast<const GLuint *>(data);
+    auto f = static_cast<const GLfloat *>(data);
+    switch (type)
+    {
+    case UniformType::Int:
+        glUniform1iv(location, 1, i);
+        break;
+    case UniformType::UInt:
+        glUniform1uiv(location, 1, u);
+        break;
+    case UniformType::Float:
+        glUniform1fv(location, 1, f);
+        break;
+    case UniformType::Vec2:
+        glUniform2fv(location, 1, f);
+        break;
+    case UniformType::Vec3:
+        glUniform3fv(location, 1, f);
+        break;
+    case UniformType::Vec4:
+        glUniform4fv(location, 1, f);
+        break;
+    case UniformType::IVec2:
+        glUniform2iv(location, 1, i);
+        break;
+    case UniformType::IVec3:
+        glUniform3iv(location, 1, i);
+        break;
+    case UniformType::IVec4:
+        glUniform4iv(location, 1, i);
+        break;
+    case UniformType::UVec2:
+        glUniform2uiv(location, 1, u);
+        break;
+    case UniformType::UVec3:
+        glUniform3uiv(location, 1, u);
+        break;
+    case UniformType::UVec4:
+        glUniform4uiv(location, 1, u);
+        break;
+    case UniformType::Mat2:
+        glUniformMatrix2fv(location, 1, GL_FALSE, f);
+        break;
+    case UniformType::Mat3:
+        glUniformMatrix3fv(location, 1, GL_FALSE, f);
+        break;
+    case UniformType::Mat4:
+        glUniformMatrix4fv(location, 1, GL_FALSE, f);
+        break;
+    }
+}
+
+void OpenGLDevice::setEnabled(GLenum cap, bool enabled)
+{
+    if (enabled)
+        glEnable(cap);
+    else
+        glDisable(cap);
+}
+
+bool OpenGLDevice::isEnabled(GLenum cap)
+{
+    return glIsEnabled(cap);
+}
+
+void OpenGLDevice::cullFace(GLenum face)
+{
+    glCullFace(face);
+}
+
+void OpenGLDevice::polygonOffset(float factor, float units)
+{
+    glPolygonOffset(factor, units);
+}
+
+void OpenGLDevice::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    glViewport(x, y, width, height);
+}
+
+void OpenGLDevice::clear(GLbitfield mask)
+{
+    glClear(mask);
+}
+
+void OpenGLDevice::clearColor(float r, float g, float b, float a)
+{
+    glClearColor(r, g, b, a);
+}
+
+void OpenGLDevice::drawElements(GLenum mode, GLsizei count, GLenum type, size_t offset, GLsizei instances)
+{
+    auto indices = reinterpret_cast<const void *>(offset);
+    if (instances)
+        glDrawElementsInstanced(mode, count, type, indices, instances);
+    else
+        glDrawElements(mode, count, type, indices);
+}
+
+void OpenGLDevice::drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+{
+    if (instances)
+        glDrawArraysInstanced(mode, first, count, instances);
+    else
+        glDrawArrays(mode, first, count);
+}
+
+void OpenGLDevice::blitFramebuffer(GLint srcWidth, GLint srcHeight, GLint dstWidth, GLint dstHeight, GLbitfield mask,
+                                   GLenum filter)
+{
+    glBlitFramebuffer(0, 0, srcWidth, srcHeight, 0, 0, dstWidth, dstHeight, mask, filter);
+}
+
+void OpenGLDevice::dispatchCompute(GLuint x, GLuint y, GLuint z)
+{
+    glDispatchCompute(x, y, z);
+}
+
+void OpenGLDevice::barrier(GLbitfield barriers)
+{
+    glMemoryBarrier(barriers);
+}
+
+void OpenGLDevice::multiDrawElementsIndirect(GLenum mode, GLenum type, size_t offset, GLsizei drawCount)
+{
+    glMultiDrawElementsIndirect(mode, type, reinterpret_cast<const void *>(offset), drawCount, 0);
+}
+
+void OpenGLDevice::multiDrawElementsIndirectCount(GLenum mode, GLenum type, size_t offset, size_t countOffset,
+                                                  GLsizei maxDrawCount)
+{
+    if (GLEW_VERSION_4_6)
+        glMultiDrawElementsIndirectCount(mode, type, reinterpret_cast<const void *>(offset),
+                                         static_cast<GLintptr>(countOffset), maxDrawCount, 0);
+    else
+        glMultiDrawElementsIndirectCountARB(mode, type, reinterpret_cast<const void *>(offset),
+                                            static_cast<GLintptr>(countOffset), maxDrawCount, 0);
+}
+
+void OpenGLDevice::queryTimestamp(GLuint query)
+{
+    glQueryCounter(query, GL_TIMESTAMP);
+}
+
+bool OpenGLDevice::getQueryResult(GLuint query, GLuint64 &result)
+{
+    GLint available{0};
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return false;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+    return true;
+}
+
+GLuint64 OpenGLDevice::getTimestamp()
+{
+    GLint64 timestamp{0};
+    glGetInteger64v(GL_TIMESTAMP, &timestamp);
+    return static_cast<GLuint64>(timestamp);
+}
+
+GLsync OpenGLDevice::fenceSync()
+{
+    return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool OpenGLDevice::clientWaitSync(GLsync sync, GLuint64 timeout)
+{
+    // flush, so fence is guaranteed to signal
+    auto status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+void OpenGLDevice::deleteSync(GLsync sync)
+{
+    glDeleteSync(sync);
+}
+
+} // namespace RenderIt
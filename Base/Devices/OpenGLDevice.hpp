@@ -0,0 +1,104 @@
+#pragma once
+#include <string>
+
+#include "Device.hpp"
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Device forwarding to the current GL context
+class OpenGLDevice : public GraphicsDevice
+{
+  public:
+    std::string GetName() const override;
+
+    bool HasContext() const override;
+
+    std::string GetDriverInfo() const override;
+
+    bool HasParallelCompile() const override;
+
+    bool HasIndirectCount() const override;
+
+    bool HasShaderDrawParameters() const override;
+
+  protected:
+    void createObjects(DeviceObject type, GLsizei count, GLuint *ids) override;
+    void deleteObjects(DeviceObject type, GLsizei count, const GLuint *ids) override;
+    void bindVertexArray(GLuint vao) override;
+    void bindBuffer(GLenum target, GLuint buffer) override;
+    void bindBufferBase(GLenum target, GLuint binding, GLuint buffer) override;
+    void bindBufferRange(GLenum target, GLuint binding, GLuint buffer, size_t offset, size_t size) override;
+    void bindTexture(GLenum target, GLuint texture) override;
+    void bindTextureUnit(GLuint unit, GLuint texture) override;
+    void bindFramebuffer(GLenum target, GLuint fbo) override;
+    void bindRenderbuffer(GLuint rbo) override;
+    bool isFramebufferComplete(GLuint fbo) override;
+
+    void bufferData(GLenum target, size_t size, const void *data, GLenum usage) override;
+    void bufferStorage(GLenum target, size_t size, const void *data, GLbitfield flags) override;
+    void bufferSubData(GLenum target, size_t offset, size_t size, const void *data) override;
+    void copyBufferSubData(GLuint src, GLuint dst, size_t srcOffset, size_t dstOffset, size_t size) override;
+    void clearBufferData(GLuint buffer, GLenum internalFormat, GLenum format, GLenum type,
+                         const void *data) override;
+    void getBufferSubData(GLuint buffer, size_t offset, size_t size, void *data) override;
+    void *mapBuffer(GLuint buffer, GLenum access) override;
+    void *mapBufferRange(GLuint buffer, size_t offset, size_t size, GLbitfield access) override;
+    void unmapBuffer(GLuint buffer) override;
+    void vertexAttribute(GLuint index, GLint size, GLenum type, bool integer, GLsizei stride, size_t offset) override;
+    void texParameter(GLenum target, GLenum name, GLint value) override;
+    void texImage2D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type,
+                    const void *data) override;
+    void copyTexSubImage2D(GLenum target, GLint x, GLint y, GLsizei width, GLsizei height) override;
+    void texImage3D(GLenum target, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLenum format,
+                    GLenum type, const void *data) override;
+    void texStorage2D(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height) override;
+    void texImage2DMultisample(GLenum target, GLsizei samples, GLenum internalFormat, GLsizei width,
+                               GLsizei height) override;
+    void renderbufferStorage(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei samples) override;
+    void generateMipmap(GLenum target) override;
+    void bindImageTexture(GLuint unit, GLuint texture, GLint level, GLenum access, GLenum format) override;
+
+    void setCompilerThreads(unsigned count) override;
+    GLuint submitShader(GLenum type, const std::string &source) override;
+    GLuint submitProgram(const std::vector<GLuint> &shaders, bool retrievable) override;
+    bool isProgramReady(GLuint program) override;
+    bool getShaderStatus(GLuint shader, std::string &log) override;
+    bool getProgramStatus(GLuint program, std::string &log) override;
+    bool getProgramBinary(GLuint program, GLenum &format, std::vector<unsigned char> &binary) override;
+    GLuint programBinary(GLenum format, const std::vector<unsigned char> &binary) override;
+    void deleteShader(GLuint shader) override;
+    void deleteProgram(GLuint program) override;
+    void useProgram(GLuint program) override;
+    void getUniformLocations(GLuint program, std::unordered_map<std::string, GLint> &locations) override;
+    GLuint getResourceIndex(GLuint program, GLenum interface, const std::string &name) override;
+    void blockBinding(GLuint program, GLenum interface, GLuint index, GLuint binding) override;
+    void uniform(GLint location, UniformType type, const void *data) override;
+
+    void setEnabled(GLenum cap, bool enabled) override;
+    bool isEnabled(GLenum cap) override;
+    void cullFace(GLenum face) override;
+    void polygonOffset(float factor, float units) override;
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+    void clear(GLbitfield mask) override;
+    void clearColor(float r, float g, float b, float a) override;
+    void drawElements(GLenum mode, GLsizei count, GLenum type, size_t offset, GLsizei instances) override;
+    void drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instances) override;
+    void blitFramebuffer(GLint srcWidth, GLint srcHeight, GLint dstWidth, GLint dstHeight, GLbitfield mask,
+                         GLenum filter) override;
+    void dispatchCompute(GLuint x, GLuint y, GLuint z) override;
+    void barrier(GLbitfield barriers) override;
+    void multiDrawElementsIndirect(GLenum mode, GLenum type, size_t offset, GLsizei drawCount) override;
+    void multiDrawElementsIndirectCount(GLenum mode, GLenum type, size_t offset, size_t countOffset,
+                                        GLsizei maxDrawCount) override;
+    void queryTimestamp(GLuint query) override;
+    bool getQueryResult(GLuint query, GLuint64 &result) override;
+    GLuint64 getTimestamp() override;
+    GLsync fenceSync() override;
+    bool clientWaitSync(GLsync sync, GLuint64 timeout) override;
+    void deleteSync(GLsync sync) override;
+};
+
+} // namespace RenderIt
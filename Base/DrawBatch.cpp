@@ -0,0 +1,319 @@
+#include "DrawBatch.hpp"
+#include "Device.hpp"
+#include "GPUCulling.hpp"
+#include "Materials.hpp"
+#include "Tools.hpp"
+#include "Vertex.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+
+namespace RenderIt
+{
+
+DrawBatch::DrawBatch() : _defaultMaterial(std::make_shared<Material>()), _buildID(0), _numUploaded(0)
+{
+}
+
+DrawBatch::~DrawBatch()
+{
+    Reset();
+}
+
+bool DrawBatch::Build(const std::vector<const Model *> &models)
+{
+    Reset();
+
+    struct Candidate
+    {
+        const Model *model;
+        const Mesh *mesh;
+        std::shared_ptr<Material> material;
+        // primitive type, face culling, texture IDs
+        std::vector<GLuint> key;
+    };
+    std::vector<Candidate> candidates;
+
+    // collect opaque meshes of static models
+    std::queue<const Model *> ms;
+    for (auto m : models)
+        if (m)
+            ms.push(m);
+    while (!ms.empty())
+    {
+        auto m = ms.front();
+        ms.pop();
+        for (auto i = 0u; i < m->GetNumChildren(); ++i)
+            ms.push(m->GetChild(i).get());
+        if (m->HasAnimation())
+            continue;
+        bool batched = false;
+        for (auto i = 0u; i < m->GetNumMeshes(); ++i)
+        {
+            auto mesh = m->GetMesh(i).get();
+            if (!mesh->GetVertexArray().has_value() || !mesh->GetNumIndices())
+                continue;
+            const auto &mat = mesh->material ? mesh->material : _defaultMaterial;
+            if (mat->IsTransparent() || mat->IsRefractive())
+                continue;
+            std::vector<GLuint> key{mesh->primType, static_cast<GLuint>(mat->twoSided)};
+            for (int t = 0; t < Material::MAX_MAPS_COUNT; ++t)
+            {
+                const auto &tex = mat->GetMap(t);
+                key.push_back(tex ? tex->Get() : 0u);
+            }
+            candidates.push_back({m, mesh, mat, std::move(key)});
+            batched = true;
+        }
+        if (batched)
+            _models.insert(m);
+    }
+    if (candidates.empty())
+        return false;
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate &a, const Candidate &b) { return a.key < b.key; });
+
+    // place geometry of every unique mesh in merged buffers
+    // map mesh -> (first index, base vertex)
+    std::unordered_map<const Mesh *, std::pair<GLuint, GLint>> offsets;
+    size_t numVertices = 0, numIndices = 0;
+    for (const auto &c : candidates)
+    {
+        if (offsets.count(c.mesh))
+            continue;
+        offsets[c.mesh] = {static_cast<GLuint>(numIndices), static_cast<GLint>(numVertices)};
+        numVertices += c.mesh->GetNumVertices();
+        numIndices += c.mesh->GetNumIndices();
+    }
+    _vao = std::make_unique<SVAO>();
+    _vbo = std::make_unique<SBuffer>(GL_ARRAY_BUFFER);
+    _ebo = std::make_unique<SBuffer>(GL_ELEMENT_ARRAY_BUFFER);
+    auto &device = GraphicsDevice::Get();
+    _vao->Bind();
+    _vbo->Bind();
+    device.BufferData(_vbo->type, numVertices * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+    _ebo->Bind();
+    device.BufferData(_ebo->type, numIndices * sizeof(unsigned), nullptr, GL_STATIC_DRAW);
+    Mesh::SetupVAOAttributes();
+    _vao->UnBind();
+    for (const auto &[mesh, offset] : offsets)
+    {
+        device.CopyBufferSubData(mesh->GetVertexBuffer().value(), _vbo->Get(), 0, offset.second * sizeof(Vertex),
+                                 mesh->GetNumVertices() * sizeof(Vertex));
+        device.CopyBufferSubData(mesh->GetIndexBuffer().value(), _ebo->Get(), 0, offset.first * sizeof(unsigned),
+                                 mesh->GetNumIndices() * sizeof(unsigned));
+    }
+
+    // build commands, grouped by key
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        const auto &c = candidates[i];
+        const auto &offset = offsets[c.mesh];
+        _commands.push_back(
+            {static_cast<GLuint>(c.mesh->GetNumIndices()), 1u, offset.first, offset.second, static_cast<GLuint>(i)});
+        _sources.emplace_back(c.model, c.mesh);
+        if (!i || candidates[i - 1].key != c.key)
+            _groups.push_back({c.mesh->primType, c.material->twoSided, c.material, i, 0});
+        ++_groups.back().count;
+    }
+    _draws.resize(_commands.size());
+    // no material synced yet, so first Update uploads every draw
+    _drawMaterials.assign(_commands.size(), nullptr);
+    collectMaterials();
+    countGroups();
+
+    _commandsBuffer = std::make_unique<SBuffer>(GL_DRAW_INDIRECT_BUFFER);
+    _commandsBuffer->Bind();
+    device.BufferData(_commandsBuffer->type, _commands.size() * sizeof(DrawElementsIndirectCommand), _commands.data(),
+                      GL_DYNAMIC_DRAW);
+    _commandsBuffer->UnBind();
+    _drawsSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
+    _drawsSSBO->Bind();
+    device.BufferData(_drawsSSBO->type, _draws.size() * sizeof(DrawData), nullptr, GL_DYNAMIC_DRAW);
+    _drawsSSBO->UnBind();
+
+    static unsigned buildCounter = 0;
+    _buildID = ++buildCounter;
+
+    Update();
+
+    Tools::display_message(LOGNAME,
+                           "batched " + std::to_string(_commands.size()) + " meshes into " +
+                               std::to_string(_groups.size()) + " multi-draws",
+                           Tools::MessageType::INFO);
+    return true;
+}
+
+void DrawBatch::Update()
+{
+    _numUploaded = 0;
+    if (_draws.empty())
+        return;
+    auto materials = MaterialManager::Instance();
+    // constants are uploaded by manager only if changed
+    for (const auto &mat : _materials)
+        materials->Sync(mat);
+    bool commandsChanged = false, materialsChanged = false;
+    // range of draws to upload
+    size_t first = _draws.size(), last = 0;
+    for (size_t i = 0; i < _sources.size(); ++i)
+    {
+        const auto &[model, mesh] = _sources[i];
+        auto &draw = _draws[i];
+        const auto &mat = mesh->material ? mesh->material : _defaultMaterial;
+        if (_drawMaterials[i] != mat.get())
+        {
+            materials->Sync(mat);
+            _drawMaterials[i] = mat.get();
+            materialsChanged = true;
+        }
+        auto slot = static_cast<unsigned>(mat->bufferIndex);
+        if (draw.material != slot || std::memcmp(&draw.model, &model->transform.matrix, sizeof(glm::mat4)) != 0)
+        {
+            draw.model = model->transform.matrix;
+            draw.modelInv = model->transform.matrixInv;
+            draw.material = slot;
+            first = (std::min)(first, i);
+            last = i;
+        }
+        // hidden meshes keep their command with no instance
+        GLuint instances = mesh->drawMesh ? 1u : 0u;
+        if (_commands[i].instanceCount != instances)
+        {
+            _commands[i].instanceCount = instances;
+            commandsChanged = true;
+        }
+    }
+    if (materialsChanged)
+        collectMaterials();
+    auto &device = GraphicsDevice::Get();
+    if (first <= last)
+    {
+        _numUploaded = last - first + 1;
+        _drawsSSBO->Bind();
+        device.BufferSubData(_drawsSSBO->type, first * sizeof(DrawData), _numUploaded * sizeof(DrawData),
+                             &_draws[first]);
+        _drawsSSBO->UnBind();
+    }
+    if (commandsChanged)
+    {
+        countGroups();
+        _commandsBuffer->Bind();
+        device.BufferSubData(_commandsBuffer->type, 0, _commands.size() * sizeof(DrawElementsIndirectCommand),
+                             _commands.data());
+        _commandsBuffer->UnBind();
+    }
+}
+
+void DrawBatch::Draw(const Shader *shader, const GPUCuller *culler) const
+{
+    if (!_vao || _groups.empty() || !shader->IsCompiled())
+        return;
+    auto &device = GraphicsDevice::Get();
+    // culled counts need indirect parameters, else all commands are drawn
+    bool culled = culler && culler->HasResult(*this) && device.HasIndirectCount();
+    // program may have been replaced since uniforms were set (culling binds its compute program)
+    shader->Bind();
+    auto hasBlend = device.IsEnabled(GL_BLEND);
+    auto hasCullFace = device.IsEnabled(GL_CULL_FACE);
+    device.SetEnabled(GL_BLEND, false);
+    MaterialManager::Instance()->BindMaterials();
+    _drawsSSBO->BindBase(DRAWBATCH_SSBO_BINDING);
+    if (culled)
+    {
+        device.BindBuffer(GL_DRAW_INDIRECT_BUFFER, culler->GetCommandsBuffer());
+        device.BindBuffer(GL_PARAMETER_BUFFER, culler->GetCountsBuffer());
+    }
+    else
+        _commandsBuffer->Bind();
+    _vao->Bind();
+    for (size_t g = 0; g < _groups.size(); ++g)
+    {
+        const auto &group = _groups[g];
+        shader->ConfigMaterialMaps(group.material.get());
+        device.SetEnabled(GL_CULL_FACE, !group.twoSided);
+        auto offset = group.first * sizeof(DrawElementsIndirectCommand);
+        // surviving commands are compacted at start of group, count is written by culler
+        if (culled)
+            device.MultiDrawElementsIndirectCount(group.primType, GL_UNSIGNED_INT, offset, g * sizeof(GLuint),
+                                                  static_cast<GLsizei>(group.count), group.indices, group.instances);
+        else
+            device.MultiDrawElementsIndirect(group.primType, GL_UNSIGNED_INT, offset,
+                                             static_cast<GLsizei>(group.count), group.indices, group.instances);
+    }
+    _vao->UnBind();
+    if (culled)
+        device.BindBuffer(GL_PARAMETER_BUFFER, 0);
+    device.BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    _drawsSSBO->UnBindBase(DRAWBATCH_SSBO_BINDING);
+    device.SetEnabled(GL_CULL_FACE, hasCullFace);
+    if (hasBlend)
+        device.SetEnabled(GL_BLEND, true);
+}
+
+bool DrawBatch::Contains(const Model *model) const
+{
+    return _models.count(model);
+}
+
+void DrawBatch::Reset()
+{
+    _vao = nullptr;
+    _vbo = nullptr;
+    _ebo = nullptr;
+    _commandsBuffer = nullptr;
+    _drawsSSBO = nullptr;
+    _commands.clear();
+    _draws.clear();
+    _sources.clear();
+    _drawMaterials.clear();
+    _materials.clear();
+    _groups.clear();
+    _models.clear();
+    _buildID = 0;
+    _numUploaded = 0;
+}
+
+size_t DrawBatch::GetNumDraws() const
+{
+    return _commands.size();
+}
+
+size_t DrawBatch::GetNumGroups() const
+{
+    return _groups.size();
+}
+
+size_t DrawBatch::GetNumUploaded() const
+{
+    return _numUploaded;
+}
+
+void DrawBatch::collectMaterials()
+{
+    _materials.clear();
+    std::unordered_set<const Material *> seen;
+    for (const auto &source : _sources)
+    {
+        const auto &mat = source.second->material ? source.second->material : _defaultMaterial;
+        if (seen.insert(mat.get()).second)
+            _materials.push_back(mat);
+    }
+}
+
+void DrawBatch::countGroups()
+{
+    for (auto &group : _groups)
+    {
+        group.indices = group.instances = 0;
+        for (size_t i = group.first; i < group.first + group.count; ++i)
+        {
+            group.indices += static_cast<size_t>(_commands[i].count) * _commands[i].instanceCount;
+            group.instances += _commands[i].instanceCount;
+        }
+    }
+}
+
+} // namespace RenderIt
@@ -0,0 +1,135 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "GLStructs.hpp"
+#include "Material.hpp"
+#include "Mesh.hpp"
+#include "Model.hpp"
+#include "Shader.hpp"
+
+#define DRAWBATCH_SSBO_BINDING 5
+
+/** @file */
+
+namespace RenderIt
+{
+
+class GPUCuller;
+
+/// Indirect draw command, layout defined by OpenGL
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+/// Per-draw data in std430 layout, indexed by baseInstance of command (gl_BaseInstanceARB)
+struct DrawData
+{
+    glm::mat4 model;
+    glm::mat4 modelInv;
+    unsigned material;
+    unsigned padding[3];
+};
+
+/// Batch of static opaque meshes submitted with multi-draw indirect
+/// Shaders must declare
+/// layout(std430, binding = 5) readonly buffer DrawsData { DrawData draws[]; };
+/// and read draws[gl_BaseInstanceARB] (ARB_shader_draw_parameters) instead of model uniforms
+class DrawBatch
+{
+    friend class GPUCuller;
+
+  public:
+    DrawBatch();
+
+    ~DrawBatch();
+
+    /// Build batch from opaque meshes of non-animated models (children included)
+    bool Build(const std::vector<const Model *> &models);
+
+    /// Update per-draw matrices, materials and visibility, only changed draws are uploaded
+    void Update();
+
+    /// Draw batch, one multi-draw per texture set
+    /// With culler, draws the commands that survived its last Cull of this batch
+    void Draw(const Shader *shader, const GPUCuller *culler = nullptr) const;
+
+    /// Whether opaque meshes of model are drawn by this batch
+    bool Contains(const Model *model) const;
+
+    /// Reset batch data
+    void Reset();
+
+    /// Get number of draws in batch
+    size_t GetNumDraws() const;
+
+    /// Get number of multi-draw calls
+    size_t GetNumGroups() const;
+
+    /// Get number of draws uploaded by last Update
+    size_t GetNumUploaded() const;
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "DrawBatch";
+
+  private:
+    /// Gather unique materials of draws
+    void collectMaterials();
+
+    /// Sum indices & instances of commands per group, reported to device stats on draw
+    void countGroups();
+
+  private:
+    /// Draws sharing primitive type, face culling and textures
+    struct Group
+    {
+        GLenum primType;
+        bool twoSided;
+        std::shared_ptr<Material> material;
+        size_t first;
+        size_t count;
+        // index count x instance count & instance count of all commands
+        size_t indices = 0;
+        size_t instances = 0;
+    };
+
+  private:
+    std::unique_ptr<SVAO> _vao;
+    std::unique_ptr<SBuffer> _vbo;
+    std::unique_ptr<SBuffer> _ebo;
+    std::unique_ptr<SBuffer> _commandsBuffer;
+    std::unique_ptr<SBuffer> _drawsSSBO;
+
+    std::vector<DrawElementsIndirectCommand> _commands;
+    std::vector<DrawData> _draws;
+    // (model, mesh) of each draw, same order as commands
+    std::vector<std::pair<const Model *, const Mesh *>> _sources;
+    // material synced for each draw, detects meshes given another material
+    std::vector<const Material *> _drawMaterials;
+    // unique materials of batch, synced once per Update
+    std::vector<std::shared_ptr<Material>> _materials;
+    std::vector<Group> _groups;
+    std::unordered_set<const Model *> _models;
+    // used for meshes without material
+    std::shared_ptr<Material> _defaultMaterial;
+    // unique per Build, 0 if empty
+    unsigned _buildID;
+    size_t _numUploaded;
+};
+
+} // namespace RenderIt
@@ -0,0 +1,57 @@
+#include "FrameConstants.hpp"
+#include "Device.hpp"
+#include "StreamBuffer.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+
+namespace RenderIt
+{
+
+std::shared_ptr<FrameConstants> FrameConstants::Instance()
+{
+    static auto constants = std::make_shared<FrameConstants>();
+    return constants;
+}
+
+void FrameConstants::SetCamera(const glm::mat4 &view, const glm::mat4 &proj, const glm::mat4 &viewInv,
+                               const glm::mat4 &projInv, const glm::vec3 &position)
+{
+    _data.view = view;
+    _data.proj = proj;
+    _data.viewInv = viewInv;
+    _data.projInv = projInv;
+    _data.projView = proj * view;
+    _data.cameraPos = glm::vec4(position, 1.0f);
+}
+
+void FrameConstants::SetScreenSize(int width, int height)
+{
+    auto w = static_cast<float>((std::max)(width, 1));
+    auto h = static_cast<float>((std::max)(height, 1));
+    _data.screenSize = glm::vec4(w, h, 1.0f / w, 1.0f / h);
+}
+
+void FrameConstants::SetTime(float seconds, float deltaSeconds, unsigned frame)
+{
+    _data.time = glm::vec4(seconds, deltaSeconds, static_cast<float>(frame), 0.0f);
+}
+
+const FrameConstantsData &FrameConstants::Get() const
+{
+    return _data;
+}
+
+void FrameConstants::Bind(unsigned binding) const
+{
+    auto constants = StreamBuffer::Instance()->Upload(&_data, sizeof(_data));
+    constants.BindRange(GL_UNIFORM_BUFFER, binding);
+}
+
+void FrameConstants::UnBind(unsigned binding) const
+{
+    GraphicsDevice::Get().BindBufferBase(GL_UNIFORM_BUFFER, binding, 0);
+}
+
+} // namespace RenderIt
@@ -0,0 +1,79 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+
+#define FRAME_CONSTANTS_BINDING 0
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Per-frame data shared by all shaders, std140 layout of FrameConstants uniform block
+struct FrameConstantsData
+{
+    glm::mat4 view{1.0f};
+    glm::mat4 proj{1.0f};
+    glm::mat4 viewInv{1.0f};
+    glm::mat4 projInv{1.0f};
+    glm::mat4 projView{1.0f};
+    /// World space camera position, w unused
+    glm::vec4 cameraPos{0.0f};
+    /// Width, height, 1 / width, 1 / height
+    glm::vec4 screenSize{1.0f};
+    /// Time (seconds), delta time (seconds), frame index, w unused
+    glm::vec4 time{0.0f};
+};
+
+/// Frame constants uniform buffer
+/// AppContext sets time & screen size, Camera sets matrices & binds once per frame in PrepareFrame
+class FrameConstants
+{
+  public:
+    /// Get singleton
+    static std::shared_ptr<FrameConstants> Instance();
+
+    /// Set camera matrices & position
+    void SetCamera(const glm::mat4 &view, const glm::mat4 &proj, const glm::mat4 &viewInv, const glm::mat4 &projInv,
+                   const glm::vec3 &position);
+
+    /// Set screen size in pixels
+    void SetScreenSize(int width, int height);
+
+    /// Set time of frame
+    void SetTime(float seconds, float deltaSeconds, unsigned frame);
+
+    /// Get current data
+    const FrameConstantsData &Get() const;
+
+    /// Upload to stream buffer & bind to uniform buffer binding
+    void Bind(unsigned binding = FRAME_CONSTANTS_BINDING) const;
+
+    /// UnBind uniform buffer binding
+    void UnBind(unsigned binding = FRAME_CONSTANTS_BINDING) const;
+
+  public:
+    const std::string LOGNAME = "FrameConstants";
+
+    /// GLSL declaration of block, insert after #version line (binding is FRAME_CONSTANTS_BINDING)
+    inline static const std::string BlockSource = R"(
+        layout(std140, binding = 0) uniform FrameConstants
+        {
+            mat4 mat_View;
+            mat4 mat_Proj;
+            mat4 mat_ViewInv;
+            mat4 mat_ProjInv;
+            mat4 mat_ProjView;
+            vec4 vec_CameraPos;
+            vec4 vec_ScreenSize;
+            vec4 vec_Time;
+        };
+    )";
+
+  private:
+    FrameConstantsData _data;
+};
+
+} // namespace RenderIt
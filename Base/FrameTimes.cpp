@@ -0,0 +1,154 @@
+#include "FrameTimes.hpp"
+#include "Tools.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace RenderIt
+{
+
+/// Write summary as JSON object
+static void write_summary_json(std::ostream &out, const FrameTimeSummary &summary)
+{
+    out << "{\"frames\": " << summary.frames << ", \"mean\": " << summary.mean << ", \"min\": " << summary.min
+        << ", \"max\": " << summary.max << ", \"p50\": " << summary.p50 << ", \"p95\": " << summary.p95
+        << ", \"p99\": " << summary.p99 << ", \"hitches\": " << summary.hitches << "}";
+}
+
+FrameTimes::FrameTimes(size_t capacity)
+    : _next(0), _count(0), _total(0), _hitches(0), _hitchThreshold(33.3f), _windows({60, 600}), _uiWindow(300)
+{
+    SetCapacity(capacity);
+}
+
+void FrameTimes::Push(float seconds)
+{
+    auto ms = seconds * 1000.0f;
+    _times[_next] = ms;
+    _next = (_next + 1) % _times.size();
+    _count = (std::min)(_count + 1, _times.size());
+    ++_total;
+    if (ms > _hitchThreshold)
+        ++_hitches;
+}
+
+void FrameTimes::SetCapacity(size_t capacity)
+{
+    _times.assign((std::max)(capacity, size_t(1)), 0.0f);
+    _next = 0;
+    _count = 0;
+}
+
+size_t FrameTimes::GetCapacity() const
+{
+    return _times.size();
+}
+
+size_t FrameTimes::GetNumFrames() const
+{
+    return _count;
+}
+
+size_t FrameTimes::GetTotalFrames() const
+{
+    return _total;
+}
+
+size_t FrameTimes::GetTotalHitches() const
+{
+    return _hitches;
+}
+
+void FrameTimes::SetHitchThreshold(float ms)
+{
+    _hitchThreshold = (std::max)(0.0f, ms);
+}
+
+float FrameTimes::GetHitchThreshold() const
+{
+    return _hitchThreshold;
+}
+
+void FrameTimes::SetWindows(const std::vector<size_t> &windows)
+{
+    _windows = windows;
+}
+
+const std::vector<size_t> &FrameTimes::GetWindows() const
+{
+    return _windows;
+}
+
+std::vector<float> FrameTimes::GetFrameTimes(size_t window) const
+{
+    auto count = window ? (std::min)(window, _count) : _count;
+    std::vector<float> times(count);
+    auto start = (_next + _times.size() - count) % _times.size();
+    for (size_t i = 0; i < count; ++i)
+        times[i] = _times[(start + i) % _times.size()];
+    return times;
+}
+
+FrameTimeSummary FrameTimes::Summarize(size_t window) const
+{
+    FrameTimeSummary summary;
+    auto times = GetFrameTimes(window);
+    if (times.empty())
+        return summary;
+    summary.frames = times.size();
+    double total = 0.0;
+    for (auto t : times)
+    {
+        total += t;
+        if (t > _hitchThreshold)
+            ++summary.hitches;
+    }
+    summary.mean = static_cast<float>(total / static_cast<double>(times.size()));
+    // nearest rank, partial sorts in increasing order
+    auto percentile = [&times](float p) {
+        auto nth = times.begin() + static_cast<size_t>(p * static_cast<float>(times.size() - 1) + 0.5f);
+        std::nth_element(times.begin(), nth, times.end());
+        return *nth;
+    };
+    summary.min = *std::min_element(times.begin(), times.end());
+    summary.p50 = percentile(0.5f);
+    summary.p95 = percentile(0.95f);
+    summary.p99 = percentile(0.99f);
+    summary.max = *std::max_element(times.begin(), times.end());
+    return summary;
+}
+
+bool FrameTimes::WriteCSV(const std::string &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        Tools::display_message(LOGNAME, "Failed to write frame times to " + path, Tools::MessageType::WARN);
+        return false;
+    }
+    auto times = GetFrameTimes();
+    auto first = _total - times.size();
+    file << "frame,ms,hitch\n";
+    for (size_t i = 0; i < times.size(); ++i)
+        file << first + i << "," << times[i] << "," << (times[i] > _hitchThreshold ? 1 : 0) << "\n";
+    return true;
+}
+
+std::string FrameTimes::ToJSON() const
+{
+    std::stringstream out;
+    out << "{\"total_frames\": " << _total << ", \"total_hitches\": " << _hitches
+        << ", \"hitch_ms\": " << _hitchThreshold << ", \"all\": ";
+    write_summary_json(out, Summarize());
+    out << ", \"windows\": [";
+    for (size_t i = 0; i < _windows.size(); ++i)
+    {
+        out << (i ? ", " : "");
+        write_summary_json(out, Summarize(_windows[i]));
+    }
+    out << "]}";
+    return out.str();
+}
+
+} // namespace RenderIt
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#define FRAME_TIMES_DEFAULT_CAPACITY 4096
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Frame time statistics in milliseconds
+struct FrameTimeSummary
+{
+    size_t frames = 0;
+    float mean = 0.0f;
+    float min = 0.0f;
+    float p50 = 0.0f;
+    float p95 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    /// Frames longer than hitch threshold
+    size_t hitches = 0;
+};
+
+/// Rolling frame time recorder
+/// Keeps latest frames in fixed-size ring buffer, hitches are counted over all frames
+class FrameTimes
+{
+  public:
+    FrameTimes(size_t capacity = FRAME_TIMES_DEFAULT_CAPACITY);
+
+    /// Record frame time (seconds)
+    void Push(float seconds);
+
+    /// Resize ring buffer, drops recorded frames
+    void SetCapacity(size_t capacity);
+
+    /// Get max number of kept frames
+    size_t GetCapacity() const;
+
+    /// Get number of kept frames
+    size_t GetNumFrames() const;
+
+    /// Get number of recorded frames since start
+    size_t GetTotalFrames() const;
+
+    /// Get number of hitches since start
+    size_t GetTotalHitches() const;
+
+    /// Set hitch threshold (milliseconds)
+    void SetHitchThreshold(float ms);
+
+    /// Get hitch threshold (milliseconds)
+    float GetHitchThreshold() const;
+
+    /// Set windows (latest N frames) of JSON summaries, 0 for all kept frames
+    void SetWindows(const std::vector<size_t> &windows);
+
+    /// Get windows of JSON summaries
+    const std::vector<size_t> &GetWindows() const;
+
+    /// Get latest frame times (milliseconds) from oldest to newest, 0 for all kept frames
+    std::vector<float> GetFrameTimes(size_t window = 0) const;
+
+    /// Compute stats of latest frames, 0 for all kept frames
+    FrameTimeSummary Summarize(size_t window = 0) const;
+
+    /// Write kept frames as CSV (frame, ms, hitch), returns false if failed
+    bool WriteCSV(const std::string &path) const;
+
+    /// Get summary of all kept frames & of each window as JSON object
+    std::string ToJSON() const;
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "FrameTimes";
+
+  private:
+    std::vector<float> _times;
+    size_t _next, _count, _total, _hitches;
+    float _hitchThreshold;
+    std::vector<size_t> _windows;
+    int _uiWindow;
+};
+
+} // namespace RenderIt
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 
+#include "Device.hpp"
+
 /** @file */
 
 namespace RenderIt
@@ -19,20 +21,20 @@ struct SVAO
     SVAO(size_t size = 1)
     {
         IDs.resize(size);
-        glGenVertexArrays(static_cast<GLsizei>(size), IDs.data());
+        GraphicsDevice::Get().CreateObjects(DeviceObject::VertexArray, static_cast<GLsizei>(size), IDs.data());
     }
     ~SVAO()
     {
-        glDeleteVertexArrays(static_cast<GLsizei>(IDs.size()), IDs.data());
+        GraphicsDevice::Get().DeleteObjects(DeviceObject::VertexArray, static_cast<GLsizei>(IDs.size()), IDs.data());
     }
     void Bind(size_t idx = 0) const
     {
         if (idx < IDs.size())
-            glBindVertexArray(IDs[idx]);
+            GraphicsDevice::Get().BindVertexArray(IDs[idx]);
     }
     void UnBind() const
     {
-        glBindVertexArray(0);
+        GraphicsDevice::Get().BindVertexArray(0);
     }
     GLuint Get(size_t idx = 0) const
     {
@@ -50,29 +52,29 @@ struct SBuffer
     {
         this->type = type;
         IDs.resize(size);
-        glGenBuffers(static_cast<GLsizei>(size), IDs.data());
+        GraphicsDevice::Get().CreateObjects(DeviceObject::Buffer, static_cast<GLsizei>(size), IDs.data());
     }
     ~SBuffer()
     {
-        glDeleteBuffers(static_cast<GLsizei>(IDs.size()), IDs.data());
+        GraphicsDevice::Get().DeleteObjects(DeviceObject::Buffer, static_cast<GLsizei>(IDs.size()), IDs.data());
     }
     void Bind(size_t idx = 0) const
     {
         if (idx < IDs.size())
-            glBindBuffer(type, IDs[idx]);
+            GraphicsDevice::Get().BindBuffer(type, IDs[idx]);
     }
     void UnBind() const
     {
-        glBindBuffer(type, 0);
+        GraphicsDevice::Get().BindBuffer(type, 0);
     }
     void BindBase(GLuint binding, size_t idx = 0) const
     {
         if (idx < IDs.size())
-            glBindBufferBase(type, binding, IDs[idx]);
+            GraphicsDevice::Get().BindBufferBase(type, binding, IDs[idx]);
     }
     void UnBindBase(GLuint binding) const
     {
-        glBindBufferBase(type, binding, 0);
+        GraphicsDevice::Get().BindBufferBase(type, binding, 0);
     }
     GLuint Get(size_t idx = 0) const
     {
@@ -91,20 +93,20 @@ struct STexture
     {
         this->type = type;
         IDs.resize(size);
-        glGenTextures(static_cast<GLsizei>(size), IDs.data());
+        GraphicsDevice::Get().CreateObjects(DeviceObject::Texture, static_cast<GLsizei>(size), IDs.data());
     }
     ~STexture()
     {
-        glDeleteTextures(static_cast<GLsizei>(IDs.size()), IDs.data());
+        GraphicsDevice::Get().DeleteObjects(DeviceObject::Texture, static_cast<GLsizei>(IDs.size()), IDs.data());
     }
     void Bind(size_t idx = 0) const
     {
         if (idx < IDs.size())
-            glBindTexture(type, IDs[idx]);
+            GraphicsDevice::Get().BindTexture(type, IDs[idx]);
     }
     void UnBind() const
     {
-        glBindTexture(type, 0);
+        GraphicsDevice::Get().BindTexture(type, 0);
     }
     GLuint Get(size_t idx = 0) const
     {
@@ -122,44 +124,45 @@ struct SFBO
     SFBO(size_t size = 1)
     {
         IDs.resize(size);
-        glGenFramebuffers(static_cast<GLsizei>(size), IDs.data());
+        GraphicsDevice::Get().CreateObjects(DeviceObject::Framebuffer, static_cast<GLsizei>(size), IDs.data());
     }
     ~SFBO()
     {
-        glDeleteFramebuffers(static_cast<GLsizei>(IDs.size()), IDs.data());
+        GraphicsDevice::Get().DeleteObjects(DeviceObject::Framebuffer, static_cast<GLsizei>(IDs.size()),
+                                             IDs.data());
     }
     void Bind(size_t idx = 0) const
     {
         if (idx < IDs.size())
-            glBindFramebuffer(GL_FRAMEBUFFER, IDs[idx]);
+            GraphicsDevice::Get().BindFramebuffer(GL_FRAMEBUFFER, IDs[idx]);
     }
     void UnBind() const
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        GraphicsDevice::Get().BindFramebuffer(GL_FRAMEBUFFER, 0);
     }
     void BindRead(size_t idx = 0) const
     {
         if (idx < IDs.size())
-            glBindFramebuffer(GL_READ_FRAMEBUFFER, IDs[idx]);
+            GraphicsDevice::Get().BindFramebuffer(GL_READ_FRAMEBUFFER, IDs[idx]);
     }
     void UnBindRead() const
     {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        GraphicsDevice::Get().BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
     }
     void BindDraw(size_t idx = 0) const
     {
         if (idx < IDs.size())
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, IDs[idx]);
+            GraphicsDevice::Get().BindFramebuffer(GL_DRAW_FRAMEBUFFER, IDs[idx]);
     }
     void UnBindDraw() const
     {
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        GraphicsDevice::Get().BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     }
     bool Validate(size_t idx = 0) const
     {
         if (idx >= IDs.size())
             return false;
-        return glCheckNamedFramebufferStatus(IDs[idx], GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        return GraphicsDevice::Get().IsFramebufferComplete(IDs[idx]);
     }
     GLuint Get(size_t idx = 0) const
     {
@@ -176,20 +179,21 @@ struct SRBO
     SRBO(size_t size = 1)
     {
         IDs.resize(size);
-        glGenRenderbuffers(static_cast<GLsizei>(size), IDs.data());
+        GraphicsDevice::Get().CreateObjects(DeviceObject::Renderbuffer, static_cast<GLsizei>(size), IDs.data());
     }
     ~SRBO()
     {
-        glDeleteRenderbuffers(static_cast<GLsizei>(IDs.size()), IDs.data());
+        GraphicsDevice::Get().DeleteObjects(DeviceObject::Renderbuffer, static_cast<GLsizei>(IDs.size()),
+                                             IDs.data());
     }
     void Bind(size_t idx = 0) const
     {
         if (idx < IDs.size())
-            glBindRenderbuffer(GL_RENDERBUFFER, IDs[idx]);
+            GraphicsDevice::Get().BindRenderbuffer(IDs[idx]);
     }
     void UnBind() const
     {
-        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        GraphicsDevice::Get().BindRenderbuffer(0);
     }
     GLuint Get(size_t idx = 0) const
     {
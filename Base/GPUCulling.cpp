@@ -0,0 +1,462 @@
+#include "GPUCulling.hpp"
+#include "Device.hpp"
+#include "StreamBuffer.hpp"
+#include "Tools.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace RenderIt
+{
+
+/// Same test as culling compute shader, false if all corners are outside one clip plane
+static bool frustum_visible(const glm::mat4 &mvp, const glm::vec3 &bmin, const glm::vec3 &bmax)
+{
+    unsigned outside = 0x3Fu;
+    for (int i = 0; i < 8; ++i)
+    {
+        glm::vec4 p = mvp * glm::vec4((i & 1) ? bmax.x : bmin.x, (i & 2) ? bmax.y : bmin.y,
+                                      (i & 4) ? bmax.z : bmin.z, 1.0f);
+        unsigned bits = 0u;
+        bits |= p.x < -p.w ? 0x01u : 0u;
+        bits |= p.x > p.w ? 0x02u : 0u;
+        bits |= p.y < -p.w ? 0x04u : 0u;
+        bits |= p.y > p.w ? 0x08u : 0u;
+        bits |= p.z < -p.w ? 0x10u : 0u;
+        bits |= p.z > p.w ? 0x20u : 0u;
+        outside &= bits;
+    }
+    return outside == 0u;
+}
+
+GPUCuller::GPUCuller()
+    : useHiZ(true), validateNext(false), _hiZWidth(0), _hiZHeight(0), _hiZLevels(0), _hasPyramid(false),
+      _batchBuildID(0), _numDraws(0), _numGroups(0), _lastBatch(nullptr), _cullFrame(0), _validateAll(false),
+      _validating(false), _mismatches(0)
+{
+    auto validate = std::getenv("RENDERIT_VALIDATE_CULLING");
+    _validateAll = validate && std::string(validate) != "0";
+
+    const std::string copySource = R"(
+        #version 450 core
+        layout(local_size_x = 8, local_size_y = 8) in;
+
+        layout(r32f, binding = 0) writeonly uniform image2D hiZLevel;
+        uniform sampler2D map_Depth;
+
+        void main()
+        {
+            ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+            if (any(greaterThanEqual(p, imageSize(hiZLevel))))
+                return;
+            imageStore(hiZLevel, p, vec4(texelFetch(map_Depth, p, 0).r));
+        }
+    )";
+    const std::string downsampleSource = R"(
+        #version 450 core
+        layout(local_size_x = 8, local_size_y = 8) in;
+
+        layout(r32f, binding = 0) readonly uniform image2D srcLevel;
+        layout(r32f, binding = 1) writeonly uniform image2D dstLevel;
+
+        float load(ivec2 p)
+        {
+            return imageLoad(srcLevel, p).r;
+        }
+
+        void main()
+        {
+            ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+            ivec2 dstSize = imageSize(dstLevel);
+            if (any(greaterThanEqual(p, dstSize)))
+                return;
+            ivec2 srcSize = imageSize(srcLevel);
+            ivec2 s = p * 2;
+            float d = max(max(load(s), load(s + ivec2(1, 0))), max(load(s + ivec2(0, 1)), load(s + ivec2(1, 1))));
+            // odd source sizes fold last column & row into last texel
+            bool extraX = (srcSize.x & 1) != 0 && p.x == dstSize.x - 1;
+            bool extraY = (srcSize.y & 1) != 0 && p.y == dstSize.y - 1;
+            if (extraX)
+                d = max(d, max(load(s + ivec2(2, 0)), load(s + ivec2(2, 1))));
+            if (extraY)
+                d = max(d, max(load(s + ivec2(0, 2)), load(s + ivec2(1, 2))));
+            if (extraX && extraY)
+                d = max(d, load(s + ivec2(2, 2)));
+            imageStore(dstLevel, p, vec4(d));
+        }
+    )";
+    const std::string cullSource = R"(
+        #version 450 core
+        layout(local_size_x = 64) in;
+
+        struct DrawElementsIndirectCommand
+        {
+            uint count;
+            uint instanceCount;
+            uint firstIndex;
+            int baseVertex;
+            uint baseInstance;
+        };
+
+        struct DrawData
+        {
+            mat4 model;
+            mat4 modelInv;
+            uint material;
+        };
+
+        struct DrawCullData
+        {
+            vec4 boundsMin;
+            vec4 boundsMax;
+            uint group;
+            uint groupFirst;
+        };
+
+        layout(std430, binding = 5) readonly buffer DrawsData
+        {
+            DrawData draws[];
+        };
+
+        layout(std430, binding = 7) readonly buffer CommandsIn
+        {
+            DrawElementsIndirectCommand commandsIn[];
+        };
+
+        layout(std430, binding = 8) writeonly buffer CommandsOut
+        {
+            DrawElementsIndirectCommand commandsOut[];
+        };
+
+        layout(std430, binding = 9) buffer CountsData
+        {
+            uint counts[];
+        };
+
+        layout(std430, binding = 10) readonly buffer CullData
+        {
+            DrawCullData cullData[];
+        };
+
+        uniform sampler2D map_HiZ;
+        uniform mat4 mat_ProjView;
+        uniform uint val_NumDraws;
+        uniform int val_HiZLevels;
+        uniform bool val_UseHiZ;
+
+        bool occluded(vec3 ndcMin, vec3 ndcMax)
+        {
+            vec2 uvMin = clamp(ndcMin.xy * 0.5 + 0.5, 0.0, 1.0);
+            vec2 uvMax = clamp(ndcMax.xy * 0.5 + 0.5, 0.0, 1.0);
+            float depthMin = ndcMin.z * 0.5 + 0.5;
+            // level where bounds cover at most 2x2 texels
+            vec2 size = (uvMax - uvMin) * vec2(textureSize(map_HiZ, 0));
+            int level = clamp(int(ceil(log2(max(max(size.x, size.y), 1.0)))), 0, val_HiZLevels - 1);
+            ivec2 levelSize = textureSize(map_HiZ, level);
+            ivec2 p0 = clamp(ivec2(uvMin * vec2(levelSize)), ivec2(0), levelSize - 1);
+            ivec2 p1 = clamp(ivec2(uvMax * vec2(levelSize)), ivec2(0), levelSize - 1);
+            float depthMax = 0.0;
+            for (int y = p0.y; y <= p1.y; ++y)
+                for (int x = p0.x; x <= p1.x; ++x)
+                    depthMax = max(depthMax, texelFetch(map_HiZ, ivec2(x, y), level).r);
+            return depthMin > depthMax;
+        }
+
+        void main()
+        {
+            uint idx = gl_GlobalInvocationID.x;
+            if (idx >= val_NumDraws)
+                return;
+            DrawElementsIndirectCommand command = commandsIn[idx];
+            if (command.instanceCount == 0)
+                return;
+            DrawCullData data = cullData[idx];
+            mat4 mvp = mat_ProjView * draws[idx].model;
+
+            uint outside = 0x3F;
+            bool crossesNear = false;
+            vec3 ndcMin = vec3(1.0), ndcMax = vec3(-1.0);
+            for (int i = 0; i < 8; ++i)
+            {
+                vec3 corner = vec3((i & 1) != 0 ? data.boundsMax.x : data.boundsMin.x,
+                                   (i & 2) != 0 ? data.boundsMax.y : data.boundsMin.y,
+                                   (i & 4) != 0 ? data.boundsMax.z : data.boundsMin.z);
+                vec4 p = mvp * vec4(corner, 1.0);
+                uint bits = 0;
+                bits |= p.x < -p.w ? 0x01 : 0;
+                bits |= p.x > p.w ? 0x02 : 0;
+                bits |= p.y < -p.w ? 0x04 : 0;
+                bits |= p.y > p.w ? 0x08 : 0;
+                bits |= p.z < -p.w ? 0x10 : 0;
+                bits |= p.z > p.w ? 0x20 : 0;
+                outside &= bits;
+                if (p.w <= 1e-5)
+                    crossesNear = true;
+                else
+                {
+                    vec3 ndc = p.xyz / p.w;
+                    ndcMin = min(ndcMin, ndc);
+                    ndcMax = max(ndcMax, ndc);
+                }
+            }
+            if (outside != 0)
+                return;
+            if (val_UseHiZ && !crossesNear && occluded(ndcMin, ndcMax))
+                return;
+
+            uint slot = atomicAdd(counts[data.group], 1);
+            commandsOut[data.groupFirst + slot] = command;
+        }
+    )";
+
+    _copyShader = std::make_unique<Shader>();
+    _copyShader->AddSource(copySource, GL_COMPUTE_SHADER);
+    _downsampleShader = std::make_unique<Shader>();
+    _downsampleShader->AddSource(downsampleSource, GL_COMPUTE_SHADER);
+    _cullShader = std::make_unique<Shader>();
+    _cullShader->AddSource(cullSource, GL_COMPUTE_SHADER);
+    Tools::compile_shaders_parallel({_copyShader.get(), _downsampleShader.get(), _cullShader.get()});
+}
+
+GPUCuller::~GPUCuller()
+{
+    _copyShader = nullptr;
+    _downsampleShader = nullptr;
+    _cullShader = nullptr;
+    _depthTexture = nullptr;
+    _hiZTexture = nullptr;
+    _cullDataSSBO = nullptr;
+    _commandsBuffer = nullptr;
+    _countsBuffer = nullptr;
+}
+
+void GPUCuller::BuildDepthPyramid(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return;
+    allocatePyramid(width, height);
+    _depthTexture->Bind();
+    GraphicsDevice::Get().CopyTexSubImage2D(_depthTexture->type, 0, 0, width, height);
+    _depthTexture->UnBind();
+    BuildDepthPyramid(_depthTexture->Get(), width, height);
+}
+
+void GPUCuller::BuildDepthPyramid(GLuint depthTexture, int width, int height)
+{
+    if (width <= 0 || height <= 0 || !_copyShader->IsCompiled() || !_downsampleShader->IsCompiled())
+        return;
+    allocatePyramid(width, height);
+    auto &device = GraphicsDevice::Get();
+
+    _copyShader->Bind();
+    _copyShader->TextureBinding(depthTexture, 0);
+    _copyShader->UniformInt("map_Depth", 0);
+    device.BindImageTexture(0, _hiZTexture->Get(), 0, GL_WRITE_ONLY, GL_R32F);
+    device.DispatchCompute((width + 7) / 8, (height + 7) / 8, 1);
+    device.Barrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    _copyShader->UnBind();
+
+    downsamplePyramid();
+    _hasPyramid = true;
+}
+
+void GPUCuller::Cull(const DrawBatch &batch, const glm::mat4 &projView)
+{
+    // culled commands are only drawn with indirect count
+    auto &device = GraphicsDevice::Get();
+    if (!batch.GetNumDraws() || !_cullShader->IsCompiled() || !device.HasIndirectCount())
+        return;
+    // validation culls without Hi-Z, its result is replaced by cull below
+    if ((validateNext || _validateAll) && !_validating)
+    {
+        validateNext = false;
+        _validating = true;
+        _mismatches = Validate(batch, projView);
+        _validating = false;
+    }
+    prepareBatch(batch);
+
+    GLuint zero = 0u;
+    device.ClearBufferData(_countsBuffer->Get(), GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+    _cullShader->Bind();
+    _cullShader->UniformMat4("mat_ProjView", projView);
+    _cullShader->UniformUInt("val_NumDraws", static_cast<unsigned>(_numDraws));
+    _cullShader->UniformBool("val_UseHiZ", useHiZ && _hasPyramid);
+    _cullShader->UniformInt("val_HiZLevels", _hiZLevels);
+    if (_hasPyramid)
+    {
+        _cullShader->TextureBinding(_hiZTexture->Get(), 0);
+        _cullShader->UniformInt("map_HiZ", 0);
+    }
+    batch._drawsSSBO->BindBase(DRAWBATCH_SSBO_BINDING);
+    device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPUCULL_COMMANDS_IN_BINDING, batch._commandsBuffer->Get());
+    device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPUCULL_COMMANDS_OUT_BINDING, _commandsBuffer->Get());
+    device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPUCULL_COUNTS_BINDING, _countsBuffer->Get());
+    _cullDataSSBO->BindBase(GPUCULL_DATA_BINDING);
+
+    device.DispatchCompute(static_cast<GLuint>((_numDraws + GPUCULL_GROUP_SIZE - 1) / GPUCULL_GROUP_SIZE), 1, 1);
+    // outputs are consumed as indirect commands & draw counts
+    device.Barrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+    _cullDataSSBO->UnBindBase(GPUCULL_DATA_BINDING);
+    device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPUCULL_COUNTS_BINDING, 0);
+    device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPUCULL_COMMANDS_OUT_BINDING, 0);
+    device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, GPUCULL_COMMANDS_IN_BINDING, 0);
+    batch._drawsSSBO->UnBindBase(DRAWBATCH_SSBO_BINDING);
+    _cullShader->UnBind();
+    _lastBatch = &batch;
+    _cullFrame = StreamBuffer::Instance()->GetFrame();
+}
+
+bool GPUCuller::HasResult(const DrawBatch &batch) const
+{
+    // results of previous frames are stale
+    return _lastBatch == &batch && _batchBuildID == batch._buildID && _commandsBuffer &&
+           _cullFrame == StreamBuffer::Instance()->GetFrame();
+}
+
+GLuint GPUCuller::GetCommandsBuffer() const
+{
+    return _commandsBuffer ? _commandsBuffer->Get() : 0u;
+}
+
+GLuint GPUCuller::GetCountsBuffer() const
+{
+    return _countsBuffer ? _countsBuffer->Get() : 0u;
+}
+
+size_t GPUCuller::Validate(const DrawBatch &batch, const glm::mat4 &projView)
+{
+    if (!batch.GetNumDraws())
+        return 0;
+    auto hiZ = useHiZ;
+    useHiZ = false;
+    Cull(batch, projView);
+    useHiZ = hiZ;
+    if (!HasResult(batch))
+        return 0;
+    auto &device = GraphicsDevice::Get();
+    device.Barrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    std::vector<GLuint> counts(_numGroups);
+    std::vector<DrawElementsIndirectCommand> commands(_numDraws);
+    device.GetBufferSubData(_countsBuffer->Get(), 0, counts.size() * sizeof(GLuint), counts.data());
+    device.GetBufferSubData(_commandsBuffer->Get(), 0, commands.size() * sizeof(DrawElementsIndirectCommand),
+                            commands.data());
+    std::vector<bool> gpuVisible(_numDraws, false);
+    for (size_t g = 0; g < batch._groups.size(); ++g)
+    {
+        const auto &group = batch._groups[g];
+        for (size_t i = 0; i < std::min<size_t>(counts[g], group.count); ++i)
+        {
+            auto drawIdx = commands[group.first + i].baseInstance;
+            if (drawIdx < gpuVisible.size())
+                gpuVisible[drawIdx] = true;
+        }
+    }
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < _numDraws; ++i)
+    {
+        const auto &bounds = batch._sources[i].first->bounds;
+        bool cpuVisible = batch._commands[i].instanceCount > 0 &&
+                          frustum_visible(projView * batch._draws[i].model, bounds.min, bounds.max);
+        if (cpuVisible != gpuVisible[i])
+            ++mismatches;
+    }
+    Tools::display_message(LOGNAME,
+                           "frustum culling mismatches: " + std::to_string(mismatches) + " / " +
+                               std::to_string(_numDraws),
+                           mismatches ? Tools::MessageType::WARN : Tools::MessageType::INFO);
+    return mismatches;
+}
+
+void GPUCuller::allocatePyramid(int width, int height)
+{
+    if (_hiZTexture && _hiZWidth == width && _hiZHeight == height)
+        return;
+    _hiZWidth = width;
+    _hiZHeight = height;
+    _hiZLevels = 1 + static_cast<int>(std::floor(std::log2(std::max(width, height))));
+    _hasPyramid = false;
+
+    GPU_MEMORY_SCOPE(RenderTargets, "GPUCuller");
+    auto &device = GraphicsDevice::Get();
+    _depthTexture = std::make_unique<STexture>(GL_TEXTURE_2D);
+    _depthTexture->Bind();
+    device.TexStorage2D(_depthTexture->type, 1, GL_DEPTH_COMPONENT32F, width, height);
+    device.TexParameter(_depthTexture->type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    device.TexParameter(_depthTexture->type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    _depthTexture->UnBind();
+
+    _hiZTexture = std::make_unique<STexture>(GL_TEXTURE_2D);
+    _hiZTexture->Bind();
+    device.TexStorage2D(_hiZTexture->type, _hiZLevels, GL_R32F, width, height);
+    device.TexParameter(_hiZTexture->type, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    device.TexParameter(_hiZTexture->type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    device.TexParameter(_hiZTexture->type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    device.TexParameter(_hiZTexture->type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    _hiZTexture->UnBind();
+}
+
+void GPUCuller::downsamplePyramid()
+{
+    auto &device = GraphicsDevice::Get();
+    _downsampleShader->Bind();
+    for (int level = 1; level < _hiZLevels; ++level)
+    {
+        int w = std::max(1, _hiZWidth >> level);
+        int h = std::max(1, _hiZHeight >> level);
+        device.BindImageTexture(0, _hiZTexture->Get(), level - 1, GL_READ_ONLY, GL_R32F);
+        device.BindImageTexture(1, _hiZTexture->Get(), level, GL_WRITE_ONLY, GL_R32F);
+        device.DispatchCompute((w + 7) / 8, (h + 7) / 8, 1);
+        device.Barrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+    // pyramid is sampled by culling shader
+    device.Barrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    _downsampleShader->UnBind();
+}
+
+void GPUCuller::prepareBatch(const DrawBatch &batch)
+{
+    if (_commandsBuffer && _batchBuildID == batch._buildID)
+        return;
+    _batchBuildID = batch._buildID;
+    _numDraws = batch._commands.size();
+    _numGroups = batch._groups.size();
+
+    // bounds are in model space, only depend on batch build
+    std::vector<DrawCullData> data(_numDraws);
+    for (size_t g = 0; g < _numGroups; ++g)
+    {
+        const auto &group = batch._groups[g];
+        for (size_t i = group.first; i < group.first + group.count; ++i)
+        {
+            const auto &bounds = batch._sources[i].first->bounds;
+            data[i].boundsMin = glm::vec4(bounds.min, 1.0f);
+            data[i].boundsMax = glm::vec4(bounds.max, 1.0f);
+            data[i].group = static_cast<unsigned>(g);
+            data[i].groupFirst = static_cast<unsigned>(group.first);
+        }
+    }
+    auto &device = GraphicsDevice::Get();
+    _cullDataSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
+    _cullDataSSBO->Bind();
+    device.BufferData(_cullDataSSBO->type, data.size() * sizeof(DrawCullData), data.data(), GL_STATIC_DRAW);
+    _cullDataSSBO->UnBind();
+
+    _commandsBuffer = std::make_unique<SBuffer>(GL_DRAW_INDIRECT_BUFFER);
+    _commandsBuffer->Bind();
+    device.BufferData(_commandsBuffer->type, _numDraws * sizeof(DrawElementsIndirectCommand), nullptr,
+                      GL_DYNAMIC_COPY);
+    _commandsBuffer->UnBind();
+
+    _countsBuffer = std::make_unique<SBuffer>(GL_PARAMETER_BUFFER);
+    _countsBuffer->Bind();
+    device.BufferData(_countsBuffer->type, _numGroups * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+    _countsBuffer->UnBind();
+}
+
+} // namespace RenderIt
@@ -0,0 +1,115 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DrawBatch.hpp"
+#include "GLStructs.hpp"
+#include "Shader.hpp"
+
+// bindings used only while culling compute runs, draws data stays at DRAWBATCH_SSBO_BINDING
+#define GPUCULL_COMMANDS_IN_BINDING 7
+#define GPUCULL_COMMANDS_OUT_BINDING 8
+#define GPUCULL_COUNTS_BINDING 9
+#define GPUCULL_DATA_BINDING 10
+#define GPUCULL_GROUP_SIZE 64
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Per-draw culling data in std430 layout
+struct DrawCullData
+{
+    // model space bounds of draw
+    glm::vec4 boundsMin;
+    glm::vec4 boundsMax;
+    // multi-draw group of draw & its first command
+    unsigned group;
+    unsigned groupFirst;
+    unsigned padding[2];
+};
+
+/// GPU culling of a DrawBatch with compute shaders
+/// Draws are tested against frustum and a Hi-Z pyramid built from previous frame depth,
+/// survivors are appended per multi-draw group and drawn with glMultiDrawElementsIndirectCount
+/// Compacted commands keep draw index in baseInstance, so batch shaders read draws[gl_BaseInstanceARB]
+class GPUCuller
+{
+  public:
+    GPUCuller();
+
+    ~GPUCuller();
+
+    /// Build Hi-Z pyramid from depth of currently bound read framebuffer (single sampled)
+    void BuildDepthPyramid(int width, int height);
+
+    /// Build Hi-Z pyramid from depth texture
+    void BuildDepthPyramid(GLuint depthTexture, int width, int height);
+
+    /// Cull batch, results are consumed by DrawBatch::Draw
+    void Cull(const DrawBatch &batch, const glm::mat4 &projView);
+
+    /// Whether last Cull call was for batch in current frame
+    bool HasResult(const DrawBatch &batch) const;
+
+    /// Get compacted command buffer
+    GLuint GetCommandsBuffer() const;
+
+    /// Get per-group draw counts buffer
+    GLuint GetCountsBuffer() const;
+
+    /// Compare frustum culling results on GPU against CPU, returns number of mismatched draws
+    /// Reads back results, for debugging only, also run by Cull if validateNext or RENDERIT_VALIDATE_CULLING is set
+    size_t Validate(const DrawBatch &batch, const glm::mat4 &projView);
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "GPUCuller";
+    bool useHiZ;
+    /// Validate next Cull, reset once validated
+    bool validateNext;
+
+  private:
+    /// Allocate Hi-Z pyramid for size
+    void allocatePyramid(int width, int height);
+
+    /// Downsample Hi-Z level 0 into remaining levels
+    void downsamplePyramid();
+
+    /// Upload culling data & allocate outputs for batch
+    void prepareBatch(const DrawBatch &batch);
+
+  private:
+    std::unique_ptr<Shader> _copyShader;
+    std::unique_ptr<Shader> _downsampleShader;
+    std::unique_ptr<Shader> _cullShader;
+
+    std::unique_ptr<STexture> _depthTexture;
+    std::unique_ptr<STexture> _hiZTexture;
+    int _hiZWidth, _hiZHeight, _hiZLevels;
+    bool _hasPyramid;
+
+    std::unique_ptr<SBuffer> _cullDataSSBO;
+    std::unique_ptr<SBuffer> _commandsBuffer;
+    std::unique_ptr<SBuffer> _countsBuffer;
+    // build of batch the outputs are prepared for
+    unsigned _batchBuildID;
+    size_t _numDraws, _numGroups;
+    const DrawBatch *_lastBatch;
+    // frame of last Cull, results are only used in same frame
+    uint64_t _cullFrame;
+    // validate every Cull, set by environment
+    bool _validateAll;
+    bool _validating;
+    size_t _mismatches;
+};
+
+} // namespace RenderIt
@@ -2,15 +2,31 @@
 #include "Bone.hpp"
 #include "Bounds.hpp"
 #include "Camera.hpp"
+#include "CameraPath.hpp"
 #include "Context.hpp"
+#include "Device.hpp"
+#include "DrawBatch.hpp"
+#include "FrameTimes.hpp"
 #include "GLStructs.hpp"
+#include "GPUCulling.hpp"
+#include "InputRecorder.hpp"
+#include "Jobs.hpp"
 #include "Lights.hpp"
 #include "Material.hpp"
+#include "Materials.hpp"
 #include "Mesh.hpp"
 #include "Model.hpp"
+#include "Occlusion.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
 #include "Scene.hpp"
+#include "ShaderCache.hpp"
 #include "Shadow.hpp"
+#include "StreamBuffer.hpp"
+#include "StressScene.hpp"
+#include "Tools.hpp"
 #include "Transform.hpp"
+#include "TransformSystem.hpp"
 
 #include "Cameras/FreeCamera.hpp"
 #include "Cameras/OrbitCamera.hpp"
@@ -18,7 +34,9 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui.h>
 
+#include <algorithm>
 #include <array>
+#include <filesystem>
 #include <memory>
 #include <string>
 
@@ -37,6 +55,14 @@ void UIShowVector(const glm::vec3 &v)
     ImGui::Text("(%.2f,%.2f,%.2f)", v.x, v.y, v.z);
 }
 
+void UIShowDeviceStats(const DeviceStats &stats)
+{
+    stats.ForEach([](const char *name, size_t value) {
+        if (value)
+            ImGui::Text("%s: %llu", name, static_cast<unsigned long long>(value));
+    });
+}
+
 void UIShowTexture(const std::shared_ptr<STexture> &tex)
 {
     if (!tex)
@@ -149,25 +175,31 @@ void UIEditMaterial(std::shared_ptr<Material> &mat)
     }
     if (ImGui::TreeNode("Values"))
     {
-        ImGui::ColorEdit3(Material::valNameColorAmbient.c_str(), glm::value_ptr(mat->colorAmbient));
-        ImGui::ColorEdit3(Material::valNameColorDiffuse.c_str(), glm::value_ptr(mat->colorDiffuse));
-        ImGui::ColorEdit3(Material::valNameColorSpecular.c_str(), glm::value_ptr(mat->colorSpecular));
-        ImGui::ColorEdit3(Material::valNameColorEmissive.c_str(), glm::value_ptr(mat->colorEmissive));
-        ImGui::ColorEdit3(Material::valNameColorTransparent.c_str(), glm::value_ptr(mat->colorTransparent));
-        ImGui::DragFloat(Material::valNameValShininess.c_str(), &mat->valShininess, 0.01f, 0.0f, 1000.0f, "%.2f");
-        ImGui::DragFloat(Material::valNameValOpacity.c_str(), &mat->valOpacity, 0.001f, 0.0f, 1.0f, "%.3f");
-        ImGui::DragFloat(Material::valNameValRefract.c_str(), &mat->valRefract, 0.001f, 0.0f, 1.0f, "%.3f");
-        ImGui::DragFloat(Material::valNameValPBRMetallic.c_str(), &mat->valPBRMetallic, 0.001f, 0.0f, 1.0f, "%.3f");
-        ImGui::DragFloat(Material::valNameValPBRRoughness.c_str(), &mat->valPBRRoughness, 0.001f, 0.0f, 1.0f, "%.3f");
-        ImGui::Checkbox("PBR Mode", &mat->valHasPBR);
+        bool changed = false;
+        changed |= ImGui::ColorEdit3(Material::valNameColorAmbient.c_str(), glm::value_ptr(mat->colorAmbient));
+        changed |= ImGui::ColorEdit3(Material::valNameColorDiffuse.c_str(), glm::value_ptr(mat->colorDiffuse));
+        changed |= ImGui::ColorEdit3(Material::valNameColorSpecular.c_str(), glm::value_ptr(mat->colorSpecular));
+        changed |= ImGui::ColorEdit3(Material::valNameColorEmissive.c_str(), glm::value_ptr(mat->colorEmissive));
+        changed |= ImGui::ColorEdit3(Material::valNameColorTransparent.c_str(), glm::value_ptr(mat->colorTransparent));
+        changed |=
+            ImGui::DragFloat(Material::valNameValShininess.c_str(), &mat->valShininess, 0.01f, 0.0f, 1000.0f, "%.2f");
+        changed |= ImGui::DragFloat(Material::valNameValOpacity.c_str(), &mat->valOpacity, 0.001f, 0.0f, 1.0f, "%.3f");
+        changed |= ImGui::DragFloat(Material::valNameValRefract.c_str(), &mat->valRefract, 0.001f, 0.0f, 1.0f, "%.3f");
+        changed |=
+            ImGui::DragFloat(Material::valNameValPBRMetallic.c_str(), &mat->valPBRMetallic, 0.001f, 0.0f, 1.0f, "%.3f");
+        changed |= ImGui::DragFloat(Material::valNameValPBRRoughness.c_str(), &mat->valPBRRoughness, 0.001f, 0.0f,
+                                    1.0f, "%.3f");
+        changed |= ImGui::Checkbox("PBR Mode", &mat->valHasPBR);
         ImGui::Checkbox("Two Sided", &mat->twoSided);
         if (ImGui::TreeNode("Alpha Mode"))
         {
-            ImGui::RadioButton("OPAQUE", &mat->alphaMode, 0);
-            ImGui::RadioButton("BLEND", &mat->alphaMode, 1);
-            ImGui::RadioButton("MASK", &mat->alphaMode, 2);
+            changed |= ImGui::RadioButton("OPAQUE", &mat->alphaMode, 0);
+            changed |= ImGui::RadioButton("BLEND", &mat->alphaMode, 1);
+            changed |= ImGui::RadioButton("MASK", &mat->alphaMode, 2);
             ImGui::TreePop();
         }
+        if (changed)
+            mat->MarkChanged();
         ImGui::TreePop();
     }
 }
@@ -313,6 +345,52 @@ void AppContext::UI()
     ImGui::Text("Author: ");
     ImGui::SameLine();
     ImGui::TextColored(ImVec4(0.25f, 1.0f, 0.7f, 1.0f), "teamclouday");
+    if (ImGui::TreeNode("Frame Times"))
+    {
+        _frameTimes.UI();
+        if (ImGui::Button("Dump CSV"))
+            _frameTimes.WriteCSV("frame_times.csv");
+        ImGui::SameLine();
+        if (ImGui::Button("Dump JSON"))
+            WriteFrameStats("frame_stats.json");
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Input Record"))
+    {
+        _inputRecorder.UI();
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Jobs"))
+    {
+        JobSystem::Instance()->UI();
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Device"))
+    {
+        GraphicsDevice::Get().UI();
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Stream Buffers"))
+    {
+        StreamBuffer::UIAll();
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Shader Cache"))
+    {
+        ImGui::Text("Startup: %.3f s", _tStartup);
+        ShaderCache::Instance()->UI();
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Render Stats"))
+    {
+        RenderStats::Instance()->UI();
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("Profiler"))
+    {
+        Profiler::Instance()->UI();
+        ImGui::TreePop();
+    }
 
     ImGui::PopID();
 }
@@ -343,6 +421,13 @@ void Camera::UI()
     if (ImGui::DragFloat3("Center", glm::value_ptr(_centerVec), 0.001f, -10000.0f, 10000.0f, "%.3f"))
         _updated = false;
     ImGui::Text("Distance: %.5f", _dist);
+    if (ImGui::TreeNode("Flythrough"))
+    {
+        if (!_flythrough)
+            _flythrough = std::make_shared<CameraPath>();
+        _flythrough->UI(*this);
+        ImGui::TreePop();
+    }
 
     ImGui::Separator();
 
@@ -386,8 +471,9 @@ void Camera::UI()
     ImGui::Text("Updated: %s", _updated ? "true" : "false");
 
     ImGui::Separator();
-    if (ImGui::DragFloat2("CSM Near Far", glm::value_ptr(_csmNearFar), 0.001f, 0.001f, 1000.0f, "%.3f"))
-        updateCSMDists();
+    auto csmNearFar = _csmNearFar;
+    if (ImGui::DragFloat2("CSM Near Far", glm::value_ptr(csmNearFar), 0.001f, 0.001f, 1000.0f, "%.3f"))
+        SetShadowNearFar(csmNearFar.x, csmNearFar.y);
     if (ImGui::DragFloat2("Omni Near Far", glm::value_ptr(_omniNearFarOffset), 0.001f, 0.001f, 1000.0f, "%.3f"))
         updateOmniData();
     ImGui::DragFloat("Omni Normal Offset", &_omniNearFarOffset.z, 0.0001f, 0.0f, 1.0f, "%.4f");
@@ -691,9 +777,371 @@ void LightManager::UI()
     ImGui::PopID();
 }
 
+void MaterialManager::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::Text("Slots: %d / %d", static_cast<int>(_materialsData.size()), static_cast<int>(_capacity));
+    ImGui::Text("Uploads: %d", static_cast<int>(_numUploads));
+
+    ImGui::PopID();
+}
+
+void DrawBatch::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::Text("Draws: %d", static_cast<int>(_commands.size()));
+    ImGui::Text("Multi-Draws: %d", static_cast<int>(_groups.size()));
+    ImGui::Text("Uploaded: %d", static_cast<int>(_numUploaded));
+
+    ImGui::PopID();
+}
+
+void GPUCuller::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::Checkbox("Hi-Z", &useHiZ);
+    ImGui::Text("Hi-Z: %d x %d (%d levels)", _hiZWidth, _hiZHeight, _hiZLevels);
+    ImGui::Text("Draws: %d", static_cast<int>(_numDraws));
+    ImGui::Text("Multi-Draws: %d", static_cast<int>(_numGroups));
+    if (ImGui::Button("Validate"))
+        validateNext = true;
+    ImGui::SameLine();
+    ImGui::Text("Mismatches: %d", static_cast<int>(_mismatches));
+
+    ImGui::PopID();
+}
+
+void OcclusionCuller::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::Checkbox("SIMD", &useSIMD);
+    ImGui::Text("Resolution: %d x %d", _width, _height);
+    ImGui::Text("Occluders: %d", static_cast<int>(_occluders.size()));
+    ImGui::Text("Triangles: %d", static_cast<int>(_triangles.size()));
+    ImGui::Text("Culled: %d / %d", static_cast<int>(_numCulled), static_cast<int>(_numTested));
+    ImGui::Text("Rasterize: %.3f ms", _lastRasterMs);
+
+    ImGui::PopID();
+}
+
+void TransformSystem::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::Checkbox("SIMD", &useSIMD);
+    ImGui::Text("Transforms: %d", static_cast<int>(_models.size()));
+    ImGui::Text("Updated: %d (%.3f ms)", static_cast<int>(_lastUpdated), _lastUpdateMs);
+
+    ImGui::PopID();
+}
+
+void GraphicsDevice::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::Text("Backend: %s", GetName().c_str());
+    UIShowDeviceStats(_frameStats);
+
+    auto total = GetTotalMemory();
+    if (ImGui::TreeNode("Memory", "Memory (%.2f MB)", total.bytes / double(1 << 20)))
+    {
+        for (auto i = 0u; i < DEVICE_MEMORY_CATEGORIES; ++i)
+        {
+            auto category = static_cast<MemoryCategory>(i);
+            const auto &stats = GetMemoryStats(category);
+            ImGui::Text("%s: %.2f MB (peak %.2f MB, %d allocations)", std::to_string(category).c_str(),
+                        stats.bytes / double(1 << 20), stats.peak / double(1 << 20),
+                        static_cast<int>(stats.allocations));
+        }
+        if (ImGui::TreeNode("Largest"))
+        {
+            auto allocations = GetAllocations();
+            for (size_t i = 0; i < (std::min)(allocations.size(), size_t(32)); ++i)
+            {
+                const auto &allocation = allocations[i];
+                ImGui::Text("%s %s (%d): %.2f MB", std::to_string(allocation.category).c_str(),
+                            allocation.owner ? allocation.owner : "-", static_cast<int>(allocation.id),
+                            allocation.bytes / double(1 << 20));
+            }
+            ImGui::TreePop();
+        }
+        ImGui::TreePop();
+    }
+
+    ImGui::PopID();
+}
+
+void CameraPath::UI(Camera &camera)
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::Text("Keyframes: %d, Duration: %.2fs", static_cast<int>(_keyframes.size()), GetDuration());
+    if (_playing)
+    {
+        ImGui::ProgressBar(GetDuration() > 0.0f ? _time / GetDuration() : 1.0f, ImVec2(200.0f, 0.0f));
+        if (ImGui::Button("Stop"))
+            Stop();
+    }
+    else
+    {
+        static float step = CAMERA_PATH_DEFAULT_STEP;
+        ImGui::DragFloat("Step", &step, 0.0001f, 0.0001f, 1.0f, "%.4f");
+        if (ImGui::Button("Play"))
+            Play(step);
+    }
+    static float interval = 2.0f;
+    ImGui::DragFloat("Interval", &interval, 0.01f, 0.01f, 100.0f, "%.2f");
+    if (ImGui::Button("Add Keyframe"))
+    {
+        CameraKeyframe keyframe;
+        keyframe.time = _keyframes.empty() ? 0.0f : GetDuration() + interval;
+        keyframe.position = camera.GetPosition();
+        keyframe.center = camera.GetCenter();
+        AddKeyframe(keyframe);
+    }
+    static char path[256] = "camera.path";
+    ImGui::InputText("Path", path, sizeof(path));
+    if (ImGui::Button("Load"))
+        Load(path);
+    ImGui::SameLine();
+    if (ImGui::Button("Save"))
+        Save(path);
+
+    for (auto i = 0u; i < _segments.size(); ++i)
+    {
+        const auto &segment = _segments[i];
+        auto summary = segment.frameTimes.Summarize();
+        ImGui::Text("%s: p50 %.2f, p95 %.2f, max %.2f ms (%d)", segment.name.c_str(), summary.p50, summary.p95,
+                    summary.max, static_cast<int>(summary.frames));
+    }
+
+    ImGui::PopID();
+}
+
+void StressScene::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    static StressSceneConfig config;
+    auto dragCount = [](const char *label, unsigned &count) {
+        auto value = static_cast<int>(count);
+        if (ImGui::DragInt(label, &value, 1.0f, 0, 1000000))
+            count = static_cast<unsigned>((std::max)(value, 0));
+    };
+    dragCount("Static Props", config.staticProps);
+    dragCount("Instanced Meshes", config.instancedMeshes);
+    dragCount("Skinned Models", config.skinnedModels);
+    dragCount("Point Lights", config.pointLights);
+    dragCount("Transparent Objects", config.transparentObjects);
+    ImGui::DragFloat("Extent", &config.extent, 0.1f, 1.0f, 10000.0f, "%.1f");
+    ImGui::Checkbox("Static Batch (MDI)", &config.staticBatch);
+    auto seed = static_cast<int>(config.seed);
+    if (ImGui::DragInt("Seed", &seed))
+        config.seed = static_cast<uint32_t>(seed);
+    if (ImGui::Button("Select Skinned Model"))
+        config.skinnedModelPath = Tools::select_file_in_explorer("Select Model File");
+    ImGui::Text("Skinned Model: %s", config.skinnedModelPath.empty() ? "none" : config.skinnedModelPath.c_str());
+    if (ImGui::Button("Build"))
+        Build(config);
+    ImGui::SameLine();
+    if (ImGui::Button("Clear"))
+        Clear();
+    ImGui::Text("Models: %d, Skinned: %d, Lights: %d", static_cast<int>(_scene->models.size()),
+                static_cast<int>(_skinnedModels.size()), static_cast<int>(_lights.size()));
+
+    ImGui::PopID();
+}
+
+void FrameTimes::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::DragInt("Window", &_uiWindow, 1.0f, 10, static_cast<int>(_times.size()));
+    ImGui::DragFloat("Hitch (ms)", &_hitchThreshold, 0.1f, 1.0f, 1000.0f, "%.1f");
+    auto summary = Summarize(static_cast<size_t>(_uiWindow));
+    ImGui::Text("Mean %.2f, P50 %.2f, P95 %.2f, P99 %.2f, Max %.2f (ms)", summary.mean, summary.p50, summary.p95,
+                summary.p99, summary.max);
+    ImGui::Text("Hitches: %d in window, %d of %d frames", static_cast<int>(summary.hitches),
+                static_cast<int>(_hitches), static_cast<int>(_total));
+    auto times = GetFrameTimes(static_cast<size_t>(_uiWindow));
+    if (!times.empty())
+        ImGui::PlotHistogram("Frame (ms)", times.data(), static_cast<int>(times.size()), 0, nullptr, 0.0f,
+                             (std::max)(summary.max, _hitchThreshold * 1.5f), ImVec2(250.0f, 60.0f));
+
+    ImGui::PopID();
+}
+
+void InputRecorder::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    if (IsReplaying())
+    {
+        ImGui::Text("Replaying %s: frame %d%s", _path.c_str(), static_cast<int>(_numFrames),
+                    _replayFinished ? " (finished)" : "");
+    }
+    else if (IsRecording())
+    {
+        ImGui::Text("Recording %s: frame %d", _path.c_str(), static_cast<int>(_numFrames));
+        if (ImGui::Button("Stop"))
+            Stop();
+    }
+    else
+    {
+        static char path[256] = "input.rec";
+        ImGui::InputText("Path", path, sizeof(path));
+        if (ImGui::Button("Record"))
+            StartRecording(path);
+    }
+
+    ImGui::PopID();
+}
+
+void RenderStats::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::Text("Frame");
+    UIShowDeviceStats(_frame);
+    ImGui::Separator();
+    for (auto i = 0u; i < _framePasses.size(); ++i)
+    {
+        const auto &pass = _framePasses[i];
+        ImGui::PushID(static_cast<int>(i));
+        // zero indent means default spacing
+        if (pass.depth)
+            ImGui::Indent(pass.depth * 10.0f);
+        if (ImGui::TreeNode(pass.name.c_str(), "%s (%d draws)", pass.name.c_str(),
+                            static_cast<int>(pass.stats.drawCalls)))
+        {
+            UIShowDeviceStats(pass.stats);
+            ImGui::TreePop();
+        }
+        if (pass.depth)
+            ImGui::Unindent(pass.depth * 10.0f);
+        ImGui::PopID();
+    }
+
+    ImGui::PopID();
+}
+
+void Profiler::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    bool enabled = IsEnabled();
+    if (ImGui::Checkbox("Enabled", &enabled))
+        SetEnabled(enabled);
+    static int captureFrames = 120;
+    ImGui::DragInt("Capture Frames", &captureFrames, 1.0f, 1, 10000);
+    if (ImGui::Button("Capture"))
+        Capture(static_cast<unsigned>(captureFrames));
+    ImGui::SameLine();
+    if (IsCapturing())
+        ImGui::Text("Capturing (%d)", static_cast<int>(_captured.size()));
+    else if (!_captured.empty() && ImGui::Button("Export Trace"))
+        ExportChromeTrace((std::filesystem::current_path() / "RenderItTrace.json").string());
+    ImGui::Text("Dropped GPU Frames: %d", static_cast<int>(_numDropped));
+
+    const auto &frame = _lastFrame;
+    ImGui::Text("Frame %d: %.3f ms", static_cast<int>(frame.index), frame.duration * 1e-3);
+    auto showEvents = [](std::vector<ProfileEvent> events) {
+        std::sort(events.begin(), events.end(), [](const ProfileEvent &a, const ProfileEvent &b) {
+            return a.thread != b.thread ? a.thread < b.thread : a.start < b.start;
+        });
+        for (const auto &event : events)
+            ImGui::Text("[%d] %*s%s: %.3f ms", static_cast<int>(event.thread), static_cast<int>(event.depth * 2), "",
+                        event.name, event.duration * 1e-3);
+    };
+    if (ImGui::TreeNode("CPU"))
+    {
+        showEvents(frame.cpuEvents);
+        ImGui::TreePop();
+    }
+    if (ImGui::TreeNode("GPU"))
+    {
+        if (!frame.gpuResolved)
+            ImGui::Text("No results");
+        showEvents(frame.gpuEvents);
+        ImGui::TreePop();
+    }
+
+    ImGui::PopID();
+}
+
+void JobSystem::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::Text("Workers: %d", static_cast<int>(_workers.size()));
+    ImGui::Text("Queued: %d", static_cast<int>(_numQueued.load()));
+    ImGui::Text("Executed: %d", static_cast<int>(_numExecuted.load()));
+
+    ImGui::PopID();
+}
+
+void StreamBuffer::UI()
+{
+    const std::lock_guard<std::mutex> lock(_mtx);
+    ImGui::PushID(this);
+
+    ImGui::Text("Region Size: %.1f KB (x%d)", _regionSize / 1024.0f, STREAM_BUFFER_REGIONS);
+    ImGui::Text("Frame: %.1f KB", _frameBytes / 1024.0f);
+    ImGui::Text("Peak: %.1f KB", _peakBytes / 1024.0f);
+    ImGui::Text("Stalls: %d", static_cast<int>(_stalls));
+    ImGui::Text("Grows: %d", static_cast<int>(_grows));
+    ImGui::Text("Failed: %d", static_cast<int>(_failed));
+
+    ImGui::PopID();
+}
+
+void ShaderCache::UI()
+{
+    ImGui::PushID(LOGNAME.c_str());
+
+    ImGui::TextWrapped("Directory: %s", IsEnabled() ? _directory.c_str() : "(disabled)");
+    ImGui::Text("Hits: %d (%.2f ms)", static_cast<int>(_stats.hits), _stats.loadMs);
+    ImGui::Text("Misses: %d (%.2f ms)", static_cast<int>(_stats.misses), _stats.compileMs);
+    ImGui::Text("Rejected: %d", static_cast<int>(_stats.rejected));
+    ImGui::Text("Stored: %d", static_cast<int>(_stats.stored));
+    if (IsEnabled() && ImGui::Button("Clear"))
+        Clear();
+
+    ImGui::PopID();
+}
+
+void StreamBuffer::UIAll()
+{
+    ImGui::PushID("StreamBuffers");
+    const auto &buffers = instances();
+    for (size_t i = 0; i < buffers.size(); ++i)
+    {
+        if (ImGui::TreeNode(("Stream Buffer " + std::to_string(i)).c_str()))
+        {
+            buffers[i]->UI();
+            ImGui::TreePop();
+        }
+    }
+    ImGui::PopID();
+}
+
 void Scene::UI()
 {
     ImGui::PushID(LOGNAME.c_str());
+    if (_transformsBuilt && ImGui::TreeNode("Transforms"))
+    {
+        _transforms.UI();
+        ImGui::TreePop();
+    }
+    if (_staticBatch && ImGui::TreeNode("Static Batch"))
+    {
+        _staticBatch->UI();
+        ImGui::TreePop();
+    }
     auto iter = models.begin();
     auto index = 0u;
     while (iter != models.end())
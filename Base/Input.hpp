@@ -14,6 +14,7 @@ namespace RenderIt
 class InputManager
 {
     friend class AppContext;
+    friend class InputRecorder;
 
   public:
     InputManager();
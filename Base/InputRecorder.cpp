@@ -0,0 +1,182 @@
+#include "InputRecorder.hpp"
+#include "Input.hpp"
+#include "Tools.hpp"
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace RenderIt
+{
+
+/// Write value as raw bytes
+template <typename T> static void write_value(std::ofstream &file, const T &value)
+{
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/// Read value from raw bytes, returns false at end of file
+template <typename T> static bool read_value(std::ifstream &file, T &value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+InputRecorder::InputRecorder() : _numFrames(0), _tStart(0.0), _headerWritten(false), _replayFinished(false)
+{
+}
+
+InputRecorder::~InputRecorder()
+{
+    Stop();
+}
+
+bool InputRecorder::StartRecording(const std::string &path)
+{
+    Stop();
+    _output.open(path, std::ios::binary);
+    if (!_output.is_open())
+    {
+        Tools::display_message(LOGNAME, "Failed to record input to " + path, Tools::MessageType::WARN);
+        return false;
+    }
+    _path = path;
+    return true;
+}
+
+bool InputRecorder::StartReplay(const std::string &path)
+{
+    Stop();
+    _input.open(path, std::ios::binary);
+    uint32_t magic = 0, version = 0;
+    if (!_input.is_open() || !read_value(_input, magic) || !read_value(_input, version) ||
+        !read_value(_input, _tStart) || magic != INPUT_RECORD_MAGIC || version != INPUT_RECORD_VERSION)
+    {
+        Tools::display_message(LOGNAME, "Failed to replay input from " + path, Tools::MessageType::WARN);
+        _input.close();
+        return false;
+    }
+    _path = path;
+    return true;
+}
+
+void InputRecorder::Stop()
+{
+    if (_output.is_open())
+    {
+        _output.close();
+        Tools::display_message(LOGNAME, std::to_string(_numFrames) + " frames recorded to " + _path,
+                               Tools::MessageType::INFO);
+    }
+    if (_input.is_open())
+        _input.close();
+    _numFrames = 0;
+    _headerWritten = false;
+    _replayFinished = false;
+}
+
+bool InputRecorder::IsRecording() const
+{
+    return _output.is_open();
+}
+
+bool InputRecorder::IsReplaying() const
+{
+    return _input.is_open();
+}
+
+bool InputRecorder::IsReplayFinished() const
+{
+    return _replayFinished;
+}
+
+uint32_t InputRecorder::GetNumFrames() const
+{
+    return _numFrames;
+}
+
+double InputRecorder::GetStartTime() const
+{
+    return _tStart;
+}
+
+void InputRecorder::RecordFrame(float deltaTime, double frameEndTime)
+{
+    if (!IsRecording())
+        return;
+    if (!_headerWritten)
+    {
+        _tStart = frameEndTime - deltaTime;
+        write_value(_output, INPUT_RECORD_MAGIC);
+        write_value(_output, INPUT_RECORD_VERSION);
+        write_value(_output, _tStart);
+        _headerWritten = true;
+    }
+    auto input = InputManager::Instance();
+    const std::lock_guard<std::mutex> lock(input->_mtx);
+    write_value(_output, deltaTime);
+    write_value(_output, frameEndTime);
+    write_value(_output, input->_mousePosData);
+    write_value(_output, input->_wheelData);
+    // bits 0-2 mouse down, 3-5 mouse pressed, 6 wheel reset
+    uint8_t mouseFlags = input->_resetMouseWheel ? 64 : 0;
+    for (auto i = 0; i < 3; ++i)
+        mouseFlags |= (input->_mouseDown[i] ? 1 : 0) << i | (input->_mouseDown_acc[i] ? 1 : 0) << (i + 3);
+    write_value(_output, mouseFlags);
+    // only keys down or pressed, bit 0 down, bit 1 pressed
+    std::vector<std::pair<int16_t, uint8_t>> keys;
+    for (const auto &[key, down] : input->_keyStates)
+    {
+        auto pressed = input->_keyStates_acc.count(key) && input->_keyStates_acc[key];
+        if (down || pressed)
+            keys.push_back({static_cast<int16_t>(key), static_cast<uint8_t>((down ? 1 : 0) | (pressed ? 2 : 0))});
+    }
+    write_value(_output, static_cast<uint16_t>(keys.size()));
+    for (const auto &[key, flags] : keys)
+    {
+        write_value(_output, key);
+        write_value(_output, flags);
+    }
+    ++_numFrames;
+}
+
+bool InputRecorder::ReplayFrame(float &deltaTime, double &frameEndTime)
+{
+    if (!IsReplaying() || _replayFinished)
+        return false;
+    std::array<float, 2> mousePos, wheel;
+    uint8_t mouseFlags = 0;
+    uint16_t numKeys = 0;
+    if (!read_value(_input, deltaTime) || !read_value(_input, frameEndTime) || !read_value(_input, mousePos) ||
+        !read_value(_input, wheel) || !read_value(_input, mouseFlags) || !read_value(_input, numKeys))
+    {
+        _replayFinished = true;
+        Tools::display_message(LOGNAME, std::to_string(_numFrames) + " frames replayed from " + _path,
+                               Tools::MessageType::INFO);
+        return false;
+    }
+    auto input = InputManager::Instance();
+    const std::lock_guard<std::mutex> lock(input->_mtx);
+    input->_mousePosData = mousePos;
+    input->_wheelData = wheel;
+    input->_resetMouseWheel = mouseFlags & 64;
+    for (auto i = 0; i < 3; ++i)
+    {
+        input->_mouseDown[i] = (mouseFlags >> i) & 1;
+        input->_mouseDown_acc[i] = (mouseFlags >> (i + 3)) & 1;
+    }
+    input->_keyStates.clear();
+    input->_keyStates_acc.clear();
+    for (uint16_t i = 0; i < numKeys; ++i)
+    {
+        int16_t key = 0;
+        uint8_t flags = 0;
+        if (!read_value(_input, key) || !read_value(_input, flags))
+            break;
+        input->_keyStates[key] = flags & 1;
+        input->_keyStates_acc[key] = flags & 2;
+    }
+    ++_numFrames;
+    return true;
+}
+
+} // namespace RenderIt
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#define INPUT_RECORD_MAGIC 0x49544952u // "RITI"
+#define INPUT_RECORD_VERSION 1u
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Records per-frame InputManager state & frame times to binary file, and replays them
+/// Replayed frames overwrite live input, so camera paths & animations repeat exactly
+/// File: header (magic, version, start time), then per frame
+/// delta, end time, mouse position, wheel, mouse flags, key count & (key, flags) of active keys
+class InputRecorder
+{
+  public:
+    InputRecorder();
+
+    ~InputRecorder();
+
+    /// Start writing frames to file, returns false if failed
+    bool StartRecording(const std::string &path);
+
+    /// Start reading frames from file, returns false if failed
+    bool StartReplay(const std::string &path);
+
+    /// Close file of recording or replay
+    void Stop();
+
+    /// Whether recording
+    bool IsRecording() const;
+
+    /// Whether replaying
+    bool IsReplaying() const;
+
+    /// Whether replay ran out of frames
+    bool IsReplayFinished() const;
+
+    /// Get number of recorded or replayed frames
+    uint32_t GetNumFrames() const;
+
+    /// Get frame end time before first frame (seconds)
+    double GetStartTime() const;
+
+    /// Write input state & times of finished frame
+    void RecordFrame(float deltaTime, double frameEndTime);
+
+    /// Apply input state & times of next frame, returns false if replay ended
+    bool ReplayFrame(float &deltaTime, double &frameEndTime);
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "InputRecorder";
+
+  private:
+    std::ofstream _output;
+    std::ifstream _input;
+    std::string _path;
+    uint32_t _numFrames;
+    double _tStart;
+    bool _headerWritten;
+    bool _replayFinished;
+};
+
+} // namespace RenderIt
@@ -0,0 +1,104 @@
+#include "Instances.hpp"
+#include "Device.hpp"
+#include "Tools.hpp"
+
+#include <algorithm>
+
+namespace RenderIt
+{
+
+InstanceBuffer::InstanceBuffer(size_t capacity) : _capacity(0), _dirtyBegin(0), _dirtyEnd(0)
+{
+    _instancesSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
+    allocate(std::max(capacity, size_t(1)));
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+    _instancesSSBO = nullptr;
+}
+
+void InstanceBuffer::Resize(size_t count)
+{
+    auto oldCount = _instances.size();
+    _instances.resize(count, {glm::mat4(1.0f), glm::mat4(1.0f), glm::vec4(0.0f)});
+    if (count > _capacity)
+    {
+        auto capacity = _capacity;
+        while (capacity < count)
+            capacity *= 2;
+        allocate(capacity);
+        // new storage holds no data
+        markDirty(0, count);
+    }
+    else if (count > oldCount)
+        markDirty(oldCount, count);
+}
+
+void InstanceBuffer::Set(size_t idx, const glm::mat4 &matrix, const glm::vec4 &attribute)
+{
+    if (idx >= _instances.size())
+        return;
+    auto &instance = _instances[idx];
+    // skip inverse & upload of unchanged instances
+    if (instance.matrix == matrix && instance.attribute == attribute)
+        return;
+    instance.matrix = matrix;
+    instance.matrixInv = Tools::affineInverse(matrix);
+    instance.attribute = attribute;
+    markDirty(idx, idx + 1);
+}
+
+void InstanceBuffer::Set(size_t idx, const Transform &transform, const glm::vec4 &attribute)
+{
+    if (idx >= _instances.size())
+        return;
+    auto &instance = _instances[idx];
+    if (instance.matrix == transform.matrix && instance.attribute == attribute)
+        return;
+    instance.matrix = transform.matrix;
+    instance.matrixInv = transform.matrixInv;
+    instance.attribute = attribute;
+    markDirty(idx, idx + 1);
+}
+
+void InstanceBuffer::Bind(unsigned binding) const
+{
+    _dirtyEnd = std::min(_dirtyEnd, _instances.size());
+    if (_dirtyBegin < _dirtyEnd)
+    {
+        _instancesSSBO->Bind();
+        GraphicsDevice::Get().BufferSubData(_instancesSSBO->type, _dirtyBegin * sizeof(InstanceData),
+                                            (_dirtyEnd - _dirtyBegin) * sizeof(InstanceData),
+                                            _instances.data() + _dirtyBegin);
+        _instancesSSBO->UnBind();
+    }
+    _dirtyBegin = _dirtyEnd = 0;
+    _instancesSSBO->BindBase(binding);
+}
+
+void InstanceBuffer::UnBind(unsigned binding) const
+{
+    _instancesSSBO->UnBindBase(binding);
+}
+
+size_t InstanceBuffer::GetCount() const
+{
+    return _instances.size();
+}
+
+void InstanceBuffer::markDirty(size_t begin, size_t end)
+{
+    _dirtyBegin = _dirtyBegin < _dirtyEnd ? std::min(_dirtyBegin, begin) : begin;
+    _dirtyEnd = std::max(_dirtyEnd, end);
+}
+
+void InstanceBuffer::allocate(size_t capacity)
+{
+    _capacity = capacity;
+    _instancesSSBO->Bind();
+    GraphicsDevice::Get().BufferData(_instancesSSBO->type, _capacity * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW);
+    _instancesSSBO->UnBind();
+}
+
+} // namespace RenderIt
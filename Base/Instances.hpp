@@ -0,0 +1,90 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GLStructs.hpp"
+#include "Transform.hpp"
+
+#define INSTANCES_SSBO_BINDING 6
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Per-instance data in std430 layout, fetched with gl_InstanceID
+struct InstanceData
+{
+    glm::mat4 matrix;
+    glm::mat4 matrixInv;
+    glm::vec4 attribute;
+};
+
+/// Per-instance transforms & attributes for instanced drawing
+/// Shaders must include BlockSource and declare
+/// uniform bool val_INSTANCED;
+/// and use instances[gl_InstanceID].matrix instead of model matrix if val_INSTANCED
+class InstanceBuffer
+{
+  public:
+    InstanceBuffer(size_t capacity = 64);
+
+    ~InstanceBuffer();
+
+    /// Set number of instances, grows buffer if needed
+    void Resize(size_t count);
+
+    /// Set instance data by world matrix, unchanged instances are not uploaded again
+    void Set(size_t idx, const glm::mat4 &matrix, const glm::vec4 &attribute = glm::vec4(0.0f));
+
+    /// Set instance data by transform
+    void Set(size_t idx, const Transform &transform, const glm::vec4 &attribute = glm::vec4(0.0f));
+
+    /// Upload changed instances and bind instance data
+    void Bind(unsigned binding = INSTANCES_SSBO_BINDING) const;
+
+    /// Unbind instance data
+    void UnBind(unsigned binding = INSTANCES_SSBO_BINDING) const;
+
+    /// Get number of instances
+    size_t GetCount() const;
+
+  public:
+    const std::string LOGNAME = "InstanceBuffer";
+
+    inline static const std::string ShaderInstancedName = "val_INSTANCED";
+
+    /// GLSL declaration of instance data, insert after #version
+    inline static const std::string BlockSource = R"(
+        struct InstanceData
+        {
+            mat4 matrix;
+            mat4 matrixInv;
+            vec4 attribute;
+        };
+        layout(std430, binding = 6) readonly buffer InstancesData
+        {
+            InstanceData instances[];
+        };
+    )";
+
+  private:
+    /// Allocate SSBO of capacity
+    void allocate(size_t capacity);
+
+    /// Extend range of instances to upload
+    void markDirty(size_t begin, size_t end);
+
+  private:
+    std::unique_ptr<SBuffer> _instancesSSBO;
+    std::vector<InstanceData> _instances;
+    size_t _capacity;
+    // range of instances changed since last upload
+    mutable size_t _dirtyBegin, _dirtyEnd;
+};
+
+} // namespace RenderIt
@@ -0,0 +1,289 @@
+#include "Jobs.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace RenderIt
+{
+
+// worker index of calling thread in its job system, -1 for other threads
+static thread_local int tls_workerIndex = -1;
+static thread_local const JobSystem *tls_workerOwner = nullptr;
+
+bool JobCounter::IsDone() const
+{
+    return _count.load() <= 0;
+}
+
+#pragma region scratch
+
+ScratchAllocator::ScratchAllocator(size_t blockSize) : _blockSize(blockSize), _block(0), _offset(0)
+{
+}
+
+void *ScratchAllocator::Allocate(size_t size, size_t alignment)
+{
+    alignment = std::max(alignment, size_t(1));
+    while (true)
+    {
+        if (_block >= _blocks.size())
+        {
+            auto capacity = std::max(_blockSize, size + alignment);
+            _blocks.emplace_back(std::make_unique<unsigned char[]>(capacity), capacity);
+        }
+        auto &[data, capacity] = _blocks[_block];
+        auto base = reinterpret_cast<uintptr_t>(data.get());
+        auto aligned = ((base + _offset + alignment - 1) / alignment) * alignment - base;
+        if (aligned + size <= capacity)
+        {
+            _offset = aligned + size;
+            return data.get() + aligned;
+        }
+        // continue in next block, insert a larger one if it cannot hold the allocation
+        ++_block;
+        _offset = 0;
+        if (_block < _blocks.size() && _blocks[_block].second < size + alignment)
+        {
+            auto capacity = std::max(_blockSize, size + alignment);
+            _blocks.emplace(_blocks.begin() + _block, std::make_unique<unsigned char[]>(capacity), capacity);
+        }
+    }
+}
+
+ScratchAllocator::Marker ScratchAllocator::GetMarker() const
+{
+    return {_block, _offset};
+}
+
+void ScratchAllocator::Release(const Marker &marker)
+{
+    _block = marker.first;
+    _offset = marker.second;
+}
+
+void ScratchAllocator::Reset()
+{
+    _block = 0;
+    _offset = 0;
+}
+
+ScratchScope::ScratchScope() : _scratch(JobSystem::GetScratch()), _marker(_scratch.GetMarker())
+{
+}
+
+ScratchScope::~ScratchScope()
+{
+    _scratch.Release(_marker);
+}
+
+ScratchAllocator &ScratchScope::Get()
+{
+    return _scratch;
+}
+
+#pragma endregion scratch
+
+JobSystem::JobSystem(unsigned numWorkers)
+    : _nextWorker(0), _numQueued(0), _numExecuted(0), _stop(false)
+{
+    if (!numWorkers)
+        numWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+    for (auto i = 0u; i < numWorkers; ++i)
+        _workers.push_back(std::make_unique<Worker>());
+    for (auto i = 0u; i < numWorkers; ++i)
+        _threads.emplace_back(&JobSystem::workerLoop, this, static_cast<int>(i));
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMtx);
+        _stop = true;
+    }
+    _sleepCV.notify_all();
+    for (auto &thread : _threads)
+        thread.join();
+}
+
+std::shared_ptr<JobSystem> JobSystem::Instance()
+{
+    static auto jobs = std::make_shared<JobSystem>();
+    return jobs;
+}
+
+std::shared_ptr<JobCounter> JobSystem::Run(Job job, const std::shared_ptr<JobCounter> &dependency)
+{
+    auto counter = std::make_shared<JobCounter>();
+    counter->_count = 1;
+    Task task{std::move(job), counter};
+    if (dependency)
+        pushAfter(std::move(task), dependency);
+    else
+        push(std::move(task));
+    return counter;
+}
+
+std::shared_ptr<JobCounter> JobSystem::ParallelFor(size_t begin, size_t end, size_t grain,
+                                                   std::function<void(size_t, size_t)> func,
+                                                   const std::shared_ptr<JobCounter> &dependency)
+{
+    auto counter = std::make_shared<JobCounter>();
+    if (end <= begin)
+        return counter;
+    grain = std::max(grain, size_t(1));
+    auto numChunks = (end - begin + grain - 1) / grain;
+    counter->_count = static_cast<int>(numChunks);
+    for (auto chunk = begin; chunk < end; chunk += grain)
+    {
+        auto chunkEnd = std::min(chunk + grain, end);
+        Task task{[func, chunk, chunkEnd]() { func(chunk, chunkEnd); }, counter};
+        if (dependency)
+            pushAfter(std::move(task), dependency);
+        else
+            push(std::move(task));
+    }
+    return counter;
+}
+
+void JobSystem::Wait(const std::shared_ptr<JobCounter> &counter)
+{
+    if (!counter)
+        return;
+    int self = tls_workerOwner == this ? tls_workerIndex : -1;
+    while (!counter->IsDone())
+    {
+        Task task;
+        if (pop(task, self))
+            execute(task);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::RunOnMainThread(Job job)
+{
+    std::lock_guard<std::mutex> lock(_mainMtx);
+    _mainJobs.push_back(std::move(job));
+}
+
+void JobSystem::ProcessMainThread()
+{
+    std::vector<Job> jobs;
+    {
+        std::lock_guard<std::mutex> lock(_mainMtx);
+        jobs.swap(_mainJobs);
+    }
+    for (auto &job : jobs)
+        job();
+}
+
+size_t JobSystem::GetNumWorkers() const
+{
+    return _workers.size();
+}
+
+ScratchAllocator &JobSystem::GetScratch()
+{
+    thread_local ScratchAllocator scratch;
+    return scratch;
+}
+
+void JobSystem::push(Task task)
+{
+    size_t idx = tls_workerOwner == this && tls_workerIndex >= 0 ? static_cast<size_t>(tls_workerIndex)
+                                                                   : _nextWorker++ % _workers.size();
+    ++_numQueued;
+    {
+        std::lock_guard<std::mutex> lock(_workers[idx]->mtx);
+        _workers[idx]->tasks.push_back(std::move(task));
+    }
+    // taking sleep lock orders push before wait of a worker that just found no task, so wakeup is not lost
+    {
+        std::lock_guard<std::mutex> lock(_sleepMtx);
+    }
+    _sleepCV.notify_one();
+}
+
+void JobSystem::pushAfter(Task task, const std::shared_ptr<JobCounter> &dependency)
+{
+    {
+        std::lock_guard<std::mutex> lock(dependency->_mtx);
+        if (!dependency->IsDone())
+        {
+            dependency->_continuations.push_back(
+                [this, task = std::move(task)]() mutable { push(std::move(task)); });
+            return;
+        }
+    }
+    push(std::move(task));
+}
+
+bool JobSystem::pop(Task &task, int self)
+{
+    auto numWorkers = static_cast<int>(_workers.size());
+    if (self >= 0)
+    {
+        auto &worker = *_workers[self];
+        std::lock_guard<std::mutex> lock(worker.mtx);
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            --_numQueued;
+            return true;
+        }
+    }
+    // steal oldest task, starting after own deque
+    for (int i = 1; i <= numWorkers; ++i)
+    {
+        auto &worker = *_workers[(std::max(self, 0) + i) % numWorkers];
+        std::lock_guard<std::mutex> lock(worker.mtx);
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+            --_numQueued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(Task &task)
+{
+    {
+        PROFILE_SCOPE("Job");
+        task.job();
+    }
+    ++_numExecuted;
+    auto counter = std::move(task.counter);
+    if (counter->_count.fetch_sub(1) != 1)
+        return;
+    std::vector<Job> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->_mtx);
+        continuations.swap(counter->_continuations);
+    }
+    for (auto &continuation : continuations)
+        continuation();
+}
+
+void JobSystem::workerLoop(int self)
+{
+    tls_workerIndex = self;
+    tls_workerOwner = this;
+    while (!_stop)
+    {
+        Task task;
+        if (pop(task, self))
+        {
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_sleepMtx);
+        _sleepCV.wait(lock, [this]() { return _stop || _numQueued > 0; });
+    }
+}
+
+} // namespace RenderIt
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define JOBS_SCRATCH_BLOCK_SIZE (1u << 20)
+
+/** @file */
+
+namespace RenderIt
+{
+
+using Job = std::function<void()>;
+
+/// Number of unfinished jobs of a group, continuations run when it drops to 0
+class JobCounter
+{
+    friend class JobSystem;
+
+  public:
+    /// Whether all jobs are finished
+    bool IsDone() const;
+
+  private:
+    std::atomic<int> _count{0};
+    std::mutex _mtx;
+    std::vector<Job> _continuations;
+};
+
+/// Linear per-thread allocator for temporary data of jobs
+/// Memory is released in bulk with markers, no destructors are run
+class ScratchAllocator
+{
+  public:
+    /// Position to release back to
+    using Marker = std::pair<size_t, size_t>;
+
+    ScratchAllocator(size_t blockSize = JOBS_SCRATCH_BLOCK_SIZE);
+
+    /// Allocate bytes, valid until released
+    void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /// Allocate array of trivially destructible type
+    template <typename T> T *Allocate(size_t count)
+    {
+        return static_cast<T *>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /// Get current position
+    Marker GetMarker() const;
+
+    /// Release everything allocated after marker
+    void Release(const Marker &marker);
+
+    /// Release everything
+    void Reset();
+
+  private:
+    size_t _blockSize;
+    std::vector<std::pair<std::unique_ptr<unsigned char[]>, size_t>> _blocks;
+    size_t _block, _offset;
+};
+
+/// Releases allocations of thread scratch made within scope
+class ScratchScope
+{
+  public:
+    ScratchScope();
+
+    ~ScratchScope();
+
+    /// Get scratch allocator of scope
+    ScratchAllocator &Get();
+
+  private:
+    ScratchAllocator &_scratch;
+    ScratchAllocator::Marker _marker;
+};
+
+/// Work-stealing job scheduler
+/// Each worker owns a deque, pops newest jobs itself and steals oldest jobs of others
+/// Jobs that need the GL context go to the main thread queue, processed at end of frame
+class JobSystem
+{
+  public:
+    JobSystem(unsigned numWorkers = 0);
+
+    ~JobSystem();
+
+    /// Get singleton
+    static std::shared_ptr<JobSystem> Instance();
+
+    /// Schedule job, runs after dependency finished if set
+    std::shared_ptr<JobCounter> Run(Job job, const std::shared_ptr<JobCounter> &dependency = nullptr);
+
+    /// Split [begin, end) into chunks of grain & schedule func(chunkBegin, chunkEnd) for each
+    std::shared_ptr<JobCounter> ParallelFor(size_t begin, size_t end, size_t grain,
+                                            std::function<void(size_t, size_t)> func,
+                                            const std::shared_ptr<JobCounter> &dependency = nullptr);
+
+    /// Wait for counter, calling thread runs pending jobs meanwhile
+    void Wait(const std::shared_ptr<JobCounter> &counter);
+
+    /// Schedule job on main thread
+    void RunOnMainThread(Job job);
+
+    /// Run queued main thread jobs, called by AppContext::LoopEndFrame
+    void ProcessMainThread();
+
+    /// Get number of worker threads
+    size_t GetNumWorkers() const;
+
+    /// Get scratch allocator of calling thread
+    static ScratchAllocator &GetScratch();
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "JobSystem";
+
+  private:
+    /// Job with counter to signal once finished
+    struct Task
+    {
+        Job job;
+        std::shared_ptr<JobCounter> counter;
+    };
+
+    /// Deque of a worker
+    struct Worker
+    {
+        std::deque<Task> tasks;
+        std::mutex mtx;
+    };
+
+    /// Push task to deque of calling worker, or round robin from other threads
+    void push(Task task);
+
+    /// Schedule task once counter finished
+    void pushAfter(Task task, const std::shared_ptr<JobCounter> &dependency);
+
+    /// Pop own newest task or steal oldest task of other workers
+    bool pop(Task &task, int self);
+
+    /// Run task & signal its counter
+    void execute(Task &task);
+
+    /// Worker thread loop
+    void workerLoop(int self);
+
+  private:
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread> _threads;
+    std::atomic<size_t> _nextWorker;
+    std::atomic<size_t> _numQueued;
+    std::atomic<size_t> _numExecuted;
+    std::atomic<bool> _stop;
+    std::mutex _sleepMtx;
+    std::condition_variable _sleepCV;
+
+    std::mutex _mainMtx;
+    std::vector<Job> _mainJobs;
+};
+
+} // namespace RenderIt
@@ -1,4 +1,9 @@
 #include "Lights.hpp"
+#include "Device.hpp"
+#include "FrameConstants.hpp"
+#include "RenderStats.hpp"
+#include "StreamBuffer.hpp"
+#include "Tools.hpp"
 
 #include <cstring>
 
@@ -13,13 +18,9 @@ LightManager::LightManager()
     _pointLights.reserve(LIGHTS_MAX_POINT_LIGHTS);
     _spotLights.reserve(LIGHTS_MAX_SPOT_LIGHTS);
 
-    _lightsSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
-    _lightsSSBO->Bind();
-    glBufferData(_lightsSSBO->type,
-                 LIGHTS_MAX_DIR_LIGHTS * sizeof(DirLight) + LIGHTS_MAX_POINT_LIGHTS * sizeof(PointLight) +
-                     LIGHTS_MAX_SPOT_LIGHTS * sizeof(SpotLight) + 3 * sizeof(unsigned),
-                 nullptr, GL_DYNAMIC_DRAW);
-    _lightsSSBO->UnBind();
+    _lightsData.resize(LIGHTS_MAX_DIR_LIGHTS * sizeof(DirLight) + LIGHTS_MAX_POINT_LIGHTS * sizeof(PointLight) +
+                           LIGHTS_MAX_SPOT_LIGHTS * sizeof(SpotLight) + 3 * sizeof(unsigned),
+                       0);
 
     prepareDrawData();
 }
@@ -38,55 +39,58 @@ void LightManager::Update(bool updateAllLights)
     updateSSBO();
 }
 
-void LightManager::DrawLights(const glm::mat4 &matProjView, const glm::vec3 &cameraPos) const
+void LightManager::DrawLights() const
 {
     std::shared_ptr<Mesh> mesh = _drawModel->GetMesh(0);
-    if (!mesh)
+    if (!mesh || !_drawShader->Poll(true))
         return;
+    RENDER_PASS("Lights");
     _drawShader->Bind();
-    _drawShader->UniformMat4("mProjView", matProjView);
     _drawShader->UniformFloat("vLightScale", lightDrawScale);
-    _drawShader->UniformVec3("vCameraPos", cameraPos);
     BindLights(0);
+    auto &device = GraphicsDevice::Get();
     auto VAO = mesh->GetVertexArray().value();
-    auto count = mesh->GetNumIndices();
-    glBindVertexArray(VAO);
+    auto count = static_cast<GLsizei>(mesh->GetNumIndices());
+    device.BindVertexArray(VAO);
     // dir lights
     if (drawDirLights && !_dirLights.empty() && mesh)
     {
-        auto hasDepth = glIsEnabled(GL_DEPTH_TEST);
-        glDisable(GL_DEPTH_TEST);
+        auto hasDepth = device.IsEnabled(GL_DEPTH_TEST);
+        device.SetEnabled(GL_DEPTH_TEST, false);
         _drawShader->UniformInt("vLightType", 0);
-        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, 0,
-                                static_cast<GLsizei>(_dirLights.size()));
+        device.DrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(_dirLights.size()));
         if (hasDepth)
-            glEnable(GL_DEPTH_TEST);
+            device.SetEnabled(GL_DEPTH_TEST, true);
     }
     if (drawPointLights && !_pointLights.empty() && mesh)
     {
         _drawShader->UniformInt("vLightType", 1);
-        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, 0,
-                                static_cast<GLsizei>(_pointLights.size()));
+        device.DrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(_pointLights.size()));
     }
     if (drawSpotLights && !_spotLights.empty() && mesh)
     {
         _drawShader->UniformInt("vLightType", 2);
-        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, 0,
-                                static_cast<GLsizei>(_spotLights.size()));
+        device.DrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(_spotLights.size()));
     }
-    glBindVertexArray(0);
+    device.BindVertexArray(0);
     UnBindLights(0);
     _drawShader->UnBind();
 }
 
 void LightManager::BindLights(unsigned binding) const
 {
-    _lightsSSBO->BindBase(binding);
+    auto stream = StreamBuffer::Instance();
+    if (!_lightsRangeValid || !_lightsRange.data || _lightsRange.frame != stream->GetFrame())
+    {
+        _lightsRange = stream->Upload(_lightsData.data(), _lightsData.size());
+        _lightsRangeValid = true;
+    }
+    _lightsRange.BindRange(GL_SHADER_STORAGE_BUFFER, binding);
 }
 
 void LightManager::UnBindLights(unsigned binding) const
 {
-    _lightsSSBO->UnBindBase(binding);
+    GraphicsDevice::Get().BindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
 }
 
 bool LightManager::PushLight(LightType type)
@@ -245,59 +249,30 @@ size_t LightManager::GetNumLights(LightType type) const
 
 void LightManager::updateSSBO()
 {
+    auto data = _lightsData.data();
+    _lightsRangeValid &= _dirLightsSSBOUpdated && _pointLightsSSBOUpdated && _spotLightsSSBOUpdated;
     if (!_dirLightsSSBOUpdated)
     {
-        auto offset = 0;
-        _lightsSSBO->Bind();
-        auto sizePtr = reinterpret_cast<unsigned *>(
-            glMapBufferRange(_lightsSSBO->type, offset, sizeof(unsigned), GL_MAP_WRITE_BIT));
-        *sizePtr = static_cast<unsigned>(_dirLights.size());
-        glUnmapBuffer(_lightsSSBO->type);
-        if (!_dirLights.empty())
-        {
-            auto numBytes = _dirLights.size() * sizeof(DirLight);
-            auto dataPtr = glMapBufferRange(_lightsSSBO->type, offset + sizeof(unsigned), numBytes, GL_MAP_WRITE_BIT);
-            std::memcpy(dataPtr, _dirLights.data(), numBytes);
-            glUnmapBuffer(_lightsSSBO->type);
-        }
-        _lightsSSBO->UnBind();
+        auto size = static_cast<unsigned>(_dirLights.size());
+        std::memcpy(data, &size, sizeof(unsigned));
+        std::memcpy(data + sizeof(unsigned), _dirLights.data(), size * sizeof(DirLight));
         _dirLightsSSBOUpdated = true;
     }
     if (!_pointLightsSSBOUpdated)
     {
         auto offset = sizeof(unsigned) + LIGHTS_MAX_DIR_LIGHTS * sizeof(DirLight);
-        _lightsSSBO->Bind();
-        auto sizePtr = reinterpret_cast<unsigned *>(
-            glMapBufferRange(_lightsSSBO->type, offset, sizeof(unsigned), GL_MAP_WRITE_BIT));
-        *sizePtr = static_cast<unsigned>(_pointLights.size());
-        glUnmapBuffer(_lightsSSBO->type);
-        if (!_pointLights.empty())
-        {
-            auto numBytes = _pointLights.size() * sizeof(PointLight);
-            auto dataPtr = glMapBufferRange(_lightsSSBO->type, offset + sizeof(unsigned), numBytes, GL_MAP_WRITE_BIT);
-            std::memcpy(dataPtr, _pointLights.data(), numBytes);
-            glUnmapBuffer(_lightsSSBO->type);
-        }
-        _lightsSSBO->UnBind();
+        auto size = static_cast<unsigned>(_pointLights.size());
+        std::memcpy(data + offset, &size, sizeof(unsigned));
+        std::memcpy(data + offset + sizeof(unsigned), _pointLights.data(), size * sizeof(PointLight));
         _pointLightsSSBOUpdated = true;
     }
     if (!_spotLightsSSBOUpdated)
     {
         auto offset = 2 * sizeof(unsigned) + LIGHTS_MAX_DIR_LIGHTS * sizeof(DirLight) +
                       LIGHTS_MAX_POINT_LIGHTS * sizeof(PointLight);
-        _lightsSSBO->Bind();
-        auto sizePtr = reinterpret_cast<unsigned *>(
-            glMapBufferRange(_lightsSSBO->type, offset, sizeof(unsigned), GL_MAP_WRITE_BIT));
-        *sizePtr = static_cast<unsigned>(_spotLights.size());
-        glUnmapBuffer(_lightsSSBO->type);
-        if (!_spotLights.empty())
-        {
-            auto numBytes = _spotLights.size() * sizeof(SpotLight);
-            auto dataPtr = glMapBufferRange(_lightsSSBO->type, offset + sizeof(unsigned), numBytes, GL_MAP_WRITE_BIT);
-            std::memcpy(dataPtr, _spotLights.data(), numBytes);
-            glUnmapBuffer(_lightsSSBO->type);
-        }
-        _lightsSSBO->UnBind();
+        auto size = static_cast<unsigned>(_spotLights.size());
+        std::memcpy(data + offset, &size, sizeof(unsigned));
+        std::memcpy(data + offset + sizeof(unsigned), _spotLights.data(), size * sizeof(SpotLight));
         _spotLightsSSBOUpdated = true;
     }
 }
@@ -305,15 +280,12 @@ void LightManager::updateSSBO()
 void LightManager::prepareDrawData()
 {
     // load shaders
-    std::string vertSource = R"(
-        #version 450 core
+    std::string vertSource = "#version 450 core\n" + FrameConstants::BlockSource + R"(
         layout(location = 0) in vec3 inPos;
         layout(location = 0) out vec3 vertColor;
 
-        uniform mat4 mProjView;
         uniform int vLightType;
         uniform float vLightScale;
-        uniform vec3 vCameraPos;
 
         struct DirLight
         {
@@ -371,7 +343,7 @@ void LightManager::prepareDrawData()
             if (vLightType == LIGHT_TYPE_DIR)
             {
                 DirLight light = dirLights[gl_InstanceID];
-                pos.xyz += vCameraPos + vec3(light.dir[0], light.dir[1], light.dir[2]);
+                pos.xyz += vec_CameraPos.xyz + vec3(light.dir[0], light.dir[1], light.dir[2]);
                 vertColor = vec3(light.color[0], light.color[1], light.color[2]) * light.intensity;
             }
             else if (vLightType == LIGHT_TYPE_POINT)
@@ -386,7 +358,7 @@ void LightManager::prepareDrawData()
                 pos.xyz += vec3(light.pos[0], light.pos[1], light.pos[2]);
                 vertColor = vec3(light.color[0], light.color[1], light.color[2]) * light.intensity;
             }
-            gl_Position = mProjView * pos;
+            gl_Position = mat_ProjView * pos;
         }
     )";
     std::string fragSource = R"(
@@ -398,7 +370,8 @@ void LightManager::prepareDrawData()
     _drawShader = std::make_unique<Shader>();
     _drawShader->AddSource(vertSource, GL_VERTEX_SHADER);
     _drawShader->AddSource(fragSource, GL_FRAGMENT_SHADER);
-    _drawShader->Compile();
+    // compiled while model loads, finished on first draw
+    Tools::compile_shaders_parallel({_drawShader.get()}, false);
     // load models
     _drawModel = std::make_unique<Model>();
     _drawModel->Load(MeshShape::Cube);
@@ -8,6 +8,7 @@
 #include "GLStructs.hpp"
 #include "Model.hpp"
 #include "Shader.hpp"
+#include "StreamBuffer.hpp"
 
 #define LIGHTS_MAX_DIR_LIGHTS 4
 #define LIGHTS_MAX_POINT_LIGHTS 4
@@ -113,10 +114,10 @@ class LightManager
     /// Update light data (SSBO)
     void Update(bool updateAllLights = false);
 
-    /// Render positions of lights into scene
-    void DrawLights(const glm::mat4 &matProjView, const glm::vec3 &cameraPos) const;
+    /// Render positions of lights into scene, camera from frame constants
+    void DrawLights() const;
 
-    /// Bind light data
+    /// Upload light data to stream buffer & bind it
     void BindLights(unsigned binding = 0) const;
 
     /// Unbine light data
@@ -149,7 +150,7 @@ class LightManager
     bool drawDirLights, drawPointLights, drawSpotLights;
 
   private:
-    /// Update lights SSBO
+    /// Update changed sections of lights block, marks block for upload
     void updateSSBO();
 
     /// Load & prepare lights draw data
@@ -161,13 +162,16 @@ class LightManager
     std::vector<PointLight> _pointLights;
     std::vector<SpotLight> _spotLights;
 
-    // light data SSBO
+    // light data SSBO, uploaded to stream buffer on bind
     // layout:
     // (size, dir data, size, point data, size, spot data)
-    std::unique_ptr<SBuffer> _lightsSSBO;
+    std::vector<unsigned char> _lightsData;
     bool _dirLightsSSBOUpdated;
     bool _pointLightsSSBOUpdated;
     bool _spotLightsSSBOUpdated;
+    // range of lights block uploaded in current frame, reused by binds until block changes
+    mutable StreamAllocation _lightsRange;
+    mutable bool _lightsRangeValid = false;
 
     // light shadow maps
     std::unique_ptr<STexture> _dirLightsShadowMaps;
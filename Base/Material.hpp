@@ -67,6 +67,11 @@ struct Material
     // e.g. bool map_DIFFUSE_exists;
     inline static const std::string existsEXT = "_exists";
 
+    // this prefix makes shader feature keys of maps
+    // defined in variants of materials with the texture
+    // e.g. #define HAS_map_DIFFUSE
+    inline static const std::string featurePRE = "HAS_";
+
 #pragma endregion material_maps
 
 #pragma region material_consts
@@ -111,9 +116,105 @@ struct Material
     bool twoSided = false;
     int alphaMode = 0; // 0 opaque, 1 alpha blending, 2 alpha mask
 
+    // shader feature keys of alpha modes
+    inline static const std::string alphaModeNameBlend = "ALPHA_MODE_BLEND";
+    inline static const std::string alphaModeNameMask = "ALPHA_MODE_MASK";
+
 #pragma endregion material_other
 
+#pragma region material_buffer
+
+    // slot in the materials SSBO, assigned by MaterialManager
+    // -1 if this material is not registered yet
+    int bufferIndex = -1;
+
+    // incremented by MarkChanged, MaterialManager only packs & uploads constants if version changed
+    unsigned version = 0;
+
+    /// Mark constants or maps as edited, so they are uploaded on next draw
+    void MarkChanged()
+    {
+        ++version;
+    }
+
+#pragma endregion material_buffer
+
     inline static const int MAX_MAPS_COUNT = 17;
+
+    /// Get texture map by index (legacy maps first, then pbr maps)
+    const std::shared_ptr<STexture> &GetMap(int idx) const
+    {
+        switch (idx)
+        {
+        case 0:
+            return diffuse;
+        case 1:
+            return specular;
+        case 2:
+            return ambient;
+        case 3:
+            return emissive;
+        case 4:
+            return height;
+        case 5:
+            return normals;
+        case 6:
+            return shininess;
+        case 7:
+            return opacity;
+        case 8:
+            return displacement;
+        case 9:
+            return lightmap;
+        case 10:
+            return reflection;
+        case 11:
+            return pbr_color;
+        case 12:
+            return pbr_normal;
+        case 13:
+            return pbr_emission;
+        case 14:
+            return pbr_metalness;
+        case 15:
+            return pbr_roughness;
+        case 16:
+        default:
+            return pbr_occlusion;
+        }
+    }
+
+    /// Get shader name of texture map by index
+    static const std::string &GetMapName(int idx)
+    {
+        static const std::string *names[MAX_MAPS_COUNT] = {
+            &mapNameDiffuse,      &mapNameSpecular,     &mapNameAmbient,      &mapNameEmissive,  &mapNameHeight,
+            &mapNameNormals,      &mapNameShininess,    &mapNameOpacity,      &mapNameDisplacement,
+            &mapNameLightmap,     &mapNameReflection,   &mapNamePBRColor,     &mapNamePBRNormal, &mapNamePBREmission,
+            &mapNamePBRMetalness, &mapNamePBRRoughness, &mapNamePBROcclusion};
+        return *names[idx < 0 || idx >= MAX_MAPS_COUNT ? MAX_MAPS_COUNT - 1 : idx];
+    }
+
+    /// Whether material should be drawn in transparent pass
+    bool IsTransparent() const
+    {
+        return valOpacity < 1.0f || opacity || alphaMode == 1;
+    }
+
+    /// Whether material should be drawn in transmissive pass
+    bool IsRefractive() const
+    {
+        return valRefract != 1.0f;
+    }
+
+    /// Get bitmask of existing texture maps, bit i is set if GetMap(i) exists
+    unsigned GetMapsMask() const
+    {
+        unsigned mask = 0u;
+        for (int i = 0; i < MAX_MAPS_COUNT; ++i)
+            mask |= GetMap(i) ? (1u << i) : 0u;
+        return mask;
+    }
 };
 
 } // namespace RenderIt
@@ -0,0 +1,134 @@
+#include "Materials.hpp"
+#include "Device.hpp"
+
+#include <cstring>
+
+namespace RenderIt
+{
+
+MaterialManager::MaterialManager() : _capacity(0), _numUploads(0)
+{
+    _materialsSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
+    reserve(MATERIALS_INIT_CAPACITY);
+}
+
+std::shared_ptr<MaterialManager> MaterialManager::Instance()
+{
+    static auto manager = std::make_shared<MaterialManager>();
+    return manager;
+}
+
+unsigned MaterialManager::Register(const std::shared_ptr<Material> &mat)
+{
+    if (owns(mat.get()))
+        return static_cast<unsigned>(mat->bufferIndex);
+
+    // reuse slot of a released material
+    size_t slot = 0;
+    while (slot < _owners.size() && !_owners[slot].expired())
+        ++slot;
+    if (slot == _owners.size())
+    {
+        _owners.emplace_back();
+        _ownersRaw.push_back(nullptr);
+        _versions.push_back(0);
+        _materialsData.emplace_back();
+    }
+    _owners[slot] = mat;
+    _ownersRaw[slot] = mat.get();
+    _versions[slot] = mat->version;
+    _materialsData[slot] = pack(mat.get());
+    mat->bufferIndex = static_cast<int>(slot);
+
+    if (_materialsData.size() > _capacity)
+        reserve(_capacity * 2);
+    else
+    {
+        _materialsSSBO->Bind();
+        GraphicsDevice::Get().BufferSubData(_materialsSSBO->type, slot * sizeof(MaterialData), sizeof(MaterialData),
+                                            &_materialsData[slot]);
+        _materialsSSBO->UnBind();
+        ++_numUploads;
+    }
+    return static_cast<unsigned>(slot);
+}
+
+unsigned MaterialManager::Sync(const std::shared_ptr<Material> &mat)
+{
+    if (!owns(mat.get()))
+        return Register(mat);
+
+    auto slot = static_cast<size_t>(mat->bufferIndex);
+    if (_versions[slot] == mat->version)
+        return static_cast<unsigned>(slot);
+    _versions[slot] = mat->version;
+    // edits may restore previous values, skip upload then
+    auto data = pack(mat.get());
+    if (std::memcmp(&data, &_materialsData[slot], sizeof(MaterialData)) != 0)
+    {
+        _materialsData[slot] = data;
+        _materialsSSBO->Bind();
+        GraphicsDevice::Get().BufferSubData(_materialsSSBO->type, slot * sizeof(MaterialData), sizeof(MaterialData),
+                                            &data);
+        _materialsSSBO->UnBind();
+        ++_numUploads;
+    }
+    return static_cast<unsigned>(slot);
+}
+
+void MaterialManager::BindMaterials(unsigned binding) const
+{
+    _materialsSSBO->BindBase(binding);
+}
+
+void MaterialManager::UnBindMaterials(unsigned binding) const
+{
+    _materialsSSBO->UnBindBase(binding);
+}
+
+size_t MaterialManager::GetNumMaterials() const
+{
+    return _materialsData.size();
+}
+
+MaterialData MaterialManager::pack(const Material *mat)
+{
+    MaterialData data;
+    data.ambientShininess = glm::vec4(mat->colorAmbient, mat->valShininess);
+    data.diffuseOpacity = glm::vec4(mat->colorDiffuse, mat->valOpacity);
+    data.specularRefract = glm::vec4(mat->colorSpecular, mat->valRefract);
+    data.emissiveMetallic = glm::vec4(mat->colorEmissive, mat->valPBRMetallic);
+    data.transparentRoughness = glm::vec4(mat->colorTransparent, mat->valPBRRoughness);
+    data.alphaCutoff = mat->valAlphaCutoff;
+    data.mapsMask = mat->GetMapsMask();
+    data.hasPBR = static_cast<int>(mat->valHasPBR);
+    data.alphaMode = mat->alphaMode;
+    return data;
+}
+
+bool MaterialManager::owns(const Material *mat) const
+{
+    if (!mat || mat->bufferIndex < 0)
+        return false;
+    auto slot = static_cast<size_t>(mat->bufferIndex);
+    // copied materials carry the index of their source, so compare owner as well
+    return slot < _ownersRaw.size() && _ownersRaw[slot] == mat && !_owners[slot].expired();
+}
+
+void MaterialManager::reserve(size_t capacity)
+{
+    _capacity = capacity;
+    auto &device = GraphicsDevice::Get();
+    _materialsSSBO->Bind();
+    device.BufferData(_materialsSSBO->type, _capacity * sizeof(MaterialData), nullptr, GL_DYNAMIC_DRAW);
+    if (!_materialsData.empty())
+    {
+        device.BufferSubData(_materialsSSBO->type, 0, _materialsData.size() * sizeof(MaterialData),
+                             _materialsData.data());
+        ++_numUploads;
+    }
+    _materialsSSBO->UnBind();
+    BindMaterials(MATERIALS_SSBO_BINDING);
+}
+
+} // namespace RenderIt
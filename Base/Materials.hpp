@@ -0,0 +1,115 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GLStructs.hpp"
+#include "Material.hpp"
+
+#define MATERIALS_SSBO_BINDING 4
+#define MATERIALS_INIT_CAPACITY 64
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Material constants packed in std430 layout
+struct MaterialData
+{
+    glm::vec4 ambientShininess;
+    glm::vec4 diffuseOpacity;
+    glm::vec4 specularRefract;
+    glm::vec4 emissiveMetallic;
+    glm::vec4 transparentRoughness;
+    float alphaCutoff;
+    unsigned mapsMask;
+    int hasPBR;
+    int alphaMode;
+};
+
+static_assert(sizeof(MaterialData) == 96, "MaterialData must match std430 layout");
+
+/// Global material manager
+/// Keeps constants of all materials in one SSBO
+/// Shaders that declare the MaterialsData block only receive a material index per draw
+class MaterialManager
+{
+  public:
+    MaterialManager();
+
+    /// Get instance
+    static std::shared_ptr<MaterialManager> Instance();
+
+    /// Assign a buffer slot to material
+    unsigned Register(const std::shared_ptr<Material> &mat);
+
+    /// Upload material constants if version of material changed, and return its buffer slot
+    unsigned Sync(const std::shared_ptr<Material> &mat);
+
+    /// Bind materials data
+    void BindMaterials(unsigned binding = MATERIALS_SSBO_BINDING) const;
+
+    /// Unbind materials data
+    void UnBindMaterials(unsigned binding = MATERIALS_SSBO_BINDING) const;
+
+    /// Get number of registered slots
+    size_t GetNumMaterials() const;
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "MaterialManager";
+
+    inline static const std::string ShaderBlockName = "MaterialsData";
+    inline static const std::string ShaderIndexName = "val_MATERIAL";
+
+    /// GLSL declaration of materials data, insert after #version
+    inline static const std::string BlockSource = R"(
+        struct MaterialData
+        {
+            vec4 ambientShininess;
+            vec4 diffuseOpacity;
+            vec4 specularRefract;
+            vec4 emissiveMetallic;
+            vec4 transparentRoughness;
+            float alphaCutoff;
+            uint mapsMask;
+            int hasPBR;
+            int alphaMode;
+        };
+        layout(std430, binding = 4) readonly buffer MaterialsData
+        {
+            MaterialData materials[];
+        };
+        uniform uint val_MATERIAL;
+    )";
+
+  private:
+    /// Pack material constants
+    static MaterialData pack(const Material *mat);
+
+    /// Check whether slot is owned by material
+    bool owns(const Material *mat) const;
+
+    /// Grow SSBO to fit capacity
+    void reserve(size_t capacity);
+
+  private:
+    std::unique_ptr<SBuffer> _materialsSSBO;
+    // CPU copy of SSBO data
+    std::vector<MaterialData> _materialsData;
+    // owners of slots, expired slots are reused
+    std::vector<std::weak_ptr<Material>> _owners;
+    std::vector<const Material *> _ownersRaw;
+    // material version uploaded to slot
+    std::vector<unsigned> _versions;
+    size_t _capacity;
+    size_t _numUploads;
+};
+
+} // namespace RenderIt
@@ -1,5 +1,7 @@
 #include "Mesh.hpp"
+#include "Device.hpp"
 #include "Material.hpp"
+#include "Materials.hpp"
 
 #include <cstddef>
 
@@ -19,10 +21,62 @@ Mesh::~Mesh()
 
 void Mesh::Draw(const Shader *shader, const RenderPass &pass) const
 {
-    if (!_vao || !_indicesCount || !drawMesh)
+    draw(shader, pass, 0);
+}
+
+void Mesh::DrawInstanced(const Shader *shader, size_t count, const RenderPass &pass) const
+{
+    if (count)
+        draw(shader, pass, count);
+}
+
+void Mesh::Record(CommandList &list, const Shader *shader, const RenderPass &pass, size_t instances) const
+{
+    // as in draw, but readiness of shader is checked on replay
+    if (!_vao || !_indicesCount || !drawMesh || !shader)
         return;
-    auto hasBlend = glIsEnabled(GL_BLEND);
-    auto hasCullFace = glIsEnabled(GL_CULL_FACE);
+    auto isTransparent = false;
+    if (material && pass != RenderPass::AllUnOrdered)
+    {
+        isTransparent = material->IsTransparent();
+        if ((pass == RenderPass::Transparent) != isTransparent)
+            return;
+        if ((pass == RenderPass::Transmissive) != material->IsRefractive())
+            return;
+    }
+    // same states as draw, restored after replay
+    list.PushState();
+    if (material)
+    {
+        list.ConfigMaterial(material);
+        list.SetEnabled(GL_CULL_FACE, !material->twoSided);
+    }
+    list.BindVertexArray(_vao->Get());
+    if (isTransparent)
+    {
+        list.SetEnabled(GL_CULL_FACE, true);
+        list.CullFace(GL_FRONT);
+        list.DrawElements(primType, _indicesCount, instances);
+        list.CullFace(GL_BACK);
+        list.DrawElements(primType, _indicesCount, instances);
+    }
+    else
+    {
+        list.SetEnabled(GL_BLEND, false);
+        list.DrawElements(primType, _indicesCount, instances);
+    }
+    list.BindVertexArray(0);
+    list.PopState();
+}
+
+void Mesh::draw(const Shader *shader, const RenderPass &pass, size_t instances) const
+{
+    // skip until shader compiled in background is ready
+    if (!_vao || !_indicesCount || !drawMesh || !shader->IsCompiled())
+        return;
+    auto &device = GraphicsDevice::Get();
+    auto hasBlend = device.IsEnabled(GL_BLEND);
+    auto hasCullFace = device.IsEnabled(GL_CULL_FACE);
     auto isTransparent = false;
     if (material)
     {
@@ -30,53 +84,57 @@ void Mesh::Draw(const Shader *shader, const RenderPass &pass) const
         if (pass != RenderPass::AllUnOrdered)
         {
             // check render pass for transparency
-            isTransparent = material->valOpacity < 1.0f || material->opacity || material->alphaMode == 1;
+            isTransparent = material->IsTransparent();
             if ((pass == RenderPass::Transparent) != isTransparent)
                 return;
             // check render pass for refraction
-            auto isRefract = material->valRefract != 1.0f;
-            if ((pass == RenderPass::Transmissive) != isRefract)
+            if ((pass == RenderPass::Transmissive) != material->IsRefractive())
                 return;
         }
         // configure material
-        shader->ConfigMaterialTextures(material.get());
-        if (material->twoSided)
-            glDisable(GL_CULL_FACE);
+        if (shader->UsesMaterialBuffer())
+            shader->ConfigMaterialBuffer(material.get(), MaterialManager::Instance()->Sync(material));
         else
-            glEnable(GL_CULL_FACE);
+            shader->ConfigMaterialTextures(material.get());
+        device.SetEnabled(GL_CULL_FACE, !material->twoSided);
     }
     _vao->Bind();
     if (isTransparent)
     {
         // for transparent meshes, render back face and then front face
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT);
-        glDrawElements(primType, static_cast<GLsizei>(_indicesCount), GL_UNSIGNED_INT, 0);
-        glCullFace(GL_BACK);
-        glDrawElements(primType, static_cast<GLsizei>(_indicesCount), GL_UNSIGNED_INT, 0);
+        device.SetEnabled(GL_CULL_FACE, true);
+        device.CullFace(GL_FRONT);
+        drawElements(instances);
+        device.CullFace(GL_BACK);
+        drawElements(instances);
     }
     else
     {
-        glDisable(GL_BLEND);
-        glDrawElements(primType, static_cast<GLsizei>(_indicesCount), GL_UNSIGNED_INT, 0);
+        device.SetEnabled(GL_BLEND, false);
+        drawElements(instances);
     }
     _vao->UnBind();
-    if (hasCullFace)
-        glEnable(GL_CULL_FACE);
-    else
-        glDisable(GL_CULL_FACE);
+    device.SetEnabled(GL_CULL_FACE, hasCullFace);
     if (hasBlend)
-        glEnable(GL_BLEND);
+        device.SetEnabled(GL_BLEND, true);
+}
+
+void Mesh::drawElements(size_t instances) const
+{
+    GraphicsDevice::Get().DrawElements(primType, static_cast<GLsizei>(_indicesCount), GL_UNSIGNED_INT, 0,
+                                       static_cast<GLsizei>(instances));
 }
 
 void Mesh::Load(const std::vector<Vertex> &vertices, const std::vector<unsigned> &indices,
                 std::shared_ptr<Material> mat, GLenum type)
 {
+    GPU_MEMORY_SCOPE(Geometry, "Mesh");
     if (_vao || _vbo || _ebo)
         Reset();
     _vao = std::make_unique<SVAO>();
     _vbo = std::make_unique<SBuffer>(GL_ARRAY_BUFFER);
     _ebo = std::make_unique<SBuffer>(GL_ELEMENT_ARRAY_BUFFER);
+    // material is registered on first draw, so constants edited after loading are uploaded
     material = mat;
     _indicesCount = indices.size();
     _verticesCount = vertices.size();
@@ -84,10 +142,10 @@ void Mesh::Load(const std::vector<Vertex> &vertices, const std::vector<unsigned>
 
     _vao->Bind();
     _vbo->Bind();
-    glBufferData(_vbo->type, _verticesCount * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    GraphicsDevice::Get().BufferData(_vbo->type, _verticesCount * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
     _ebo->Bind();
-    glBufferData(_ebo->type, _indicesCount * sizeof(unsigned), indices.data(), GL_STATIC_DRAW);
-    setupVAOAttributes();
+    GraphicsDevice::Get().BufferData(_ebo->type, _indicesCount * sizeof(unsigned), indices.data(), GL_STATIC_DRAW);
+    SetupVAOAttributes();
     _vao->UnBind();
 }
 
@@ -98,17 +156,17 @@ void Mesh::Reset()
     _ebo = nullptr;
 }
 
-std::optional<GLuint> Mesh::GetVertexArray()
+std::optional<GLuint> Mesh::GetVertexArray() const
 {
     return _vao ? _vao->Get() : std::optional<GLuint>{std::nullopt};
 }
 
-std::optional<GLuint> Mesh::GetVertexBuffer()
+std::optional<GLuint> Mesh::GetVertexBuffer() const
 {
     return _vbo ? _vbo->Get() : std::optional<GLuint>{std::nullopt};
 }
 
-std::optional<GLuint> Mesh::GetIndexBuffer()
+std::optional<GLuint> Mesh::GetIndexBuffer() const
 {
     return _ebo ? _ebo->Get() : std::optional<GLuint>{std::nullopt};
 }
@@ -123,32 +181,40 @@ size_t Mesh::GetNumIndices() const
     return _indicesCount;
 }
 
-void Mesh::setupVAOAttributes() const
+bool Mesh::ReadGeometry(std::vector<glm::vec3> &positions, std::vector<unsigned> &indices) const
+{
+    if (!_vbo || !_ebo)
+        return false;
+    std::vector<Vertex> vertices(_verticesCount);
+    indices.resize(_indicesCount);
+    auto &device = GraphicsDevice::Get();
+    device.GetBufferSubData(_vbo->Get(), 0, vertices.size() * sizeof(Vertex), vertices.data());
+    device.GetBufferSubData(_ebo->Get(), 0, indices.size() * sizeof(unsigned), indices.data());
+    positions.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+        positions[i] = vertices[i].position;
+    return true;
+}
+
+void Mesh::SetupVAOAttributes()
 {
+    auto &device = GraphicsDevice::Get();
     // position
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, position));
+    device.VertexAttribute(0, 3, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, position));
     // normal
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
+    device.VertexAttribute(1, 3, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, normal));
     // texcoords
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, texcoords));
+    device.VertexAttribute(2, 2, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, texcoords));
     // tangent
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, tangent));
+    device.VertexAttribute(3, 3, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, tangent));
     // bitangent
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, bitangent));
+    device.VertexAttribute(4, 3, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, bitangent));
     // bone IDs
-    glEnableVertexAttribArray(5);
-    glVertexAttribIPointer(5, 4, GL_UNSIGNED_INT, sizeof(Vertex), (void *)offsetof(Vertex, boneIDs));
+    device.VertexAttribute(5, 4, GL_UNSIGNED_INT, true, sizeof(Vertex), offsetof(Vertex, boneIDs));
     // bone weights
-    glEnableVertexAttribArray(6);
-    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, boneWeights));
+    device.VertexAttribute(6, 4, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, boneWeights));
     // vertex color
-    glEnableVertexAttribArray(7);
-    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, color));
+    device.VertexAttribute(7, 4, GL_FLOAT, false, sizeof(Vertex), offsetof(Vertex, color));
 }
 
 } // namespace RenderIt
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "CommandList.hpp"
 #include "GLStructs.hpp"
 #include "RenderPass.hpp"
 #include "Shader.hpp"
@@ -27,6 +28,13 @@ class Mesh
     /// Draw mesh data
     void Draw(const Shader *shader, const RenderPass &pass = RenderPass::Ordered) const;
 
+    /// Draw mesh instances, instance data must be bound (see InstanceBuffer)
+    void DrawInstanced(const Shader *shader, size_t count, const RenderPass &pass = RenderPass::Ordered) const;
+
+    /// Record draw of mesh into command list, instanced if instances > 0
+    void Record(CommandList &list, const Shader *shader, const RenderPass &pass = RenderPass::Ordered,
+                size_t instances = 0) const;
+
     /// Load with mesh data
     void Load(const std::vector<Vertex> &vertices, const std::vector<unsigned> &indices, std::shared_ptr<Material> mat,
               GLenum type = GL_TRIANGLES);
@@ -35,13 +43,13 @@ class Mesh
     void Reset();
 
     /// Get vertex array
-    std::optional<GLuint> GetVertexArray();
+    std::optional<GLuint> GetVertexArray() const;
 
     /// Get vertex buffer
-    std::optional<GLuint> GetVertexBuffer();
+    std::optional<GLuint> GetVertexBuffer() const;
 
     /// Get index buffer
-    std::optional<GLuint> GetIndexBuffer();
+    std::optional<GLuint> GetIndexBuffer() const;
 
     /// Get number of vertices
     size_t GetNumVertices() const;
@@ -49,9 +57,15 @@ class Mesh
     /// Get number of indices
     size_t GetNumIndices() const;
 
+    /// Read back vertex positions & indices from GPU
+    bool ReadGeometry(std::vector<glm::vec3> &positions, std::vector<unsigned> &indices) const;
+
     /// UI calls
     void UI();
 
+    /// Configure attribute points of Vertex layout on bound VAO
+    static void SetupVAOAttributes();
+
   public:
     const std::string LOGNAME = "Mesh";
     std::shared_ptr<Material> material;
@@ -59,8 +73,11 @@ class Mesh
     bool drawMesh;
 
   private:
-    /// Configure VAO attribute points
-    void setupVAOAttributes() const;
+    /// Draw with material & render states, instanced if instances > 0
+    void draw(const Shader *shader, const RenderPass &pass, size_t instances) const;
+
+    /// Issue draw call on bound VAO
+    void drawElements(size_t instances) const;
 
   private:
     std::unique_ptr<SVAO> _vao;
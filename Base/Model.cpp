@@ -1,6 +1,8 @@
 #include "Model.hpp"
 #include "Animator.hpp"
+#include "Device.hpp"
 #include "Material.hpp"
+#include "Materials.hpp"
 #include "Tools.hpp"
 #include "Vertex.hpp"
 
@@ -10,6 +12,7 @@
 #include <stb_image.h>
 
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <queue>
 #include <tuple>
@@ -22,8 +25,8 @@ namespace RenderIt
 {
 
 Model::Model()
-    : modelName(MODEL_NAME_DEFAULT), transform(Transform::Type::TRS), _animationActive(0), _animNodeRoot(nullptr),
-      _parent(nullptr)
+    : modelName(MODEL_NAME_DEFAULT), transform(Transform::Type::TRS), _animationActive(0), _animationTime(0.0f),
+      _animNodeRoot(nullptr)
 {
 }
 
@@ -125,14 +128,15 @@ bool Model::Load(const std::string &modelSource, bool isFile, unsigned flags, bo
                         normal = Tools::matrixMultiplyVector(nodeGlobalT, normal);
                         tangent = Tools::matrixMultiplyVector(nodeGlobalT, tangent);
                         bitangent = Tools::matrixMultiplyVector(nodeGlobalT, bitangent);
-                        // update bounds for static meshes
-                        bounds.Update(position);
                     }
                 }
 
                 vertices.push_back(
                     {position, normal, texcoords, tangent, bitangent, defaultBoneID, defaultBoneWeights, vertexColor});
             }
+            // update bounds for static meshes
+            if (!mesh->mNumBones && nodeParentBoneID < 0 && !vertices.empty())
+                bounds.Update(&vertices[0].position, vertices.size(), sizeof(Vertex));
 
             // indices data
             for (auto faceIdx = 0u; faceIdx < mesh->mNumFaces; ++faceIdx)
@@ -400,6 +404,8 @@ void Model::Draw(const Shader *shader, const RenderPass &pass) const
         for (auto &mesh : _meshes)
             mesh->Draw(shader, p);
     };
+    if (shader->UsesMaterialBuffer())
+        MaterialManager::Instance()->BindMaterials();
     switch (pass)
     {
     case RenderPass::Ordered: {
@@ -420,16 +426,94 @@ void Model::Draw(const Shader *shader, const RenderPass &pass) const
     }
 }
 
+void Model::DrawInstanced(const Shader *shader, const InstanceBuffer &instances, const RenderPass &pass) const
+{
+    auto count = instances.GetCount();
+    if (!count)
+        return;
+    auto drawCall = [&](const RenderPass &p) {
+        for (auto &mesh : _meshes)
+            mesh->DrawInstanced(shader, count, p);
+    };
+    if (shader->UsesMaterialBuffer())
+        MaterialManager::Instance()->BindMaterials();
+    instances.Bind();
+    shader->UniformBool(InstanceBuffer::ShaderInstancedName, true);
+    switch (pass)
+    {
+    case RenderPass::Ordered: {
+        drawCall(RenderPass::Opaque);
+        drawCall(RenderPass::Transparent);
+        break;
+    }
+    case RenderPass::AllOrdered: {
+        drawCall(RenderPass::Opaque);
+        drawCall(RenderPass::Transparent);
+        drawCall(RenderPass::Transmissive);
+        break;
+    }
+    default: {
+        drawCall(pass);
+        break;
+    }
+    }
+    shader->UniformBool(InstanceBuffer::ShaderInstancedName, false);
+    instances.UnBind();
+}
+
+void Model::Record(CommandList &list, const Shader *shader, const RenderPass &pass) const
+{
+    auto recordCall = [&](const RenderPass &p) {
+        for (auto &mesh : _meshes)
+            mesh->Record(list, shader, p);
+    };
+    switch (pass)
+    {
+    case RenderPass::Ordered: {
+        recordCall(RenderPass::Opaque);
+        recordCall(RenderPass::Transparent);
+        break;
+    }
+    case RenderPass::AllOrdered: {
+        recordCall(RenderPass::Opaque);
+        recordCall(RenderPass::Transparent);
+        recordCall(RenderPass::Transmissive);
+        break;
+    }
+    default: {
+        recordCall(pass);
+        break;
+    }
+    }
+}
+
+std::shared_ptr<Model> Model::Clone() const
+{
+    auto model = std::make_shared<Model>();
+    model->transform = transform;
+    model->bounds = bounds;
+    model->modelName = modelName;
+    model->_meshes = _meshes;
+    model->_textures = _textures;
+    model->_animationActive = _animationActive;
+    model->_animationTime = _animationTime;
+    model->_animations = _animations;
+    model->_boneInfo = _boneInfo;
+    model->_animNodeRoot = _animNodeRoot;
+    return model;
+}
+
 void Model::Reset()
 {
     _meshes.clear();
     _meshes.resize(0);
     _children.clear();
     _children.resize(0);
-    _parent = nullptr;
+    _parent.reset();
     modelName = MODEL_NAME_DEFAULT;
     _animations.clear();
     _animations.resize(0);
+    _animationTime = 0.0f;
     _boneInfo.clear();
     _animNodeRoot = nullptr;
 }
@@ -448,7 +532,7 @@ bool Model::AddChild(std::shared_ptr<Model> child)
     child->transform.parentMatrix = transform.matrix;
     child->transform.UpdateMatrix();
     _children.push_back(child);
-    child->_parent = std::shared_ptr<Model>(this);
+    child->_parent = weak_from_this();
     return true;
 }
 
@@ -465,7 +549,7 @@ std::shared_ptr<Model> Model::RemoveChild(unsigned idx)
 
 std::shared_ptr<Model> Model::GetParent() const
 {
-    return _parent;
+    return _parent.lock();
 }
 
 std::shared_ptr<Model> Model::GetChild(unsigned idx) const
@@ -482,8 +566,22 @@ size_t Model::GetNumChildren() const
 
 void Model::SetActiveAnimation(unsigned idx)
 {
-    if (idx < _animations.size())
+    if (idx < _animations.size() && idx != _animationActive)
+    {
         _animationActive = idx;
+        _animationTime = 0.0f;
+    }
+}
+
+void Model::SetAnimationTime(float ticks)
+{
+    auto duration = GetAnimationDuration();
+    _animationTime = duration > 0.0f ? std::fmod((std::max)(ticks, 0.0f), duration) : 0.0f;
+}
+
+float Model::GetAnimationDuration() const
+{
+    return HasAnimation() && _animations[_animationActive] ? _animations[_animationActive]->duration : 0.0f;
 }
 
 size_t Model::GetNumAnimations() const
@@ -525,15 +623,17 @@ std::shared_ptr<STexture> Model::loadTexture(const std::string &path)
         return nullptr;
     }
 
+    GPU_MEMORY_SCOPE(MaterialTextures, "Model");
+    auto &device = GraphicsDevice::Get();
     auto tex = std::make_shared<STexture>(GL_TEXTURE_2D);
     tex->Bind();
-    glTexParameteri(tex->type, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(tex->type, GL_TEXTURE_WRAP_R, GL_REPEAT);
-    glTexParameteri(tex->type, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(tex->type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(tex->type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    device.TexParameter(tex->type, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    device.TexParameter(tex->type, GL_TEXTURE_WRAP_R, GL_REPEAT);
+    device.TexParameter(tex->type, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    device.TexParameter(tex->type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    device.TexParameter(tex->type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    device.TexImage2D(GL_TEXTURE_2D, GL_RGBA, w, h, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    device.GenerateMipmap(GL_TEXTURE_2D);
     tex->UnBind();
 
     stbi_image_free(data);
@@ -559,15 +659,17 @@ std::shared_ptr<STexture> Model::loadTexture(unsigned char *pixels, int width, i
         return nullptr;
     }
 
+    GPU_MEMORY_SCOPE(MaterialTextures, "Model");
+    auto &device = GraphicsDevice::Get();
     auto tex = std::make_shared<STexture>(GL_TEXTURE_2D);
     tex->Bind();
-    glTexParameteri(tex->type, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(tex->type, GL_TEXTURE_WRAP_R, GL_REPEAT);
-    glTexParameteri(tex->type, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(tex->type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(tex->type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    device.TexParameter(tex->type, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    device.TexParameter(tex->type, GL_TEXTURE_WRAP_R, GL_REPEAT);
+    device.TexParameter(tex->type, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    device.TexParameter(tex->type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    device.TexParameter(tex->type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    device.TexImage2D(GL_TEXTURE_2D, GL_RGBA, w, h, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    device.GenerateMipmap(GL_TEXTURE_2D);
     tex->UnBind();
 
     stbi_image_free(data);
@@ -592,7 +694,10 @@ bool Model::updateDynamicBounds(const aiScene *scene)
             continue;
         auto vertexCount = mesh->GetNumVertices();
         // map vertices
-        auto dataPtr = reinterpret_cast<Vertex *>(glMapNamedBuffer(VBO.value(), GL_READ_ONLY));
+        auto &device = GraphicsDevice::Get();
+        auto dataPtr = reinterpret_cast<Vertex *>(device.MapBuffer(VBO.value(), GL_READ_ONLY));
+        if (!dataPtr)
+            continue;
         for (auto vertexIdx = 0u; vertexIdx < vertexCount; ++vertexIdx, ++dataPtr)
         {
             auto pos = (*dataPtr).position;
@@ -607,7 +712,7 @@ bool Model::updateDynamicBounds(const aiScene *scene)
                 bounds.Update(Tools::matrixMultiplyPoint(mat, pos));
             }
         }
-        glUnmapNamedBuffer(VBO.value());
+        device.UnmapBuffer(VBO.value());
     }
     anim->Update(0.0f);
     return true;
@@ -11,7 +11,9 @@
 
 #include "Animation.hpp"
 #include "Bounds.hpp"
+#include "CommandList.hpp"
 #include "GLStructs.hpp"
+#include "Instances.hpp"
 #include "Mesh.hpp"
 #include "RenderPass.hpp"
 #include "Shader.hpp"
@@ -31,7 +33,7 @@ namespace RenderIt
         aiProcess_FlipUVs
 
 /// Model definition
-class Model
+class Model : public std::enable_shared_from_this<Model>
 {
   public:
     friend class Animator;
@@ -54,6 +56,16 @@ class Model
     /// Draw all meshes
     void Draw(const Shader *shader, const RenderPass &pass = RenderPass::Ordered) const;
 
+    /// Draw all meshes once per instance, instance matrices replace model transform
+    void DrawInstanced(const Shader *shader, const InstanceBuffer &instances,
+                       const RenderPass &pass = RenderPass::Ordered) const;
+
+    /// Record draws of all meshes into command list, safe to call from worker threads
+    void Record(CommandList &list, const Shader *shader, const RenderPass &pass = RenderPass::Ordered) const;
+
+    /// Create model sharing meshes, textures & animations with this model (children excluded)
+    std::shared_ptr<Model> Clone() const;
+
     /// Reset model data
     void Reset();
 
@@ -87,6 +99,12 @@ class Model
     /// Whether model has animation
     bool HasAnimation() const;
 
+    /// Set playback time (in ticks) of active animation, wrapped to its duration
+    void SetAnimationTime(float ticks);
+
+    /// Get duration (in ticks) of active animation, 0 if none
+    float GetAnimationDuration() const;
+
 #pragma endregion animations
 
 #pragma region meshes
@@ -136,6 +154,8 @@ class Model
 #pragma region model_animations
 
     unsigned _animationActive;
+    // playback time in ticks, kept per model so clones sharing animations play independently
+    mutable float _animationTime;
     // animations
     std::vector<std::shared_ptr<Animation>> _animations;
     // map bone name -> (bone ID, transform matrix)
@@ -147,7 +167,8 @@ class Model
 
 #pragma region model_hierarchy
 
-    std::shared_ptr<Model> _parent;
+    // weak, parent owns its children
+    std::weak_ptr<Model> _parent;
     std::vector<std::shared_ptr<Model>> _children;
 
 #pragma endregion model_hierarchy
@@ -0,0 +1,397 @@
+#include "Occlusion.hpp"
+#include "SIMD.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace RenderIt
+{
+
+// clip space w below this is treated as behind camera
+constexpr float OCCLUSION_NEAR_W = 1e-5f;
+
+OcclusionCuller::OcclusionCuller(int width, int height, unsigned numThreads)
+    : useSIMD(true), _numThreads(numThreads), _jobs(JobSystem::Instance()), _lastRasterMs(0.0), _numTested(0),
+      _numCulled(0)
+{
+    // whole tiles, and rows of 4 pixels for SIMD path
+    _width = std::max(1, (width + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE) * OCCLUSION_TILE_SIZE;
+    _height = std::max(1, (height + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE) * OCCLUSION_TILE_SIZE;
+    _tilesX = _width / OCCLUSION_TILE_SIZE;
+    _tilesY = _height / OCCLUSION_TILE_SIZE;
+    if (!_numThreads)
+        _numThreads = static_cast<unsigned>(_jobs->GetNumWorkers()) + 1u;
+    _numThreads = std::min(_numThreads, static_cast<unsigned>(_tilesY));
+    _depth.resize(static_cast<size_t>(_width) * _height, 1.0f);
+    _tileDepth.resize(static_cast<size_t>(_tilesX) * _tilesY, 1.0f);
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+    Wait();
+}
+
+size_t OcclusionCuller::SelectOccluders(const std::vector<const Model *> &models, float minSize)
+{
+    Wait();
+    size_t count = 0;
+    std::queue<const Model *> ms;
+    for (auto m : models)
+        if (m)
+            ms.push(m);
+    while (!ms.empty())
+    {
+        auto m = ms.front();
+        ms.pop();
+        for (auto i = 0u; i < m->GetNumChildren(); ++i)
+            ms.push(m->GetChild(i).get());
+        if (m->HasAnimation() || !m->bounds.IsValid())
+            continue;
+        const auto &mat = m->transform.matrix;
+        if (m->bounds.Transform(mat).Diagonal() < minSize)
+            continue;
+        for (auto i = 0u; i < m->GetNumMeshes(); ++i)
+        {
+            auto mesh = m->GetMesh(i);
+            auto numTriangles = mesh->GetNumIndices() / 3;
+            if (mesh->primType != GL_TRIANGLES || !numTriangles || numTriangles > OCCLUSION_MAX_TRIANGLES)
+                continue;
+            std::vector<glm::vec3> positions;
+            std::vector<unsigned> indices;
+            if (!mesh->ReadGeometry(positions, indices))
+                continue;
+            AddOccluder(positions, indices, mat, m);
+            ++count;
+        }
+    }
+    return count;
+}
+
+void OcclusionCuller::AddOccluder(const std::vector<glm::vec3> &positions, const std::vector<unsigned> &indices,
+                                  const glm::mat4 &matrix, const Model *model)
+{
+    Wait();
+    _occluders.push_back({positions, indices, matrix, model});
+}
+
+void OcclusionCuller::ClearOccluders()
+{
+    Wait();
+    _occluders.clear();
+}
+
+void OcclusionCuller::Begin(const glm::mat4 &projView)
+{
+    Wait();
+    _projView = projView;
+    _numTested = _numCulled = 0;
+    // read model transforms on calling thread
+    std::vector<glm::mat4> matrices(_occluders.size());
+    for (size_t i = 0; i < _occluders.size(); ++i)
+        matrices[i] = _occluders[i].model ? _occluders[i].model->transform.matrix : _occluders[i].matrix;
+    _pending = _jobs->Run([this, projView, matrices = std::move(matrices)]() {
+        auto start = std::chrono::steady_clock::now();
+        setupTriangles(projView, matrices);
+        // split rows into bands of whole tiles
+        size_t tilesPerBand = (_tilesY + _numThreads - 1) / _numThreads;
+        auto bands =
+            _jobs->ParallelFor(0, static_cast<size_t>(_tilesY), tilesPerBand, [this](size_t begin, size_t end) {
+                rasterizeRows(static_cast<int>(begin) * OCCLUSION_TILE_SIZE,
+                              static_cast<int>(end) * OCCLUSION_TILE_SIZE);
+            });
+        _jobs->Wait(bands);
+        _lastRasterMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    });
+}
+
+void OcclusionCuller::Wait()
+{
+    _jobs->Wait(_pending);
+    _pending = nullptr;
+}
+
+void OcclusionCuller::Rasterize(const glm::mat4 &projView)
+{
+    Begin(projView);
+    Wait();
+}
+
+bool OcclusionCuller::IsVisible(const Bounds &bounds, const glm::mat4 &matrix) const
+{
+    if (!bounds.IsValid())
+        return true;
+    if (_pending)
+        _jobs->Wait(_pending);
+    ++_numTested;
+
+    // project corners to screen
+    auto mvp = _projView * matrix;
+    float minX = std::numeric_limits<float>::max(), minY = minX, minZ = minX;
+    float maxX = -minX, maxY = -minX;
+    for (int i = 0; i < 8; ++i)
+    {
+        glm::vec4 corner((i & 1) ? bounds.max.x : bounds.min.x, (i & 2) ? bounds.max.y : bounds.min.y,
+                         (i & 4) ? bounds.max.z : bounds.min.z, 1.0f);
+        auto clip = mvp * corner;
+        // crossing near plane
+        if (clip.w <= OCCLUSION_NEAR_W)
+            return true;
+        float wInv = 1.0f / clip.w;
+        float x = (clip.x * wInv * 0.5f + 0.5f) * _width;
+        float y = (clip.y * wInv * 0.5f + 0.5f) * _height;
+        float z = clip.z * wInv * 0.5f + 0.5f;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        minZ = std::min(minZ, z);
+    }
+    if (minZ <= 0.0f)
+        return true;
+    // outside of view
+    if (maxX < 0.0f || maxY < 0.0f || minX > _width || minY > _height || minZ > 1.0f)
+    {
+        ++_numCulled;
+        return false;
+    }
+
+    int x0 = std::clamp(static_cast<int>(std::floor(minX)), 0, _width - 1);
+    int x1 = std::clamp(static_cast<int>(std::ceil(maxX)), 0, _width - 1);
+    int y0 = std::clamp(static_cast<int>(std::floor(minY)), 0, _height - 1);
+    int y1 = std::clamp(static_cast<int>(std::ceil(maxY)), 0, _height - 1);
+    for (int ty = y0 / OCCLUSION_TILE_SIZE; ty <= y1 / OCCLUSION_TILE_SIZE; ++ty)
+    {
+        for (int tx = x0 / OCCLUSION_TILE_SIZE; tx <= x1 / OCCLUSION_TILE_SIZE; ++tx)
+        {
+            // nearest point is behind everything in tile
+            if (minZ > _tileDepth[ty * _tilesX + tx])
+                continue;
+            // otherwise check pixels of tile covered by bounds
+            int px0 = std::max(x0, tx * OCCLUSION_TILE_SIZE);
+            int px1 = std::min(x1, tx * OCCLUSION_TILE_SIZE + OCCLUSION_TILE_SIZE - 1);
+            int py0 = std::max(y0, ty * OCCLUSION_TILE_SIZE);
+            int py1 = std::min(y1, ty * OCCLUSION_TILE_SIZE + OCCLUSION_TILE_SIZE - 1);
+            for (int py = py0; py <= py1; ++py)
+                for (int px = px0; px <= px1; ++px)
+                    if (minZ <= _depth[py * _width + px])
+                        return true;
+        }
+    }
+    ++_numCulled;
+    return false;
+}
+
+bool OcclusionCuller::IsVisible(const Model *model) const
+{
+    return IsVisible(model->bounds, model->transform.matrix);
+}
+
+const std::vector<float> &OcclusionCuller::GetDepthBuffer() const
+{
+    if (_pending)
+        _jobs->Wait(_pending);
+    return _depth;
+}
+
+const std::vector<float> &OcclusionCuller::GetTileDepth() const
+{
+    if (_pending)
+        _jobs->Wait(_pending);
+    return _tileDepth;
+}
+
+int OcclusionCuller::GetWidth() const
+{
+    return _width;
+}
+
+int OcclusionCuller::GetHeight() const
+{
+    return _height;
+}
+
+void OcclusionCuller::setupTriangles(const glm::mat4 &projView, const std::vector<glm::mat4> &matrices)
+{
+    _triangles.clear();
+    std::vector<glm::vec4> clip;
+    auto toScreen = [&](const glm::vec4 &c) {
+        float wInv = 1.0f / c.w;
+        return glm::vec3((c.x * wInv * 0.5f + 0.5f) * _width, (c.y * wInv * 0.5f + 0.5f) * _height,
+                         c.z * wInv * 0.5f + 0.5f);
+    };
+    for (size_t o = 0; o < _occluders.size(); ++o)
+    {
+        const auto &occluder = _occluders[o];
+        auto mvp = projView * matrices[o];
+        clip.resize(occluder.positions.size());
+        for (size_t i = 0; i < clip.size(); ++i)
+            clip[i] = mvp * glm::vec4(occluder.positions[i], 1.0f);
+        for (size_t i = 0; i + 2 < occluder.indices.size(); i += 3)
+        {
+            const auto &c0 = clip[occluder.indices[i]];
+            const auto &c1 = clip[occluder.indices[i + 1]];
+            const auto &c2 = clip[occluder.indices[i + 2]];
+            // dropping triangles crossing near plane only loses occlusion, never adds it
+            if (c0.w <= OCCLUSION_NEAR_W || c1.w <= OCCLUSION_NEAR_W || c2.w <= OCCLUSION_NEAR_W)
+                continue;
+            ScreenTriangle tri{toScreen(c0), toScreen(c1), toScreen(c2), 0.0f, 0.0f};
+            if (tri.v0.z < 0.0f || tri.v1.z < 0.0f || tri.v2.z < 0.0f)
+                continue;
+            // pushing depth beyond far plane back to far is conservative
+            tri.v0.z = std::min(tri.v0.z, 1.0f);
+            tri.v1.z = std::min(tri.v1.z, 1.0f);
+            tri.v2.z = std::min(tri.v2.z, 1.0f);
+            float area = (tri.v1.x - tri.v0.x) * (tri.v2.y - tri.v0.y) - (tri.v1.y - tri.v0.y) * (tri.v2.x - tri.v0.x);
+            if (std::abs(area) < 1e-6f)
+                continue;
+            // counter-clockwise order
+            if (area < 0.0f)
+                std::swap(tri.v1, tri.v2);
+            tri.minY = std::min({tri.v0.y, tri.v1.y, tri.v2.y});
+            tri.maxY = std::max({tri.v0.y, tri.v1.y, tri.v2.y});
+            float minX = std::min({tri.v0.x, tri.v1.x, tri.v2.x});
+            float maxX = std::max({tri.v0.x, tri.v1.x, tri.v2.x});
+            if (maxX < 0.0f || minX > _width || tri.maxY < 0.0f || tri.minY > _height)
+                continue;
+            _triangles.push_back(tri);
+        }
+    }
+}
+
+void OcclusionCuller::rasterizeRows(int rowBegin, int rowEnd)
+{
+    std::fill(_depth.begin() + static_cast<size_t>(rowBegin) * _width,
+              _depth.begin() + static_cast<size_t>(rowEnd) * _width, 1.0f);
+    for (const auto &tri : _triangles)
+    {
+        if (tri.maxY < rowBegin || tri.minY > rowEnd)
+            continue;
+        if (useSIMD && SIMD_ENABLED)
+            rasterizeTriangleSIMD(tri, rowBegin, rowEnd);
+        else
+            rasterizeTriangleScalar(tri, rowBegin, rowEnd);
+    }
+    updateTiles(rowBegin, rowEnd);
+}
+
+/// Edge function a * x + b * y + c, positive on the left of v0 -> v1
+struct OcclusionEdge
+{
+    OcclusionEdge(const glm::vec3 &v0, const glm::vec3 &v1)
+    {
+        a = v0.y - v1.y;
+        b = v1.x - v0.x;
+        c = -(a * v0.x + b * v0.y);
+    }
+    float a, b, c;
+};
+
+/// Depth plane z = z0 + dzdx * (x - x0) + dzdy * (y - y0), as a * x + b * y + c
+struct OcclusionDepthPlane
+{
+    OcclusionDepthPlane(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2)
+    {
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+        float areaInv = 1.0f / area;
+        a = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) * areaInv;
+        b = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) * areaInv;
+        c = v0.z - a * v0.x - b * v0.y;
+    }
+    float a, b, c;
+};
+
+void OcclusionCuller::rasterizeTriangleScalar(const ScreenTriangle &tri, int rowBegin, int rowEnd)
+{
+    OcclusionEdge e0(tri.v1, tri.v2), e1(tri.v2, tri.v0), e2(tri.v0, tri.v1);
+    OcclusionDepthPlane plane(tri.v0, tri.v1, tri.v2);
+    int x0 = std::max(0, static_cast<int>(std::floor(std::min({tri.v0.x, tri.v1.x, tri.v2.x}))));
+    int x1 = std::min(_width, static_cast<int>(std::ceil(std::max({tri.v0.x, tri.v1.x, tri.v2.x}))));
+    int y0 = std::max(rowBegin, static_cast<int>(std::floor(tri.minY)));
+    int y1 = std::min(rowEnd, static_cast<int>(std::ceil(tri.maxY)));
+    for (int y = y0; y < y1; ++y)
+    {
+        float py = y + 0.5f;
+        auto row = _depth.data() + static_cast<size_t>(y) * _width;
+        for (int x = x0; x < x1; ++x)
+        {
+            float px = x + 0.5f;
+            if (e0.a * px + e0.b * py + e0.c < 0.0f || e1.a * px + e1.b * py + e1.c < 0.0f ||
+                e2.a * px + e2.b * py + e2.c < 0.0f)
+                continue;
+            row[x] = std::min(row[x], plane.a * px + plane.b * py + plane.c);
+        }
+    }
+}
+
+void OcclusionCuller::rasterizeTriangleSIMD(const ScreenTriangle &tri, int rowBegin, int rowEnd)
+{
+#ifdef RENDERIT_SIMD_SSE
+    OcclusionEdge e0(tri.v1, tri.v2), e1(tri.v2, tri.v0), e2(tri.v0, tri.v1);
+    OcclusionDepthPlane plane(tri.v0, tri.v1, tri.v2);
+    // start at multiple of 4, width is a multiple of 4, lanes outside [xMin, x1) are masked as in scalar path
+    int xMin = std::max(0, static_cast<int>(std::floor(std::min({tri.v0.x, tri.v1.x, tri.v2.x}))));
+    int x0 = xMin & ~3;
+    int x1 = std::min(_width, static_cast<int>(std::ceil(std::max({tri.v0.x, tri.v1.x, tri.v2.x}))));
+    int y0 = std::max(rowBegin, static_cast<int>(std::floor(tri.minY)));
+    int y1 = std::min(rowEnd, static_cast<int>(std::ceil(tri.maxY)));
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 e0a = _mm_set1_ps(e0.a), e1a = _mm_set1_ps(e1.a), e2a = _mm_set1_ps(e2.a), za = _mm_set1_ps(plane.a);
+    const __m128 e0c = _mm_set1_ps(e0.c), e1c = _mm_set1_ps(e1.c), e2c = _mm_set1_ps(e2.c), zc = _mm_set1_ps(plane.c);
+    const __m128 rangeMin = _mm_set1_ps(static_cast<float>(xMin)), rangeMax = _mm_set1_ps(static_cast<float>(x1));
+    for (int y = y0; y < y1; ++y)
+    {
+        float py = y + 0.5f;
+        auto row = _depth.data() + static_cast<size_t>(y) * _width;
+        const __m128 e0b = _mm_set1_ps(e0.b * py), e1b = _mm_set1_ps(e1.b * py), e2b = _mm_set1_ps(e2.b * py),
+                     zb = _mm_set1_ps(plane.b * py);
+        for (int x = x0; x < x1; x += 4)
+        {
+            // evaluated per block in same order as scalar path (a * x + b * y + c), no incremental drift
+            __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+            __m128 w0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e0a, px), e0b), e0c);
+            __m128 w1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1a, px), e1b), e1c);
+            __m128 w2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2a, px), e2b), e2c);
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)),
+                                       _mm_cmpge_ps(w2, zero));
+            inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(px, rangeMin), _mm_cmplt_ps(px, rangeMax)));
+            if (_mm_movemask_ps(inside))
+            {
+                __m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(za, px), zb), zc);
+                __m128 depth = _mm_loadu_ps(row + x);
+                __m128 closer = _mm_min_ps(depth, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, depth)));
+            }
+        }
+    }
+#else
+    rasterizeTriangleScalar(tri, rowBegin, rowEnd);
+#endif
+}
+
+void OcclusionCuller::updateTiles(int rowBegin, int rowEnd)
+{
+    for (int ty = rowBegin / OCCLUSION_TILE_SIZE; ty < rowEnd / OCCLUSION_TILE_SIZE; ++ty)
+    {
+        for (int tx = 0; tx < _tilesX; ++tx)
+        {
+            float maxDepth = 0.0f;
+            for (int y = ty * OCCLUSION_TILE_SIZE; y < (ty + 1) * OCCLUSION_TILE_SIZE; ++y)
+            {
+                auto row = _depth.data() + static_cast<size_t>(y) * _width + tx * OCCLUSION_TILE_SIZE;
+                for (int x = 0; x < OCCLUSION_TILE_SIZE; ++x)
+                    maxDepth = std::max(maxDepth, row[x]);
+            }
+            _tileDepth[ty * _tilesX + tx] = maxDepth;
+        }
+    }
+}
+
+} // namespace RenderIt
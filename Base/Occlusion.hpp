@@ -0,0 +1,131 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Bounds.hpp"
+#include "Jobs.hpp"
+#include "Model.hpp"
+
+#define OCCLUSION_WIDTH 256
+#define OCCLUSION_HEIGHT 128
+#define OCCLUSION_TILE_SIZE 8
+#define OCCLUSION_MAX_TRIANGLES 4096
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// CPU occlusion culling with a low resolution depth buffer
+/// Large occluders are rasterized on worker threads, then bounds of other models
+/// are tested against per-tile max depth before submission
+/// Depth is NDC depth remapped to [0, 1], cleared to 1 (far)
+class OcclusionCuller
+{
+  public:
+    OcclusionCuller(int width = OCCLUSION_WIDTH, int height = OCCLUSION_HEIGHT, unsigned numThreads = 0);
+
+    ~OcclusionCuller();
+
+    /// Pick non-animated models with world bounds diagonal >= minSize as occluders
+    /// Geometry is read back from GPU once, meshes above OCCLUSION_MAX_TRIANGLES are skipped
+    size_t SelectOccluders(const std::vector<const Model *> &models, float minSize);
+
+    /// Add occluder from CPU triangles, matrix transforms to world space
+    /// If model is set, its transform is read at every Begin
+    void AddOccluder(const std::vector<glm::vec3> &positions, const std::vector<unsigned> &indices,
+                     const glm::mat4 &matrix = glm::mat4(1.0f), const Model *model = nullptr);
+
+    /// Remove all occluders
+    void ClearOccluders();
+
+    /// Start rasterizing occluders on worker threads
+    void Begin(const glm::mat4 &projView);
+
+    /// Wait for rasterization started by Begin
+    void Wait();
+
+    /// Rasterize occluders and wait
+    void Rasterize(const glm::mat4 &projView);
+
+    /// Test bounds in model space, returns false only if fully occluded or off screen
+    bool IsVisible(const Bounds &bounds, const glm::mat4 &matrix = glm::mat4(1.0f)) const;
+
+    /// Test model bounds with its transform
+    bool IsVisible(const Model *model) const;
+
+    /// Get depth buffer (row major, bottom row first)
+    const std::vector<float> &GetDepthBuffer() const;
+
+    /// Get per-tile max depth (row major, bottom row first)
+    const std::vector<float> &GetTileDepth() const;
+
+    /// Get depth buffer width
+    int GetWidth() const;
+
+    /// Get depth buffer height
+    int GetHeight() const;
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "OcclusionCuller";
+    // disable to run the scalar reference rasterizer
+    bool useSIMD;
+
+  private:
+    /// Occluder triangles in model space
+    struct Occluder
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<unsigned> indices;
+        glm::mat4 matrix;
+        const Model *model;
+    };
+
+    /// Triangle in screen space, (x, y) in pixels and z in [0, 1]
+    struct ScreenTriangle
+    {
+        glm::vec3 v0, v1, v2;
+        float minY, maxY;
+    };
+
+    /// Transform & setup occluder triangles
+    void setupTriangles(const glm::mat4 &projView, const std::vector<glm::mat4> &matrices);
+
+    /// Rasterize triangles into rows [rowBegin, rowEnd) and update their tiles
+    void rasterizeRows(int rowBegin, int rowEnd);
+
+    /// Rasterize triangle into rows, scalar path
+    void rasterizeTriangleScalar(const ScreenTriangle &tri, int rowBegin, int rowEnd);
+
+    /// Rasterize triangle into rows, 4 pixels at a time
+    void rasterizeTriangleSIMD(const ScreenTriangle &tri, int rowBegin, int rowEnd);
+
+    /// Update max depth of tiles in rows
+    void updateTiles(int rowBegin, int rowEnd);
+
+  private:
+    int _width, _height;
+    int _tilesX, _tilesY;
+    unsigned _numThreads;
+    glm::mat4 _projView;
+
+    std::vector<Occluder> _occluders;
+    std::vector<ScreenTriangle> _triangles;
+    std::vector<float> _depth;
+    std::vector<float> _tileDepth;
+
+    std::shared_ptr<JobSystem> _jobs;
+    std::shared_ptr<JobCounter> _pending;
+    double _lastRasterMs;
+    // atomic since scenes may be recorded on worker threads
+    mutable std::atomic<size_t> _numTested, _numCulled;
+};
+
+} // namespace RenderIt
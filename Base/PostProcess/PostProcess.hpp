@@ -5,6 +5,7 @@
 
 #include <GL/glew.h>
 
+#include "Device.hpp"
 #include "GLStructs.hpp"
 #include "Shader.hpp"
 
@@ -45,20 +46,22 @@ class PostProcess
     void ReadFramebuffer(const PostProcess *other, GLbitfield mask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT,
                          GLenum filter = GL_NEAREST)
     {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, other->GetFramebuffer());
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GetFramebuffer());
-        glBlitFramebuffer(0, 0, other->_frameWidth, other->_frameHeight, 0, 0, _frameWidth, _frameHeight, mask, filter);
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        auto &device = GraphicsDevice::Get();
+        device.BindFramebuffer(GL_READ_FRAMEBUFFER, other->GetFramebuffer());
+        device.BindFramebuffer(GL_DRAW_FRAMEBUFFER, GetFramebuffer());
+        device.BlitFramebuffer(other->_frameWidth, other->_frameHeight, _frameWidth, _frameHeight, mask, filter);
+        device.BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        device.BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     }
 
     void ReadGlobalFramebuffer(int w, int h, GLbitfield mask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT,
                                GLenum filter = GL_NEAREST)
     {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GetFramebuffer());
-        glBlitFramebuffer(0, 0, w, h, 0, 0, _frameWidth, _frameHeight, mask, filter);
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        auto &device = GraphicsDevice::Get();
+        device.BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        device.BindFramebuffer(GL_DRAW_FRAMEBUFFER, GetFramebuffer());
+        device.BlitFramebuffer(w, h, _frameWidth, _frameHeight, mask, filter);
+        device.BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     }
 
     /// UI calls
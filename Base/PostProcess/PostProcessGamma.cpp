@@ -1,4 +1,6 @@
 #include "PostProcess/PostProcessGamma.hpp"
+#include "Device.hpp"
+#include "RenderStats.hpp"
 #include "Tools.hpp"
 
 #include <algorithm>
@@ -30,6 +32,9 @@ void PostProcessGamma::StopRecord()
 
 void PostProcessGamma::Draw(std::function<void(const Shader *)> func)
 {
+    if (!_shader->Poll(true))
+        return;
+    RENDER_PASS("PostProcess");
     _shader->Bind();
     if (func)
         func(_shader.get());
@@ -42,7 +47,7 @@ void PostProcessGamma::Draw(std::function<void(const Shader *)> func)
     else
         Tools::display_message(NAME, "no screen texture!", Tools::MessageType::WARN);
     _VAO->Bind();
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    GraphicsDevice::Get().DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     _VAO->UnBind();
     _shader->UnBind();
 }
@@ -93,7 +98,8 @@ void PostProcessGamma::loadShader()
     _shader = std::make_unique<Shader>();
     _shader->AddSource(vertShader, GL_VERTEX_SHADER);
     _shader->AddSource(fragShader, GL_FRAGMENT_SHADER);
-    _shader->Compile();
+    // finished on first draw, so shaders of all filters compile in parallel
+    Tools::compile_shaders_parallel({_shader.get()}, false);
 }
 
 void PostProcessGamma::loadVAO()
@@ -111,24 +117,26 @@ void PostProcessGamma::loadVAO()
     _VBO = std::make_unique<SBuffer>(GL_ARRAY_BUFFER);
     _VAO->Bind();
     _VBO->Bind();
-    glBufferData(_VBO->type, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0);
+    auto &device = GraphicsDevice::Get();
+    device.BufferData(_VBO->type, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    device.VertexAttribute(0, 2, GL_FLOAT, false, 2 * sizeof(float), 0);
     _VAO->UnBind();
 }
 
 bool PostProcessGamma::loadFBO()
 {
+    GPU_MEMORY_SCOPE(RenderTargets, "PostProcessGamma");
+    auto &device = GraphicsDevice::Get();
     _TEX = std::make_unique<STexture>(GL_TEXTURE_2D);
     _TEX->Bind();
-    glTexImage2D(_TEX->type, 0, GL_RGBA16F, _frameWidth, _frameHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    device.TexImage2D(_TEX->type, GL_RGBA16F, _frameWidth, _frameHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     _TEX->UnBind();
 
     _RBO = std::make_unique<SRBO>();
     _RBO->Bind();
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _frameWidth, _frameHeight);
+    device.RenderbufferStorage(GL_DEPTH24_STENCIL8, _frameWidth, _frameHeight);
     _RBO->UnBind();
 
     _FBO = std::make_unique<SFBO>();
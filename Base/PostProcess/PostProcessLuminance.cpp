@@ -1,4 +1,6 @@
 #include "PostProcess/PostProcessLuminance.hpp"
+#include "Device.hpp"
+#include "RenderStats.hpp"
 #include "Tools.hpp"
 
 #include <algorithm>
@@ -56,16 +58,18 @@ void PostProcessLuminance::Draw(std::function<void(const Shader *)> func)
 
 void PostProcessLuminance::Compute(float timeDelta)
 {
-    if (!_FBO)
+    if (!_FBO || !_shaderFill->Poll(true) || !_shaderComp->Poll(true))
         return;
+    RENDER_PASS("Luminance");
+    auto &device = GraphicsDevice::Get();
     // dispatch to fill histogram buffer
     _histSSBO->BindBase(1u);
     _shaderFill->Bind();
     _shaderFill->UniformFloat("minLogLum", _minLog);
     _shaderFill->UniformFloat("rangeLogLumInv", _rangeLogInv);
-    glBindImageTexture(0u, _TEX->Get(), 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
-    glDispatchCompute(_dispatchX, _dispatchY, 1);
-    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    device.BindImageTexture(0u, _TEX->Get(), 0, GL_READ_ONLY, GL_RGBA16F);
+    device.DispatchCompute(_dispatchX, _dispatchY, 1);
+    device.Barrier(GL_SHADER_STORAGE_BARRIER_BIT);
     _shaderFill->UnBind();
     // dispatch to compute values (max, min, avg)
     _shaderComp->Bind();
@@ -73,18 +77,18 @@ void PostProcessLuminance::Compute(float timeDelta)
     _shaderComp->UniformFloat("minLogLum", _minLog);
     _shaderComp->UniformFloat("rangeLogLum", _rangeLog);
     _valsSSBO->BindBase(0u);
-    glDispatchCompute(1, 1, 1);
-    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    device.DispatchCompute(1, 1, 1);
+    device.Barrier(GL_SHADER_STORAGE_BARRIER_BIT);
     _valsSSBO->UnBindBase(0u);
     _shaderComp->UnBind();
     _histSSBO->UnBindBase(1u);
     // retrieve values
     _valsSSBO->Bind();
-    auto dataPtr = reinterpret_cast<float *>(glMapBuffer(_valsSSBO->type, GL_READ_ONLY));
+    auto dataPtr = reinterpret_cast<float *>(device.MapBuffer(_valsSSBO->Get(), GL_READ_ONLY));
     _lumMax = *dataPtr;
     _lumMin = *(dataPtr + 1);
     _lumAvg = *(dataPtr + 2);
-    glUnmapBuffer(_valsSSBO->type);
+    device.UnmapBuffer(_valsSSBO->Get());
     _valsSSBO->UnBind();
     // compute smooth luminance average
     if (timeDelta >= 0.0f)
@@ -178,7 +182,6 @@ void PostProcessLuminance::loadShader()
     )";
     _shaderFill = std::make_unique<Shader>();
     _shaderFill->AddSource(compShaderFill, GL_COMPUTE_SHADER);
-    _shaderFill->Compile();
 
     std::string compShaderComp = R"(
         #version 450 core
@@ -246,21 +249,24 @@ void PostProcessLuminance::loadShader()
     )";
     _shaderComp = std::make_unique<Shader>();
     _shaderComp->AddSource(compShaderComp, GL_COMPUTE_SHADER);
-    _shaderComp->Compile();
+    // both passes compile together, finished on first compute
+    Tools::compile_shaders_parallel({_shaderFill.get(), _shaderComp.get()}, false);
 }
 
 bool PostProcessLuminance::loadFBO()
 {
+    GPU_MEMORY_SCOPE(RenderTargets, "PostProcessLuminance");
+    auto &device = GraphicsDevice::Get();
     _TEX = std::make_unique<STexture>(GL_TEXTURE_2D);
     _TEX->Bind();
-    glTexImage2D(_TEX->type, 0, GL_RGBA16F, _frameWidth, _frameHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    device.TexImage2D(_TEX->type, GL_RGBA16F, _frameWidth, _frameHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     _TEX->UnBind();
 
     _RBO = std::make_unique<SRBO>();
     _RBO->Bind();
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _frameWidth, _frameHeight);
+    device.RenderbufferStorage(GL_DEPTH24_STENCIL8, _frameWidth, _frameHeight);
     _RBO->UnBind();
 
     _FBO = std::make_unique<SFBO>();
@@ -282,12 +288,13 @@ void PostProcessLuminance::loadSSBO()
     // histogram & buffers
     _histSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
     _histSSBO->Bind();
-    glBufferData(_histSSBO->type, 3 * DISPATCH_GROUPSIZE * sizeof(unsigned), nullptr, GL_DYNAMIC_COPY);
+    GraphicsDevice::Get().BufferData(_histSSBO->type, 3 * DISPATCH_GROUPSIZE * sizeof(unsigned), nullptr,
+                                     GL_DYNAMIC_COPY);
     _histSSBO->UnBind();
     // max, min, sum
     _valsSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
     _valsSSBO->Bind();
-    glBufferData(_valsSSBO->type, 3 * sizeof(float), nullptr, GL_DYNAMIC_READ);
+    GraphicsDevice::Get().BufferData(_valsSSBO->type, 3 * sizeof(float), nullptr, GL_DYNAMIC_READ);
     _valsSSBO->UnBind();
 }
 
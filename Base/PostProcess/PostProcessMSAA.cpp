@@ -1,4 +1,6 @@
 #include "PostProcess/PostProcessMSAA.hpp"
+#include "Device.hpp"
+#include "RenderStats.hpp"
 #include "Tools.hpp"
 
 #include <algorithm>
@@ -30,6 +32,9 @@ void PostProcessMSAA::StopRecord()
 
 void PostProcessMSAA::Draw(std::function<void(const Shader *)> func)
 {
+    if (!_shader->Poll(true))
+        return;
+    RENDER_PASS("PostProcess");
     _shader->Bind();
     if (func)
         func(_shader.get());
@@ -42,7 +47,7 @@ void PostProcessMSAA::Draw(std::function<void(const Shader *)> func)
         Tools::display_message(NAME, "no screen texture!", Tools::MessageType::WARN);
     _shader->UniformInt("numSamples", _numSamples);
     _VAO->Bind();
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    GraphicsDevice::Get().DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     _VAO->UnBind();
     _shader->UnBind();
 }
@@ -99,7 +104,7 @@ void PostProcessMSAA::loadShader()
     _shader = std::make_unique<Shader>();
     _shader->AddSource(vertShader, GL_VERTEX_SHADER);
     _shader->AddSource(fragShader, GL_FRAGMENT_SHADER);
-    _shader->Compile();
+    Tools::compile_shaders_parallel({_shader.get()}, false);
 }
 
 void PostProcessMSAA::loadVAO()
@@ -117,22 +122,24 @@ void PostProcessMSAA::loadVAO()
     _VBO = std::make_unique<SBuffer>(GL_ARRAY_BUFFER);
     _VAO->Bind();
     _VBO->Bind();
-    glBufferData(_VBO->type, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0);
+    auto &device = GraphicsDevice::Get();
+    device.BufferData(_VBO->type, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    device.VertexAttribute(0, 2, GL_FLOAT, false, 2 * sizeof(float), 0);
     _VAO->UnBind();
 }
 
 bool PostProcessMSAA::loadFBO()
 {
+    GPU_MEMORY_SCOPE(RenderTargets, "PostProcessMSAA");
+    auto &device = GraphicsDevice::Get();
     _TEX = std::make_unique<STexture>(GL_TEXTURE_2D_MULTISAMPLE);
     _TEX->Bind();
-    glTexImage2DMultisample(_TEX->type, _numSamples, GL_RGBA16F, _frameWidth, _frameHeight, GL_TRUE);
+    device.TexImage2DMultisample(_TEX->type, _numSamples, GL_RGBA16F, _frameWidth, _frameHeight);
     _TEX->UnBind();
 
     _RBO = std::make_unique<SRBO>();
     _RBO->Bind();
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, _numSamples, GL_DEPTH24_STENCIL8, _frameWidth, _frameHeight);
+    device.RenderbufferStorage(GL_DEPTH24_STENCIL8, _frameWidth, _frameHeight, _numSamples);
     _RBO->UnBind();
 
     _FBO = std::make_unique<SFBO>();
@@ -1,4 +1,6 @@
 #include "PostProcess/PostProcessTone.hpp"
+#include "Device.hpp"
+#include "RenderStats.hpp"
 #include "Tools.hpp"
 
 #include <algorithm>
@@ -30,6 +32,9 @@ void PostProcessTone::StopRecord()
 
 void PostProcessTone::Draw(std::function<void(const Shader *)> func)
 {
+    if (!_shader->Poll(true))
+        return;
+    RENDER_PASS("PostProcess");
     _shader->Bind();
     if (func)
         func(_shader.get());
@@ -42,7 +47,7 @@ void PostProcessTone::Draw(std::function<void(const Shader *)> func)
         Tools::display_message(NAME, "no screen texture!", Tools::MessageType::WARN);
     _shader->UniformFloat("exposure", _exposure);
     _VAO->Bind();
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    GraphicsDevice::Get().DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     _VAO->UnBind();
     _shader->UnBind();
 }
@@ -88,7 +93,7 @@ void PostProcessTone::loadShader()
     _shader = std::make_unique<Shader>();
     _shader->AddSource(vertShader, GL_VERTEX_SHADER);
     _shader->AddSource(fragShader, GL_FRAGMENT_SHADER);
-    _shader->Compile();
+    Tools::compile_shaders_parallel({_shader.get()}, false);
 }
 
 void PostProcessTone::loadVAO()
@@ -106,24 +111,26 @@ void PostProcessTone::loadVAO()
     _VBO = std::make_unique<SBuffer>(GL_ARRAY_BUFFER);
     _VAO->Bind();
     _VBO->Bind();
-    glBufferData(_VBO->type, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 0);
+    auto &device = GraphicsDevice::Get();
+    device.BufferData(_VBO->type, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    device.VertexAttribute(0, 2, GL_FLOAT, false, 2 * sizeof(float), 0);
     _VAO->UnBind();
 }
 
 bool PostProcessTone::loadFBO()
 {
+    GPU_MEMORY_SCOPE(RenderTargets, "PostProcessTone");
+    auto &device = GraphicsDevice::Get();
     _TEX = std::make_unique<STexture>(GL_TEXTURE_2D);
     _TEX->Bind();
-    glTexImage2D(_TEX->type, 0, GL_RGBA16F, _frameWidth, _frameHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    device.TexImage2D(_TEX->type, GL_RGBA16F, _frameWidth, _frameHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     _TEX->UnBind();
 
     _RBO = std::make_unique<SRBO>();
     _RBO->Bind();
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _frameWidth, _frameHeight);
+    device.RenderbufferStorage(GL_DEPTH24_STENCIL8, _frameWidth, _frameHeight);
     _RBO->UnBind();
 
     _FBO = std::make_unique<SFBO>();
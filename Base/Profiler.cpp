@@ -0,0 +1,262 @@
+#include "Profiler.hpp"
+#include "Device.hpp"
+#include "Tools.hpp"
+
+#include <chrono>
+#include <fstream>
+
+namespace RenderIt
+{
+
+static thread_local int tls_profileThread = -1;
+static thread_local unsigned tls_profileDepth = 0;
+static std::atomic<unsigned> numProfileThreads{0};
+
+/// Index of calling thread, in order of first profiled scope
+static unsigned profile_thread_index()
+{
+    if (tls_profileThread < 0)
+        tls_profileThread = static_cast<int>(numProfileThreads.fetch_add(1));
+    return static_cast<unsigned>(tls_profileThread);
+}
+
+/// Escape string for JSON
+static std::string json_escape(const char *str)
+{
+    std::string result;
+    for (; str && *str; ++str)
+    {
+        if (*str == '"' || *str == '\\')
+            result.push_back('\\');
+        result.push_back(*str);
+    }
+    return result;
+}
+
+Profiler::Profiler()
+    : _epoch(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now().time_since_epoch())
+                 .count()),
+      _currentGPUReference(0), _gpuDepth(0), _captureRemaining(0), _numDropped(0)
+{
+}
+
+Profiler::~Profiler()
+{
+    if (!_queries.empty())
+        GraphicsDevice::Get().DeleteObjects(DeviceObject::Query, static_cast<GLsizei>(_queries.size()),
+                                            _queries.data());
+}
+
+std::shared_ptr<Profiler> Profiler::Instance()
+{
+    static auto profiler = std::make_shared<Profiler>();
+    return profiler;
+}
+
+void Profiler::SetEnabled(bool enable)
+{
+    _enabled.store(enable);
+}
+
+void Profiler::EndFrame()
+{
+    auto &device = GraphicsDevice::Get();
+    auto tEnd = now();
+    PendingFrame pending;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        pending.frame = std::move(_current);
+        _current = ProfileFrame();
+        _current.index = pending.frame.index + 1;
+        _current.start = tEnd;
+    }
+    pending.frame.duration = tEnd - pending.frame.start;
+    pending.queries = std::move(_currentQueries);
+    pending.gpuReference = _currentGPUReference;
+    _currentQueries.clear();
+    _gpuDepth = 0;
+
+    auto enabled = IsEnabled();
+    // pair next frame start with GPU clock, to place GPU events on CPU timeline
+    _currentGPUReference = enabled && device.HasContext() ? device.GetTimestamp() : 0;
+    if (enabled || !pending.frame.cpuEvents.empty() || !pending.queries.empty())
+        _pending.push_back(std::move(pending));
+
+    while (!_pending.empty())
+    {
+        auto &front = _pending.front();
+        if (!resolve(front))
+        {
+            if (_pending.size() <= PROFILER_GPU_FRAMES_IN_FLIGHT)
+                break;
+            // too far behind, drop GPU results instead of waiting
+            ++_numDropped;
+            for (const auto &query : front.queries)
+            {
+                _freeQueries.push_back(query.begin);
+                _freeQueries.push_back(query.end);
+            }
+        }
+        finish(std::move(front.frame));
+        _pending.pop_front();
+    }
+}
+
+const ProfileFrame &Profiler::GetLastFrame() const
+{
+    return _lastFrame;
+}
+
+void Profiler::Capture(unsigned numFrames)
+{
+    _captured.clear();
+    _captured.reserve(numFrames);
+    _captureRemaining = numFrames;
+    if (numFrames)
+        SetEnabled(true);
+}
+
+bool Profiler::IsCapturing() const
+{
+    return _captureRemaining > 0;
+}
+
+size_t Profiler::GetNumCaptured() const
+{
+    return _captured.size();
+}
+
+bool Profiler::ExportChromeTrace(const std::string &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        Tools::display_message(LOGNAME, "Failed to write trace to " + path, Tools::MessageType::WARN);
+        return false;
+    }
+    // pid 0: frames, pid 1: CPU threads, pid 2: GPU
+    file << "{\"traceEvents\":[\n";
+    file << R"({"name":"process_name","ph":"M","pid":0,"args":{"name":"Frames"}},)" << "\n";
+    file << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"CPU"}},)" << "\n";
+    file << R"({"name":"process_name","ph":"M","pid":2,"args":{"name":"GPU"}})";
+    auto writeEvent = [&file](const std::string &name, const char *cat, int pid, unsigned tid, double ts,
+                              double dur) {
+        file << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << cat << "\",\"ph\":\"X\",\"pid\":" << pid
+             << ",\"tid\":" << tid << ",\"ts\":" << ts << ",\"dur\":" << dur << "}";
+    };
+    file.precision(3);
+    file << std::fixed;
+    for (const auto &frame : _captured)
+    {
+        writeEvent("Frame " + std::to_string(frame.index), "frame", 0, 0, frame.start, frame.duration);
+        for (const auto &event : frame.cpuEvents)
+            writeEvent(json_escape(event.name), "cpu", 1, event.thread, event.start, event.duration);
+        for (const auto &event : frame.gpuEvents)
+            writeEvent(json_escape(event.name), "gpu", 2, 0, event.start, event.duration);
+    }
+    file << "\n]}\n";
+    Tools::display_message(LOGNAME, "Trace of " + std::to_string(_captured.size()) + " frames written to " + path,
+                           Tools::MessageType::INFO);
+    return true;
+}
+
+double Profiler::now() const
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now().time_since_epoch())
+                  .count();
+    return static_cast<double>(ns - _epoch) * 1e-3;
+}
+
+void Profiler::beginScope(ProfileScope &scope, bool gpu)
+{
+    scope._active = true;
+    scope._depth = tls_profileDepth++;
+    scope._start = now();
+    auto &device = GraphicsDevice::Get();
+    if (!gpu || !device.HasContext())
+        return;
+    GPUQuery query{scope._name, _gpuDepth++, acquireQuery(), acquireQuery()};
+    device.QueryTimestamp(query.begin);
+    scope._frame = _current.index;
+    scope._gpuQuery = static_cast<int>(_currentQueries.size());
+    _currentQueries.push_back(query);
+}
+
+void Profiler::endScope(ProfileScope &scope)
+{
+    ProfileEvent event;
+    event.name = scope._name;
+    event.thread = profile_thread_index();
+    event.depth = scope._depth;
+    event.start = scope._start;
+    event.duration = now() - scope._start;
+    --tls_profileDepth;
+    if (scope._gpuQuery >= 0)
+    {
+        --_gpuDepth;
+        // scopes crossing frame end are dropped with their frame
+        if (scope._frame == _current.index)
+            GraphicsDevice::Get().QueryTimestamp(_currentQueries[scope._gpuQuery].end);
+    }
+    std::lock_guard<std::mutex> lock(_mtx);
+    _current.cpuEvents.push_back(event);
+}
+
+GLuint Profiler::acquireQuery()
+{
+    if (_freeQueries.empty())
+    {
+        std::vector<GLuint> queries(32);
+        GraphicsDevice::Get().CreateObjects(DeviceObject::Query, static_cast<GLsizei>(queries.size()),
+                                            queries.data());
+        _queries.insert(_queries.end(), queries.begin(), queries.end());
+        _freeQueries.insert(_freeQueries.end(), queries.begin(), queries.end());
+    }
+    auto query = _freeQueries.back();
+    _freeQueries.pop_back();
+    return query;
+}
+
+bool Profiler::resolve(PendingFrame &pending)
+{
+    auto &device = GraphicsDevice::Get();
+    std::vector<GLuint64> times(pending.queries.size() * 2);
+    // queries complete in order, test last one first
+    for (auto i = pending.queries.size(); i-- > 0;)
+    {
+        const auto &query = pending.queries[i];
+        if (!device.GetQueryResult(query.end, times[i * 2 + 1]) || !device.GetQueryResult(query.begin, times[i * 2]))
+            return false;
+    }
+    auto &frame = pending.frame;
+    frame.gpuEvents.reserve(pending.queries.size());
+    for (auto i = 0u; i < pending.queries.size(); ++i)
+    {
+        const auto &query = pending.queries[i];
+        ProfileEvent event;
+        event.name = query.name;
+        event.depth = query.depth;
+        event.start = frame.start + static_cast<double>(static_cast<int64_t>(times[i * 2] - pending.gpuReference)) *
+                                        1e-3;
+        event.duration = static_cast<double>(times[i * 2 + 1] - times[i * 2]) * 1e-3;
+        frame.gpuEvents.push_back(event);
+        _freeQueries.push_back(query.begin);
+        _freeQueries.push_back(query.end);
+    }
+    frame.gpuResolved = true;
+    return true;
+}
+
+void Profiler::finish(ProfileFrame &&frame)
+{
+    if (_captureRemaining)
+    {
+        _captured.push_back(frame);
+        --_captureRemaining;
+    }
+    _lastFrame = std::move(frame);
+}
+
+} // namespace RenderIt
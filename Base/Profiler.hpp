@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#define PROFILER_GPU_FRAMES_IN_FLIGHT 4
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+/// Time CPU scope on any thread, name must be a string literal
+#define PROFILE_SCOPE(name) RenderIt::ProfileScope PROFILER_CONCAT(_profileScope, __LINE__)(name, false)
+
+/// Time CPU & GPU scope, only on GL thread
+#define PROFILE_GPU_SCOPE(name) RenderIt::ProfileScope PROFILER_CONCAT(_profileScope, __LINE__)(name, true)
+
+/** @file */
+
+namespace RenderIt
+{
+
+class ProfileScope;
+
+/// Timed scope, times in microseconds since profiler start
+struct ProfileEvent
+{
+    const char *name = nullptr;
+    unsigned thread = 0;
+    unsigned depth = 0;
+    double start = 0.0;
+    double duration = 0.0;
+};
+
+/// Timed scopes of one frame
+struct ProfileFrame
+{
+    uint64_t index = 0;
+    double start = 0.0;
+    double duration = 0.0;
+    std::vector<ProfileEvent> cpuEvents;
+    std::vector<ProfileEvent> gpuEvents;
+    /// Whether GPU queries were resolved, false if dropped
+    bool gpuResolved = false;
+};
+
+/// Frame profiler of CPU scopes & GPU timestamp queries
+/// GPU results are read PROFILER_GPU_FRAMES_IN_FLIGHT frames later without stalling
+/// Scopes cost one relaxed atomic load when disabled
+class Profiler
+{
+    friend class ProfileScope;
+
+  public:
+    Profiler();
+
+    ~Profiler();
+
+    /// Get singleton
+    static std::shared_ptr<Profiler> Instance();
+
+    /// Enable/Disable recording
+    static void SetEnabled(bool enable);
+
+    /// Whether recording
+    static bool IsEnabled()
+    {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Close current frame & start next, called by AppContext on GL thread
+    void EndFrame();
+
+    /// Get latest frame with resolved GPU queries
+    const ProfileFrame &GetLastFrame() const;
+
+    /// Keep next frames for export
+    void Capture(unsigned numFrames);
+
+    /// Whether capture is in progress
+    bool IsCapturing() const;
+
+    /// Get number of captured frames
+    size_t GetNumCaptured() const;
+
+    /// Export captured frames as Chrome trace JSON (chrome://tracing, Perfetto)
+    bool ExportChromeTrace(const std::string &path) const;
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "Profiler";
+
+  private:
+    /// GPU scope waiting for timestamps
+    struct GPUQuery
+    {
+        const char *name;
+        unsigned depth;
+        GLuint begin, end;
+    };
+
+    /// Frame waiting for GPU results
+    struct PendingFrame
+    {
+        ProfileFrame frame;
+        std::vector<GPUQuery> queries;
+        GLuint64 gpuReference;
+    };
+
+    /// Get microseconds since profiler start
+    double now() const;
+
+    void beginScope(ProfileScope &scope, bool gpu);
+
+    void endScope(ProfileScope &scope);
+
+    /// Get query from pool
+    GLuint acquireQuery();
+
+    /// Convert resolved queries into events, false if not ready
+    bool resolve(PendingFrame &pending);
+
+    /// Store frame as latest & capture it
+    void finish(ProfileFrame &&frame);
+
+  private:
+    static inline std::atomic<bool> _enabled{false};
+
+    const int64_t _epoch;
+    mutable std::mutex _mtx;
+    ProfileFrame _current;
+    std::vector<GPUQuery> _currentQueries;
+    GLuint64 _currentGPUReference;
+    unsigned _gpuDepth;
+    std::deque<PendingFrame> _pending;
+    std::vector<GLuint> _queries, _freeQueries;
+    ProfileFrame _lastFrame;
+    std::vector<ProfileFrame> _captured;
+    unsigned _captureRemaining;
+    size_t _numDropped;
+};
+
+/// Scope timed from construction to destruction, see PROFILE_SCOPE
+class ProfileScope
+{
+    friend class Profiler;
+
+  public:
+    ProfileScope(const char *name, bool gpu) : _name(name)
+    {
+        if (Profiler::IsEnabled())
+            Profiler::Instance()->beginScope(*this, gpu);
+    }
+
+    ~ProfileScope()
+    {
+        if (_active)
+            Profiler::Instance()->endScope(*this);
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+  private:
+    const char *_name;
+    bool _active = false;
+    unsigned _depth = 0;
+    double _start = 0.0;
+    uint64_t _frame = 0;
+    int _gpuQuery = -1;
+};
+
+} // namespace RenderIt
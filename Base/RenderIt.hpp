@@ -4,25 +4,48 @@
 #include "Animator.hpp"
 #include "Bone.hpp"
 #include "Bounds.hpp"
+#include "BVH.hpp"
 #include "Camera.hpp"
+#include "CameraPath.hpp"
+#include "CommandList.hpp"
 #include "Context.hpp"
+#include "Device.hpp"
+#include "DrawBatch.hpp"
+#include "FrameConstants.hpp"
+#include "FrameTimes.hpp"
 #include "GLStructs.hpp"
+#include "GPUCulling.hpp"
 #include "Input.hpp"
+#include "InputRecorder.hpp"
+#include "Instances.hpp"
+#include "Jobs.hpp"
 #include "Lights.hpp"
 #include "Material.hpp"
+#include "Materials.hpp"
 #include "Mesh.hpp"
 #include "Model.hpp"
+#include "Occlusion.hpp"
+#include "Profiler.hpp"
 #include "RenderPass.hpp"
+#include "RenderStats.hpp"
 #include "Scene.hpp"
 #include "Shader.hpp"
+#include "ShaderCache.hpp"
+#include "SIMD.hpp"
 #include "Shadow.hpp"
+#include "StreamBuffer.hpp"
+#include "StressScene.hpp"
 #include "Skybox.hpp"
 #include "Transform.hpp"
+#include "TransformSystem.hpp"
 #include "Vertex.hpp"
 
 #include "Cameras/FreeCamera.hpp"
 #include "Cameras/OrbitCamera.hpp"
 
+#include "Devices/NullDevice.hpp"
+#include "Devices/OpenGLDevice.hpp"
+
 #include "Shapes/MeshShapes.hpp"
 
 #include "PostProcess/PostProcess.hpp"
@@ -0,0 +1,118 @@
+#include "RenderStats.hpp"
+#include "Tools.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace RenderIt
+{
+
+/// Write counters as JSON object
+static void write_stats_json(std::ostream &out, const DeviceStats &stats)
+{
+    out << "{";
+    bool first = true;
+    stats.ForEach([&](const char *name, size_t value) {
+        out << (first ? "" : ", ") << "\"" << name << "\": " << value;
+        first = false;
+    });
+    out << "}";
+}
+
+std::shared_ptr<RenderStats> RenderStats::Instance()
+{
+    static auto stats = std::make_shared<RenderStats>();
+    return stats;
+}
+
+void RenderStats::BeginPass(const char *name)
+{
+    _open.push_back({name, GraphicsDevice::Get().GetStats()});
+}
+
+void RenderStats::EndPass()
+{
+    if (_open.empty())
+        return;
+    auto [name, begin] = _open.back();
+    _open.pop_back();
+    auto stats = GraphicsDevice::Get().GetStats() - begin;
+    auto depth = static_cast<unsigned>(_open.size());
+    auto iter = std::find_if(_passes.begin(), _passes.end(),
+                             [&](const PassStats &pass) { return pass.depth == depth && pass.name == name; });
+    if (iter == _passes.end())
+        _passes.push_back({name, depth, stats});
+    else
+        iter->stats += stats;
+}
+
+void RenderStats::EndFrame()
+{
+    _frame = GraphicsDevice::Get().GetFrameStats();
+    _framePasses.swap(_passes);
+    _passes.clear();
+}
+
+const DeviceStats &RenderStats::GetFrameStats() const
+{
+    return _frame;
+}
+
+const std::vector<PassStats> &RenderStats::GetPassStats() const
+{
+    return _framePasses;
+}
+
+const DeviceStats *RenderStats::GetPassStats(const std::string &name) const
+{
+    for (const auto &pass : _framePasses)
+        if (pass.name == name)
+            return &pass.stats;
+    return nullptr;
+}
+
+bool RenderStats::CheckBudget(const DeviceStats &budget, const std::string &pass) const
+{
+    const auto *stats = pass.empty() ? &_frame : GetPassStats(pass);
+    if (!stats)
+    {
+        Tools::display_message(LOGNAME, "pass " + pass + " not found", Tools::MessageType::WARN);
+        return false;
+    }
+    // visit both in same order
+    std::vector<size_t> limits;
+    budget.ForEach([&](const char *, size_t value) { limits.push_back(value); });
+    bool withinBudget = true;
+    size_t idx = 0;
+    stats->ForEach([&](const char *name, size_t value) {
+        auto limit = limits[idx++];
+        if (!limit || value <= limit)
+            return;
+        withinBudget = false;
+        Tools::display_message(LOGNAME,
+                               (pass.empty() ? std::string("frame") : pass) + " " + name + " = " +
+                                   std::to_string(value) + " exceeds " + std::to_string(limit),
+                               Tools::MessageType::WARN);
+    });
+    return withinBudget;
+}
+
+std::string RenderStats::ToJSON() const
+{
+    std::stringstream out;
+    out << "{\"frame\": ";
+    write_stats_json(out, _frame);
+    out << ", \"passes\": [";
+    for (auto i = 0u; i < _framePasses.size(); ++i)
+    {
+        const auto &pass = _framePasses[i];
+        out << (i ? ", " : "") << "{\"name\": \"" << pass.name << "\", \"depth\": " << pass.depth
+            << ", \"stats\": ";
+        write_stats_json(out, pass.stats);
+        out << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+} // namespace RenderIt
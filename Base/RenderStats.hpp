@@ -0,0 +1,93 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Device.hpp"
+#include "Profiler.hpp"
+
+/// Profile & count device calls of render pass, only on GL thread
+#define RENDER_PASS(name)                                                                                              \
+    PROFILE_GPU_SCOPE(name);                                                                                           \
+    RenderIt::RenderStatsScope PROFILER_CONCAT(_renderStatsScope, __LINE__)(name)
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Device counters of a render pass, passes of same name & depth are summed per frame
+struct PassStats
+{
+    std::string name;
+    unsigned depth = 0;
+    DeviceStats stats;
+};
+
+/// Per-frame & per-pass counters of draws, binds, uploads
+/// Collected from GraphicsDevice, see RENDER_PASS
+class RenderStats
+{
+  public:
+    /// Get singleton
+    static std::shared_ptr<RenderStats> Instance();
+
+    /// Start counting pass, nested passes are included in parent
+    void BeginPass(const char *name);
+
+    /// Stop counting innermost pass
+    void EndPass();
+
+    /// Keep passes as last frame, called by AppContext after GraphicsDevice::EndFrame
+    void EndFrame();
+
+    /// Get counters of last frame
+    const DeviceStats &GetFrameStats() const;
+
+    /// Get counters of last frame passes, in order of first use
+    const std::vector<PassStats> &GetPassStats() const;
+
+    /// Get counters of last frame pass by name, null if not found
+    const DeviceStats *GetPassStats(const std::string &name) const;
+
+    /// Check last frame or pass against budget, zero counters of budget are not checked
+    /// Exceeded counters are logged, returns false if any
+    bool CheckBudget(const DeviceStats &budget, const std::string &pass = "") const;
+
+    /// Get last frame & pass counters as JSON object
+    std::string ToJSON() const;
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "RenderStats";
+
+  private:
+    std::vector<std::pair<const char *, DeviceStats>> _open;
+    std::vector<PassStats> _passes, _framePasses;
+    DeviceStats _frame;
+};
+
+/// Pass counted from construction to destruction, see RENDER_PASS
+class RenderStatsScope
+{
+  public:
+    RenderStatsScope(const char *name)
+    {
+        RenderStats::Instance()->BeginPass(name);
+    }
+
+    ~RenderStatsScope()
+    {
+        RenderStats::Instance()->EndPass();
+    }
+
+    RenderStatsScope(const RenderStatsScope &) = delete;
+
+    RenderStatsScope &operator=(const RenderStatsScope &) = delete;
+};
+
+} // namespace RenderIt
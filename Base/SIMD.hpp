@@ -0,0 +1,26 @@
+#pragma once
+
+// SSE is part of every x86-64 target, AVX only if enabled by compiler flags
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RENDERIT_SIMD_SSE 1
+#include <immintrin.h>
+#endif
+
+#if defined(RENDERIT_SIMD_SSE) && defined(__AVX__)
+#define RENDERIT_SIMD_AVX 1
+#endif
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Whether SIMD code paths are compiled in
+constexpr bool SIMD_ENABLED =
+#ifdef RENDERIT_SIMD_SSE
+    true;
+#else
+    false;
+#endif
+
+} // namespace RenderIt
@@ -1,10 +1,30 @@
 #include "Scene.hpp"
+#include "RenderStats.hpp"
+#include "StreamBuffer.hpp"
 
+#include <algorithm>
 #include <queue>
+#include <unordered_map>
 
 namespace RenderIt
 {
 
+/// Name of pass for profiler & stats scopes
+static const char *pass_name(const RenderPass &pass)
+{
+    switch (pass)
+    {
+    case RenderPass::Opaque:
+        return "Opaque";
+    case RenderPass::Transparent:
+        return "Transparent";
+    case RenderPass::Transmissive:
+        return "Transmissive";
+    default:
+        return "Scene";
+    }
+}
+
 std::shared_ptr<Scene> Scene::Instance()
 {
     static auto scene = std::make_shared<Scene>();
@@ -18,7 +38,11 @@ bool Scene::AttachObject(std::shared_ptr<Model> model)
     // find the ultimate parent of model
     while (model->GetParent())
         model = model->GetParent();
-    return models.insert(model).second;
+    if (!models.insert(model).second)
+        return false;
+    _transformsBuilt = false;
+    _drawGroups.valid = false;
+    return true;
 }
 
 bool Scene::RemoveObject(const std::shared_ptr<Model> &model)
@@ -26,28 +50,62 @@ bool Scene::RemoveObject(const std::shared_ptr<Model> &model)
     if (!models.count(model))
         return false;
     models.erase(model);
+    _transformsBuilt = false;
+    _drawGroups.valid = false;
     return true;
 }
 
+void Scene::UpdateTransforms()
+{
+    // rebuild when models or children changed
+    if (!_transformsBuilt || !_transforms.Pull())
+    {
+        _transforms.Build(models);
+        _transformsBuilt = true;
+        _drawGroups.valid = false;
+    }
+    _transforms.Update();
+}
+
 void Scene::Draw(const Shader *shader, const RenderPass &pass,
-                 std::function<void(const Model *, const Shader *)> configModelShader) const
+                 std::function<void(const Model *, const Shader *)> configModelShader,
+                 const OcclusionCuller *culler) const
 {
-    auto drawCall = [&](const RenderPass &p) {
-        std::queue<const Model *> ms;
-        for (auto m : models)
-            ms.push(m.get());
+    const auto &drawn = drawGroups();
+    auto singles = drawn.singles;
+    const auto &groups = drawn.groups;
+    for (auto i = 0u; i < groups.size(); ++i)
+        uploadInstances(i, groups[i]);
+
+    // test visibility once for all passes, groups are skipped only if every instance is hidden
+    std::vector<bool> groupsVisible(groups.size(), true);
+    if (culler)
+    {
+        std::erase_if(singles, [&](const Model *m) { return !culler->IsVisible(m); });
+        for (auto i = 0u; i < groups.size(); ++i)
+            groupsVisible[i] = std::any_of(groups[i].begin(), groups[i].end(),
+                                           [&](const Model *m) { return culler->IsVisible(m); });
+    }
 
-        while (!ms.empty())
+    auto drawCall = [&](const RenderPass &p) {
+        RENDER_PASS(pass_name(p));
+        for (auto m : singles)
         {
-            auto m = ms.front();
-            ms.pop();
-            // draw model
+            // opaque meshes of batched models are drawn by DrawStaticBatch
+            if (p == RenderPass::Opaque && _staticBatch && _staticBatch->Contains(m))
+                continue;
             if (configModelShader)
                 configModelShader(m, shader);
             m->Draw(shader, p);
-            // get children
-            for (auto child : m->_children)
-                ms.push(child.get());
+        }
+        for (auto i = 0u; i < groups.size(); ++i)
+        {
+            if (!groupsVisible[i])
+                continue;
+            auto m = groups[i].front();
+            if (configModelShader)
+                configModelShader(m, shader);
+            m->DrawInstanced(shader, *_instanceBuffers[i], p);
         }
     };
     switch (pass)
@@ -70,4 +128,268 @@ void Scene::Draw(const Shader *shader, const RenderPass &pass,
     }
 }
 
+void Scene::Record(CommandList &list, const Shader *shader, const RenderPass &pass,
+                   std::function<void(const Model *, CommandList &)> recordModel,
+                   const OcclusionCuller *culler) const
+{
+    PROFILE_SCOPE("Record");
+    const auto &drawn = drawGroups();
+    auto singles = drawn.singles;
+    const auto &groups = drawn.groups;
+    // slots keep index of group, as instance buffers are indexed by group
+    std::vector<bool> groupsVisible(groups.size(), true);
+    if (culler)
+    {
+        std::erase_if(singles, [&](const Model *m) { return !culler->IsVisible(m); });
+        for (auto i = 0u; i < groups.size(); ++i)
+            groupsVisible[i] = std::any_of(groups[i].begin(), groups[i].end(),
+                                           [&](const Model *m) { return culler->IsVisible(m); });
+    }
+
+    if (list.GetShader() != shader)
+        list.BindProgram(shader);
+    auto recordCall = [&](const RenderPass &p) {
+        for (auto m : singles)
+        {
+            if (p == RenderPass::Opaque && _staticBatch && _staticBatch->Contains(m))
+                continue;
+            if (recordModel)
+                recordModel(m, list);
+            m->Record(list, shader, p);
+        }
+        // instance buffers are shared by all lists, fill right before drawing
+        for (auto i = 0u; i < groups.size(); ++i)
+        {
+            if (!groupsVisible[i])
+                continue;
+            auto m = groups[i].front();
+            if (recordModel)
+                recordModel(m, list);
+            // unchanged instances are not uploaded again on replay
+            list.Callback([this, shader, p, i, group = groups[i]]() {
+                uploadInstances(i, group);
+                group.front()->DrawInstanced(shader, *_instanceBuffers[i], p);
+            });
+        }
+    };
+    switch (pass)
+    {
+    case RenderPass::Ordered: {
+        recordCall(RenderPass::Opaque);
+        recordCall(RenderPass::Transparent);
+        break;
+    }
+    case RenderPass::AllOrdered: {
+        recordCall(RenderPass::Opaque);
+        recordCall(RenderPass::Transparent);
+        recordCall(RenderPass::Transmissive);
+        break;
+    }
+    default: {
+        recordCall(pass);
+        break;
+    }
+    }
+}
+
+bool Scene::BuildStaticBatch()
+{
+    std::vector<const Model *> ms;
+    for (auto m : models)
+        ms.push_back(m.get());
+    _drawGroups.valid = false;
+    _staticBatch = std::make_unique<DrawBatch>();
+    if (!_staticBatch->Build(ms))
+    {
+        _staticBatch = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void Scene::CullStaticBatch(GPUCuller &culler, const glm::mat4 &projView) const
+{
+    if (!_staticBatch)
+        return;
+    RENDER_PASS("GPU Culling");
+    _staticBatch->Update();
+    culler.Cull(*_staticBatch, projView);
+}
+
+void Scene::DrawStaticBatch(const Shader *shader, const GPUCuller *culler) const
+{
+    if (!_staticBatch)
+        return;
+    RENDER_PASS("Opaque Batch");
+    // already updated by CullStaticBatch
+    if (!culler || !culler->HasResult(*_staticBatch))
+        _staticBatch->Update();
+    _staticBatch->Draw(shader, culler);
+}
+
+void Scene::ResetStaticBatch()
+{
+    _drawGroups.valid = false;
+    _staticBatch = nullptr;
+}
+
+bool Scene::HasStaticBatch() const
+{
+    return _staticBatch != nullptr;
+}
+
+void Scene::BuildBVHs()
+{
+    _meshBVHs.clear();
+    std::queue<const Model *> q;
+    for (auto m : models)
+        q.push(m.get());
+    while (!q.empty())
+    {
+        auto m = q.front();
+        q.pop();
+        for (auto child : m->_children)
+            q.push(child.get());
+        // skinned vertices move every frame
+        if (m->HasAnimation())
+            continue;
+        for (auto i = 0u; i < m->GetNumMeshes(); ++i)
+        {
+            auto mesh = m->GetMesh(i).get();
+            if (mesh->primType != GL_TRIANGLES || _meshBVHs.count(mesh))
+                continue;
+            std::vector<glm::vec3> positions;
+            std::vector<unsigned> indices;
+            if (!mesh->ReadGeometry(positions, indices))
+                continue;
+            auto bvh = std::make_unique<MeshBVH>();
+            bvh->BuildAsync(std::move(positions), std::move(indices));
+            _meshBVHs[mesh] = std::move(bvh);
+        }
+    }
+}
+
+bool Scene::Raycast(const Ray &ray, RayHit &hit) const
+{
+    bool found = false;
+    std::queue<const Model *> q;
+    for (auto m : models)
+        q.push(m.get());
+    while (!q.empty())
+    {
+        auto m = q.front();
+        q.pop();
+        for (auto child : m->_children)
+            q.push(child.get());
+        if (!m->bounds.IsValid())
+            continue;
+
+        // ray in model space, direction is not normalized so distances stay in world units
+        const auto &matInv = m->transform.matrixInv;
+        Ray local{glm::vec3(matInv * glm::vec4(ray.origin, 1.0f)), glm::mat3(matInv) * ray.direction};
+        auto invDir = 1.0f / local.direction;
+        auto t1 = (m->bounds.min - local.origin) * invDir;
+        auto t2 = (m->bounds.max - local.origin) * invDir;
+        auto tMin = glm::min(t1, t2), tMax = glm::max(t1, t2);
+        float tEnter = std::max({tMin.x, tMin.y, tMin.z, 0.0f});
+        float tExit = std::min({tMax.x, tMax.y, tMax.z, hit.distance});
+        if (tEnter > tExit)
+            continue;
+
+        for (auto i = 0u; i < m->GetNumMeshes(); ++i)
+        {
+            auto mesh = m->GetMesh(i).get();
+            auto bvh = _meshBVHs.find(mesh);
+            if (!mesh->drawMesh || bvh == _meshBVHs.end())
+                continue;
+            if (bvh->second->Intersect(local, hit))
+            {
+                hit.model = m;
+                hit.mesh = mesh;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+const Scene::DrawGroups &Scene::drawGroups() const
+{
+    std::lock_guard<std::mutex> lock(_drawGroupsMtx);
+    // per frame catches edits the scene does not see (children, meshes, animations)
+    auto frame = StreamBuffer::Instance()->GetFrame();
+    if (_drawGroups.valid && _drawGroups.frame == frame && _drawGroups.autoInstancing == autoInstancing)
+        return _drawGroups;
+    _drawGroups.singles.clear();
+    _drawGroups.groups.clear();
+    auto ms = collectModels();
+    if (autoInstancing)
+        groupInstances(ms, _drawGroups.singles, _drawGroups.groups);
+    else
+        _drawGroups.singles = std::move(ms);
+    _drawGroups.autoInstancing = autoInstancing;
+    _drawGroups.frame = frame;
+    _drawGroups.valid = true;
+    return _drawGroups;
+}
+
+std::vector<const Model *> Scene::collectModels() const
+{
+    std::vector<const Model *> ms;
+    std::queue<const Model *> q;
+    for (auto m : models)
+        q.push(m.get());
+    while (!q.empty())
+    {
+        auto m = q.front();
+        q.pop();
+        ms.push_back(m);
+        for (auto child : m->_children)
+            q.push(child.get());
+    }
+    return ms;
+}
+
+void Scene::groupInstances(const std::vector<const Model *> &ms, std::vector<const Model *> &singles,
+                           std::vector<std::vector<const Model *>> &groups) const
+{
+    // models cloned from the same source share their first mesh
+    std::unordered_map<const Mesh *, size_t> groupIndices;
+    std::vector<std::vector<const Model *>> candidates;
+    for (auto m : ms)
+    {
+        if (m->_meshes.empty() || m->HasAnimation() || (_staticBatch && _staticBatch->Contains(m)))
+        {
+            singles.push_back(m);
+            continue;
+        }
+        auto key = m->_meshes.front().get();
+        auto iter = groupIndices.find(key);
+        if (iter == groupIndices.end())
+        {
+            groupIndices[key] = candidates.size();
+            candidates.push_back({m});
+        }
+        else
+            candidates[iter->second].push_back(m);
+    }
+    for (auto &c : candidates)
+    {
+        if (c.size() < 2)
+            singles.push_back(c.front());
+        else
+            groups.push_back(std::move(c));
+    }
+}
+
+void Scene::uploadInstances(size_t slot, const std::vector<const Model *> &group) const
+{
+    while (_instanceBuffers.size() <= slot)
+        _instanceBuffers.push_back(std::make_unique<InstanceBuffer>());
+    auto &buffer = _instanceBuffers[slot];
+    buffer->Resize(group.size());
+    for (auto j = 0u; j < group.size(); ++j)
+        buffer->Set(j, group[j]->transform);
+}
+
 } // namespace RenderIt
@@ -2,12 +2,22 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
+#include "BVH.hpp"
+#include "CommandList.hpp"
+#include "DrawBatch.hpp"
+#include "GPUCulling.hpp"
+#include "Instances.hpp"
 #include "Model.hpp"
+#include "Occlusion.hpp"
 #include "RenderPass.hpp"
 #include "Shader.hpp"
+#include "TransformSystem.hpp"
 
 /** @file */
 
@@ -31,9 +41,55 @@ class Scene
 
 #pragma endregion object_management
 
+    /// Propagate transforms through model hierarchy, only edited subtrees are recomputed
+    /// Children follow later parent moves, call once per frame before drawing
+    void UpdateTransforms();
+
     /// Draw scene, and configure shader for each model
+    /// Opaque meshes in static batch are skipped, see DrawStaticBatch
+    /// With autoInstancing, models sharing meshes (see Model::Clone) are drawn instanced
+    /// With culler, models it reports as occluded are skipped
     void Draw(const Shader *shader, const RenderPass &pass = RenderPass::Ordered,
-              std::function<void(const Model *, const Shader *)> configModelShader = nullptr) const;
+              std::function<void(const Model *, const Shader *)> configModelShader = nullptr,
+              const OcclusionCuller *culler = nullptr) const;
+
+    /// Record scene draws into command list, same rules as Draw
+    /// Does not call GL, so passes can be recorded on worker threads while scene is not modified
+    /// recordModel records per-model commands (e.g. model matrix) into the list
+    /// Instance data of instanced groups is uploaded when the list is executed
+    void Record(CommandList &list, const Shader *shader, const RenderPass &pass = RenderPass::Ordered,
+                std::function<void(const Model *, CommandList &)> recordModel = nullptr,
+                const OcclusionCuller *culler = nullptr) const;
+
+#pragma region static_batch
+
+    /// Batch opaque meshes of non-animated models for multi-draw indirect
+    bool BuildStaticBatch();
+
+    /// Cull static batch on GPU before opaque pass, uses culler's Hi-Z of previous frame
+    void CullStaticBatch(GPUCuller &culler, const glm::mat4 &projView) const;
+
+    /// Draw static batch, shader reads per-draw data (see DrawBatch)
+    /// With culler, draws the survivors of CullStaticBatch in this frame
+    void DrawStaticBatch(const Shader *shader, const GPUCuller *culler = nullptr) const;
+
+    /// Release static batch, all meshes go through Draw again
+    void ResetStaticBatch();
+
+    /// Whether static batch is built
+    bool HasStaticBatch() const;
+
+#pragma endregion static_batch
+
+#pragma region ray_queries
+
+    /// Build triangle BVHs of non-animated meshes on worker threads
+    void BuildBVHs();
+
+    /// Find closest mesh hit by world space ray, meshes with BVH still building are skipped
+    bool Raycast(const Ray &ray, RayHit &hit) const;
+
+#pragma endregion ray_queries
 
     /// UI calls
     void UI();
@@ -41,6 +97,40 @@ class Scene
   public:
     const std::string LOGNAME = "Scene";
     std::unordered_set<std::shared_ptr<Model>> models;
+    bool autoInstancing = false;
+
+  private:
+    /// Models split into single draws & instanced groups
+    struct DrawGroups
+    {
+        std::vector<const Model *> singles;
+        std::vector<std::vector<const Model *>> groups;
+        bool autoInstancing = false;
+        uint64_t frame = 0;
+        bool valid = false;
+    };
+
+    /// Get draw groups, regrouped once per frame or when scene changed, thread safe
+    const DrawGroups &drawGroups() const;
+
+    /// Collect models & their children in breadth-first order
+    std::vector<const Model *> collectModels() const;
+
+    /// Split models into single draws and groups sharing the same meshes
+    void groupInstances(const std::vector<const Model *> &ms, std::vector<const Model *> &singles,
+                        std::vector<std::vector<const Model *>> &groups) const;
+
+    /// Fill instance buffer of slot with transforms of group, only changed instances are uploaded
+    void uploadInstances(size_t slot, const std::vector<const Model *> &group) const;
+
+  private:
+    std::unique_ptr<DrawBatch> _staticBatch;
+    mutable std::vector<std::unique_ptr<InstanceBuffer>> _instanceBuffers;
+    mutable DrawGroups _drawGroups;
+    mutable std::mutex _drawGroupsMtx;
+    std::unordered_map<const Mesh *, std::unique_ptr<MeshBVH>> _meshBVHs;
+    TransformSystem _transforms;
+    bool _transformsBuilt = false;
 };
 
 } // namespace RenderIt
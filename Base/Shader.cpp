@@ -1,12 +1,67 @@
 #include "Shader.hpp"
+#include "Device.hpp"
+#include "FrameConstants.hpp"
+#include "Materials.hpp"
+#include "ShaderCache.hpp"
 #include "Tools.hpp"
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
 namespace RenderIt
 {
 
-Shader::Shader() : _compiled(false), _program(0), _shaders(0)
+/// Bytes of uniform value
+static size_t uniform_size(UniformType type)
+{
+    switch (type)
+    {
+    case UniformType::Vec2:
+    case UniformType::IVec2:
+    case UniformType::UVec2:
+        return 8;
+    case UniformType::Vec3:
+    case UniformType::IVec3:
+    case UniformType::UVec3:
+        return 12;
+    case UniformType::Vec4:
+    case UniformType::IVec4:
+    case UniformType::UVec4:
+    case UniformType::Mat2:
+        return 16;
+    case UniformType::Mat3:
+        return 36;
+    case UniformType::Mat4:
+        return 64;
+    default:
+        return 4;
+    }
+}
+
+/// Insert defines after #version line, keeping line numbers of source in logs
+static std::string insert_defines(const std::string &source, const std::string &defines)
+{
+    auto pos = source.find("#version");
+    if (pos == std::string::npos)
+        return defines + "#line 1\n" + source;
+    auto end = source.find('\n', pos);
+    if (end == std::string::npos)
+        return source + "\n" + defines;
+    auto line = std::count(source.begin(), source.begin() + end, '\n') + 2;
+    return source.substr(0, end + 1) + defines + "#line " + std::to_string(line) + "\n" + source.substr(end + 1);
+}
+
+/// Shaders with compiles started by CompileAsync
+static std::vector<Shader *> &pending_shaders()
+{
+    static std::vector<Shader *> shaders;
+    return shaders;
+}
+
+Shader::Shader() : _compiled(false), _usesMaterialBuffer(false), _materialSamplersSet(false), _program(0)
 {
 }
 
@@ -17,58 +72,82 @@ Shader::~Shader()
 
 bool Shader::AddSource(const std::string &source, GLenum type)
 {
-    if (_compiled)
+    if (_submitted)
         Reset();
-
-    GLuint shader = glCreateShader(type);
-    const char *content = source.c_str();
-    glShaderSource(shader, 1, &content, nullptr);
-    glCompileShader(shader);
-
-    GLint success{0};
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success)
+    if (source.empty())
     {
-        GLint infoLen{0};
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
-        std::vector<GLchar> infoLog(infoLen + 1);
-        glGetShaderInfoLog(shader, infoLen, nullptr, infoLog.data());
-
-        std::string message = "Failed to compile shader\n" + std::string(infoLog.data());
-        message += "\n" + source;
-        Tools::display_message(LOGNAME, message, Tools::MessageType::ERROR);
-
+        Tools::display_message(LOGNAME, "Empty shader source", Tools::MessageType::WARN);
         return false;
     }
 
-    _shaders.push_back(shader);
+    _sources.emplace_back(type, source);
     return true;
 }
 
+std::string Shader::WithFrameConstants(const std::string &source)
+{
+    return insert_defines(source, FrameConstants::BlockSource + "\n");
+}
+
 bool Shader::Compile()
 {
-    if (_compiled)
-        return false;
-    _program = glCreateProgram();
-    for (auto &shader : _shaders)
-        glAttachShader(_program, shader);
-    glLinkProgram(_program);
-
-    GLint success{0};
-    glGetProgramiv(_program, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        GLint infoLen{0};
-        glGetProgramiv(_program, GL_INFO_LOG_LENGTH, &infoLen);
-        std::vector<GLchar> infoLog(infoLen + 1);
-        glGetProgramInfoLog(_program, infoLen, nullptr, infoLog.data());
+    return CompileAsync() && Poll(true);
+}
 
-        std::string message = "Failed to link shaders\n" + std::string(infoLog.data());
-        Tools::display_message(LOGNAME, message, Tools::MessageType::ERROR);
-        Reset();
+bool Shader::CompileAsync()
+{
+    if (_compiled || _pending.program || _sources.empty())
+        return false;
+    _submitted = true;
+    auto cache = ShaderCache::Instance();
+    uint64_t key = cache->IsEnabled() ? cache->ComputeKey(_sources) : 0;
+    _program = cache->Load(key);
+    if (_program)
+        return setupProgram();
+    submitSources(_sources, key, _pending);
+    pending_shaders().push_back(this);
+    return true;
+}
 
+bool Shader::Poll(bool wait)
+{
+    if (_compiled || !_pending.program)
+        return _compiled;
+    if (!wait && !GraphicsDevice::Get().IsProgramReady(_pending.program))
+        return false;
+    auto &pending = pending_shaders();
+    pending.erase(std::remove(pending.begin(), pending.end(), this), pending.end());
+    _program = finishSources(_sources, _pending);
+    if (!_program)
+    {
+        // sources & features are kept, so compile can be retried
+        releasePrograms();
         return false;
     }
+    return setupProgram();
+}
+
+bool Shader::IsPending() const
+{
+    return _pending.program != 0;
+}
+
+size_t Shader::PollPending()
+{
+    // finished shaders remove themselves
+    auto shaders = pending_shaders();
+    for (auto shader : shaders)
+        shader->Poll();
+    return pending_shaders().size();
+}
+
+bool Shader::setupProgram()
+{
+    auto &device = GraphicsDevice::Get();
+    _usesMaterialBuffer = device.GetResourceIndex(_program, GL_SHADER_STORAGE_BLOCK,
+                                                  MaterialManager::ShaderBlockName) != GL_INVALID_INDEX;
+    _materialSamplersSet = false;
+    device.GetUniformLocations(_program, _uniformLocations);
 
     return _compiled = true;
 }
@@ -80,23 +159,24 @@ bool Shader::IsCompiled() const
 
 void Shader::Bind() const
 {
-    if (_compiled)
-        glUseProgram(_program);
+    if (!_compiled)
+        return;
+    if (_features.empty())
+        GraphicsDevice::Get().UseProgram(_program);
+    else
+        useVariant(nullptr, true);
 }
 
 void Shader::UnBind() const
 {
-    glUseProgram(0);
+    GraphicsDevice::Get().UseProgram(0);
 }
 
 void Shader::Reset()
 {
-    for (auto &shader : _shaders)
-        glDeleteShader(shader);
-    if (_compiled)
-        glDeleteProgram(_program);
-    _shaders.resize(0);
-    _compiled = false;
+    releasePrograms();
+    _sources.clear();
+    _submitted = false;
 }
 
 GLuint Shader::GetProgram() const
@@ -108,39 +188,24 @@ void Shader::ConfigMaterialTextures(const Material *mat) const
 {
     if (!_compiled)
         return;
+    if (!_features.empty())
+        BindVariant(GetMaterialFeatures(mat));
 
-    // bind textures
+    // bind textures, existence of maps declared as features is known by variant
     int texIdx = 0;
-    auto bindTexture = [&](const std::shared_ptr<STexture> &tex, const std::string &name) {
+    for (int i = 0; i < Material::MAX_MAPS_COUNT; ++i)
+    {
+        const auto &tex = mat->GetMap(i);
+        const auto &name = Material::GetMapName(i);
         if (tex)
         {
             TextureBinding(tex->Get(), static_cast<uint32_t>(texIdx));
             UniformInt(name, texIdx);
-            UniformBool(name + Material::existsEXT, true);
             ++texIdx;
         }
-        else
-            UniformBool(name + Material::existsEXT, false);
-    };
-
-    bindTexture(mat->diffuse, Material::mapNameDiffuse);
-    bindTexture(mat->specular, Material::mapNameSpecular);
-    bindTexture(mat->ambient, Material::mapNameAmbient);
-    bindTexture(mat->emissive, Material::mapNameEmissive);
-    bindTexture(mat->height, Material::mapNameHeight);
-    bindTexture(mat->normals, Material::mapNameNormals);
-    bindTexture(mat->shininess, Material::mapNameShininess);
-    bindTexture(mat->opacity, Material::mapNameOpacity);
-    bindTexture(mat->displacement, Material::mapNameDisplacement);
-    bindTexture(mat->lightmap, Material::mapNameLightmap);
-    bindTexture(mat->reflection, Material::mapNameReflection);
-
-    bindTexture(mat->pbr_color, Material::mapNamePBRColor);
-    bindTexture(mat->pbr_normal, Material::mapNamePBRNormal);
-    bindTexture(mat->pbr_emission, Material::mapNamePBREmission);
-    bindTexture(mat->pbr_metalness, Material::mapNamePBRMetalness);
-    bindTexture(mat->pbr_roughness, Material::mapNamePBRRoughness);
-    bindTexture(mat->pbr_occlusion, Material::mapNamePBROcclusion);
+        if (!_mapFeatures[i])
+            UniformBool(name + Material::existsEXT, tex != nullptr);
+    }
 
     // set constants
     UniformVec3(Material::valNameColorAmbient, mat->colorAmbient);
@@ -157,139 +222,464 @@ void Shader::ConfigMaterialTextures(const Material *mat) const
     UniformFloat(Material::valNameValAlphaCutoff, mat->valAlphaCutoff);
 }
 
+void Shader::ConfigMaterialBuffer(const Material *mat, unsigned index, uint32_t baseUnit) const
+{
+    if (!_compiled)
+        return;
+    ConfigMaterialMaps(mat, baseUnit);
+    UniformUInt(MaterialManager::ShaderIndexName, index);
+}
+
+void Shader::ConfigMaterialMaps(const Material *mat, uint32_t baseUnit) const
+{
+    if (!_compiled)
+        return;
+    if (!_features.empty())
+        BindVariant(GetMaterialFeatures(mat));
+
+    // existing maps are packed into units from baseUnit, samplers only change with the set of maps
+    auto mask = mat->GetMapsMask();
+    if (!_materialSamplersSet || mask != _materialSamplersMask || baseUnit != _materialSamplersBase)
+    {
+        auto unit = static_cast<int>(baseUnit);
+        for (int i = 0; i < Material::MAX_MAPS_COUNT; ++i)
+        {
+            if (mask & (1u << i))
+                UniformInt(Material::GetMapName(i), unit++);
+        }
+        _materialSamplersSet = true;
+        _materialSamplersMask = mask;
+        _materialSamplersBase = baseUnit;
+    }
+    // existence of maps is read from mapsMask in SSBO
+    auto unit = baseUnit;
+    for (int i = 0; i < Material::MAX_MAPS_COUNT; ++i)
+    {
+        const auto &tex = mat->GetMap(i);
+        if (tex)
+            TextureBinding(tex->Get(), unit++);
+    }
+}
+
+void Shader::submitSources(const std::vector<std::pair<GLenum, std::string>> &sources, uint64_t key,
+                           PendingProgram &pending) const
+{
+    // status is only read once linked, so driver can compile stages & programs in parallel
+    auto &device = GraphicsDevice::Get();
+    pending.start = std::chrono::steady_clock::now();
+    pending.key = key;
+    for (const auto &[type, source] : sources)
+        pending.shaders.push_back(device.SubmitShader(type, source));
+    pending.program = device.SubmitProgram(pending.shaders, ShaderCache::Instance()->IsEnabled());
+}
+
+GLuint Shader::finishSources(const std::vector<std::pair<GLenum, std::string>> &sources,
+                             PendingProgram &pending) const
+{
+    auto &device = GraphicsDevice::Get();
+    auto cache = ShaderCache::Instance();
+    auto program = pending.program;
+    std::string infoLog;
+    if (!device.GetProgramStatus(program, infoLog))
+    {
+        // report failed stage with its source, link error otherwise
+        std::string message = "Failed to link shaders\n" + infoLog;
+        for (size_t i = 0; i < pending.shaders.size(); ++i)
+        {
+            std::string shaderLog;
+            if (!device.GetShaderStatus(pending.shaders[i], shaderLog))
+            {
+                message = "Failed to compile shader\n" + shaderLog + "\n" + sources[i].second;
+                break;
+            }
+        }
+        Tools::display_message(LOGNAME, message, Tools::MessageType::ERROR);
+        device.DeleteProgram(program);
+        program = 0;
+    }
+    // stages are no longer needed once linked
+    for (auto shader : pending.shaders)
+        device.DeleteShader(shader);
+    if (program)
+    {
+        cache->RecordCompile(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pending.start).count());
+        cache->Store(pending.key, program);
+    }
+    pending = PendingProgram();
+    return program;
+}
+
+bool Shader::UsesMaterialBuffer() const
+{
+    return _usesMaterialBuffer;
+}
+
+GLint Shader::GetUniformLocation(const std::string &name) const
+{
+    auto iter = _uniformLocations.find(name);
+    return iter == _uniformLocations.end() ? -1 : iter->second;
+}
+
+uint32_t Shader::AddFeature(const std::string &key)
+{
+    auto feature = GetFeature(key);
+    if (feature)
+        return feature;
+    if (_features.size() >= SHADER_MAX_FEATURES)
+    {
+        Tools::display_message(LOGNAME, "Too many features, ignored " + key, Tools::MessageType::WARN);
+        return 0u;
+    }
+    feature = 1u << _features.size();
+    _features.push_back(key);
+    for (int i = 0; i < Material::MAX_MAPS_COUNT; ++i)
+    {
+        if (key == Material::featurePRE + Material::GetMapName(i))
+            _mapFeatures[i] = feature;
+    }
+    if (key == Material::alphaModeNameBlend)
+        _alphaBlendFeature = feature;
+    else if (key == Material::alphaModeNameMask)
+        _alphaMaskFeature = feature;
+    return feature;
+}
+
+void Shader::AddMaterialFeatures()
+{
+    for (int i = 0; i < Material::MAX_MAPS_COUNT; ++i)
+        AddFeature(Material::featurePRE + Material::GetMapName(i));
+    AddFeature(Material::alphaModeNameBlend);
+    AddFeature(Material::alphaModeNameMask);
+}
+
+uint32_t Shader::GetFeature(const std::string &key) const
+{
+    auto iter = std::find(_features.begin(), _features.end(), key);
+    return iter == _features.end() ? 0u : 1u << (iter - _features.begin());
+}
+
+bool Shader::HasFeatures() const
+{
+    return !_features.empty();
+}
+
+uint32_t Shader::GetMaterialFeatures(const Material *mat) const
+{
+    uint32_t features = 0u;
+    for (int i = 0; i < Material::MAX_MAPS_COUNT; ++i)
+        features |= mat->GetMap(i) ? _mapFeatures[i] : 0u;
+    if (mat->alphaMode == 1)
+        features |= _alphaBlendFeature;
+    else if (mat->alphaMode == 2)
+        features |= _alphaMaskFeature;
+    return features;
+}
+
+void Shader::BindVariant(uint32_t features) const
+{
+    if (_compiled)
+        useVariant(getVariant(features), false);
+}
+
+size_t Shader::GetNumVariants() const
+{
+    size_t count = 0;
+    for (const auto &[features, variant] : _variants)
+        count += variant.program ? 1 : 0;
+    return count;
+}
+
+GLuint Shader::buildProgram(const std::vector<std::pair<GLenum, std::string>> &sources) const
+{
+    auto cache = ShaderCache::Instance();
+    uint64_t key = cache->IsEnabled() ? cache->ComputeKey(sources) : 0;
+    auto program = cache->Load(key);
+    if (program)
+        return program;
+    PendingProgram pending;
+    submitSources(sources, key, pending);
+    return finishSources(sources, pending);
+}
+
+void Shader::ClearFeatures()
+{
+    releaseVariants();
+    _features.clear();
+    _mapFeatures.fill(0u);
+    _alphaBlendFeature = _alphaMaskFeature = 0u;
+}
+
+void Shader::releasePrograms()
+{
+    auto &device = GraphicsDevice::Get();
+    if (_compiled)
+        device.DeleteProgram(_program);
+    if (_pending.program)
+    {
+        auto &pending = pending_shaders();
+        pending.erase(std::remove(pending.begin(), pending.end(), this), pending.end());
+        device.DeleteProgram(_pending.program);
+        for (auto shader : _pending.shaders)
+            device.DeleteShader(shader);
+        _pending = PendingProgram();
+    }
+    _program = 0;
+    releaseVariants();
+    _uniformLocations.clear();
+    _compiled = false;
+    _usesMaterialBuffer = false;
+    _materialSamplersSet = false;
+}
+
+void Shader::releaseVariants() const
+{
+    auto &device = GraphicsDevice::Get();
+    for (auto &[features, variant] : _variants)
+    {
+        if (variant.program)
+            device.DeleteProgram(variant.program);
+    }
+    _variants.clear();
+    _active = nullptr;
+    _baseVersion = _stateVersion = 0;
+    _states.clear();
+}
+
+Shader::Variant *Shader::getVariant(uint32_t features) const
+{
+    if (!features)
+        return nullptr;
+    auto &variant = _variants[features];
+    if (!variant.program && !variant.failed)
+    {
+        std::string defines;
+        for (size_t i = 0; i < _features.size(); ++i)
+        {
+            if (features & (1u << i))
+                defines += "#define " + _features[i] + "\n";
+        }
+        std::vector<std::pair<GLenum, std::string>> sources;
+        for (const auto &[type, source] : _sources)
+            sources.emplace_back(type, insert_defines(source, defines));
+        variant.program = buildProgram(sources);
+        if (variant.program)
+            GraphicsDevice::Get().GetUniformLocations(variant.program, variant.uniformLocations);
+        else
+        {
+            Tools::display_message(LOGNAME, "Failed to compile variant, using base program\n" + defines,
+                                   Tools::MessageType::WARN);
+            variant.failed = true;
+        }
+    }
+    return variant.failed ? nullptr : &variant;
+}
+
+void Shader::useVariant(Variant *variant, bool force) const
+{
+    if (!force && variant == _active)
+        return;
+    auto &device = GraphicsDevice::Get();
+    device.UseProgram(variant ? variant->program : _program);
+    _active = variant;
+    auto &version = variant ? variant->version : _baseVersion;
+    if (version == _stateVersion)
+        return;
+    auto program = variant ? variant->program : _program;
+    for (const auto &[key, state] : _states)
+    {
+        if (state.version <= version)
+            continue;
+        if (state.interface)
+        {
+            auto name = key.substr(1);
+            auto idx = device.GetResourceIndex(program, state.interface, name);
+            device.BlockBinding(program, state.interface, idx, *reinterpret_cast<const uint32_t *>(state.data.data()));
+        }
+        else
+            device.Uniform(activeLocation(key), state.type, state.data.data());
+    }
+    version = _stateVersion;
+}
+
+GLint Shader::activeLocation(const std::string &name) const
+{
+    if (!_active)
+        return GetUniformLocation(name);
+    auto iter = _active->uniformLocations.find(name);
+    return iter == _active->uniformLocations.end() ? -1 : iter->second;
+}
+
+void Shader::setUniform(const std::string &name, UniformType type, const void *data) const
+{
+    if (_features.empty())
+    {
+        GraphicsDevice::Get().Uniform(GetUniformLocation(name), type, data);
+        return;
+    }
+    auto &state = _states[name];
+    state.type = type;
+    std::memcpy(state.data.data(), data, uniform_size(type));
+    state.version = ++_stateVersion;
+    // bound program is always up to date
+    (_active ? _active->version : _baseVersion) = _stateVersion;
+    GraphicsDevice::Get().Uniform(activeLocation(name), type, data);
+}
+
+void Shader::setBlockBinding(const std::string &name, GLenum interface, uint32_t binding) const
+{
+    auto &device = GraphicsDevice::Get();
+    auto program = _active ? _active->program : _program;
+    device.BlockBinding(program, interface, device.GetResourceIndex(program, interface, name), binding);
+    if (_features.empty())
+        return;
+    // blocks are keyed apart from uniforms, '#' is not valid in GLSL names
+    auto &state = _states["#" + name];
+    state.interface = interface;
+    std::memcpy(state.data.data(), &binding, sizeof(binding));
+    state.version = ++_stateVersion;
+    (_active ? _active->version : _baseVersion) = _stateVersion;
+}
+
 void Shader::UniformBool(const std::string &name, bool val) const
 {
     if (!_compiled)
         return;
-    glUniform1i(glGetUniformLocation(_program, name.c_str()), static_cast<int>(val));
+    int v = static_cast<int>(val);
+    setUniform(name, UniformType::Int, &v);
 }
 
 void Shader::UniformInt(const std::string &name, int val) const
 {
     if (!_compiled)
         return;
-    glUniform1i(glGetUniformLocation(_program, name.c_str()), val);
+    setUniform(name, UniformType::Int, &val);
 }
 
 void Shader::UniformUInt(const std::string &name, unsigned val) const
 {
     if (!_compiled)
         return;
-    glUniform1ui(glGetUniformLocation(_program, name.c_str()), val);
+    setUniform(name, UniformType::UInt, &val);
 }
 
 void Shader::UniformFloat(const std::string &name, float val) const
 {
     if (!_compiled)
         return;
-    glUniform1f(glGetUniformLocation(_program, name.c_str()), val);
+    setUniform(name, UniformType::Float, &val);
 }
 
 void Shader::UniformVec2(const std::string &name, const glm::vec2 &val) const
 {
     if (!_compiled)
         return;
-    glUniform2fv(glGetUniformLocation(_program, name.c_str()), 1, glm::value_ptr(val));
+    setUniform(name, UniformType::Vec2, glm::value_ptr(val));
 }
 
 void Shader::UniformVec3(const std::string &name, const glm::vec3 &val) const
 {
     if (!_compiled)
         return;
-    glUniform3fv(glGetUniformLocation(_program, name.c_str()), 1, glm::value_ptr(val));
+    setUniform(name, UniformType::Vec3, glm::value_ptr(val));
 }
 
 void Shader::UniformVec4(const std::string &name, const glm::vec4 &val) const
 {
     if (!_compiled)
         return;
-    glUniform4fv(glGetUniformLocation(_program, name.c_str()), 1, glm::value_ptr(val));
+    setUniform(name, UniformType::Vec4, glm::value_ptr(val));
 }
 
 void Shader::UniformIVec2(const std::string &name, const glm::ivec2 &val) const
 {
     if (!_compiled)
         return;
-    glUniform2iv(glGetUniformLocation(_program, name.c_str()), 1, glm::value_ptr(val));
+    setUniform(name, UniformType::IVec2, glm::value_ptr(val));
 }
 
 void Shader::UniformIVec3(const std::string &name, const glm::ivec3 &val) const
 {
     if (!_compiled)
         return;
-    glUniform3iv(glGetUniformLocation(_program, name.c_str()), 1, glm::value_ptr(val));
+    setUniform(name, UniformType::IVec3, glm::value_ptr(val));
 }
 
 void Shader::UniformIVec4(const std::string &name, const glm::ivec4 &val) const
 {
     if (!_compiled)
         return;
-    glUniform4iv(glGetUniformLocation(_program, name.c_str()), 1, glm::value_ptr(val));
+    setUniform(name, UniformType::IVec4, glm::value_ptr(val));
 }
 
 void Shader::UniformUIVec2(const std::string &name, const glm::uvec2 &val) const
 {
     if (!_compiled)
         return;
-    glUniform2uiv(glGetUniformLocation(_program, name.c_str()), 1, glm::value_ptr(val));
+    setUniform(name, UniformType::UVec2, glm::value_ptr(val));
 }
 
 void Shader::UniformUIVec3(const std::string &name, const glm::uvec3 &val) const
 {
     if (!_compiled)
         return;
-    glUniform3uiv(glGetUniformLocation(_program, name.c_str()), 1, glm::value_ptr(val));
+    setUniform(name, UniformType::UVec3, glm::value_ptr(val));
 }
 
 void Shader::UniformUIVec4(const std::string &name, const glm::uvec4 &val) const
 {
     if (!_compiled)
         return;
-    glUniform4uiv(glGetUniformLocation(_program, name.c_str()), 1, glm::value_ptr(val));
+    setUniform(name, UniformType::UVec4, glm::value_ptr(val));
 }
 
 void Shader::UniformMat2(const std::string &name, const glm::mat2 &val) const
 {
     if (!_compiled)
         return;
-    glUniformMatrix2fv(glGetUniformLocation(_program, name.c_str()), 1, GL_FALSE, glm::value_ptr(val));
+    setUniform(name, UniformType::Mat2, glm::value_ptr(val));
 }
 
 void Shader::UniformMat3(const std::string &name, const glm::mat3 &val) const
 {
     if (!_compiled)
         return;
-    glUniformMatrix3fv(glGetUniformLocation(_program, name.c_str()), 1, GL_FALSE, glm::value_ptr(val));
+    setUniform(name, UniformType::Mat3, glm::value_ptr(val));
 }
 
 void Shader::UniformMat4(const std::string &name, const glm::mat4 &val) const
 {
     if (!_compiled)
         return;
-    glUniformMatrix4fv(glGetUniformLocation(_program, name.c_str()), 1, GL_FALSE, glm::value_ptr(val));
+    setUniform(name, UniformType::Mat4, glm::value_ptr(val));
 }
 
 void Shader::UboBinding(const std::string &name, uint32_t binding) const
 {
     if (!_compiled)
         return;
-    GLuint idx = glGetUniformBlockIndex(_program, name.c_str());
-    glUniformBlockBinding(_program, idx, binding);
+    setBlockBinding(name, GL_UNIFORM_BLOCK, binding);
 }
 
 void Shader::SsboBinding(const std::string &name, uint32_t binding) const
 {
     if (!_compiled)
         return;
-    GLuint idx = glGetProgramResourceIndex(_program, GL_SHADER_STORAGE_BLOCK, name.c_str());
-    glShaderStorageBlockBinding(_program, idx, binding);
+    setBlockBinding(name, GL_SHADER_STORAGE_BLOCK, binding);
 }
 
 void Shader::TextureBinding(const GLuint &texID, uint32_t binding) const
 {
     if (!_compiled)
         return;
-    glBindTextureUnit(binding, texID);
+    GraphicsDevice::Get().BindTextureUnit(binding, texID);
+}
+
+void Shader::Uniform(const std::string &name, UniformType type, const void *data) const
+{
+    if (!_compiled)
+        return;
+    setUniform(name, type, data);
 }
 
 } // namespace RenderIt
@@ -2,19 +2,28 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "Device.hpp"
 #include "GLStructs.hpp"
 #include "Material.hpp"
 
+#define SHADER_MAX_FEATURES 32
+
 /** @file */
 
 namespace RenderIt
 {
 
 /// Shader program helper class
+/// Declared feature keys make permutations: variants are compiled on first use with enabled keys defined
 class Shader
 {
   public:
@@ -22,12 +31,30 @@ class Shader
 
     ~Shader();
 
-    /// Add shader source to compile
+    /// Add shader source to compile, stages are compiled by Compile
+    /// Sources of previous compile are replaced, declared features are kept
     bool AddSource(const std::string &source, GLenum type);
 
-    /// Link the added shaders and compile a shader program
+    /// Insert FrameConstants block after #version line of source, line numbers of source are kept in logs
+    static std::string WithFrameConstants(const std::string &source);
+
+    /// Compile & link added sources into program, loaded from ShaderCache if cached
     bool Compile();
 
+    /// Start compile & link of added sources without waiting, program is compiled once Poll finds it ready
+    /// Draws skip shader until compiled, returns false if nothing to compile
+    bool CompileAsync();
+
+    /// Finish compile started by CompileAsync if driver completed it or if waiting, returns whether compiled
+    bool Poll(bool wait = false);
+
+    /// Whether compile started by CompileAsync is not finished
+    bool IsPending() const;
+
+    /// Poll all shaders with pending compiles, called once per frame by AppContext
+    /// Returns number of shaders still pending
+    static size_t PollPending();
+
     /// Is program compiled
     bool IsCompiled() const;
 
@@ -37,7 +64,7 @@ class Shader
     /// Unbind current program
     void UnBind() const;
 
-    /// Reset program
+    /// Reset program, variants & sources, declared features are kept
     void Reset();
 
     /// Get raw program
@@ -46,6 +73,51 @@ class Shader
     /// Configure material textures
     void ConfigMaterialTextures(const Material *mat) const;
 
+    /// Configure material textures and pass index into materials SSBO
+    void ConfigMaterialBuffer(const Material *mat, unsigned index, uint32_t baseUnit = 0) const;
+
+    /// Bind existing material textures to consecutive units from baseUnit
+    /// Units above the maps of material are free for the caller
+    void ConfigMaterialMaps(const Material *mat, uint32_t baseUnit = 0) const;
+
+    /// Whether program reads material constants from materials SSBO
+    bool UsesMaterialBuffer() const;
+
+    /// Get uniform location from cache filled at link time, -1 if not active
+    /// Does not call GL, safe to use from worker threads
+    GLint GetUniformLocation(const std::string &name) const;
+
+#pragma region permutations
+
+    /// Declare feature key, variants define enabled keys after #version line
+    /// Returns bit of key in feature masks, 0 if SHADER_MAX_FEATURES keys are declared
+    uint32_t AddFeature(const std::string &key);
+
+    /// Declare material features, HAS_ key per texture map & ALPHA_MODE_BLEND / ALPHA_MODE_MASK
+    /// Material configuration then binds variant of material & skips *_exists uniforms
+    void AddMaterialFeatures();
+
+    /// Get bit of declared feature key, 0 if not declared
+    uint32_t GetFeature(const std::string &key) const;
+
+    /// Whether feature keys are declared
+    bool HasFeatures() const;
+
+    /// Get mask of declared features matching material maps & alpha mode
+    uint32_t GetMaterialFeatures(const Material *mat) const;
+
+    /// Bind variant of feature mask (base program if 0), compiled on first use
+    /// Uniforms & block bindings set on shader are applied to variant, falls back to base program if compile failed
+    void BindVariant(uint32_t features) const;
+
+    /// Get number of compiled variants, base program excluded
+    size_t GetNumVariants() const;
+
+    /// Remove declared features & their variants, base program is kept
+    void ClearFeatures();
+
+#pragma endregion permutations
+
 #pragma region uniform_methods
 
     void UniformBool(const std::string &name, bool val) const;
@@ -86,15 +158,107 @@ class Shader
 
     void TextureBinding(const GLuint &texID, uint32_t binding) const;
 
+    /// Set uniform by name, applied to bound variant
+    void Uniform(const std::string &name, UniformType type, const void *data) const;
+
+
 #pragma endregion uniform_methods
 
   public:
     const std::string LOGNAME = "Shader";
 
+  private:
+    /// Program of feature mask other than base
+    struct Variant
+    {
+        GLuint program = 0;
+        std::unordered_map<std::string, GLint> uniformLocations;
+        /// Version of recorded states applied to program
+        uint64_t version = 0;
+        bool failed = false;
+    };
+
+    /// Uniform value or block binding set on shader, applied to variants when bound
+    struct RecordedState
+    {
+        UniformType type = UniformType::Int;
+        /// Block interface, 0 for uniforms
+        GLenum interface = 0;
+        std::array<unsigned char, sizeof(glm::mat4)> data{};
+        uint64_t version = 0;
+    };
+
+    /// Program submitted to driver, stages are kept until link status is read
+    struct PendingProgram
+    {
+        GLuint program = 0;
+        std::vector<GLuint> shaders;
+        /// ShaderCache key of sources
+        uint64_t key = 0;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /// Load program from ShaderCache or compile it, returns 0 on failure
+    GLuint buildProgram(const std::vector<std::pair<GLenum, std::string>> &sources) const;
+
+    /// Submit compile of stages & link of retrievable program without checking status
+    void submitSources(const std::vector<std::pair<GLenum, std::string>> &sources, uint64_t key,
+                       PendingProgram &pending) const;
+
+    /// Wait for submitted program & store it in ShaderCache, returns 0 on failure
+    GLuint finishSources(const std::vector<std::pair<GLenum, std::string>> &sources, PendingProgram &pending) const;
+
+    /// Read interface of linked base program
+    bool setupProgram();
+
+    /// Delete base program, pending compile & variants, sources & features are kept
+    void releasePrograms();
+
+    /// Delete variant programs & recorded states
+    void releaseVariants() const;
+
+    /// Get variant of feature mask, compiled if new, null for base program or if compile failed
+    Variant *getVariant(uint32_t features) const;
+
+    /// Bind variant (null for base program) & apply states recorded since it was bound last
+    /// Program is only rebound if variant changed or forced, as another program may be bound
+    void useVariant(Variant *variant, bool force) const;
+
+    /// Get location of uniform in bound program
+    GLint activeLocation(const std::string &name) const;
+
+    /// Set uniform of bound program, recorded for variants
+    void setUniform(const std::string &name, UniformType type, const void *data) const;
+
+    /// Set block binding of bound program, recorded for variants
+    void setBlockBinding(const std::string &name, GLenum interface, uint32_t binding) const;
+
   private:
     bool _compiled;
+    bool _usesMaterialBuffer;
+    mutable bool _materialSamplersSet;
+    // maps mask & base unit samplers are set for
+    mutable unsigned _materialSamplersMask = 0;
+    mutable uint32_t _materialSamplersBase = 0;
     GLuint _program;
-    std::vector<GLuint> _shaders;
+    std::vector<std::pair<GLenum, std::string>> _sources;
+    std::unordered_map<std::string, GLint> _uniformLocations;
+    PendingProgram _pending;
+    // sources were compiled (or failed), next AddSource starts new sources
+    bool _submitted = false;
+
+    std::vector<std::string> _features;
+    // feature bit of material map index, alpha modes
+    std::array<uint32_t, Material::MAX_MAPS_COUNT> _mapFeatures{};
+    uint32_t _alphaBlendFeature = 0, _alphaMaskFeature = 0;
+
+    // variants are compiled lazily from const draw calls
+    mutable std::unordered_map<uint32_t, Variant> _variants;
+    // bound variant, null for base program
+    mutable Variant *_active = nullptr;
+    mutable uint64_t _baseVersion = 0;
+    mutable uint64_t _stateVersion = 0;
+    mutable std::unordered_map<std::string, RecordedState> _states;
 };
 
 } // namespace RenderIt
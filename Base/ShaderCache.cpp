@@ -0,0 +1,209 @@
+#include "ShaderCache.hpp"
+#include "Device.hpp"
+#include "Tools.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+// "RIPB" little endian
+#define SHADER_CACHE_MAGIC 0x42504952u
+#define SHADER_CACHE_VERSION 1u
+#define SHADER_CACHE_EXT ".bin"
+
+namespace fs = std::filesystem;
+
+namespace RenderIt
+{
+
+/// Header of cached binary file, followed by binary
+struct ShaderCacheHeader
+{
+    uint32_t magic = SHADER_CACHE_MAGIC;
+    uint32_t version = SHADER_CACHE_VERSION;
+    uint64_t key = 0;
+    uint32_t format = 0;
+    uint32_t size = 0;
+};
+
+/// Continue 64-bit FNV-1a hash with bytes
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t size)
+{
+    auto bytes = reinterpret_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+ShaderCache::ShaderCache()
+{
+    auto directory = std::getenv("RENDERIT_SHADER_CACHE");
+    if (!directory)
+        _directory = (fs::current_path() / fs::path("shader_cache")).string();
+    else if (std::string(directory) != "0")
+        _directory = directory;
+}
+
+std::shared_ptr<ShaderCache> ShaderCache::Instance()
+{
+    static auto cache = std::make_shared<ShaderCache>();
+    return cache;
+}
+
+void ShaderCache::SetDirectory(const std::string &directory)
+{
+    _directory = directory;
+}
+
+const std::string &ShaderCache::GetDirectory() const
+{
+    return _directory;
+}
+
+bool ShaderCache::IsEnabled() const
+{
+    return !_directory.empty();
+}
+
+uint64_t ShaderCache::ComputeKey(const std::vector<std::pair<GLenum, std::string>> &sources)
+{
+    // driver is fixed once context exists
+    if (_driverInfo.empty())
+        _driverInfo = GraphicsDevice::Get().GetDriverInfo();
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = fnv1a(hash, _driverInfo.data(), _driverInfo.size());
+    for (const auto &source : sources)
+    {
+        uint64_t size = source.second.size();
+        hash = fnv1a(hash, &source.first, sizeof(source.first));
+        hash = fnv1a(hash, &size, sizeof(size));
+        hash = fnv1a(hash, source.second.data(), source.second.size());
+    }
+    return hash;
+}
+
+GLuint ShaderCache::Load(uint64_t key)
+{
+    if (!IsEnabled())
+        return 0;
+    auto start = std::chrono::steady_clock::now();
+    auto path = filePath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        ++_stats.misses;
+        return 0;
+    }
+    ShaderCacheHeader header;
+    std::vector<unsigned char> binary;
+    bool valid = static_cast<bool>(file.read(reinterpret_cast<char *>(&header), sizeof(header))) &&
+                 header.magic == SHADER_CACHE_MAGIC && header.version == SHADER_CACHE_VERSION && header.key == key &&
+                 header.size > 0;
+    if (valid)
+    {
+        binary.resize(header.size);
+        valid = static_cast<bool>(file.read(reinterpret_cast<char *>(binary.data()), header.size));
+    }
+    file.close();
+    GLuint program = valid ? GraphicsDevice::Get().ProgramBinary(header.format, binary) : 0;
+    if (!program)
+    {
+        // stale or corrupted, replaced once compiled from source
+        std::error_code error;
+        fs::remove(path, error);
+        ++_stats.rejected;
+        ++_stats.misses;
+        return 0;
+    }
+    ++_stats.hits;
+    _stats.loadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return program;
+}
+
+bool ShaderCache::Store(uint64_t key, GLuint program)
+{
+    if (!IsEnabled() || !program)
+        return false;
+    ShaderCacheHeader header;
+    std::vector<unsigned char> binary;
+    GLenum format = 0;
+    if (!GraphicsDevice::Get().GetProgramBinary(program, format, binary) || binary.empty())
+        return false;
+    header.key = key;
+    header.format = format;
+    header.size = static_cast<uint32_t>(binary.size());
+
+    std::error_code error;
+    fs::create_directories(_directory, error);
+    auto path = filePath(key);
+    // write whole file before replacing, so readers never see partial binaries
+    auto tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            Tools::display_message(LOGNAME, "Failed to write program binary to " + path, Tools::MessageType::WARN);
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(binary.data()), binary.size());
+        if (!file)
+            return false;
+    }
+    fs::rename(tmpPath, path, error);
+    if (error)
+    {
+        fs::remove(tmpPath, error);
+        return false;
+    }
+    ++_stats.stored;
+    return true;
+}
+
+void ShaderCache::RecordCompile(double ms)
+{
+    _stats.compileMs += ms;
+}
+
+void ShaderCache::Clear()
+{
+    if (!IsEnabled())
+        return;
+    std::error_code error;
+    for (const auto &entry : fs::directory_iterator(_directory, error))
+    {
+        if (entry.path().extension() == SHADER_CACHE_EXT)
+            fs::remove(entry.path(), error);
+    }
+}
+
+const ShaderCacheStats &ShaderCache::GetStats() const
+{
+    return _stats;
+}
+
+std::string ShaderCache::ToJSON() const
+{
+    std::stringstream out;
+    out << "{\"enabled\": " << (IsEnabled() ? "true" : "false") << ", \"hits\": " << _stats.hits
+        << ", \"misses\": " << _stats.misses << ", \"rejected\": " << _stats.rejected
+        << ", \"stored\": " << _stats.stored << ", \"load_ms\": " << _stats.loadMs
+        << ", \"compile_ms\": " << _stats.compileMs << "}";
+    return out.str();
+}
+
+std::string ShaderCache::filePath(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx" SHADER_CACHE_EXT, static_cast<unsigned long long>(key));
+    return (fs::path(_directory) / fs::path(name)).string();
+}
+
+} // namespace RenderIt
@@ -0,0 +1,86 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Counters of program cache lookups
+struct ShaderCacheStats
+{
+    size_t hits = 0;
+    size_t misses = 0;
+    /// Binaries found but rejected by driver or corrupted, counted as misses too
+    size_t rejected = 0;
+    size_t stored = 0;
+    /// Time spent creating programs from binaries
+    double loadMs = 0.0;
+    /// Time spent compiling & linking programs from source
+    double compileMs = 0.0;
+};
+
+/// On-disk cache of linked program binaries
+/// Keyed by FNV-1a hash of all stage sources & driver info, invalid binaries are removed & compiled from source
+/// Directory is RENDERIT_SHADER_CACHE if set (empty or 0 disables cache), else shader_cache in working directory
+class ShaderCache
+{
+  public:
+    ShaderCache();
+
+    /// Get singleton
+    static std::shared_ptr<ShaderCache> Instance();
+
+    /// Set cache directory, empty disables cache
+    void SetDirectory(const std::string &directory);
+
+    /// Get cache directory
+    const std::string &GetDirectory() const;
+
+    /// Whether programs are cached
+    bool IsEnabled() const;
+
+    /// Compute key of program stages (type & source) for active device driver
+    uint64_t ComputeKey(const std::vector<std::pair<GLenum, std::string>> &sources);
+
+    /// Create program from cached binary, returns 0 if not cached or rejected
+    GLuint Load(uint64_t key);
+
+    /// Write binary of program linked as retrievable, returns false if failed
+    bool Store(uint64_t key, GLuint program);
+
+    /// Account time of program compiled from source
+    void RecordCompile(double ms);
+
+    /// Remove all cached binaries
+    void Clear();
+
+    /// Get lookup counters
+    const ShaderCacheStats &GetStats() const;
+
+    /// Get lookup counters as JSON object
+    std::string ToJSON() const;
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "ShaderCache";
+
+  private:
+    /// Get path of cached binary
+    std::string filePath(uint64_t key) const;
+
+  private:
+    std::string _directory;
+    std::string _driverInfo;
+    ShaderCacheStats _stats;
+};
+
+} // namespace RenderIt
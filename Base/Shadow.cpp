@@ -1,6 +1,13 @@
 #include "Shadow.hpp"
+#include "Device.hpp"
+#include "Instances.hpp"
+#include "Jobs.hpp"
+#include "Materials.hpp"
+#include "RenderStats.hpp"
+#include "StreamBuffer.hpp"
 #include "Tools.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 #include <glm/gtc/matrix_transform.hpp>
@@ -14,6 +21,8 @@ ShadowManager::ShadowManager()
     setupCSM();
     setupOmni();
     setupSpot();
+    // shaders of all shadow types are compiled together
+    Tools::compile_shaders_parallel({_csmShader.get(), _omniShader.get(), _spotShader.get()});
 }
 
 std::shared_ptr<ShadowManager> ShadowManager::Instance()
@@ -34,22 +43,24 @@ void ShadowManager::AttachLightManager(std::shared_ptr<LightManager> lights)
 
 void ShadowManager::RecordShadows(std::function<void(const Shader *)> renderFunc)
 {
+    RENDER_PASS("Shadows");
+    auto &device = GraphicsDevice::Get();
     if (!_lights || !_camera)
     {
         Tools::display_message(NAME, "lights or camera not set!", Tools::MessageType::WARN);
         return;
     }
-    glViewport(0, 0, SHADOW_SIZE, SHADOW_SIZE);
-    glEnable(GL_POLYGON_OFFSET_FILL);
-    glCullFace(GL_FRONT);
+    device.Viewport(0, 0, SHADOW_SIZE, SHADOW_SIZE);
+    device.SetEnabled(GL_POLYGON_OFFSET_FILL, true);
+    device.CullFace(GL_FRONT);
     // directional lights
     {
         computeCSMLightMatrices();
-        glPolygonOffset(_csmOffsets.x, _csmOffsets.y);
+        device.PolygonOffset(_csmOffsets.x, _csmOffsets.y);
         _csmFBO->Bind();
-        glClear(GL_DEPTH_BUFFER_BIT);
+        device.Clear(GL_DEPTH_BUFFER_BIT);
         _csmShader->Bind();
-        _csmSSBO->BindBase(1u);
+        BindLightSpaceData(LightType::Directional, 1u);
         for (auto lightIdx = 0u; lightIdx < _lights->_dirLights.size(); ++lightIdx)
         {
             const auto &light = _lights->_dirLights[lightIdx];
@@ -58,19 +69,19 @@ void ShadowManager::RecordShadows(std::function<void(const Shader *)> renderFunc
             _csmShader->UniformInt("lightIdx", static_cast<int>(lightIdx));
             renderFunc(_csmShader.get());
         }
-        _csmSSBO->UnBindBase(1u);
+        device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1u, 0);
         _csmShader->UnBind();
         _csmFBO->UnBind();
     }
     // point lights
     {
         computeOmniLightMatrices();
-        glPolygonOffset(_omniOffsets.x, _omniOffsets.y); // this does not seem to have any effect
+        device.PolygonOffset(_omniOffsets.x, _omniOffsets.y); // this does not seem to have any effect
         _omniFBO->Bind();
-        glClear(GL_DEPTH_BUFFER_BIT);
+        device.Clear(GL_DEPTH_BUFFER_BIT);
         _omniShader->Bind();
         _omniShader->UniformFloat("farPlaneInv", 1.0f / _camera->_omniNearFarOffset.y);
-        _omniSSBO->BindBase(1u);
+        BindLightSpaceData(LightType::Point, 1u);
         for (auto lightIdx = 0u; lightIdx < _lights->_pointLights.size(); ++lightIdx)
         {
             const auto &light = _lights->_pointLights[lightIdx];
@@ -80,12 +91,92 @@ void ShadowManager::RecordShadows(std::function<void(const Shader *)> renderFunc
             _omniShader->UniformInt("lightIdx", static_cast<int>(lightIdx));
             renderFunc(_omniShader.get());
         }
-        _omniSSBO->UnBindBase(1u);
+        device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1u, 0);
         _omniShader->UnBind();
         _omniFBO->UnBind();
     }
-    glDisable(GL_POLYGON_OFFSET_FILL);
-    glCullFace(GL_BACK);
+    device.SetEnabled(GL_POLYGON_OFFSET_FILL, false);
+    device.CullFace(GL_BACK);
+}
+
+void ShadowManager::RecordShadows(std::function<void(const Shader *, CommandList &)> recordFunc)
+{
+    RENDER_PASS("Shadows");
+    auto &device = GraphicsDevice::Get();
+    if (!_lights || !_camera)
+    {
+        Tools::display_message(NAME, "lights or camera not set!", Tools::MessageType::WARN);
+        return;
+    }
+    // light matrices are uploaded before recording
+    computeCSMLightMatrices();
+    computeOmniLightMatrices();
+    std::vector<unsigned> dirLights, pointLights;
+    for (auto lightIdx = 0u; lightIdx < _lights->_dirLights.size(); ++lightIdx)
+        if (_lights->_dirLights[lightIdx].castShadow)
+            dirLights.push_back(lightIdx);
+    for (auto lightIdx = 0u; lightIdx < _lights->_pointLights.size(); ++lightIdx)
+        if (_lights->_pointLights[lightIdx].castShadow)
+            pointLights.push_back(lightIdx);
+    auto numLists = dirLights.size() + pointLights.size();
+    while (_shadowLists.size() < numLists)
+        _shadowLists.push_back(std::make_unique<CommandList>());
+
+    auto jobs = JobSystem::Instance();
+    auto farPlaneInv = 1.0f / _camera->_omniNearFarOffset.y;
+    auto recorded = jobs->ParallelFor(0, numLists, 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i)
+        {
+            auto &list = *_shadowLists[i];
+            list.Reset();
+            if (i < dirLights.size())
+            {
+                list.BindProgram(_csmShader.get());
+                list.UniformInt("lightIdx", static_cast<int>(dirLights[i]));
+                recordFunc(_csmShader.get(), list);
+            }
+            else
+            {
+                auto lightIdx = pointLights[i - dirLights.size()];
+                list.BindProgram(_omniShader.get());
+                list.UniformFloat("farPlaneInv", farPlaneInv);
+                list.UniformVec3("lightPos", _lights->_pointLights[lightIdx].pos);
+                list.UniformInt("lightIdx", static_cast<int>(lightIdx));
+                recordFunc(_omniShader.get(), list);
+            }
+        }
+    });
+    jobs->Wait(recorded);
+
+    device.Viewport(0, 0, SHADOW_SIZE, SHADOW_SIZE);
+    device.SetEnabled(GL_POLYGON_OFFSET_FILL, true);
+    device.CullFace(GL_FRONT);
+    // directional lights
+    {
+        device.PolygonOffset(_csmOffsets.x, _csmOffsets.y);
+        _csmFBO->Bind();
+        device.Clear(GL_DEPTH_BUFFER_BIT);
+        BindLightSpaceData(LightType::Directional, 1u);
+        for (auto i = 0u; i < dirLights.size(); ++i)
+            _shadowLists[i]->Execute();
+        device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1u, 0);
+        _csmShader->UnBind();
+        _csmFBO->UnBind();
+    }
+    // point lights
+    {
+        device.PolygonOffset(_omniOffsets.x, _omniOffsets.y);
+        _omniFBO->Bind();
+        device.Clear(GL_DEPTH_BUFFER_BIT);
+        BindLightSpaceData(LightType::Point, 1u);
+        for (auto i = dirLights.size(); i < numLists; ++i)
+            _shadowLists[i]->Execute();
+        device.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1u, 0);
+        _omniShader->UnBind();
+        _omniFBO->UnBind();
+    }
+    device.SetEnabled(GL_POLYGON_OFFSET_FILL, false);
+    device.CullFace(GL_BACK);
 }
 
 GLuint ShadowManager::GetShadowMaps(LightType type) const
@@ -117,7 +208,9 @@ void ShadowManager::BindShadowData(LightType type, unsigned binding) const
     }
     case LightType::Directional:
     default: {
-        _camera->_csmDataSSBO->BindBase(binding);
+        const auto &sphereData = _camera->_csmSphereData;
+        auto data = StreamBuffer::Instance()->Upload(sphereData.data(), sizeof(sphereData));
+        data.BindRange(GL_SHADER_STORAGE_BUFFER, binding);
         break;
     }
     }
@@ -133,12 +226,14 @@ void ShadowManager::BindLightSpaceData(LightType type, unsigned binding) const
     switch (type)
     {
     case LightType::Point: {
-        _omniSSBO->BindBase(binding);
+        auto matrices = StreamBuffer::Instance()->Upload(_omniMatrices.data(), sizeof(_omniMatrices));
+        matrices.BindRange(GL_SHADER_STORAGE_BUFFER, binding);
         break;
     }
     case LightType::Directional:
     default: {
-        _csmSSBO->BindBase(binding);
+        auto matrices = StreamBuffer::Instance()->Upload(_csmMatrices.data(), sizeof(_csmMatrices));
+        matrices.BindRange(GL_SHADER_STORAGE_BUFFER, binding);
         break;
     }
     }
@@ -152,11 +247,12 @@ void ShadowManager::setupCSM()
 
 void ShadowManager::setupCSMBuffers()
 {
+    GPU_MEMORY_SCOPE(ShadowMaps, "ShadowManager");
     // setup csm shadow textures
     _csmShadowMaps = std::make_unique<STexture>(GL_TEXTURE_2D_ARRAY);
     _csmShadowMaps->Bind();
-    glTexImage3D(_csmShadowMaps->type, 0, GL_DEPTH_COMPONENT, SHADOW_SIZE, SHADOW_SIZE,
-                 SHADOW_CSM_COUNT * LIGHTS_MAX_DIR_LIGHTS, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    GraphicsDevice::Get().TexImage3D(_csmShadowMaps->type, GL_DEPTH_COMPONENT, SHADOW_SIZE, SHADOW_SIZE,
+                                     SHADOW_CSM_COUNT * LIGHTS_MAX_DIR_LIGHTS, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
     glTexParameteri(_csmShadowMaps->type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(_csmShadowMaps->type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(_csmShadowMaps->type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -171,24 +267,19 @@ void ShadowManager::setupCSMBuffers()
     if (!_csmFBO->Validate())
         Tools::display_message(NAME, "failed to create framebuffer for CSM!", Tools::MessageType::WARN);
     _csmFBO->UnBind();
-    // setup SSBO
-    _csmSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
-    _csmSSBO->Bind();
-    glBufferData(_csmSSBO->type, SHADOW_CSM_COUNT * LIGHTS_MAX_DIR_LIGHTS * sizeof(glm::mat4), nullptr,
-                 GL_DYNAMIC_DRAW);
-    _csmSSBO->UnBind();
+    _csmMatrices.fill(glm::mat4(1.0f));
 }
 
 void ShadowManager::setupCSMShaders()
 {
-    std::string vertShader = R"(
-        #version 450 core
+    std::string vertShader = "#version 450 core\n" + InstanceBuffer::BlockSource + R"(
         layout(location = 0) in vec3 inPos;
         layout(location = 2) in vec2 inTex;
         layout(location = 5) in uvec4 inBoneIDs;
         layout(location = 6) in vec4 inBoneWeights;
         layout(location = 0) out vec2 vertBaseUV;
         uniform mat4 mat_Model;
+        uniform bool val_INSTANCED;
         layout(std430, binding = 0) readonly buffer BoneMatrices
         {
             mat4 boneMats[];
@@ -208,7 +299,8 @@ void ShadowManager::setupCSMShaders()
                 boneTransform = mat4(1.0);
             }
             vertBaseUV = inTex;
-            gl_Position = mat_Model * boneTransform * vec4(inPos, 1.0);
+            mat4 model = val_INSTANCED ? instances[gl_InstanceID].matrix : mat_Model;
+            gl_Position = model * boneTransform * vec4(inPos, 1.0);
         }
     )";
     std::string geomShader = R"(
@@ -236,17 +328,15 @@ void ShadowManager::setupCSMShaders()
             EndPrimitive();
         }
     )";
-    std::string fragShader = R"(
-        #version 450 core
+    std::string fragShader = "#version 450 core\n" + MaterialManager::BlockSource + R"(
         layout(location = 0) in vec2 baseUV;
-        uniform bool val_HASPBR;
-        uniform float val_ALPHACUTOFF;
         uniform sampler2D mapPBR_COLOR;
-        uniform bool mapPBR_COLOR_exists;
+        #define MAP_BIT_PBR_COLOR 11
         void main()
         {
-            if(val_HASPBR && mapPBR_COLOR_exists &&
-                (val_ALPHACUTOFF * float(texture(mapPBR_COLOR, baseUV).a < val_ALPHACUTOFF) != 0.0))
+            MaterialData mat = materials[val_MATERIAL];
+            if(mat.hasPBR != 0 && (mat.mapsMask & (1u << MAP_BIT_PBR_COLOR)) != 0u &&
+                (mat.alphaCutoff * float(texture(mapPBR_COLOR, baseUV).a < mat.alphaCutoff) != 0.0))
                 discard;
         }
     )";
@@ -254,7 +344,6 @@ void ShadowManager::setupCSMShaders()
     _csmShader->AddSource(vertShader, GL_VERTEX_SHADER);
     _csmShader->AddSource(geomShader, GL_GEOMETRY_SHADER);
     _csmShader->AddSource(fragShader, GL_FRAGMENT_SHADER);
-    _csmShader->Compile();
 }
 
 void ShadowManager::computeCSMLightMatrices()
@@ -264,8 +353,6 @@ void ShadowManager::computeCSMLightMatrices()
     glm::vec4 origin, offset;
     glm::mat4 view, ortho, lightMatrix;
     float texels = SHADOW_SIZE * 0.5f, texelsInv = 1.0f / texels;
-    _csmSSBO->Bind();
-    auto matPtr = reinterpret_cast<glm::mat4 *>(glMapBuffer(_csmSSBO->type, GL_WRITE_ONLY));
     for (auto lightIdx = 0u; lightIdx < _lights->_dirLights.size(); ++lightIdx)
     {
         const auto &light = _lights->_dirLights[lightIdx];
@@ -292,11 +379,9 @@ void ShadowManager::computeCSMLightMatrices()
             offset.z = offset.w = 0.0f;
             ortho[3] += offset;
             lightMatrix = ortho * view;
-            *(matPtr + (cascadeIdx + lightIdx * SHADOW_CSM_COUNT)) = lightMatrix;
+            _csmMatrices[cascadeIdx + lightIdx * SHADOW_CSM_COUNT] = lightMatrix;
         }
     }
-    glUnmapBuffer(_csmSSBO->type);
-    _csmSSBO->UnBind();
 }
 
 void ShadowManager::setupOmni()
@@ -307,12 +392,13 @@ void ShadowManager::setupOmni()
 
 void ShadowManager::setupOmniBuffers()
 {
+    GPU_MEMORY_SCOPE(ShadowMaps, "ShadowManager");
     // setup omni texture cubemaps
     _omniShadowMaps = std::make_unique<STexture>(GL_TEXTURE_CUBE_MAP_ARRAY);
     _omniShadowMaps->Bind();
-    glTexImage3D(_omniShadowMaps->type, 0, GL_DEPTH_COMPONENT, SHADOW_SIZE, SHADOW_SIZE,
-                 6 * LIGHTS_MAX_POINT_LIGHTS, // number of layer-faces
-                 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    GraphicsDevice::Get().TexImage3D(_omniShadowMaps->type, GL_DEPTH_COMPONENT, SHADOW_SIZE, SHADOW_SIZE,
+                                     6 * LIGHTS_MAX_POINT_LIGHTS, // number of layer-faces
+                                     GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
     glTexParameteri(_omniShadowMaps->type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(_omniShadowMaps->type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(_omniShadowMaps->type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -328,23 +414,19 @@ void ShadowManager::setupOmniBuffers()
     if (!_omniFBO->Validate())
         Tools::display_message(NAME, "failed to create framebuffer for Omni!", Tools::MessageType::WARN);
     _omniFBO->UnBind();
-    // setup SSBO
-    _omniSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
-    _omniSSBO->Bind();
-    glBufferData(_omniSSBO->type, 6 * LIGHTS_MAX_POINT_LIGHTS * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
-    _omniSSBO->UnBind();
+    _omniMatrices.fill(glm::mat4(1.0f));
 }
 
 void ShadowManager::setupOmniShaders()
 {
-    std::string vertShader = R"(
-        #version 450 core
+    std::string vertShader = "#version 450 core\n" + InstanceBuffer::BlockSource + R"(
         layout(location = 0) in vec3 inPos;
         layout(location = 2) in vec2 inTex;
         layout(location = 5) in uvec4 inBoneIDs;
         layout(location = 6) in vec4 inBoneWeights;
         layout(location = 0) out vec2 vertBaseUV;
         uniform mat4 mat_Model;
+        uniform bool val_INSTANCED;
         layout(std430, binding = 0) readonly buffer BoneMatrices
         {
             mat4 boneMats[];
@@ -364,7 +446,8 @@ void ShadowManager::setupOmniShaders()
                 boneTransform = mat4(1.0);
             }
             vertBaseUV = inTex;
-            gl_Position = mat_Model * boneTransform * vec4(inPos, 1.0);
+            mat4 model = val_INSTANCED ? instances[gl_InstanceID].matrix : mat_Model;
+            gl_Position = model * boneTransform * vec4(inPos, 1.0);
         }
     )";
     std::string geomShader = R"(
@@ -396,20 +479,18 @@ void ShadowManager::setupOmniShaders()
             }
         }
     )";
-    std::string fragShader = R"(
-        #version 450 core
+    std::string fragShader = "#version 450 core\n" + MaterialManager::BlockSource + R"(
         layout(location = 0) in vec2 baseUV;
         layout (location = 1) in vec4 fragPos;
         uniform vec3 lightPos;
         uniform float farPlaneInv;
-        uniform bool val_HASPBR;
-        uniform float val_ALPHACUTOFF;
         uniform sampler2D mapPBR_COLOR;
-        uniform bool mapPBR_COLOR_exists;
+        #define MAP_BIT_PBR_COLOR 11
         void main()
         {
-            if(val_HASPBR && mapPBR_COLOR_exists &&
-                (val_ALPHACUTOFF * float(texture(mapPBR_COLOR, baseUV).a < val_ALPHACUTOFF) != 0.0))
+            MaterialData mat = materials[val_MATERIAL];
+            if(mat.hasPBR != 0 && (mat.mapsMask & (1u << MAP_BIT_PBR_COLOR)) != 0u &&
+                (mat.alphaCutoff * float(texture(mapPBR_COLOR, baseUV).a < mat.alphaCutoff) != 0.0))
                 discard;
             vec3 dist = fragPos.xyz - lightPos;
             gl_FragDepth = dot(dist, dist) * farPlaneInv;
@@ -419,14 +500,12 @@ void ShadowManager::setupOmniShaders()
     _omniShader->AddSource(vertShader, GL_VERTEX_SHADER);
     _omniShader->AddSource(geomShader, GL_GEOMETRY_SHADER);
     _omniShader->AddSource(fragShader, GL_FRAGMENT_SHADER);
-    _omniShader->Compile();
 }
 
 void ShadowManager::computeOmniLightMatrices()
 {
     const auto &matProj = _camera->_omniProjMat;
-    _omniSSBO->Bind();
-    auto matPtr = reinterpret_cast<glm::mat4 *>(glMapBuffer(_omniSSBO->type, GL_WRITE_ONLY));
+    auto matPtr = _omniMatrices.data();
     for (auto lightIdx = 0u; lightIdx < _lights->_pointLights.size(); ++lightIdx)
     {
         const auto &light = _lights->_pointLights[lightIdx];
@@ -449,8 +528,6 @@ void ShadowManager::computeOmniLightMatrices()
         *(matPtr + (lightIdx * 6 + 5)) =
             matProj * glm::lookAt(pos, pos + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
     }
-    glUnmapBuffer(_omniSSBO->type);
-    _omniSSBO->UnBind();
 }
 
 void ShadowManager::setupSpot()
@@ -461,11 +538,12 @@ void ShadowManager::setupSpot()
 
 void ShadowManager::setupSpotBuffers()
 {
+    GPU_MEMORY_SCOPE(ShadowMaps, "ShadowManager");
     // setup spot light shadow textures
     _spotShadowMaps = std::make_unique<STexture>(GL_TEXTURE_2D_ARRAY);
     _spotShadowMaps->Bind();
-    glTexImage3D(_spotShadowMaps->type, 0, GL_DEPTH_COMPONENT, SHADOW_SIZE, SHADOW_SIZE, LIGHTS_MAX_SPOT_LIGHTS, 0,
-                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    GraphicsDevice::Get().TexImage3D(_spotShadowMaps->type, GL_DEPTH_COMPONENT, SHADOW_SIZE, SHADOW_SIZE,
+                                     LIGHTS_MAX_SPOT_LIGHTS, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
     glTexParameteri(_spotShadowMaps->type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(_spotShadowMaps->type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(_spotShadowMaps->type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -483,20 +561,21 @@ void ShadowManager::setupSpotBuffers()
     // setup SSBO
     _spotSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
     _spotSSBO->Bind();
-    glBufferData(_spotSSBO->type, LIGHTS_MAX_SPOT_LIGHTS * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    GraphicsDevice::Get().BufferData(_spotSSBO->type, LIGHTS_MAX_SPOT_LIGHTS * sizeof(glm::mat4), nullptr,
+                                     GL_DYNAMIC_DRAW);
     _spotSSBO->UnBind();
 }
 
 void ShadowManager::setupSpotShaders()
 {
-    std::string vertShader = R"(
-        #version 450 core
+    std::string vertShader = "#version 450 core\n" + InstanceBuffer::BlockSource + R"(
         layout(location = 0) in vec3 inPos;
         layout(location = 2) in vec2 inTex;
         layout(location = 5) in uvec4 inBoneIDs;
         layout(location = 6) in vec4 inBoneWeights;
         layout(location = 0) out vec2 vertBaseUV;
         uniform mat4 mat_Model;
+        uniform bool val_INSTANCED;
         layout(std430, binding = 0) readonly buffer BoneMatrices
         {
             mat4 boneMats[];
@@ -516,7 +595,8 @@ void ShadowManager::setupSpotShaders()
                 boneTransform = mat4(1.0);
             }
             vertBaseUV = inTex;
-            gl_Position = mat_Model * boneTransform * vec4(inPos, 1.0);
+            mat4 model = val_INSTANCED ? instances[gl_InstanceID].matrix : mat_Model;
+            gl_Position = model * boneTransform * vec4(inPos, 1.0);
         }
     )";
     std::string geomShader = R"(
@@ -543,17 +623,15 @@ void ShadowManager::setupSpotShaders()
             EndPrimitive();
         }
     )";
-    std::string fragShader = R"(
-        #version 450 core
+    std::string fragShader = "#version 450 core\n" + MaterialManager::BlockSource + R"(
         layout(location = 0) in vec2 baseUV;
-        uniform bool val_HASPBR;
-        uniform float val_ALPHACUTOFF;
         uniform sampler2D mapPBR_COLOR;
-        uniform bool mapPBR_COLOR_exists;
+        #define MAP_BIT_PBR_COLOR 11
         void main()
         {
-            if(val_HASPBR && mapPBR_COLOR_exists &&
-                (val_ALPHACUTOFF * float(texture(mapPBR_COLOR, baseUV).a < val_ALPHACUTOFF) != 0.0))
+            MaterialData mat = materials[val_MATERIAL];
+            if(mat.hasPBR != 0 && (mat.mapsMask & (1u << MAP_BIT_PBR_COLOR)) != 0u &&
+                (mat.alphaCutoff * float(texture(mapPBR_COLOR, baseUV).a < mat.alphaCutoff) != 0.0))
                 discard;
         }
     )";
@@ -561,7 +639,6 @@ void ShadowManager::setupSpotShaders()
     _spotShader->AddSource(vertShader, GL_VERTEX_SHADER);
     _spotShader->AddSource(geomShader, GL_GEOMETRY_SHADER);
     _spotShader->AddSource(fragShader, GL_FRAGMENT_SHADER);
-    _spotShader->Compile();
 }
 
 void ShadowManager::computeSpotLightMatrices()
@@ -573,12 +650,12 @@ const glm::vec3 &Camera::GetOmniShadowData()
     return _omniNearFarOffset;
 }
 
-void Camera::setupCSMBuffer()
+void Camera::SetShadowNearFar(float near, float far)
 {
-    _csmDataSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
-    _csmDataSSBO->Bind();
-    glBufferData(_csmDataSSBO->type, SHADOW_CSM_COUNT * sizeof(glm::vec4), nullptr, GL_DYNAMIC_DRAW);
-    _csmDataSSBO->UnBind();
+    _csmNearFar.x = (std::max)(0.001f, near);
+    _csmNearFar.y = (std::max)(_csmNearFar.x, far);
+    updateCSMDists();
+    _updated = false;
 }
 
 void Camera::updateCSMDists()
@@ -601,8 +678,6 @@ void Camera::updateCSMData()
     float tanHalfFov = std::tan(glm::radians(_fov) * 0.5f);
     glm::vec2 xNearFar, yNearFar;
     glm::vec3 cameraNear, cameraFar;
-    _csmDataSSBO->Bind();
-    auto ssboPtr = reinterpret_cast<glm::vec4 *>(glMapBuffer(_csmDataSSBO->type, GL_WRITE_ONLY));
     for (auto cascadeIdx = 0; cascadeIdx < SHADOW_CSM_COUNT; ++cascadeIdx)
     {
         yNearFar = _csmDistData[cascadeIdx] * tanHalfFov;
@@ -634,10 +709,7 @@ void Camera::updateCSMData()
         _csmSphereData[cascadeIdx].y = center.y;
         _csmSphereData[cascadeIdx].z = center.z;
         _csmSphereData[cascadeIdx].w = radius;
-        *(ssboPtr + cascadeIdx) = _csmSphereData[cascadeIdx];
     }
-    glUnmapBuffer(_csmDataSSBO->type);
-    _csmDataSSBO->UnBind();
 }
 
 void Camera::updateOmniData()
@@ -3,10 +3,12 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <glm/glm.hpp>
 
 #include "Camera.hpp"
+#include "CommandList.hpp"
 #include "GLStructs.hpp"
 #include "Lights.hpp"
 #include "Shader.hpp"
@@ -29,6 +31,10 @@ class ShadowManager
 
     void RecordShadows(std::function<void(const Shader *)> renderFunc);
 
+    /// Record one command list per shadow casting light on job system, then replay them in order
+    /// recordFunc is called on worker threads and must not call GL
+    void RecordShadows(std::function<void(const Shader *, CommandList &)> recordFunc);
+
     GLuint GetShadowMaps(LightType type) const;
 
     void BindShadowData(LightType type, unsigned binding) const;
@@ -88,7 +94,8 @@ class ShadowManager
     std::unique_ptr<STexture> _csmShadowMaps;
     std::unique_ptr<SFBO> _csmFBO;
     std::shared_ptr<Shader> _csmShader;
-    std::shared_ptr<SBuffer> _csmSSBO;
+    // light space matrices, uploaded to stream buffer on bind
+    std::array<glm::mat4, SHADOW_CSM_COUNT * LIGHTS_MAX_DIR_LIGHTS> _csmMatrices;
 #pragma endregion cascaded_shadow
 
 #pragma region omnidirectional_shadow
@@ -96,7 +103,7 @@ class ShadowManager
     std::unique_ptr<STexture> _omniShadowMaps;
     std::shared_ptr<SFBO> _omniFBO;
     std::shared_ptr<Shader> _omniShader;
-    std::shared_ptr<SBuffer> _omniSSBO;
+    std::array<glm::mat4, 6 * LIGHTS_MAX_POINT_LIGHTS> _omniMatrices;
 #pragma endregion omnidirectional_shadow
 
 #pragma region spot_shadow
@@ -106,6 +113,9 @@ class ShadowManager
     std::shared_ptr<Shader> _spotShader;
     std::shared_ptr<SBuffer> _spotSSBO;
 #pragma endregion spot_shadow
+
+    // command lists of shadow casting lights, reused every frame
+    std::vector<std::unique_ptr<CommandList>> _shadowLists;
 };
 
 } // namespace RenderIt
@@ -1,4 +1,6 @@
 #include "Skybox.hpp"
+#include "Device.hpp"
+#include "FrameConstants.hpp"
 #include "Tools.hpp"
 
 #include <algorithm>
@@ -17,49 +19,9 @@ Skybox::Skybox() : _skybox(nullptr)
 
 bool Skybox::Load(const std::string &panoramaMap)
 {
+    GPU_MEMORY_SCOPE(IBL, "Skybox");
     int skyboxSize = 0;
-    // step 1: load map into texture
-    auto mapTex = std::make_unique<STexture>(GL_TEXTURE_2D);
-    {
-        int w, h, n;
-        auto imgSource = stbi_loadf(panoramaMap.c_str(), &w, &h, &n, STBI_rgb_alpha);
-        if (imgSource)
-        {
-            mapTex->Bind();
-            glTexParameteri(mapTex->type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(mapTex->type, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-            glTexParameteri(mapTex->type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(mapTex->type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(mapTex->type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexImage2D(mapTex->type, 0, GL_RGBA32F, w, h, 0, GL_RGBA, GL_FLOAT, imgSource);
-            glGenerateMipmap(mapTex->type);
-            mapTex->UnBind();
-            stbi_image_free(imgSource);
-        }
-        else
-        {
-            Tools::display_message(NAME,
-                                   "Failed to load " + panoramaMap + " (" + std::string(stbi_failure_reason()) + ")",
-                                   Tools::MessageType::WARN);
-            return false;
-        }
-        skyboxSize = std::min(w, h);
-    }
-    // step 2: create cubemap
-    _skybox = std::make_unique<STexture>(GL_TEXTURE_CUBE_MAP);
-    _skybox->Bind();
-    for (auto i = 0; i < 6; ++i)
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA32F, skyboxSize, skyboxSize, 0, GL_RGBA, GL_FLOAT,
-                     nullptr);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-    _skybox->UnBind();
-    // step 3: create fbo
-    auto fbo = std::make_unique<SFBO>();
-    // step 4: prepare shader
+    // step 1: prepare shader, driver compiles it while map is loaded
     auto shader = std::make_shared<Shader>();
     const std::string vertSource = R"(
         #version 450 core
@@ -127,29 +89,72 @@ bool Skybox::Load(const std::string &panoramaMap)
     )";
     shader->AddSource(vertSource, GL_VERTEX_SHADER);
     shader->AddSource(fragSource, GL_FRAGMENT_SHADER);
-    if (!shader->Compile())
+    Tools::compile_shaders_parallel({shader.get()}, false);
+    // step 2: load map into texture
+    auto mapTex = std::make_unique<STexture>(GL_TEXTURE_2D);
+    {
+        int w, h, n;
+        auto imgSource = stbi_loadf(panoramaMap.c_str(), &w, &h, &n, STBI_rgb_alpha);
+        if (imgSource)
+        {
+            mapTex->Bind();
+            GraphicsDevice::Get().TexParameter(mapTex->type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            GraphicsDevice::Get().TexParameter(mapTex->type, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+            GraphicsDevice::Get().TexParameter(mapTex->type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            GraphicsDevice::Get().TexParameter(mapTex->type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            GraphicsDevice::Get().TexParameter(mapTex->type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            GraphicsDevice::Get().TexImage2D(mapTex->type, GL_RGBA32F, w, h, GL_RGBA, GL_FLOAT, imgSource);
+            GraphicsDevice::Get().GenerateMipmap(mapTex->type);
+            mapTex->UnBind();
+            stbi_image_free(imgSource);
+        }
+        else
+        {
+            Tools::display_message(NAME,
+                                   "Failed to load " + panoramaMap + " (" + std::string(stbi_failure_reason()) + ")",
+                                   Tools::MessageType::WARN);
+            return false;
+        }
+        skyboxSize = std::min(w, h);
+    }
+    // step 3: create cubemap
+    _skybox = std::make_unique<STexture>(GL_TEXTURE_CUBE_MAP);
+    _skybox->Bind();
+    for (auto i = 0; i < 6; ++i)
+        GraphicsDevice::Get().TexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, GL_RGBA32F, skyboxSize, skyboxSize,
+                                         GL_RGBA, GL_FLOAT, nullptr);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    _skybox->UnBind();
+    // step 4: create fbo
+    auto fbo = std::make_unique<SFBO>();
+    // step 5: wait for shader
+    if (!shader->Poll(true))
         return false;
-    // step 5: record panorama into skybox
+    // step 6: record panorama into skybox
     for (auto i = 0; i < 6; ++i)
     {
         fbo->Bind();
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, _skybox->Get(),
                                0);
         _skybox->Bind();
-        glViewport(0, 0, skyboxSize, skyboxSize);
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        GraphicsDevice::Get().Viewport(0, 0, skyboxSize, skyboxSize);
+        GraphicsDevice::Get().ClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        GraphicsDevice::Get().Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         shader->Bind();
         shader->UniformInt("panorama", 0);
         shader->TextureBinding(mapTex->Get(), 0u);
         shader->UniformInt("face", i);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+        GraphicsDevice::Get().DrawArrays(GL_TRIANGLES, 0, 3);
         shader->UnBind();
         _skybox->UnBind();
         fbo->UnBind();
     }
     _skybox->Bind();
-    glGenerateMipmap(_skybox->type);
+    GraphicsDevice::Get().GenerateMipmap(_skybox->type);
     _skybox->UnBind();
     return true;
 }
@@ -157,12 +162,13 @@ bool Skybox::Load(const std::string &panoramaMap)
 bool Skybox::Load(const std::string &posX, const std::string &negX, const std::string &posY, const std::string &negY,
                   const std::string &posZ, const std::string &negZ)
 {
+    GPU_MEMORY_SCOPE(IBL, "Skybox");
     auto setFace = [&](const std::string &path, GLenum target) -> bool {
         int w, h, n;
         auto imgSource = stbi_loadf(path.c_str(), &w, &h, &n, STBI_rgb_alpha);
         if (imgSource)
         {
-            glTexImage2D(target, 0, GL_RGBA32F, w, h, 0, GL_RGBA, GL_FLOAT, imgSource);
+            GraphicsDevice::Get().TexImage2D(target, GL_RGBA32F, w, h, GL_RGBA, GL_FLOAT, imgSource);
             stbi_image_free(imgSource);
             return true;
         }
@@ -182,34 +188,35 @@ bool Skybox::Load(const std::string &posX, const std::string &negX, const std::s
     res = res && setFace(negY, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y);
     res = res && setFace(posZ, GL_TEXTURE_CUBE_MAP_POSITIVE_Z);
     res = res && setFace(negZ, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GraphicsDevice::Get().TexParameter(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    GraphicsDevice::Get().GenerateMipmap(GL_TEXTURE_CUBE_MAP);
     _skybox->UnBind();
     return res;
 }
 
-void Skybox::ClearBackground(const glm::mat4 &mProj, const glm::mat4 &mView) const
+void Skybox::ClearBackground() const
 {
     if (!_skybox)
     {
         Tools::display_message(NAME, "no skybox set!", Tools::MessageType::WARN);
         return;
     }
-    auto hasDepth = glIsEnabled(GL_DEPTH_TEST);
-    glDisable(GL_DEPTH_TEST);
-    auto mProjView = mProj * glm::mat4(glm::mat3(mView));
+    if (!_drawShader->Poll(true))
+        return;
+    auto &device = GraphicsDevice::Get();
+    auto hasDepth = device.IsEnabled(GL_DEPTH_TEST);
+    device.SetEnabled(GL_DEPTH_TEST, false);
     _drawShader->Bind();
-    _drawShader->UniformMat4("mProjView", mProjView);
     _drawShader->UniformInt("skybox", 0);
     _drawShader->TextureBinding(_skybox->Get(), 0u);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    device.DrawArrays(GL_TRIANGLES, 0, 36);
     _drawShader->UnBind();
     if (hasDepth)
-        glEnable(GL_DEPTH_TEST);
+        device.SetEnabled(GL_DEPTH_TEST, true);
 }
 
 GLuint Skybox::GetSkybox() const
@@ -219,8 +226,7 @@ GLuint Skybox::GetSkybox() const
 
 void Skybox::loadDrawShaders()
 {
-    const std::string vertSource = R"(
-        #version 450 core
+    const std::string vertSource = "#version 450 core\n" + FrameConstants::BlockSource + R"(
         layout(location = 0) out vec3 vertDir;
         const vec3 skyboxVertices[36] = vec3[36](
             vec3(-1.0, 1.0, -1.0), vec3(-1.0, -1.0, -1.0), vec3(1.0, -1.0, -1.0), vec3(1.0, -1.0, -1.0), vec3(1.0, 1.0, -1.0),
@@ -231,11 +237,11 @@ void Skybox::loadDrawShaders()
             vec3(1.0, 1.0, -1.0), vec3(1.0, 1.0, 1.0), vec3(1.0, 1.0, 1.0), vec3(-1.0, 1.0, 1.0), vec3(-1.0, 1.0, -1.0),
             vec3(-1.0, -1.0, -1.0), vec3(-1.0, -1.0, 1.0), vec3(1.0, -1.0, -1.0), vec3(1.0, -1.0, -1.0), vec3(-1.0, -1.0, 1.0),
             vec3(1.0, -1.0, 1.0));
-        uniform mat4 mProjView;
         void main()
         {
             vertDir = skyboxVertices[gl_VertexID];
-            gl_Position = (mProjView * vec4(vertDir, 1.0)).xyww;
+            // rotation only, skybox follows camera
+            gl_Position = (mat_Proj * mat4(mat3(mat_View)) * vec4(vertDir, 1.0)).xyww;
         }
     )";
     const std::string fragSource = R"(
@@ -251,7 +257,8 @@ void Skybox::loadDrawShaders()
     _drawShader = std::make_unique<Shader>();
     _drawShader->AddSource(vertSource, GL_VERTEX_SHADER);
     _drawShader->AddSource(fragSource, GL_FRAGMENT_SHADER);
-    _drawShader->Compile();
+    // finished on first draw
+    Tools::compile_shaders_parallel({_drawShader.get()}, false);
 }
 
 } // namespace RenderIt
@@ -20,7 +20,7 @@ class Skybox
     bool Load(const std::string &posX, const std::string &negX, const std::string &posY, const std::string &negY,
               const std::string &posZ, const std::string &negZ);
 
-    void ClearBackground(const glm::mat4 &mProj, const glm::mat4 &mView) const;
+    void ClearBackground() const;
 
     GLuint GetSkybox() const;
 
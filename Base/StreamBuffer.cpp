@@ -0,0 +1,197 @@
+#include "StreamBuffer.hpp"
+#include "Device.hpp"
+#include "Tools.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#define STREAM_BUFFER_FLAGS (GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT)
+// 1 second
+#define STREAM_BUFFER_WAIT_TIMEOUT 1000000000
+
+namespace RenderIt
+{
+
+void StreamAllocation::BindRange(GLenum target, GLuint binding) const
+{
+    if (buffer && size)
+        GraphicsDevice::Get().BindBufferRange(target, binding, buffer, offset, size);
+}
+
+StreamBuffer::StreamBuffer(size_t regionSize) : _glThread(std::this_thread::get_id())
+{
+    createStorage((std::max)(regionSize, size_t(STREAM_BUFFER_ALIGNMENT)));
+    instances().push_back(this);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    auto &buffers = instances();
+    buffers.erase(std::remove(buffers.begin(), buffers.end(), this), buffers.end());
+    auto &device = GraphicsDevice::Get();
+    for (auto fence : _fences)
+        device.DeleteSync(fence);
+    for (auto &retired : _retired)
+        device.DeleteSync(retired.second);
+}
+
+std::shared_ptr<StreamBuffer> StreamBuffer::Instance()
+{
+    static auto stream = std::make_shared<StreamBuffer>();
+    return stream;
+}
+
+StreamAllocation StreamBuffer::Allocate(size_t size, size_t alignment)
+{
+    const std::lock_guard<std::mutex> lock(_mtx);
+    StreamAllocation allocation;
+    if (!size)
+        return allocation;
+    alignment = (std::max)(alignment, size_t(1));
+    auto offset = (_offset + alignment - 1) / alignment * alignment;
+    if (offset + size > _regionSize)
+    {
+        if (std::this_thread::get_id() != _glThread)
+        {
+            // storage can only be replaced on GL thread, grow at end of frame
+            _demand = (std::max)(_demand, offset + size);
+            ++_failed;
+            return allocation;
+        }
+        retireStorage();
+        createStorage((std::max)(2 * _regionSize, 2 * size));
+        ++_grows;
+        offset = 0;
+    }
+    if (!_data)
+        return allocation;
+    auto regionOffset = _region * _regionSize;
+    allocation.data = _data + regionOffset + offset;
+    allocation.buffer = _buffer->Get();
+    allocation.offset = regionOffset + offset;
+    allocation.size = size;
+    allocation.frame = _frame;
+    _offset = offset + size;
+    _peakBytes = (std::max)(_peakBytes, _offset);
+    return allocation;
+}
+
+StreamAllocation StreamBuffer::Upload(const void *data, size_t size)
+{
+    auto allocation = Allocate(size);
+    if (allocation.data && data)
+        std::memcpy(allocation.data, data, size);
+    return allocation;
+}
+
+void StreamBuffer::EndFrame()
+{
+    const std::lock_guard<std::mutex> lock(_mtx);
+    auto &device = GraphicsDevice::Get();
+    if (_demand > _regionSize)
+    {
+        retireStorage();
+        createStorage(2 * _demand);
+        ++_grows;
+    }
+    else
+        _fences[_region] = device.FenceSync();
+    _demand = 0;
+
+    // free replaced storages GPU no longer reads
+    for (auto &retired : _retired)
+    {
+        if (!retired.second)
+            retired.second = device.FenceSync();
+        else if (device.ClientWaitSync(retired.second, 0))
+        {
+            device.DeleteSync(retired.second);
+            retired.first.reset();
+        }
+    }
+    _retired.erase(
+        std::remove_if(_retired.begin(), _retired.end(), [](const auto &retired) { return !retired.first; }),
+        _retired.end());
+
+    _frameBytes = _offset;
+    _region = (_region + 1) % STREAM_BUFFER_REGIONS;
+    _offset = 0;
+    ++_frame;
+    waitRegion(_region);
+}
+
+void StreamBuffer::EndFrameAll()
+{
+    for (auto buffer : instances())
+        buffer->EndFrame();
+}
+
+std::vector<StreamBuffer *> &StreamBuffer::instances()
+{
+    // constructed before first buffer, so outlives static buffers
+    static std::vector<StreamBuffer *> buffers;
+    return buffers;
+}
+
+uint64_t StreamBuffer::GetFrame() const
+{
+    const std::lock_guard<std::mutex> lock(_mtx);
+    return _frame;
+}
+
+size_t StreamBuffer::GetRegionSize() const
+{
+    const std::lock_guard<std::mutex> lock(_mtx);
+    return _regionSize;
+}
+
+void StreamBuffer::createStorage(size_t regionSize)
+{
+    GPU_MEMORY_SCOPE(Storage, "StreamBuffer");
+    auto &device = GraphicsDevice::Get();
+    _regionSize = (regionSize + STREAM_BUFFER_ALIGNMENT - 1) / STREAM_BUFFER_ALIGNMENT * STREAM_BUFFER_ALIGNMENT;
+    auto totalSize = STREAM_BUFFER_REGIONS * _regionSize;
+    _buffer = std::make_unique<SBuffer>(GL_COPY_WRITE_BUFFER);
+    _buffer->Bind();
+    device.BufferStorage(_buffer->type, totalSize, nullptr, STREAM_BUFFER_FLAGS);
+    _buffer->UnBind();
+    // mapped once, coherent writes need no flush
+    _data = reinterpret_cast<unsigned char *>(
+        device.MapBufferRange(_buffer->Get(), 0, totalSize, STREAM_BUFFER_FLAGS));
+    if (!_data)
+        Tools::display_message(LOGNAME, "Failed to map stream buffer", Tools::MessageType::WARN);
+    _offset = 0;
+}
+
+void StreamBuffer::retireStorage()
+{
+    // new storage is unused, fences of old regions are covered by retire fence
+    auto &device = GraphicsDevice::Get();
+    for (auto &fence : _fences)
+    {
+        device.DeleteSync(fence);
+        fence = nullptr;
+    }
+    if (_buffer)
+        _retired.push_back({std::move(_buffer), nullptr});
+    _data = nullptr;
+}
+
+void StreamBuffer::waitRegion(size_t region)
+{
+    auto &fence = _fences[region];
+    if (!fence)
+        return;
+    auto &device = GraphicsDevice::Get();
+    if (!device.ClientWaitSync(fence, 0))
+    {
+        // CPU is STREAM_BUFFER_REGIONS frames ahead
+        ++_stalls;
+        if (!device.ClientWaitSync(fence, STREAM_BUFFER_WAIT_TIMEOUT))
+            Tools::display_message(LOGNAME, "Timeout waiting for stream buffer region", Tools::MessageType::WARN);
+    }
+    device.DeleteSync(fence);
+    fence = nullptr;
+}
+
+} // namespace RenderIt
@@ -0,0 +1,120 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "GLStructs.hpp"
+
+#define STREAM_BUFFER_REGIONS 3
+// max uniform & shader storage offset alignment in practice
+#define STREAM_BUFFER_ALIGNMENT 256
+#define STREAM_BUFFER_DEFAULT_SIZE (1 << 20)
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Range of stream buffer written by CPU
+/// Only valid in frame it was allocated in, region is overwritten STREAM_BUFFER_REGIONS frames later
+struct StreamAllocation
+{
+    /// Persistently mapped pointer, null if allocation failed
+    void *data = nullptr;
+    GLuint buffer = 0;
+    size_t offset = 0;
+    size_t size = 0;
+    uint64_t frame = 0;
+
+    /// Bind range to indexed target (shader storage or uniform buffer)
+    void BindRange(GLenum target, GLuint binding) const;
+};
+
+/// Persistently mapped ring buffer for per-frame dynamic data
+/// Each frame writes one of STREAM_BUFFER_REGIONS regions, guarded by fence until GPU consumed it
+class StreamBuffer
+{
+  public:
+    StreamBuffer(size_t regionSize = STREAM_BUFFER_DEFAULT_SIZE);
+
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    /// Get shared per-frame buffer
+    static std::shared_ptr<StreamBuffer> Instance();
+
+    /// Allocate range of current region, thread safe
+    /// On GL thread a full region grows the buffer, on other threads allocation fails until next frame
+    StreamAllocation Allocate(size_t size, size_t alignment = STREAM_BUFFER_ALIGNMENT);
+
+    /// Allocate range & copy data into it
+    StreamAllocation Upload(const void *data, size_t size);
+
+    /// Fence current region & move to next one, waits if GPU still reads it
+    void EndFrame();
+
+    /// End frame of all stream buffers, called by AppContext
+    static void EndFrameAll();
+
+    /// Get current frame index
+    uint64_t GetFrame() const;
+
+    /// Get size of one region in bytes
+    size_t GetRegionSize() const;
+
+    /// UI calls
+    void UI();
+
+    /// UI of all stream buffers
+    static void UIAll();
+
+  public:
+    const std::string LOGNAME = "StreamBuffer";
+
+  private:
+    /// Live stream buffers
+    static std::vector<StreamBuffer *> &instances();
+
+    /// Create & map storage of all regions
+    void createStorage(size_t regionSize);
+
+    /// Keep storage alive until GPU finished current frame
+    void retireStorage();
+
+    /// Wait for fence of region
+    void waitRegion(size_t region);
+
+  private:
+    std::unique_ptr<SBuffer> _buffer;
+    unsigned char *_data = nullptr;
+    size_t _regionSize = 0;
+
+    std::array<GLsync, STREAM_BUFFER_REGIONS> _fences{};
+    size_t _region = 0;
+    size_t _offset = 0;
+    uint64_t _frame = 0;
+
+    // replaced storages, freed once fence signaled (fence is null until frame ends)
+    std::vector<std::pair<std::unique_ptr<SBuffer>, GLsync>> _retired;
+
+    // bytes requested by failed allocations in current frame
+    size_t _demand = 0;
+
+    size_t _frameBytes = 0, _peakBytes = 0;
+    size_t _stalls = 0, _grows = 0, _failed = 0;
+
+    std::thread::id _glThread;
+    mutable std::mutex _mtx;
+};
+
+} // namespace RenderIt
@@ -0,0 +1,249 @@
+#include "StressScene.hpp"
+#include "Device.hpp"
+#include "Tools.hpp"
+
+#include <GL/glew.h>
+
+#include <array>
+#include <cstring>
+#include <random>
+
+namespace RenderIt
+{
+
+/// Seeded generator, same sequence on every platform unlike std distributions
+class StressRandom
+{
+  public:
+    StressRandom(uint32_t seed) : _engine(seed)
+    {
+    }
+
+    /// Uniform float in [min, max)
+    float Range(float min, float max)
+    {
+        return min + (max - min) * static_cast<float>(_engine() >> 8) / 16777216.0f;
+    }
+
+    /// Uniform index in [0, count)
+    unsigned Index(unsigned count)
+    {
+        return static_cast<unsigned>(_engine() % count);
+    }
+
+    /// Random point on XZ plane at height
+    glm::vec3 Position(float extent, float height)
+    {
+        auto x = Range(-extent, extent);
+        auto z = Range(-extent, extent);
+        return glm::vec3(x, height, z);
+    }
+
+    /// Random saturated color
+    glm::vec3 Color()
+    {
+        auto r = Range(0.2f, 1.0f);
+        auto g = Range(0.2f, 1.0f);
+        auto b = Range(0.2f, 1.0f);
+        return glm::vec3(r, g, b);
+    }
+
+  private:
+    std::mt19937 _engine;
+};
+
+static const std::array<MeshShape, 5> stress_shapes = {MeshShape::Cube, MeshShape::Sphere, MeshShape::Cylinder,
+                                                       MeshShape::Cone, MeshShape::Torus};
+
+StressScene::StressScene() : _scene(std::make_unique<Scene>()), _buildCount(0)
+{
+    _lightsSSBO = std::make_unique<SBuffer>(GL_SHADER_STORAGE_BUFFER);
+    updateLightsSSBO();
+}
+
+bool StressScene::Build(const StressSceneConfig &config)
+{
+    Clear();
+    _config = config;
+    StressRandom random(config.seed);
+    bool success = true;
+
+    // ground
+    auto ground = loadShape(MeshShape::Plane, glm::vec3(0.5f), 1.0f);
+    if (ground)
+    {
+        ground->transform.position.y = -0.5f;
+        ground->transform.scale = glm::vec3(config.extent * 2.0f);
+        ground->transform.UpdateMatrix();
+        _scene->AttachObject(ground);
+    }
+
+    for (unsigned i = 0; i < config.staticProps; ++i)
+    {
+        auto shape = stress_shapes[random.Index(static_cast<unsigned>(stress_shapes.size()))];
+        auto model = loadShape(shape, random.Color(), 1.0f);
+        if (!model)
+        {
+            success = false;
+            break;
+        }
+        model->transform.position = random.Position(config.extent, 0.0f);
+        model->transform.rotation.y = random.Range(0.0f, 360.0f);
+        model->transform.scale = glm::vec3(random.Range(0.2f, 1.0f));
+        model->transform.UpdateMatrix();
+        _scene->AttachObject(model);
+    }
+
+    if (config.instancedMeshes)
+    {
+        auto prototype = loadShape(MeshShape::Sphere, random.Color(), 1.0f);
+        for (unsigned i = 0; prototype && i < config.instancedMeshes; ++i)
+        {
+            auto model = prototype->Clone();
+            model->transform.position = random.Position(config.extent, random.Range(0.0f, 4.0f));
+            model->transform.scale = glm::vec3(random.Range(0.1f, 0.4f));
+            model->transform.UpdateMatrix();
+            _scene->AttachObject(model);
+        }
+        success = success && prototype;
+    }
+
+    if (config.transparentObjects)
+    {
+        for (unsigned i = 0; i < config.transparentObjects; ++i)
+        {
+            auto shape = stress_shapes[random.Index(static_cast<unsigned>(stress_shapes.size()))];
+            auto model = loadShape(shape, random.Color(), random.Range(0.2f, 0.8f));
+            if (!model)
+            {
+                success = false;
+                break;
+            }
+            model->transform.position = random.Position(config.extent, random.Range(0.5f, 3.0f));
+            model->transform.scale = glm::vec3(random.Range(0.3f, 1.2f));
+            model->transform.UpdateMatrix();
+            _scene->AttachObject(model);
+        }
+    }
+
+    if (config.skinnedModels && !config.skinnedModelPath.empty())
+    {
+        // clones share animation clips but keep own playback time, start phases are staggered
+        auto prototype = std::make_shared<Model>();
+        if (prototype->Load(config.skinnedModelPath) && prototype->HasAnimation())
+        {
+            auto size = prototype->bounds.Diagonal();
+            for (unsigned i = 0; i < config.skinnedModels; ++i)
+            {
+                auto model = prototype->Clone();
+                model->transform.position = random.Position(config.extent, 0.0f);
+                model->transform.rotation.y = random.Range(0.0f, 360.0f);
+                model->transform.scale = glm::vec3(size > 0.0f ? 2.0f / size : 1.0f);
+                model->transform.UpdateMatrix();
+                model->SetAnimationTime(random.Range(0.0f, prototype->GetAnimationDuration()));
+                _skinnedModels.push_back(model);
+            }
+        }
+        else
+        {
+            Tools::display_message(LOGNAME, "Failed to load animated model " + config.skinnedModelPath,
+                                   Tools::MessageType::WARN);
+            success = false;
+        }
+    }
+
+    if (config.staticBatch && !_scene->BuildStaticBatch())
+        Tools::display_message(LOGNAME, "Failed to build static batch", Tools::MessageType::WARN);
+
+    _lights.reserve(config.pointLights);
+    for (unsigned i = 0; i < config.pointLights; ++i)
+    {
+        StressLight light;
+        light.posRange = glm::vec4(random.Position(config.extent, random.Range(0.5f, 3.0f)), random.Range(2.0f, 6.0f));
+        light.colorIntensity = glm::vec4(random.Color(), random.Range(0.5f, 2.0f));
+        _lights.push_back(light);
+    }
+    updateLightsSSBO();
+
+    Tools::display_message(LOGNAME,
+                           "Built " + std::to_string(_scene->models.size()) + " models, " +
+                               std::to_string(_skinnedModels.size()) + " skinned models, " +
+                               std::to_string(_lights.size()) + " lights",
+                           Tools::MessageType::INFO);
+    return success;
+}
+
+void StressScene::Clear()
+{
+    // new scene drops batches, BVHs & instance buffers of old one
+    _scene = std::make_unique<Scene>();
+    ++_buildCount;
+    _skinnedModels.clear();
+    _lights.clear();
+    updateLightsSSBO();
+}
+
+Scene &StressScene::GetScene()
+{
+    return *_scene;
+}
+
+const std::vector<std::shared_ptr<Model>> &StressScene::GetSkinnedModels() const
+{
+    return _skinnedModels;
+}
+
+const std::vector<StressLight> &StressScene::GetLights() const
+{
+    return _lights;
+}
+
+const StressSceneConfig &StressScene::GetConfig() const
+{
+    return _config;
+}
+
+unsigned StressScene::GetBuildCount() const
+{
+    return _buildCount;
+}
+
+void StressScene::BindLights(unsigned binding) const
+{
+    GraphicsDevice::Get().BindBufferBase(_lightsSSBO->type, binding, _lightsSSBO->IDs.front());
+}
+
+void StressScene::UnBindLights(unsigned binding) const
+{
+    GraphicsDevice::Get().BindBufferBase(_lightsSSBO->type, binding, 0);
+}
+
+std::shared_ptr<Model> StressScene::loadShape(MeshShape shape, const glm::vec3 &color, float opacity)
+{
+    auto model = std::make_shared<Model>();
+    if (!model->Load(shape))
+        return nullptr;
+    auto mat = model->GetMesh(0)->material;
+    mat->colorAmbient = glm::vec3(0.25f);
+    mat->colorDiffuse = color;
+    mat->colorSpecular = glm::vec3(1.0f);
+    mat->valShininess = 32.0f;
+    mat->valOpacity = opacity;
+    return model;
+}
+
+void StressScene::updateLightsSSBO()
+{
+    // count padded to 16 bytes, as vec4 array follows
+    std::vector<unsigned char> data(16 + _lights.size() * sizeof(StressLight), 0);
+    auto count = static_cast<uint32_t>(_lights.size());
+    std::memcpy(data.data(), &count, sizeof(count));
+    if (!_lights.empty())
+        std::memcpy(data.data() + 16, _lights.data(), _lights.size() * sizeof(StressLight));
+    auto &device = GraphicsDevice::Get();
+    _lightsSSBO->Bind();
+    device.BufferData(_lightsSSBO->type, data.size(), data.data(), GL_STATIC_DRAW);
+    _lightsSSBO->UnBind();
+}
+
+} // namespace RenderIt
@@ -0,0 +1,106 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GLStructs.hpp"
+#include "Model.hpp"
+#include "Scene.hpp"
+
+#define STRESS_LIGHTS_SSBO_BINDING 2
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Object counts & placement of generated scene
+struct StressSceneConfig
+{
+    /// Shapes with own mesh & material
+    unsigned staticProps = 1000;
+    /// Clones of one shape, drawn instanced with Scene::autoInstancing
+    unsigned instancedMeshes = 0;
+    /// Clones of animated model, skipped if no model is given
+    unsigned skinnedModels = 0;
+    unsigned pointLights = 0;
+    /// Shapes with opacity below 1, drawn in transparent pass
+    unsigned transparentObjects = 0;
+    /// Draw opaque static & instanced objects with one multi-draw indirect batch (Scene::BuildStaticBatch)
+    bool staticBatch = false;
+    /// Animated model file of skinned models
+    std::string skinnedModelPath;
+    /// Objects are placed in [-extent, extent] on XZ plane
+    float extent = 50.0f;
+    uint32_t seed = 1;
+};
+
+/// Point light of stress scene, std430 layout
+struct StressLight
+{
+    glm::vec4 posRange;
+    glm::vec4 colorIntensity;
+};
+
+/// Builder of procedural scenes for scaling tests
+/// Objects are built from MeshShape & loaded models, placed by seeded RNG, so same config gives same scene
+/// Skinned models are kept out of scene, they need per-model Animator updates
+/// Lights are kept in own SSBO (std430: uint count, StressLight lights[]), LightManager holds too few lights
+class StressScene
+{
+  public:
+    StressScene();
+
+    /// Replace scene with generated one, returns false if any object failed to load
+    bool Build(const StressSceneConfig &config);
+
+    /// Remove all generated objects & lights
+    void Clear();
+
+    /// Get scene of static, instanced & transparent objects
+    Scene &GetScene();
+
+    /// Get skinned models
+    const std::vector<std::shared_ptr<Model>> &GetSkinnedModels() const;
+
+    /// Get point lights
+    const std::vector<StressLight> &GetLights() const;
+
+    /// Get config of last build
+    const StressSceneConfig &GetConfig() const;
+
+    /// Get number of builds & clears, changes whenever models are replaced
+    unsigned GetBuildCount() const;
+
+    /// Bind lights SSBO
+    void BindLights(unsigned binding = STRESS_LIGHTS_SSBO_BINDING) const;
+
+    /// UnBind lights SSBO
+    void UnBindLights(unsigned binding = STRESS_LIGHTS_SSBO_BINDING) const;
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "StressScene";
+
+  private:
+    /// Load shape with own material
+    std::shared_ptr<Model> loadShape(MeshShape shape, const glm::vec3 &color, float opacity);
+
+    /// Upload lights to SSBO
+    void updateLightsSSBO();
+
+  private:
+    StressSceneConfig _config;
+    std::unique_ptr<Scene> _scene;
+    std::vector<std::shared_ptr<Model>> _skinnedModels;
+    std::vector<StressLight> _lights;
+    std::unique_ptr<SBuffer> _lightsSSBO;
+    unsigned _buildCount;
+};
+
+} // namespace RenderIt
@@ -1,4 +1,5 @@
 #include "Tools.hpp"
+#include "Shader.hpp"
 
 #include <GL/glew.h>
 #include <termcolor/termcolor.hpp>
@@ -204,6 +205,20 @@ void Tools::set_gl_debug(bool enable, bool filterNotifications)
     }
 }
 
+bool Tools::compile_shaders_parallel(const std::vector<Shader *> &shaders, bool wait)
+{
+    bool success = true;
+    // compiled or pending shaders are not submitted again
+    for (auto shader : shaders)
+        success = (shader->IsCompiled() || shader->IsPending() || shader->CompileAsync()) && success;
+    if (!wait)
+        return success;
+    // later shaders keep compiling while first ones are waited on
+    for (auto shader : shaders)
+        success = shader->Poll(true) && success;
+    return success;
+}
+
 glm::vec2 Tools::convertAssimpVector(const aiVector2D &v)
 {
     return glm::vec2(v.x, v.y);
@@ -268,4 +283,13 @@ glm::vec3 Tools::matrixMultiplyVector(const glm::mat4 &mat, const glm::vec3 &v)
     return glm::vec3(mat * glm::vec4(v, 0.0f));
 }
 
+glm::mat4 Tools::affineInverse(const glm::mat4 &mat)
+{
+    // [A t; 0 1]^-1 = [A^-1 -A^-1 t; 0 1]
+    auto linearInv = glm::inverse(glm::mat3(mat));
+    glm::mat4 inv(linearInv);
+    inv[3] = glm::vec4(-(linearInv * glm::vec3(mat[3])), 1.0f);
+    return inv;
+}
+
 } // namespace RenderIt
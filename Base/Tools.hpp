@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <assimp/scene.h>
 #include <glm/glm.hpp>
@@ -12,6 +13,8 @@
 namespace RenderIt
 {
 
+class Shader;
+
 /// Collection of tools
 struct Tools
 {
@@ -44,6 +47,11 @@ struct Tools
     /// Enable/Disable OpenGL debug output
     static void set_gl_debug(bool enable, bool filterNotifications = true);
 
+    /// Start compiles of all shaders before waiting on any, so driver compiles them in parallel
+    /// Without wait, shaders are finished by Shader::PollPending & skipped by draws until then
+    /// Returns false if any shader failed or had nothing to compile, already compiled shaders count as success
+    static bool compile_shaders_parallel(const std::vector<Shader *> &shaders, bool wait = true);
+
 #pragma region assimp_conversions
 
     /// Convert aiVector2D to vec2
@@ -77,6 +85,9 @@ struct Tools
 
     /// Multiply a matrix with a directional vector
     static glm::vec3 matrixMultiplyVector(const glm::mat4 &mat, const glm::vec3 &v);
+
+    /// Inverse of affine matrix (last row 0, 0, 0, 1), cheaper than glm::inverse
+    static glm::mat4 affineInverse(const glm::mat4 &mat);
 };
 
 } // namespace RenderIt
@@ -1,6 +1,7 @@
 #include "Transform.hpp"
 #include "Camera.hpp"
 #include "GLMIOStream.hpp"
+#include "Tools.hpp"
 
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -42,8 +43,8 @@ void Transform::UpdateMatrix()
     }
     }
     matrix = parentMatrix * localMatrix;
-    matrixInv = glm::inverse(matrix);
-    localMatrixInv = glm::inverse(localMatrix);
+    matrixInv = Tools::affineInverse(matrix);
+    localMatrixInv = Tools::affineInverse(localMatrix);
 }
 
 void Transform::Reset()
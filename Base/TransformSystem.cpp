@@ -0,0 +1,224 @@
+#include "TransformSystem.hpp"
+#include "Model.hpp"
+#include "SIMD.hpp"
+#include "Tools.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/euler_angles.hpp>
+
+#include <chrono>
+#include <queue>
+
+namespace RenderIt
+{
+
+/// Rotation matching glm::eulerAngleYXZ of Transform (degrees)
+static glm::quat euler_to_quat(const glm::vec3 &rotation)
+{
+    auto r = glm::radians(rotation);
+    return glm::angleAxis(r.y, glm::vec3(0.0f, 1.0f, 0.0f)) * glm::angleAxis(r.x, glm::vec3(1.0f, 0.0f, 0.0f)) *
+           glm::angleAxis(r.z, glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+TransformSystem::TransformSystem() : useSIMD(true), _lastUpdated(0), _lastUpdateMs(0.0)
+{
+}
+
+void TransformSystem::Build(const std::unordered_set<std::shared_ptr<Model>> &roots)
+{
+    _positions.clear();
+    _rotations.clear();
+    _scales.clear();
+    _eulers.clear();
+    _types.clear();
+    _rootParents.clear();
+    _rootParentsInv.clear();
+    _parents.clear();
+    _models.clear();
+    _numChildren.clear();
+    _indices.clear();
+
+    // breadth-first order places parents before children
+    std::queue<std::pair<Model *, int>> q;
+    for (const auto &m : roots)
+        q.push({m.get(), -1});
+    while (!q.empty())
+    {
+        auto [m, parent] = q.front();
+        q.pop();
+        int idx = static_cast<int>(_models.size());
+        const auto &t = m->transform;
+        _positions.push_back(t.position);
+        _rotations.push_back(euler_to_quat(t.rotation));
+        _scales.push_back(t.scale);
+        _eulers.push_back(t.rotation);
+        _types.push_back(t.type);
+        _rootParents.push_back(parent < 0 ? t.parentMatrix : glm::mat4(1.0f));
+        _rootParentsInv.push_back(parent < 0 ? Tools::affineInverse(t.parentMatrix) : glm::mat4(1.0f));
+        _parents.push_back(parent);
+        _models.push_back(m);
+        _numChildren.push_back(m->GetNumChildren());
+        _indices[m] = idx;
+        for (auto i = 0u; i < m->GetNumChildren(); ++i)
+            q.push({m->GetChild(i).get(), idx});
+    }
+
+    auto count = _models.size();
+    _local.resize(count);
+    _localInv.resize(count);
+    _world.resize(count);
+    _worldInv.resize(count);
+    _dirty.assign(count, 1);
+    _changed.assign(count, 0);
+}
+
+bool TransformSystem::Pull()
+{
+    for (size_t i = 0; i < _models.size(); ++i)
+    {
+        const auto &t = _models[i]->transform;
+        if (_numChildren[i] != _models[i]->GetNumChildren())
+            return false;
+        if (t.position != _positions[i] || t.scale != _scales[i] || t.rotation != _eulers[i] || t.type != _types[i])
+        {
+            _positions[i] = t.position;
+            _scales[i] = t.scale;
+            _types[i] = t.type;
+            if (t.rotation != _eulers[i])
+            {
+                _eulers[i] = t.rotation;
+                _rotations[i] = euler_to_quat(t.rotation);
+            }
+            _dirty[i] = 1;
+        }
+        if (_parents[i] < 0 && t.parentMatrix != _rootParents[i])
+        {
+            _rootParents[i] = t.parentMatrix;
+            _rootParentsInv[i] = Tools::affineInverse(t.parentMatrix);
+            _dirty[i] = 1;
+        }
+    }
+    return true;
+}
+
+size_t TransformSystem::Update()
+{
+    auto start = std::chrono::steady_clock::now();
+    size_t updated = 0;
+    for (size_t i = 0; i < _models.size(); ++i)
+    {
+        int parent = _parents[i];
+        bool changed = _dirty[i] || (parent >= 0 && _changed[parent]);
+        _changed[i] = changed;
+        if (!changed)
+            continue;
+        if (_dirty[i])
+            updateLocal(i);
+        _dirty[i] = 0;
+
+        // world inverse is product of inverses, no general inverse needed
+        if (parent >= 0)
+        {
+            multiply(_world[parent], _local[i], _world[i]);
+            multiply(_localInv[i], _worldInv[parent], _worldInv[i]);
+        }
+        else
+        {
+            multiply(_rootParents[i], _local[i], _world[i]);
+            multiply(_localInv[i], _rootParentsInv[i], _worldInv[i]);
+        }
+
+        auto &t = _models[i]->transform;
+        t.parentMatrix = parent >= 0 ? _world[parent] : _rootParents[i];
+        t.localMatrix = _local[i];
+        t.localMatrixInv = _localInv[i];
+        t.matrix = _world[i];
+        t.matrixInv = _worldInv[i];
+        ++updated;
+    }
+    _lastUpdated = updated;
+    _lastUpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return updated;
+}
+
+int TransformSystem::GetIndex(const Model *model) const
+{
+    auto it = _indices.find(model);
+    return it == _indices.end() ? -1 : it->second;
+}
+
+void TransformSystem::SetLocal(int idx, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale)
+{
+    if (idx < 0 || idx >= static_cast<int>(_models.size()))
+        return;
+    _positions[idx] = position;
+    _rotations[idx] = rotation;
+    _scales[idx] = scale;
+    // keep model transform in sync so Pull sees no edit
+    float y, x, z;
+    glm::extractEulerAngleYXZ(glm::mat4_cast(rotation), y, x, z);
+    auto &t = _models[idx]->transform;
+    t.position = position;
+    t.scale = scale;
+    t.rotation = glm::degrees(glm::vec3(x, y, z));
+    _eulers[idx] = t.rotation;
+    _dirty[idx] = 1;
+}
+
+size_t TransformSystem::GetCount() const
+{
+    return _models.size();
+}
+
+void TransformSystem::updateLocal(size_t idx)
+{
+    const auto &p = _positions[idx];
+    const auto &s = _scales[idx];
+    auto r = glm::mat3_cast(_rotations[idx]);
+    if (_types[idx] == Transform::Type::SRT)
+    {
+        glm::mat4 rot(r);
+        _local[idx] = glm::scale(glm::mat4(1.0f), s) * rot * glm::translate(glm::mat4(1.0f), p);
+        _localInv[idx] = Tools::affineInverse(_local[idx]);
+        return;
+    }
+    // T * R * S and its inverse S^-1 * R^T * T^-1
+    auto &local = _local[idx];
+    local[0] = glm::vec4(r[0] * s.x, 0.0f);
+    local[1] = glm::vec4(r[1] * s.y, 0.0f);
+    local[2] = glm::vec4(r[2] * s.z, 0.0f);
+    local[3] = glm::vec4(p, 1.0f);
+    auto rt = glm::transpose(r);
+    auto sInv = 1.0f / s;
+    glm::mat3 linearInv(rt[0] * sInv, rt[1] * sInv, rt[2] * sInv);
+    auto &localInv = _localInv[idx];
+    localInv = glm::mat4(linearInv);
+    localInv[3] = glm::vec4(-(linearInv * p), 1.0f);
+}
+
+void TransformSystem::multiply(const glm::mat4 &a, const glm::mat4 &b, glm::mat4 &out) const
+{
+#ifdef RENDERIT_SIMD_SSE
+    if (useSIMD)
+    {
+        // column j of result = sum of columns of a weighted by column j of b
+        auto a0 = _mm_loadu_ps(&a[0][0]);
+        auto a1 = _mm_loadu_ps(&a[1][0]);
+        auto a2 = _mm_loadu_ps(&a[2][0]);
+        auto a3 = _mm_loadu_ps(&a[3][0]);
+        for (int j = 0; j < 4; ++j)
+        {
+            auto bj = _mm_loadu_ps(&b[j][0]);
+            auto r = _mm_mul_ps(a0, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0)));
+            r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1))));
+            r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2))));
+            r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3))));
+            _mm_storeu_ps(&out[j][0], r);
+        }
+        return;
+    }
+#endif
+    out = a * b;
+}
+
+} // namespace RenderIt
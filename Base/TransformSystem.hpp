@@ -0,0 +1,93 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Transform.hpp"
+
+/** @file */
+
+namespace RenderIt
+{
+
+class Model;
+
+/// Flat transform hierarchy of models
+/// Local TRS is kept as structure of arrays in hierarchy order (parents before children),
+/// so one pass over dirty flags updates changed subtrees only
+/// Entries are updated one at a time, each with SSE 4x4 products (no SIMD lanes across entries)
+/// World matrices are written back to Model::transform
+class TransformSystem
+{
+  public:
+    TransformSystem();
+
+    /// Rebuild hierarchy from root models (children included)
+    void Build(const std::unordered_set<std::shared_ptr<Model>> &roots);
+
+    /// Read TRS of every model transform, mark changed entries dirty
+    /// Returns false if hierarchy changed since Build
+    bool Pull();
+
+    /// Recompute dirty local & world matrices, returns number of updated entries
+    size_t Update();
+
+    /// Get entry of model, -1 if not found
+    int GetIndex(const Model *model) const;
+
+    /// Set local TRS of entry
+    void SetLocal(int idx, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale);
+
+    /// Get number of entries
+    size_t GetCount() const;
+
+    /// UI calls
+    void UI();
+
+  public:
+    const std::string LOGNAME = "TransformSystem";
+    // disable to run scalar matrix products
+    bool useSIMD;
+
+  private:
+    /// Compute local matrix & its inverse of entry
+    void updateLocal(size_t idx);
+
+    /// out = a * b
+    void multiply(const glm::mat4 &a, const glm::mat4 &b, glm::mat4 &out) const;
+
+  private:
+    // local TRS
+    std::vector<glm::vec3> _positions;
+    std::vector<glm::quat> _rotations;
+    std::vector<glm::vec3> _scales;
+    // euler angles last read from model, used to detect edits
+    std::vector<glm::vec3> _eulers;
+    std::vector<Transform::Type> _types;
+    // parent matrix of roots, as set on model, & its inverse (recomputed only when parent matrix changes)
+    std::vector<glm::mat4> _rootParents;
+    std::vector<glm::mat4> _rootParentsInv;
+
+    // hierarchy
+    std::vector<int> _parents;
+    std::vector<Model *> _models;
+    std::vector<size_t> _numChildren;
+    std::unordered_map<const Model *, int> _indices;
+
+    // matrices
+    std::vector<glm::mat4> _local, _localInv;
+    std::vector<glm::mat4> _world, _worldInv;
+    std::vector<uint8_t> _dirty;
+    std::vector<uint8_t> _changed;
+
+    size_t _lastUpdated;
+    double _lastUpdateMs;
+};
+
+} // namespace RenderIt
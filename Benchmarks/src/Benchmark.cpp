@@ -0,0 +1,170 @@
+#include "Benchmark.hpp"
+#include "Tools.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <unordered_map>
+
+namespace RenderIt
+{
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+/// Seconds since start
+static double seconds_since(BenchmarkClock::time_point start)
+{
+    return std::chrono::duration<double>(BenchmarkClock::now() - start).count();
+}
+
+/// Get string value of key from single JSON line, empty if missing
+static std::string json_string(const std::string &line, const std::string &key)
+{
+    auto pos = line.find("\"" + key + "\": \"");
+    if (pos == std::string::npos)
+        return "";
+    pos += key.size() + 5;
+    auto end = line.find('"', pos);
+    return end == std::string::npos ? "" : line.substr(pos, end - pos);
+}
+
+/// Get number value of key from single JSON line, negative if missing
+static double json_number(const std::string &line, const std::string &key)
+{
+    auto pos = line.find("\"" + key + "\": ");
+    if (pos == std::string::npos)
+        return -1.0;
+    return std::strtod(line.c_str() + pos + key.size() + 4, nullptr);
+}
+
+void BenchmarkRunner::Add(const std::string &name, std::function<void()> func, size_t opsPerCall,
+                          std::function<void()> teardown)
+{
+    _entries.push_back({name, std::move(func), (std::max)(opsPerCall, size_t(1)), std::move(teardown)});
+}
+
+const std::vector<BenchmarkResult> &BenchmarkRunner::Run(const std::string &filter)
+{
+    _results.clear();
+    std::printf("%-40s %12s %12s %12s %12s %8s\n", "benchmark", "median ns", "mean ns", "min ns", "max ns", "cv %");
+    for (const auto &entry : _entries)
+    {
+        if (!filter.empty() && entry.name.find(filter) == std::string::npos)
+            continue;
+        auto result = measure(entry);
+        if (entry.teardown)
+            entry.teardown();
+        std::printf("%-40s %12.2f %12.2f %12.2f %12.2f %8.2f\n", result.name.c_str(), result.median, result.mean,
+                    result.min, result.max, result.mean > 0.0 ? 100.0 * result.stddev / result.mean : 0.0);
+        std::fflush(stdout);
+        _results.push_back(result);
+    }
+    return _results;
+}
+
+bool BenchmarkRunner::WriteJSON(const std::string &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        Tools::display_message(LOGNAME, "Failed to write results to " + path, Tools::MessageType::WARN);
+        return false;
+    }
+    // one benchmark per line, read back by CompareBaseline
+    file << "{\"benchmarks\": [\n";
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        const auto &r = _results[i];
+        file << "{\"name\": \"" << r.name << "\", \"samples\": " << r.samples << ", \"iterations\": " << r.iterations
+             << ", \"mean_ns\": " << r.mean << ", \"stddev_ns\": " << r.stddev << ", \"min_ns\": " << r.min
+             << ", \"median_ns\": " << r.median << ", \"max_ns\": " << r.max << "}"
+             << (i + 1 < _results.size() ? ",\n" : "\n");
+    }
+    file << "]}\n";
+    return true;
+}
+
+int BenchmarkRunner::CompareBaseline(const std::string &path, double thresholdPercent) const
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        Tools::display_message(LOGNAME, "Failed to read baseline " + path, Tools::MessageType::WARN);
+        return -1;
+    }
+    std::unordered_map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        auto name = json_string(line, "name");
+        auto median = json_number(line, "median_ns");
+        if (!name.empty() && median > 0.0)
+            baseline[name] = median;
+    }
+
+    // compare medians, robust to outlier samples
+    int regressions = 0;
+    std::printf("\n%-40s %12s %12s %9s\n", "benchmark", "base ns", "median ns", "change");
+    for (const auto &result : _results)
+    {
+        auto iter = baseline.find(result.name);
+        if (iter == baseline.end())
+        {
+            std::printf("%-40s %12s %12.2f %9s\n", result.name.c_str(), "-", result.median, "new");
+            continue;
+        }
+        auto change = 100.0 * (result.median - iter->second) / iter->second;
+        bool slower = change > thresholdPercent;
+        regressions += slower ? 1 : 0;
+        std::printf("%-40s %12.2f %12.2f %+8.1f%%%s\n", result.name.c_str(), iter->second, result.median, change,
+                    slower ? "  REGRESSION" : "");
+    }
+    std::printf("%d regression(s) over %.1f%% threshold\n", regressions, thresholdPercent);
+    return regressions;
+}
+
+BenchmarkResult BenchmarkRunner::measure(const Entry &entry) const
+{
+    BenchmarkResult result;
+    result.name = entry.name;
+
+    // warmup caches & calibrate calls per sample
+    size_t calls = 0;
+    auto start = BenchmarkClock::now();
+    double elapsed = 0.0;
+    do
+    {
+        entry.func();
+        ++calls;
+        elapsed = seconds_since(start);
+    } while (elapsed < warmupSeconds);
+    result.iterations = (std::max)(size_t(1), static_cast<size_t>(calls * sampleSeconds / elapsed));
+
+    std::vector<double> samples(numSamples ? numSamples : 1);
+    for (auto &sample : samples)
+    {
+        start = BenchmarkClock::now();
+        for (size_t i = 0; i < result.iterations; ++i)
+            entry.func();
+        sample = seconds_since(start) * 1e9 / static_cast<double>(result.iterations * entry.opsPerCall);
+    }
+    result.samples = static_cast<unsigned>(samples.size());
+
+    std::sort(samples.begin(), samples.end());
+    auto count = samples.size();
+    result.min = samples.front();
+    result.max = samples.back();
+    result.median = count % 2 ? samples[count / 2] : 0.5 * (samples[count / 2 - 1] + samples[count / 2]);
+    for (auto sample : samples)
+        result.mean += sample;
+    result.mean /= count;
+    for (auto sample : samples)
+        result.stddev += (sample - result.mean) * (sample - result.mean);
+    result.stddev = count > 1 ? std::sqrt(result.stddev / (count - 1)) : 0.0;
+    return result;
+}
+
+} // namespace RenderIt
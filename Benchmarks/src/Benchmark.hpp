@@ -0,0 +1,79 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Keep value alive so compiler cannot remove computation producing it
+template <typename T> inline void DoNotOptimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void *volatile sink;
+    sink = &value;
+#endif
+}
+
+/// Statistics of one benchmark, times in nanoseconds per operation
+struct BenchmarkResult
+{
+    std::string name;
+    unsigned samples = 0;
+    // calls timed per sample
+    size_t iterations = 0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double median = 0.0;
+    double max = 0.0;
+};
+
+/// Runner of CPU microbenchmarks
+/// Warmup calibrates calls per sample to sample duration, then samples are timed
+class BenchmarkRunner
+{
+  public:
+    /// Register benchmark, function performs opsPerCall operations per call
+    /// Teardown runs once benchmark is measured, releasing fixtures created by its first call
+    void Add(const std::string &name, std::function<void()> func, size_t opsPerCall = 1,
+             std::function<void()> teardown = nullptr);
+
+    /// Run benchmarks with name containing filter, prints each result
+    const std::vector<BenchmarkResult> &Run(const std::string &filter = "");
+
+    /// Write results as JSON
+    bool WriteJSON(const std::string &path) const;
+
+    /// Compare medians against results JSON, returns number of slower benchmarks (-1 if unreadable)
+    int CompareBaseline(const std::string &path, double thresholdPercent) const;
+
+  public:
+    const std::string LOGNAME = "Benchmark";
+
+    double warmupSeconds = 0.2;
+    double sampleSeconds = 0.01;
+    unsigned numSamples = 30;
+
+  private:
+    struct Entry
+    {
+        std::string name;
+        std::function<void()> func;
+        size_t opsPerCall;
+        std::function<void()> teardown;
+    };
+
+    /// Warmup, sample & compute statistics of one benchmark
+    BenchmarkResult measure(const Entry &entry) const;
+
+  private:
+    std::vector<Entry> _entries;
+    std::vector<BenchmarkResult> _results;
+};
+
+} // namespace RenderIt
@@ -0,0 +1,153 @@
+#include "Fixtures.hpp"
+
+#include <cmath>
+
+#include <assimp/Exporter.hpp>
+#include <assimp/scene.h>
+
+namespace RenderIt
+{
+
+std::unique_ptr<aiNodeAnim> make_bone_channel(const std::string &name, unsigned numKeys)
+{
+    auto channel = std::make_unique<aiNodeAnim>();
+    channel->mNodeName = aiString(name);
+    channel->mNumPositionKeys = channel->mNumRotationKeys = channel->mNumScalingKeys = numKeys;
+    channel->mPositionKeys = new aiVectorKey[numKeys];
+    channel->mRotationKeys = new aiQuatKey[numKeys];
+    channel->mScalingKeys = new aiVectorKey[numKeys];
+    for (auto i = 0u; i < numKeys; ++i)
+    {
+        auto time = static_cast<double>(i);
+        auto wave = static_cast<float>(std::sin(time * 0.25));
+        channel->mPositionKeys[i] = aiVectorKey(time, aiVector3D(0.05f * wave, 1.0f, 0.0f));
+        channel->mRotationKeys[i] = aiQuatKey(time, aiQuaternion(aiVector3D(0.0f, 0.0f, 1.0f), 0.3f * wave));
+        channel->mScalingKeys[i] = aiVectorKey(time, aiVector3D(1.0f + 0.1f * wave));
+    }
+    return channel;
+}
+
+std::string make_skinned_model_source(unsigned numBones, unsigned numKeys)
+{
+    auto scene = std::make_unique<aiScene>();
+
+    scene->mNumMaterials = 1;
+    scene->mMaterials = new aiMaterial *[1]{new aiMaterial()};
+    aiString materialName("Skin");
+    scene->mMaterials[0]->AddProperty(&materialName, AI_MATKEY_NAME);
+
+    // one quad per bone stacked along Y, fully weighted to its bone
+    auto mesh = new aiMesh();
+    mesh->mName = aiString("Chain");
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mMaterialIndex = 0;
+    mesh->mNumVertices = numBones * 4;
+    mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+    mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+    mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+    mesh->mNumUVComponents[0] = 2;
+    mesh->mNumFaces = numBones * 2;
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+    mesh->mNumBones = numBones;
+    mesh->mBones = new aiBone *[numBones];
+    for (auto i = 0u; i < numBones; ++i)
+    {
+        auto y = static_cast<float>(i), v = 4 * i;
+        const float corners[4][2] = {{-0.1f, 0.0f}, {0.1f, 0.0f}, {0.1f, 1.0f}, {-0.1f, 1.0f}};
+        for (auto c = 0u; c < 4; ++c)
+        {
+            mesh->mVertices[v + c] = aiVector3D(corners[c][0], y + corners[c][1], 0.0f);
+            mesh->mNormals[v + c] = aiVector3D(0.0f, 0.0f, 1.0f);
+            mesh->mTextureCoords[0][v + c] = aiVector3D(corners[c][0] + 0.5f, corners[c][1], 0.0f);
+        }
+        for (auto f = 0u; f < 2; ++f)
+        {
+            auto &face = mesh->mFaces[2 * i + f];
+            face.mNumIndices = 3;
+            face.mIndices = f ? new unsigned[3]{v, v + 2, v + 3} : new unsigned[3]{v, v + 1, v + 2};
+        }
+
+        auto bone = new aiBone();
+        bone->mName = aiString("Bone" + std::to_string(i));
+        aiMatrix4x4::Translation(aiVector3D(0.0f, -y, 0.0f), bone->mOffsetMatrix);
+        bone->mNumWeights = 4;
+        bone->mWeights = new aiVertexWeight[4];
+        for (auto c = 0u; c < 4; ++c)
+            bone->mWeights[c] = aiVertexWeight(v + c, 1.0f);
+        mesh->mBones[i] = bone;
+    }
+    scene->mNumMeshes = 1;
+    scene->mMeshes = new aiMesh *[1]{mesh};
+
+    // root holds mesh node & bone chain, each bone one unit above parent
+    scene->mRootNode = new aiNode("Root");
+    auto meshNode = new aiNode("Chain");
+    meshNode->mNumMeshes = 1;
+    meshNode->mMeshes = new unsigned[1]{0};
+    auto boneNode = new aiNode("Bone0");
+    scene->mRootNode->addChildren(1, &meshNode);
+    scene->mRootNode->addChildren(1, &boneNode);
+    for (auto i = 1u; i < numBones; ++i)
+    {
+        auto child = new aiNode("Bone" + std::to_string(i));
+        aiMatrix4x4::Translation(aiVector3D(0.0f, 1.0f, 0.0f), child->mTransformation);
+        boneNode->addChildren(1, &child);
+        boneNode = child;
+    }
+
+    auto animation = new aiAnimation();
+    animation->mName = aiString("Wave");
+    animation->mDuration = numKeys > 1 ? numKeys - 1.0 : 1.0;
+    animation->mTicksPerSecond = 24.0;
+    animation->mNumChannels = numBones;
+    animation->mChannels = new aiNodeAnim *[numBones];
+    for (auto i = 0u; i < numBones; ++i)
+        animation->mChannels[i] = make_bone_channel("Bone" + std::to_string(i), numKeys).release();
+    scene->mNumAnimations = 1;
+    scene->mAnimations = new aiAnimation *[1]{animation};
+
+    Assimp::Exporter exporter;
+    auto blob = exporter.ExportToBlob(scene.get(), "assbin");
+    if (!blob)
+        return "";
+    return std::string(static_cast<const char *>(blob->data), blob->size);
+}
+
+void make_box_mesh(std::vector<glm::vec3> &positions, std::vector<unsigned> &indices)
+{
+    positions.clear();
+    for (auto i = 0u; i < 8; ++i)
+        positions.emplace_back((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f);
+    // two triangles per face, outward facing
+    indices = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+               2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+}
+
+void make_grid_mesh(unsigned resolution, std::vector<glm::vec3> &positions, std::vector<unsigned> &indices)
+{
+    positions.clear();
+    indices.clear();
+    if (resolution < 2)
+        return;
+    positions.reserve(size_t(resolution) * resolution);
+    auto step = 2.0f / static_cast<float>(resolution - 1);
+    for (auto z = 0u; z < resolution; ++z)
+    {
+        for (auto x = 0u; x < resolution; ++x)
+        {
+            auto px = -1.0f + step * x, pz = -1.0f + step * z;
+            positions.emplace_back(px, 0.1f * std::sin(7.0f * px) * std::cos(5.0f * pz), pz);
+        }
+    }
+    indices.reserve(size_t(resolution - 1) * (resolution - 1) * 6);
+    for (auto z = 0u; z + 1 < resolution; ++z)
+    {
+        for (auto x = 0u; x + 1 < resolution; ++x)
+        {
+            auto v = z * resolution + x;
+            indices.insert(indices.end(), {v, v + resolution, v + 1, v + 1, v + resolution, v + resolution + 1});
+        }
+    }
+}
+
+} // namespace RenderIt
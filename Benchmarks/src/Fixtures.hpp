@@ -0,0 +1,27 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <assimp/anim.h>
+#include <glm/glm.hpp>
+
+/** @file */
+
+namespace RenderIt
+{
+
+/// Animation channel with numKeys position, rotation & scale keys one tick apart
+std::unique_ptr<aiNodeAnim> make_bone_channel(const std::string &name, unsigned numKeys);
+
+/// Skinned model source (assbin) with chain of numBones bones, one quad per bone
+/// Loaded with Model::Load(source, false), so benchmarks need no asset files
+std::string make_skinned_model_source(unsigned numBones, unsigned numKeys);
+
+/// Unit cube centered at origin, 12 triangles
+void make_box_mesh(std::vector<glm::vec3> &positions, std::vector<unsigned> &indices);
+
+/// Wavy height field of resolution x resolution vertices over [-1, 1] in XZ, 2 triangles per cell
+void make_grid_mesh(unsigned resolution, std::vector<glm::vec3> &positions, std::vector<unsigned> &indices);
+
+} // namespace RenderIt
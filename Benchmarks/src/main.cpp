@@ -0,0 +1,476 @@
+#include "RenderIt.hpp"
+
+#include "Benchmark.hpp"
+#include "Fixtures.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace RenderIt;
+
+/// Camera exposing internal update, to time cascade computation
+class BenchCamera : public Camera
+{
+  public:
+    void Update()
+    {
+        update();
+    }
+};
+
+/// Print speedup of ParallelFor against single worker run
+static void print_job_scaling(const std::vector<BenchmarkResult> &results)
+{
+    const std::string prefix = "JobSystem::ParallelFor (";
+    double single = 0.0;
+    for (const auto &r : results)
+        if (r.name == prefix + "1 workers)")
+            single = r.median;
+    if (single <= 0.0)
+        return;
+    std::printf("\n%-40s %12s\n", "job scaling", "speedup");
+    for (const auto &r : results)
+        if (!r.name.compare(0, prefix.size(), prefix) && r.median > 0.0)
+            std::printf("%-40s %11.2fx\n", r.name.c_str(), single / r.median);
+}
+
+/// Rasterize occluders with scalar & SIMD paths, returns false if depth or box visibility differ
+/// Pixels on triangle edges may differ if compiler fuses multiply-adds of scalar path, so few are tolerated
+static bool check_occlusion_paths(OcclusionCuller &culler, const glm::mat4 &projView, const std::vector<Bounds> &boxes)
+{
+    auto useSIMD = culler.useSIMD;
+    culler.useSIMD = false;
+    culler.Rasterize(projView);
+    auto scalarDepth = culler.GetDepthBuffer();
+    std::vector<bool> scalarVisible;
+    for (const auto &b : boxes)
+        scalarVisible.push_back(culler.IsVisible(b));
+
+    culler.useSIMD = true;
+    culler.Rasterize(projView);
+    const auto &depth = culler.GetDepthBuffer();
+    size_t numDepthDiffs = 0, numVisibleDiffs = 0;
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < depth.size(); ++i)
+    {
+        auto diff = std::abs(depth[i] - scalarDepth[i]);
+        maxDiff = (std::max)(maxDiff, diff);
+        numDepthDiffs += diff > 1e-5f ? 1 : 0;
+    }
+    size_t numVisible = 0;
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        auto visible = culler.IsVisible(boxes[i]);
+        numVisible += visible ? 1 : 0;
+        numVisibleDiffs += visible != scalarVisible[i] ? 1 : 0;
+    }
+    culler.useSIMD = useSIMD;
+
+    bool passed = numDepthDiffs * 1000 <= depth.size() && !numVisibleDiffs;
+    std::printf("occlusion check: %zu / %zu pixels differ (max %g), %zu / %zu boxes differ, %zu visible: %s\n",
+                numDepthDiffs, depth.size(), maxDiff, numVisibleDiffs, boxes.size(), numVisible,
+                passed ? "ok" : "FAILED");
+    return passed;
+}
+
+static void print_usage()
+{
+    std::printf("RenderItBenchmarks [--filter name] [--samples N] [--out results.json] [--baseline baseline.json] "
+                "[--threshold percent]\n");
+}
+
+int main(int argc, char **argv)
+{
+    std::string filter, outPath, baselinePath;
+    double threshold = 10.0;
+    BenchmarkRunner runner;
+    for (int i = 1; i < argc; ++i)
+    {
+        auto hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--filter") && hasValue)
+            filter = argv[++i];
+        else if (!std::strcmp(argv[i], "--samples") && hasValue)
+            runner.numSamples = static_cast<unsigned>((std::max)(1, std::atoi(argv[++i])));
+        else if (!std::strcmp(argv[i], "--out") && hasValue)
+            outPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--baseline") && hasValue)
+            baselinePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--threshold") && hasValue)
+            threshold = std::atof(argv[++i]);
+        else
+        {
+            print_usage();
+            return -1;
+        }
+    }
+
+    // no GL context, buffer uploads go to memory
+    GraphicsDevice::Set(std::make_shared<NullDevice>());
+    // consistency checks of SIMD paths, failure makes exit code 1
+    bool checksPassed = true;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+
+#pragma region bone
+    constexpr unsigned numKeys = 64;
+    auto channel = make_bone_channel("Bone", numKeys);
+    auto bone = std::make_shared<Bone>("Bone", 0, channel.get());
+    // times spread over whole key range, key search dominates
+    std::vector<float> boneTimes(256);
+    for (auto &t : boneTimes)
+        t = (dist(rng) + 10.0f) / 20.0f * (numKeys - 1);
+    runner.Add(
+        "Bone::Update",
+        [&, i = size_t(0)]() mutable {
+            bone->Update(boneTimes[i++ % boneTimes.size()]);
+            DoNotOptimize(bone->matrix);
+        });
+    runner.Add(
+        "Bone::InterpolatePosition",
+        [&, i = size_t(0)]() mutable { DoNotOptimize(bone->InterpolatePosition(boneTimes[i++ % boneTimes.size()])); });
+    runner.Add(
+        "Bone::InterpolateRotation",
+        [&, i = size_t(0)]() mutable { DoNotOptimize(bone->InterpolateRotation(boneTimes[i++ % boneTimes.size()])); });
+#pragma endregion bone
+
+#pragma region animator
+    constexpr unsigned numBones = 64;
+    auto skinnedSource = make_skinned_model_source(numBones, numKeys);
+    auto skinned = std::make_shared<Model>();
+    if (skinnedSource.empty() || !skinned->Load(skinnedSource, false) || !skinned->HasAnimation())
+        Tools::display_message("Benchmark", "Failed to create skinned model", Tools::MessageType::WARN);
+    auto animator = Animator::Instance();
+    animator->Update(1.0f / 60.0f);
+    runner.Add("Animator::UpdateAnimation (64 bones)", [&]() {
+        animator->UpdateAnimation(skinned.get());
+        DoNotOptimize(animator->AccessBoneMatrices());
+    });
+    // bone upload is a memcpy into persistently mapped null device buffer
+    runner.Add("Animator::BindBones (64 bones)", [&]() {
+        animator->BindBones(0);
+        StreamBuffer::EndFrameAll();
+    });
+#pragma endregion animator
+
+#pragma region transform
+    std::vector<Transform> transforms(1024);
+    for (size_t i = 0; i < transforms.size(); ++i)
+    {
+        auto &t = transforms[i];
+        t.type = i % 2 ? Transform::Type::SRT : Transform::Type::TRS;
+        t.position = glm::vec3(dist(rng), dist(rng), dist(rng));
+        t.rotation = glm::vec3(dist(rng), dist(rng), dist(rng)) * 18.0f;
+        t.scale = glm::vec3(1.0f + 0.05f * dist(rng));
+    }
+    runner.Add(
+        "Transform::UpdateMatrix",
+        [&]() {
+            for (auto &t : transforms)
+                t.UpdateMatrix();
+            DoNotOptimize(transforms.back().matrix);
+        },
+        transforms.size());
+
+    // trees of fanout 4 under 16 roots, a rotating 1/16 of entries is edited per frame
+    // edits of inner entries also update their subtrees
+    constexpr size_t numHierarchy = 4096, numRoots = 16, numEdited = numHierarchy / 16;
+    std::vector<std::shared_ptr<Model>> hierarchy(numHierarchy);
+    std::unordered_set<std::shared_ptr<Model>> hierarchyRoots;
+    for (size_t i = 0; i < numHierarchy; ++i)
+    {
+        auto &m = hierarchy[i] = std::make_shared<Model>();
+        m->transform.position = glm::vec3(dist(rng), dist(rng), dist(rng)) * 0.1f;
+        m->transform.rotation = glm::vec3(dist(rng), dist(rng), dist(rng)) * 18.0f;
+        if (i < numRoots)
+            hierarchyRoots.insert(m);
+        else
+            hierarchy[(i - numRoots) / 4]->AddChild(m);
+    }
+    TransformSystem transformSystem;
+    transformSystem.Build(hierarchyRoots);
+    transformSystem.Update();
+    for (auto simd : {true, false})
+    {
+        runner.Add(
+            std::string("TransformSystem::Update (4096 entries, 1/16 edited, ") + (simd ? "SIMD" : "scalar") + ")",
+            [&, simd, frame = size_t(0)]() mutable {
+                transformSystem.useSIMD = simd;
+                auto angle = glm::angleAxis(0.01f * static_cast<float>(frame), glm::vec3(0.0f, 1.0f, 0.0f));
+                for (size_t i = frame++ % 16; i < numHierarchy; i += 16)
+                    transformSystem.SetLocal(static_cast<int>(i), glm::vec3(0.1f), angle, glm::vec3(1.0f));
+                DoNotOptimize(transformSystem.Update());
+            },
+            numEdited);
+    }
+#pragma endregion transform
+
+#pragma region bounds
+    std::vector<glm::vec3> points(1024);
+    std::vector<Vertex> vertices(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+        vertices[i].position = points[i] = glm::vec3(dist(rng), dist(rng), dist(rng));
+    runner.Add(
+        "Bounds::Update (packed)",
+        [&]() {
+            Bounds b;
+            b.Update(points.data(), points.size());
+            DoNotOptimize(b);
+        },
+        points.size());
+    runner.Add(
+        "Bounds::Update (Vertex stride)",
+        [&]() {
+            Bounds b;
+            b.Update(&vertices[0].position, vertices.size(), sizeof(Vertex));
+            DoNotOptimize(b);
+        },
+        vertices.size());
+    // large batch, memory bound, compared against per-point scalar update
+    // large fixtures are generated on first call, so filtered runs skip them (first call is warmup)
+    constexpr size_t numManyPoints = 10000000;
+    std::vector<glm::vec3> manyPoints;
+    auto makeManyPoints = [&]() {
+        if (!manyPoints.empty())
+            return;
+        manyPoints.resize(numManyPoints);
+        for (auto &p : manyPoints)
+            p = glm::vec3(dist(rng), dist(rng), dist(rng));
+    };
+    runner.Add(
+        "Bounds::Update (10M packed)",
+        [&]() {
+            makeManyPoints();
+            Bounds b;
+            b.Update(manyPoints.data(), manyPoints.size());
+            DoNotOptimize(b);
+        },
+        numManyPoints);
+    runner.Add(
+        "Bounds::Update (10M scalar loop)",
+        [&]() {
+            makeManyPoints();
+            Bounds b;
+            for (const auto &p : manyPoints)
+                b.Update(p);
+            DoNotOptimize(b);
+        },
+        numManyPoints);
+#pragma endregion bounds
+
+#pragma region bvh
+    // ~1M triangles, build is scalar binned SAH, SIMD toggles 4-wide ray-box tests of queries
+    constexpr unsigned gridResolution = 708;
+    constexpr size_t gridTriangles = 2 * size_t(gridResolution - 1) * (gridResolution - 1);
+    std::vector<glm::vec3> gridPositions;
+    std::vector<unsigned> gridIndices;
+    auto makeGrid = [&]() {
+        if (gridIndices.empty())
+            make_grid_mesh(gridResolution, gridPositions, gridIndices);
+    };
+    runner.Add("MeshBVH::Build (" + std::to_string(gridTriangles) + " triangles)", [&]() {
+        makeGrid();
+        MeshBVH bvh;
+        bvh.Build(gridPositions, gridIndices);
+        DoNotOptimize(bvh.GetNumNodes());
+    });
+    auto gridBVH = std::make_shared<MeshBVH>();
+    // slanted rays from above, all hitting height field
+    std::vector<Ray> rays(4096);
+    for (auto &ray : rays)
+    {
+        ray.origin = glm::vec3(0.05f * dist(rng), 2.0f, 0.05f * dist(rng));
+        ray.direction = glm::vec3(0.02f * dist(rng), -1.0f, 0.02f * dist(rng));
+    }
+    for (auto simd : {true, false})
+    {
+        runner.Add(
+            std::string("MeshBVH::Intersect (") + std::to_string(gridTriangles) + " triangles, " +
+                (simd ? "SIMD" : "scalar") + ")",
+            [&, simd]() {
+                if (!gridBVH->IsReady())
+                {
+                    makeGrid();
+                    gridBVH->Build(gridPositions, gridIndices);
+                }
+                gridBVH->useSIMD = simd;
+                for (const auto &ray : rays)
+                {
+                    RayHit hit;
+                    DoNotOptimize(gridBVH->Intersect(ray, hit));
+                }
+            },
+            rays.size());
+    }
+#pragma endregion bvh
+
+#pragma region occlusion
+    // boxes in front of camera as occluders, CPU triangles so no GPU readback is needed
+    OcclusionCuller occlusion;
+    std::vector<glm::vec3> boxPositions;
+    std::vector<unsigned> boxIndices;
+    make_box_mesh(boxPositions, boxIndices);
+    for (int i = 0; i < 64; ++i)
+    {
+        auto matrix = glm::translate(glm::mat4(1.0f), glm::vec3(dist(rng), 0.1f * dist(rng), 0.5f * dist(rng)));
+        matrix = glm::scale(matrix, glm::vec3(1.0f + 0.2f * (dist(rng) + 10.0f)));
+        occlusion.AddOccluder(boxPositions, boxIndices, matrix);
+    }
+    auto occlusionProjView = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f) *
+                             glm::lookAt(glm::vec3(0.0f, 4.0f, 25.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    // small boxes behind & between occluders
+    std::vector<Bounds> occludees(1024);
+    for (auto &b : occludees)
+    {
+        glm::vec3 p(1.5f * dist(rng), 0.2f * dist(rng), 1.5f * dist(rng) - 10.0f);
+        b.Update(p - glm::vec3(0.5f));
+        b.Update(p + glm::vec3(0.5f));
+    }
+    checksPassed = check_occlusion_paths(occlusion, occlusionProjView, occludees) && checksPassed;
+    for (auto simd : {true, false})
+    {
+        runner.Add(std::string("OcclusionCuller::Rasterize (") + (simd ? "SIMD" : "scalar") + ")", [&, simd]() {
+            occlusion.useSIMD = simd;
+            occlusion.Rasterize(occlusionProjView);
+            DoNotOptimize(occlusion.GetTileDepth());
+        });
+    }
+    runner.Add(
+        "OcclusionCuller::IsVisible",
+        [&]() {
+            for (const auto &b : occludees)
+                DoNotOptimize(occlusion.IsVisible(b));
+        },
+        occludees.size());
+#pragma endregion occlusion
+
+#pragma region camera
+    auto camera = std::make_shared<BenchCamera>();
+    camera->SetPosition(glm::vec3(5.0f, 3.0f, 5.0f));
+    camera->SetCenter(glm::vec3(0.0f));
+    camera->SetViewNearFar(0.1f, 100.0f);
+    camera->computeShadowData = true;
+    runner.Add("Camera::SetShadowNearFar (CSM splits)", [&, i = 0u]() mutable {
+        camera->SetShadowNearFar(0.01f, 2.0f + 0.001f * static_cast<float>(i++ % 1000));
+    });
+    // view, projection & cascade bounding spheres
+    runner.Add("Camera::update (CSM data)", [&]() {
+        camera->Update();
+        DoNotOptimize(camera->GetView());
+    });
+#pragma endregion camera
+
+#pragma region tools
+    std::vector<aiMatrix4x4> aiMatrices(1024);
+    std::vector<aiQuaternion> aiQuaternions(1024);
+    std::vector<aiVector3D> aiVectors(1024);
+    for (size_t i = 0; i < aiMatrices.size(); ++i)
+    {
+        aiMatrix4x4::Translation(aiVector3D(dist(rng), dist(rng), dist(rng)), aiMatrices[i]);
+        aiQuaternions[i] = aiQuaternion(aiVector3D(0.0f, 1.0f, 0.0f), dist(rng));
+        aiVectors[i] = aiVector3D(dist(rng), dist(rng), dist(rng));
+    }
+    runner.Add(
+        "Tools::convertAssimpMatrix",
+        [&]() {
+            for (const auto &m : aiMatrices)
+                DoNotOptimize(Tools::convertAssimpMatrix(m));
+        },
+        aiMatrices.size());
+    runner.Add(
+        "Tools::convertAssimpQuaternion",
+        [&]() {
+            for (const auto &q : aiQuaternions)
+                DoNotOptimize(Tools::convertAssimpQuaternion(q));
+        },
+        aiQuaternions.size());
+    runner.Add(
+        "Tools::convertAssimpVector",
+        [&]() {
+            for (const auto &v : aiVectors)
+                DoNotOptimize(Tools::convertAssimpVector(v));
+        },
+        aiVectors.size());
+#pragma endregion tools
+
+#pragma region jobs
+    // worker counts 1, 2, 4... up to default pool size, calling thread also runs jobs while waiting
+    auto maxWorkers = (std::max)(std::thread::hardware_concurrency(), 2u) - 1u;
+    std::vector<unsigned> workerCounts;
+    for (auto n = 1u; n < maxWorkers; n *= 2)
+        workerCounts.push_back(n);
+    workerCounts.push_back(maxWorkers);
+    std::vector<float> jobInput(1 << 20), jobOutput(jobInput.size());
+    for (auto &v : jobInput)
+        v = dist(rng);
+    // pool of running case only, created on first call (warmup) & destroyed after measuring
+    // so idle workers of other cases do not compete for cores
+    std::shared_ptr<JobSystem> jobs;
+    auto releaseJobs = [&]() { jobs.reset(); };
+    for (auto n : workerCounts)
+    {
+        runner.Add(
+            "JobSystem::ParallelFor (" + std::to_string(n) + " workers)",
+            [&, n]() {
+                if (!jobs)
+                    jobs = std::make_shared<JobSystem>(n);
+                jobs->Wait(jobs->ParallelFor(0, jobInput.size(), 4096, [&](size_t begin, size_t end) {
+                    for (auto i = begin; i < end; ++i)
+                        jobOutput[i] = std::sin(jobInput[i]) * std::cos(0.5f * jobInput[i]);
+                }));
+                DoNotOptimize(jobOutput.back());
+            },
+            jobInput.size(), releaseJobs);
+    }
+    // scheduling latency, each job waits for previous one
+    constexpr unsigned chainLength = 64;
+    runner.Add(
+        "JobSystem::Run (dependency chain)",
+        [&]() {
+            if (!jobs)
+                jobs = std::make_shared<JobSystem>(maxWorkers);
+            unsigned steps = 0;
+            std::shared_ptr<JobCounter> counter;
+            for (auto i = 0u; i < chainLength; ++i)
+                counter = jobs->Run([&steps]() { ++steps; }, counter);
+            jobs->Wait(counter);
+            DoNotOptimize(steps);
+        },
+        chainLength, releaseJobs);
+#pragma endregion jobs
+
+#pragma region model
+    // assimp import & conversion to meshes, GPU uploads go to null device
+    for (auto shape : {MeshShape::Plane, MeshShape::Cube, MeshShape::Sphere, MeshShape::Cylinder, MeshShape::Cone,
+                       MeshShape::Torus})
+    {
+        runner.Add("Model::Load (" + std::to_string(shape) + ")", [shape]() {
+            Model model;
+            DoNotOptimize(model.Load(shape));
+        });
+    }
+    runner.Add("Model::Load (skinned, 64 bones)", [&]() {
+        Model model;
+        DoNotOptimize(model.Load(skinnedSource, false));
+    });
+#pragma endregion model
+
+    print_job_scaling(runner.Run(filter));
+
+    if (!outPath.empty() && runner.WriteJSON(outPath))
+        Tools::display_message("Benchmark", "Results written to " + outPath, Tools::MessageType::INFO);
+    if (!baselinePath.empty() && runner.CompareBaseline(baselinePath, threshold))
+        return 1;
+    return checksPassed ? 0 : 1;
+}
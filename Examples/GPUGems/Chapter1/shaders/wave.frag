@@ -10,14 +10,13 @@ layout(location = 0) in VERTOUT
 vertOut;
 
 uniform vec3 surfColor;
-uniform vec3 cameraPosWS;
 uniform bool displayNormal;
 
 // stage 5
 void main()
 {
     vec3 normDir = normalize(vertOut.normWS);
-    vec3 viewDir = normalize(cameraPosWS - vertOut.posWS.xyz);
+    vec3 viewDir = normalize(vec_CameraPos.xyz - vertOut.posWS.xyz);
     const vec3 lightDir = normalize(vec3(1.0));
     if (displayNormal)
     {
@@ -41,15 +41,13 @@ int main()
     cam->SetViewType(CameraViewType::Persp);
     cam->clearColor = glm::vec4(0.2f, 0.2f, 0.2f, 1.0f);
 
-    auto mView = cam->GetView();
-    auto mProj = cam->GetProj();
-
     // setup shader
     std::unique_ptr<Shader> shader = std::make_unique<Shader>();
     shader->AddSource(Tools::read_file_content("./shaders/wave.vert"), GL_VERTEX_SHADER);
     shader->AddSource(Tools::read_file_content("./shaders/wave.tesc"), GL_TESS_CONTROL_SHADER);
-    shader->AddSource(Tools::read_file_content("./shaders/wave.tese"), GL_TESS_EVALUATION_SHADER);
-    shader->AddSource(Tools::read_file_content("./shaders/wave.frag"), GL_FRAGMENT_SHADER);
+    shader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/wave.tese")),
+                      GL_TESS_EVALUATION_SHADER);
+    shader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/wave.frag")), GL_FRAGMENT_SHADER);
     if (!shader->Compile())
         return -1;
 
@@ -122,9 +120,6 @@ int main()
         shader->Bind();
         shader->UniformFloat("tessLevel", configs->tessLevel);
 
-        mView = cam->GetView();
-        mProj = cam->GetProj();
-        shader->UniformMat4("mat_VP", mProj * mView);
         shader->UniformMat4("mat_Model", configs->transform.matrix);
         shader->UniformMat3("mat_ModelInv", glm::mat3(configs->transform.matrixInv));
         shader->UniformBool("enableGerstnerWave", configs->enableGerstnerWave);
@@ -132,10 +127,8 @@ int main()
 
         shader->UniformBool("displayNormal", displayNormal || doWireframe);
         shader->UniformVec3("surfColor", configs->color);
-        shader->UniformVec3("cameraPosWS", cam->GetPosition());
 
         shader->SsboBinding("SineWaves", 0);
-        shader->UniformFloat("val_Time", app->GetFrameEndTime());
         configs->wavesBuffer->BindBase(0);
 
         VAO.Bind();
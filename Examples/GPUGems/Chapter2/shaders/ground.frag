@@ -32,7 +32,6 @@ layout(std430, binding = 0) readonly buffer SineWaves
     SineWave waves[];
 };
 
-uniform float val_Time;
 uniform float val_K;
 
 vec2 SafeNormalize(vec2 v)
@@ -70,7 +69,7 @@ vec2 ComputeNormalVariant(SineWave wave, vec2 pos)
     float phi = wave.speed * w;
     vec2 D = GetDirection(wave, pos);
     // compute angle
-    float angle = dot(D, pos) * w + val_Time * phi;
+    float angle = dot(D, pos) * w + vec_Time.x * phi;
     // prepare power
     float toPower = (sin(angle) + 1.0) * 0.5;
     float power = val_K <= 1.0 ? 1.0 : pow(toPower, val_K - 1.0);
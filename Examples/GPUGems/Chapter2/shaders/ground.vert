@@ -11,7 +11,6 @@ layout(location = 0) out VERTOUT
 }
 vertOut;
 
-uniform mat4 mat_ProjView;
 uniform mat4 mat_Model;
 
 void main()
@@ -11,13 +11,12 @@ vertOut;
 
 uniform vec3 surfColor;
 uniform float surfAlpha;
-uniform vec3 cameraPosWS;
 
 // stage 5
 void main()
 {
     vec3 normDir = normalize(vertOut.normWS);
-    vec3 viewDir = normalize(cameraPosWS - vertOut.posWS.xyz);
+    vec3 viewDir = normalize(vec_CameraPos.xyz - vertOut.posWS.xyz);
     const vec3 lightDir = vec3(0.0, 1.0, 0.0);
 
     float intensity = dot(normDir, lightDir);
@@ -42,9 +42,6 @@ int main()
     cam->SetViewType(CameraViewType::Persp);
     cam->clearColor = glm::vec4(0.2f, 0.2f, 0.2f, 1.0f);
 
-    auto mView = cam->GetView();
-    auto mProj = cam->GetProj();
-
     // setup waves
     auto waveRenderer = std::make_unique<WaveRenderer>();
     auto waveConfigs = std::make_unique<WaveConfigs>();
@@ -60,8 +57,10 @@ int main()
         mat->colorDiffuse = glm::vec3(0.6f, 0.5f, 0.3f);
     }
     auto waveGroundShader = std::make_shared<Shader>();
-    waveGroundShader->AddSource(Tools::read_file_content("./shaders/ground.vert"), GL_VERTEX_SHADER);
-    waveGroundShader->AddSource(Tools::read_file_content("./shaders/ground.frag"), GL_FRAGMENT_SHADER);
+    waveGroundShader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/ground.vert")),
+                                GL_VERTEX_SHADER);
+    waveGroundShader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/ground.frag")),
+                                GL_FRAGMENT_SHADER);
     waveGroundShader->Compile();
 
     // load lightmap
@@ -131,21 +130,14 @@ int main()
         glViewport(0, 0, w, h);
         cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        mView = cam->GetView();
-        mProj = cam->GetProj();
-
-        auto mProjView = mProj * mView;
-
         // render ground
         {
             waveGroundShader->Bind();
             waveGroundShader->TextureBinding(lightMap->Get(), 0u);
             waveGroundShader->UniformInt("lightMap", 0);
-            waveGroundShader->UniformMat4("mat_ProjView", mProjView);
             waveGroundShader->UniformMat4("mat_Model", waveGround->transform.matrix);
 
             waveGroundShader->UniformFloat("val_K", waveConfigs->powerConstant);
-            waveGroundShader->UniformFloat("val_Time", app->GetFrameEndTime());
             waveGroundShader->UniformVec3("surfColor", waveConfigs->color);
 
             waveGroundShader->SsboBinding("SineWaves", 0);
@@ -163,15 +155,12 @@ int main()
             auto waveShader = waveRenderer->shader;
             waveShader->Bind();
             waveShader->UniformFloat("tessLevel", waveConfigs->tessLevel);
-            waveShader->UniformMat4("mat_ProjView", mProjView);
             waveShader->UniformMat4("mat_Model", waveConfigs->transform.matrix);
             waveShader->UniformMat3("mat_ModelInv", glm::mat3(waveConfigs->transform.matrixInv));
             waveShader->UniformFloat("val_K", waveConfigs->powerConstant);
-            waveShader->UniformFloat("val_Time", app->GetFrameEndTime());
 
             waveShader->UniformVec3("surfColor", waveConfigs->color);
             waveShader->UniformFloat("surfAlpha", waveConfigs->surfaceAlpha);
-            waveShader->UniformVec3("cameraPosWS", cam->GetPosition());
 
             waveShader->SsboBinding("SineWaves", 0);
             waveConfigs->wavesBuffer->BindBase(0);
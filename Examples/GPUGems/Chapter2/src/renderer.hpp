@@ -13,8 +13,10 @@ struct WaveRenderer
         shader = std::make_shared<Shader>();
         shader->AddSource(Tools::read_file_content("./shaders/waves/wave.vert"), GL_VERTEX_SHADER);
         shader->AddSource(Tools::read_file_content("./shaders/waves/wave.tesc"), GL_TESS_CONTROL_SHADER);
-        shader->AddSource(Tools::read_file_content("./shaders/waves/wave.tese"), GL_TESS_EVALUATION_SHADER);
-        shader->AddSource(Tools::read_file_content("./shaders/waves/wave.frag"), GL_FRAGMENT_SHADER);
+        shader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/waves/wave.tese")),
+                          GL_TESS_EVALUATION_SHADER);
+        shader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/waves/wave.frag")),
+                          GL_FRAGMENT_SHADER);
         shader->Compile();
 
         // clang-format off
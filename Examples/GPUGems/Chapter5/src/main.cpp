@@ -27,8 +27,9 @@ int main()
     // prepare shaders
     auto shader = std::make_shared<Shader>();
     shader->AddSource(Tools::read_file_content("./shaders/noise.vert"), GL_VERTEX_SHADER);
-    shader->AddSource(Tools::read_file_content("./shaders/noise.frag"), GL_FRAGMENT_SHADER);
-    shader->AddSource(Tools::read_file_content("./shaders/noise.tese"), GL_TESS_EVALUATION_SHADER);
+    shader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/noise.frag")), GL_FRAGMENT_SHADER);
+    shader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/noise.tese")),
+                      GL_TESS_EVALUATION_SHADER);
     shader->AddSource(Tools::read_file_content("./shaders/noise.tesc"), GL_TESS_CONTROL_SHADER);
     if (!shader->Compile())
         return -1;
@@ -88,8 +89,6 @@ int main()
 
     bool doWireframe = false;
 
-    auto mProj = cam->GetProj();
-    auto mView = cam->GetView();
     auto mModel = model->transform.matrix;
     auto mModelInv = glm::mat3(model->transform.matrixInv);
 
@@ -102,11 +101,8 @@ int main()
         glViewport(0, 0, w, h);
         cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        mProj = cam->GetProj();
-        mView = cam->GetView();
         mModel = model->transform.matrix;
         mModelInv = glm::mat3(model->transform.matrixInv);
-        auto mProjView = mProj * mView;
 
         shader->Bind();
         shader->UniformFloat("tessLevel", configs->tessLevel);
@@ -114,8 +110,6 @@ int main()
         shader->UniformFloat("controlTime", configs->controlTime);
         shader->UniformFloat("controlRes", configs->controlRes);
         shader->UniformVec3("baseColor", configs->baseColor);
-        shader->UniformVec3("cameraPos", cam->GetPosition());
-        shader->UniformMat4("mat_ProjView", mProjView);
         shader->UniformMat4("mat_Model", mModel);
         shader->UniformMat3("mat_ModelInv", mModelInv);
         model->Draw(shader.get());
@@ -79,7 +79,8 @@ int main()
     // grass shader
     auto grassShader = std::make_shared<Shader>();
     grassShader->AddSource(Tools::read_file_content("./shaders/grass.vert"), GL_VERTEX_SHADER);
-    grassShader->AddSource(Tools::read_file_content("./shaders/grass.geom"), GL_GEOMETRY_SHADER);
+    grassShader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/grass.geom")),
+                           GL_GEOMETRY_SHADER);
     grassShader->AddSource(Tools::read_file_content("./shaders/grass.frag"), GL_FRAGMENT_SHADER);
     grassShader->Compile();
 
@@ -189,10 +190,8 @@ int main()
 
         // render grass
         grassShader->Bind();
-        grassShader->UniformMat4("matProjView", mProjView);
         grassShader->TextureBinding(grassTexture->Get(), 0u);
         grassShader->UniformInt("grassTexture", 0);
-        grassShader->UniformFloat("valTime", app->GetFrameEndTime());
         grassShader->UniformVec3("vecWind", windDir);
         grassShader->UniformFloat("valWind", windStrength);
         grassSSBO->BindBase(1u);
@@ -10,7 +10,6 @@ layout(location = 0) in GEOMOUT
 geomOut;
 
 // other uniforms
-uniform vec3 camPosWS;
 uniform samplerCube skybox;
 
 uniform float r;
@@ -40,7 +39,7 @@ void main()
 
     const vec3 L = normalize(vec3(1.0, 1.0, 1.0));
     vec3 P = geomOut.fragPosWS.xyz;
-    vec3 V = normalize(camPosWS - P);
+    vec3 V = normalize(vec_CameraPos.xyz - P);
     vec3 H = L + V;
     vec3 N = normalize(geomOut.normalWS);
     vec3 T = normalize(geomOut.tangentWS);
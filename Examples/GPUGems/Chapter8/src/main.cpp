@@ -35,8 +35,10 @@ int main()
     // prepare shaders
     auto shader = std::make_shared<Shader>();
     shader->AddSource(Tools::read_file_content("./shaders/Diffraction.vert"), GL_VERTEX_SHADER);
-    shader->AddSource(Tools::read_file_content("./shaders/Diffraction.geom"), GL_GEOMETRY_SHADER);
-    shader->AddSource(Tools::read_file_content("./shaders/Diffraction.frag"), GL_FRAGMENT_SHADER);
+    shader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/Diffraction.geom")),
+                      GL_GEOMETRY_SHADER);
+    shader->AddSource(Shader::WithFrameConstants(Tools::read_file_content("./shaders/Diffraction.frag")),
+                      GL_FRAGMENT_SHADER);
     if (!shader->Compile())
         return -1;
 
@@ -48,9 +50,6 @@ int main()
     cam->SetViewType(CameraViewType::Persp);
     cam->clearColor = glm::vec4(0.2f, 0.2f, 0.2f, 1.0f);
 
-    auto mView = cam->GetView();
-    auto mProj = cam->GetProj();
-
     // filters
     auto filterTone = std::make_unique<PostProcessTone>();
     auto filterLum = std::make_unique<PostProcessLuminance>();
@@ -127,23 +126,19 @@ int main()
         filterLum->Update(w, h);
         glViewport(0, 0, w, h);
         cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        mView = cam->GetView();
-        mProj = cam->GetProj();
 
         filterTone->StartRecord();
         // clear depth & render sky as background
         cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        skybox->ClearBackground(mProj, mView);
+        skybox->ClearBackground();
 
         shader->Bind();
 
-        shader->UniformMat4("matProjView", mProj * mView);
         shader->UniformMat4("matModel", modelTransform.matrix);
         shader->UniformMat3("matModelInv", glm::mat3(modelTransform.matrixInv));
         shader->UniformFloat("count", configs.w);
         shader->UniformFloat("countInv", 1.0f / configs.w);
         shader->UniformFloat("radius", configs.z);
-        shader->UniformVec3("camPosWS", cam->GetPosition());
         shader->UniformFloat("r", configs.x);
         shader->UniformFloat("d", configs.y);
         // skybox
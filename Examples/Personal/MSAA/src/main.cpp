@@ -135,7 +135,7 @@ int main()
         // this prepares MSAA framebuffer
         cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        lights->DrawLights(mProjView, cam->GetPosition());
+        lights->DrawLights();
 
         shader->Bind();
 
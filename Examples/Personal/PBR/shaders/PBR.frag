@@ -14,21 +14,16 @@ layout(location = 0) in VERTOUT
 }
 vertOut;
 
+// maps exist if HAS_<map name> is defined (see Shader::AddMaterialFeatures)
 // color maps
 uniform sampler2D map_AMBIENT;
-uniform bool map_AMBIENT_exists;
 uniform sampler2D map_DIFFUSE;
-uniform bool map_DIFFUSE_exists;
 uniform sampler2D map_SPECULAR;
-uniform bool map_SPECULAR_exists;
 uniform sampler2D map_EMISSIVE;
-uniform bool map_EMISSIVE_exists;
 // normal maps
 uniform sampler2D map_NORMALS;
-uniform bool map_NORMALS_exists;
 // opacity maps
 uniform sampler2D map_OPACITY;
-uniform bool map_OPACITY_exists;
 // color values
 uniform vec3 val_AMBIENT;
 uniform vec3 val_DIFFUSE;
@@ -41,13 +36,9 @@ uniform bool val_HASPBR;
 
 // pbr maps
 uniform sampler2D mapPBR_COLOR;
-uniform bool mapPBR_COLOR_exists;
 uniform sampler2D mapPBR_METALNESS;
-uniform bool mapPBR_METALNESS_exists;
 uniform sampler2D mapPBR_ROUGHNESS;
-uniform bool mapPBR_ROUGHNESS_exists;
 uniform sampler2D mapPBR_OCCLUSION;
-uniform bool mapPBR_OCCLUSION_exists;
 uniform float valPBR_METALLIC;
 uniform float valPBR_ROUGHNESS;
 uniform float val_ALPHACUTOFF;
@@ -106,17 +97,14 @@ uniform vec3 vec_CameraPosWS;
 
 vec3 ComputeNormal()
 {
-    if (map_NORMALS_exists)
-    {
-        mat3 TBN = mat3(vertOut.tangentWS, vertOut.bitangentWS, vertOut.normalWS);
-        // prepare normal tangent space
-        vec3 normalTS = texture(map_NORMALS, vertOut.texCoords).xyz * 2.0 - 1.0;
-        return normalize(TBN * normalTS);
-    }
-    else
-    {
-        return normalize(vertOut.normalWS);
-    }
+#ifdef HAS_map_NORMALS
+    mat3 TBN = mat3(vertOut.tangentWS, vertOut.bitangentWS, vertOut.normalWS);
+    // prepare normal tangent space
+    vec3 normalTS = texture(map_NORMALS, vertOut.texCoords).xyz * 2.0 - 1.0;
+    return normalize(TBN * normalTS);
+#else
+    return normalize(vertOut.normalWS);
+#endif
 }
 
 struct Surface
@@ -137,52 +125,80 @@ struct Surface
 
 vec3 GetAmbientColor()
 {
-    return val_AMBIENT *
-           (map_AMBIENT_exists ? texture(map_AMBIENT, vertOut.texCoords).rgb : (0.25 * vertOut.color.rgb));
+#ifdef HAS_map_AMBIENT
+    return val_AMBIENT * texture(map_AMBIENT, vertOut.texCoords).rgb;
+#else
+    return val_AMBIENT * 0.25 * vertOut.color.rgb;
+#endif
 }
 
 vec4 GetBaseColor()
 {
-    if (val_HASPBR && mapPBR_COLOR_exists)
+#ifdef HAS_mapPBR_COLOR
+    if (val_HASPBR)
     {
         return vertOut.color * texture(mapPBR_COLOR, vertOut.texCoords);
     }
-    else
-    {
-        return vec4(val_DIFFUSE *
-                        (map_DIFFUSE_exists ? texture(map_DIFFUSE, vertOut.texCoords).rgb : (0.75 * vertOut.color.rgb)),
-                    1.0);
-    }
+#endif
+#ifdef HAS_map_DIFFUSE
+    return vec4(val_DIFFUSE * texture(map_DIFFUSE, vertOut.texCoords).rgb, 1.0);
+#else
+    return vec4(val_DIFFUSE * 0.75 * vertOut.color.rgb, 1.0);
+#endif
 }
 
 vec3 GetSpecularColor()
 {
-    return val_SPECULAR * (map_SPECULAR_exists ? texture(map_SPECULAR, vertOut.texCoords).rgb : vertOut.color.rgb);
+#ifdef HAS_map_SPECULAR
+    return val_SPECULAR * texture(map_SPECULAR, vertOut.texCoords).rgb;
+#else
+    return val_SPECULAR * vertOut.color.rgb;
+#endif
 }
 
 vec3 GetEmissiveColor()
 {
-    return val_EMISSIVE * (map_EMISSIVE_exists ? texture(map_EMISSIVE, vertOut.texCoords).rgb : vec3(1.0));
+#ifdef HAS_map_EMISSIVE
+    return val_EMISSIVE * texture(map_EMISSIVE, vertOut.texCoords).rgb;
+#else
+    return val_EMISSIVE;
+#endif
 }
 
 float GetOcclusion()
 {
-    return mapPBR_OCCLUSION_exists ? texture(mapPBR_OCCLUSION, vertOut.texCoords).r : 1.0;
+#ifdef HAS_mapPBR_OCCLUSION
+    return texture(mapPBR_OCCLUSION, vertOut.texCoords).r;
+#else
+    return 1.0;
+#endif
 }
 
 float GetOpacity()
 {
-    return val_OPACITY * (map_OPACITY_exists ? texture(map_OPACITY, vertOut.texCoords).r : vertOut.color.a);
+#ifdef HAS_map_OPACITY
+    return val_OPACITY * texture(map_OPACITY, vertOut.texCoords).r;
+#else
+    return val_OPACITY * vertOut.color.a;
+#endif
 }
 
 float GetMetallic()
 {
-    return valPBR_METALLIC * (mapPBR_METALNESS_exists ? texture(mapPBR_METALNESS, vertOut.texCoords).b : 1.0);
+#ifdef HAS_mapPBR_METALNESS
+    return valPBR_METALLIC * texture(mapPBR_METALNESS, vertOut.texCoords).b;
+#else
+    return valPBR_METALLIC;
+#endif
 }
 
 float GetRoughness()
 {
-    return valPBR_ROUGHNESS * (mapPBR_ROUGHNESS_exists ? texture(mapPBR_ROUGHNESS, vertOut.texCoords).g : 1.0);
+#ifdef HAS_mapPBR_ROUGHNESS
+    return valPBR_ROUGHNESS * texture(mapPBR_ROUGHNESS, vertOut.texCoords).g;
+#else
+    return valPBR_ROUGHNESS;
+#endif
 }
 
 void ComputeDirLight(DirLight light, Surface surface, out float diff, out float spec)
@@ -334,11 +350,13 @@ void main()
         surface.colorSpecular = GetSpecularColor();
     }
 
+#ifdef ALPHA_MODE_MASK
     // apply alpha mask
-    if (val_ALPHACUTOFF * float(surface.opacity < val_ALPHACUTOFF) != 0.0)
+    if (surface.opacity < val_ALPHACUTOFF)
     {
         discard;
     }
+#endif
 
     if (dirLightsLen + pointLightsLen + spotLightsLen == 0)
     {
@@ -39,6 +39,8 @@ int main()
     auto shader = std::make_shared<Shader>();
     shader->AddSource(Tools::read_file_content("./shaders/PBR.vert"), GL_VERTEX_SHADER);
     shader->AddSource(Tools::read_file_content("./shaders/PBR.frag"), GL_FRAGMENT_SHADER);
+    // variant per combination of material maps & alpha mode, compiled on first draw
+    shader->AddMaterialFeatures();
     if (!shader->Compile())
         return -1;
 
@@ -121,7 +123,7 @@ int main()
         mProj = cam->GetProj();
         auto mProjView = mProj * mView;
 
-        lights->DrawLights(mProjView, cam->GetPosition());
+        lights->DrawLights();
 
         shader->Bind();
 
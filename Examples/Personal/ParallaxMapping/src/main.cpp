@@ -225,7 +225,7 @@ int main()
         mProj = cam->GetProj();
         auto mProjView = mProj * mView;
 
-        lights->DrawLights(mProjView, cam->GetPosition());
+        lights->DrawLights();
 
         shader->Bind();
 
@@ -144,12 +144,12 @@ int main()
         ImGui::End();
     };
 
-    auto recordShadows = [&](const Shader *shader) {
-        anim->BindBones(0u);
-        shader->UniformMat4(shadows->ShaderModelName, model->transform.matrix);
-        model->Draw(shader, RenderPass::Opaque);
-        shader->UniformMat4(shadows->ShaderModelName, modelPlane->transform.matrix);
-        modelPlane->Draw(shader);
+    // recorded on worker threads, bones are bound before replay
+    auto recordShadows = [&](const Shader *shader, CommandList &list) {
+        list.UniformMat4(shadows->ShaderModelName, model->transform.matrix);
+        model->Record(list, shader, RenderPass::Opaque);
+        list.UniformMat4(shadows->ShaderModelName, modelPlane->transform.matrix);
+        modelPlane->Record(list, shader);
     };
 
     app->Start();
@@ -173,6 +173,7 @@ int main()
         lights->Update();
 
         // record shadows
+        anim->BindBones(0u);
         shadows->RecordShadows(recordShadows);
 
         // render
@@ -189,7 +190,7 @@ int main()
         filterTone->StartRecord();
         cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        lights->DrawLights(mProjView, cam->GetPosition());
+        lights->DrawLights();
 
         shader->Bind();
 
@@ -6,25 +6,44 @@ layout(location = 0) in VERTOUT
 {
     vec3 normalWS;
     vec4 fragPosWS;
+    flat uint materialIdx;
 }
 vertOut;
 
-// color values
-uniform vec3 val_AMBIENT;
-uniform vec3 val_DIFFUSE;
-uniform vec3 val_SPECULAR;
-uniform float val_SHININESS;
+// material values
+struct MaterialData
+{
+    vec4 ambientShininess;
+    vec4 diffuseOpacity;
+    vec4 specularRefract;
+    vec4 emissiveMetallic;
+    vec4 transparentRoughness;
+    float alphaCutoff;
+    uint mapsMask;
+    int hasPBR;
+    int alphaMode;
+};
+
+layout(std430, binding = 4) readonly buffer MaterialsData
+{
+    MaterialData materials[];
+};
 
 uniform vec3 vec_CameraPosWS;
 
 void main()
 {
+    MaterialData mat = materials[vertOut.materialIdx];
+    vec3 colorAmbient = mat.ambientShininess.rgb;
+    vec3 colorDiffuse = mat.diffuseOpacity.rgb;
+    vec3 colorSpecular = mat.specularRefract.rgb;
+    float shininess = mat.ambientShininess.a;
     const vec3 lightDir = normalize(vec3(1.0, 1.0, 1.0));
     vec3 normDir = normalize(vertOut.normalWS);
     vec3 viewDir = normalize(vec_CameraPosWS - vertOut.fragPosWS.xyz);
     // diffuse
     float diff = max(dot(normDir, lightDir), 0.0);
     // specular
-    float spec = val_SHININESS > 0.0 ? pow(max(dot(reflect(-lightDir, normDir), viewDir), 0.0), val_SHININESS) : 0.0;
-    outColor = vec4(val_AMBIENT * val_DIFFUSE + val_DIFFUSE * diff + val_SPECULAR * spec, 1.0);
+    float spec = shininess > 0.0 ? pow(max(dot(reflect(-lightDir, normDir), viewDir), 0.0), shininess) : 0.0;
+    outColor = vec4(colorAmbient * colorDiffuse + colorDiffuse * diff + colorSpecular * spec, 1.0);
 }
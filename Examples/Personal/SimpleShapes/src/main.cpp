@@ -1,5 +1,6 @@
 #include "RenderIt.hpp"
 
+#include <array>
 #include <memory>
 #include <string>
 
@@ -41,6 +42,23 @@ int main()
     if (!shader->Compile())
         return -1;
 
+    // shader for batched static meshes (multi-draw indirect), needs ARB_shader_draw_parameters
+    auto &device = GraphicsDevice::Get();
+    auto batchVertShader = Tools::read_file_content("./shaders/SimpleShapesBatch.vert");
+    auto batchShader = std::make_shared<Shader>();
+    batchShader->AddSource(batchVertShader, GL_VERTEX_SHADER);
+    batchShader->AddSource(fragShader, GL_FRAGMENT_SHADER);
+    bool canBatch = device.HasShaderDrawParameters() && batchShader->Compile();
+    bool useStaticBatch = false;
+    // culled draw counts need GL 4.6 or ARB_indirect_parameters
+    bool canGPUCull = device.HasIndirectCount();
+    bool useGPUCulling = false;
+    auto gpuCuller = std::make_unique<GPUCuller>();
+    // opaque & transparent passes recorded on worker threads
+    bool useCommandLists = false;
+    auto jobs = JobSystem::Instance();
+    std::array<CommandList, 2> passLists;
+
     // setup scene
     auto scene = std::make_unique<Scene>();
 
@@ -133,6 +151,10 @@ int main()
         scene->AttachObject(shapeTorus);
     }
 
+    // triangle BVHs for picking
+    scene->BuildBVHs();
+    RayHit pickHit;
+
     // setup camera
     cam->SetPosition(glm::vec3(1.0f, 1.0f, 1.0f));
     cam->SetCenter(glm::vec3(0.0f));
@@ -161,6 +183,27 @@ int main()
             }
             if (scene && ImGui::BeginTabItem("Scene"))
             {
+                if (canBatch && ImGui::Checkbox("Static Batch (MDI)", &useStaticBatch))
+                {
+                    if (useStaticBatch)
+                        useStaticBatch = scene->BuildStaticBatch();
+                    else
+                        scene->ResetStaticBatch();
+                }
+                if (canGPUCull)
+                    ImGui::Checkbox("GPU Culling", &useGPUCulling);
+                if (useGPUCulling && ImGui::TreeNode("GPU Culler"))
+                {
+                    gpuCuller->UI();
+                    ImGui::TreePop();
+                }
+                ImGui::Checkbox("Auto Instancing", &scene->autoInstancing);
+                ImGui::Checkbox("Command Lists", &useCommandLists);
+                if (pickHit.model)
+                    ImGui::Text("Picked: %s (triangle %u, distance %.3f)", pickHit.model->modelName.c_str(),
+                                pickHit.triangle, pickHit.distance);
+                else
+                    ImGui::Text("Picked: none (middle click to pick)");
                 scene->UI();
                 ImGui::EndTabItem();
             }
@@ -174,6 +217,10 @@ int main()
         shader->UniformMat4("mat_Model", model->transform.matrix);
         shader->UniformMat3("mat_ModelInv", glm::mat3(model->transform.matrixInv));
     };
+    auto recordModel = [&](const Model *model, CommandList &list) {
+        list.UniformMat4("mat_Model", model->transform.matrix);
+        list.UniformMat3("mat_ModelInv", glm::mat3(model->transform.matrixInv));
+    };
 
     app->Start();
 
@@ -185,16 +232,57 @@ int main()
         glViewport(0, 0, w, h);
         cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        shader->Bind();
-
         mView = cam->GetView();
         mProj = cam->GetProj();
-        shader->UniformMat4("mat_ProjView", mProj * mView);
-        shader->UniformVec3("vec_CameraPosWS", cam->GetPosition());
 
-        scene->Draw(shader.get(), RenderPass::Ordered, configModelShader);
+        scene->UpdateTransforms();
 
-        shader->UnBind();
+        if (scene->HasStaticBatch())
+        {
+            // culling binds its compute program, so cull before configuring batch shader
+            if (useGPUCulling)
+                scene->CullStaticBatch(*gpuCuller, mProj * mView);
+            batchShader->Bind();
+            batchShader->UniformMat4("mat_ProjView", mProj * mView);
+            batchShader->UniformVec3("vec_CameraPosWS", cam->GetPosition());
+            scene->DrawStaticBatch(batchShader.get(), useGPUCulling ? gpuCuller.get() : nullptr);
+            batchShader->UnBind();
+        }
+
+        if (useCommandLists)
+        {
+            const RenderPass passes[] = {RenderPass::Opaque, RenderPass::Transparent};
+            auto recorded = jobs->ParallelFor(0, passLists.size(), 1, [&](size_t begin, size_t end) {
+                for (auto i = begin; i < end; ++i)
+                {
+                    auto &list = passLists[i];
+                    list.Reset();
+                    list.BindProgram(shader.get());
+                    list.UniformMat4("mat_ProjView", mProj * mView);
+                    list.UniformVec3("vec_CameraPosWS", cam->GetPosition());
+                    scene->Record(list, shader.get(), passes[i], recordModel);
+                }
+            });
+            jobs->Wait(recorded);
+            for (const auto &list : passLists)
+                list.Execute();
+            shader->UnBind();
+        }
+        else
+        {
+            shader->Bind();
+
+            shader->UniformMat4("mat_ProjView", mProj * mView);
+            shader->UniformVec3("vec_CameraPosWS", cam->GetPosition());
+
+            scene->Draw(shader.get(), RenderPass::Ordered, configModelShader);
+
+            shader->UnBind();
+        }
+
+        // depth of this frame culls next frame
+        if (useGPUCulling)
+            gpuCuller->BuildDepthPyramid(w, h);
 
         app->LoopEndFrame(renderUI);
 
@@ -203,6 +291,13 @@ int main()
             break;
         if (input->GetKeyPressed(GLFW_KEY_F11))
             app->displayUI = !app->displayUI;
+        if (input->GetMousePressed(GLFW_MOUSE_BUTTON_MIDDLE))
+        {
+            float mouseX, mouseY;
+            input->GetMousePos(mouseX, mouseY);
+            pickHit = RayHit();
+            scene->Raycast(cam->ScreenToRay(mouseX, mouseY, w, h), pickHit);
+        }
         input->Update();
     }
 
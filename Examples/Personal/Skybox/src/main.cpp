@@ -143,9 +143,9 @@ int main()
         filterTone->StartRecord();
         // clear depth & render sky as background
         cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        skybox->ClearBackground(mProj, mView);
+        skybox->ClearBackground();
 
-        lights->DrawLights(mProjView, cam->GetPosition());
+        lights->DrawLights();
 
         shader->Bind();
 
@@ -0,0 +1,86 @@
+#version 450 core
+
+layout(location = 0) out vec4 outColor;
+
+layout(location = 0) in VERTOUT
+{
+    vec3 normalWS;
+    vec4 fragPosWS;
+    flat uint materialIdx;
+}
+vertOut;
+
+// material values
+struct MaterialData
+{
+    vec4 ambientShininess;
+    vec4 diffuseOpacity;
+    vec4 specularRefract;
+    vec4 emissiveMetallic;
+    vec4 transparentRoughness;
+    float alphaCutoff;
+    uint mapsMask;
+    int hasPBR;
+    int alphaMode;
+};
+
+layout(std430, binding = 4) readonly buffer MaterialsData
+{
+    MaterialData materials[];
+};
+
+// lights of stress scene
+struct StressLight
+{
+    vec4 posRange;
+    vec4 colorIntensity;
+};
+
+layout(std430, binding = 2) readonly buffer StressLightsData
+{
+    uint lightsLen;
+    StressLight lights[];
+};
+
+uniform vec3 vec_CameraPosWS;
+
+float ComputeLightAttenuation(float range, vec3 fragToLight)
+{
+    float distSqr = dot(fragToLight, fragToLight);
+    float inner = distSqr / (range * range);
+    inner = clamp(1.0 - inner * inner, 0.0, 1.0);
+    return inner * inner;
+}
+
+void main()
+{
+    MaterialData mat = materials[vertOut.materialIdx];
+    vec3 colorAmbient = mat.ambientShininess.rgb;
+    vec3 colorDiffuse = mat.diffuseOpacity.rgb;
+    vec3 colorSpecular = mat.specularRefract.rgb;
+    float shininess = mat.ambientShininess.a;
+    vec3 normDir = normalize(vertOut.normalWS);
+    vec3 viewDir = normalize(vec_CameraPosWS - vertOut.fragPosWS.xyz);
+
+    // sun
+    const vec3 sunDir = normalize(vec3(1.0, 1.0, 1.0));
+    float diff = max(dot(normDir, sunDir), 0.0);
+    float spec = shininess > 0.0 ? pow(max(dot(reflect(-sunDir, normDir), viewDir), 0.0), shininess) : 0.0;
+    vec3 color = colorAmbient * colorDiffuse + (colorDiffuse * diff + colorSpecular * spec) * 0.5;
+
+    // every light is evaluated, cost scales with light count
+    for (uint i = 0; i < lightsLen; i++)
+    {
+        StressLight light = lights[i];
+        vec3 fragToLight = light.posRange.xyz - vertOut.fragPosWS.xyz;
+        float atten = ComputeLightAttenuation(light.posRange.w, fragToLight);
+        if (atten <= 0.0)
+            continue;
+        vec3 lightDir = normalize(fragToLight);
+        diff = max(dot(normDir, lightDir), 0.0);
+        spec = shininess > 0.0 ? pow(max(dot(reflect(-lightDir, normDir), viewDir), 0.0), shininess) : 0.0;
+        color += (colorDiffuse * diff + colorSpecular * spec) * light.colorIntensity.rgb * light.colorIntensity.w *
+                 atten;
+    }
+    outColor = vec4(color, mat.diffuseOpacity.a);
+}
@@ -0,0 +1,45 @@
+#version 450 core
+
+layout(location = 0) in vec3 inPos;
+layout(location = 1) in vec3 inNormal;
+
+layout(location = 0) out VERTOUT
+{
+    vec3 normalWS;
+    vec4 fragPosWS;
+    flat uint materialIdx;
+}
+vertOut;
+
+uniform mat4 mat_ProjView;
+uniform mat4 mat_Model;
+uniform mat3 mat_ModelInv;
+uniform uint val_MATERIAL;
+uniform bool val_INSTANCED;
+
+struct InstanceData
+{
+    mat4 matrix;
+    mat4 matrixInv;
+    vec4 attribute;
+};
+
+layout(std430, binding = 6) readonly buffer InstancesData
+{
+    InstanceData instances[];
+};
+
+void main()
+{
+    mat4 model = mat_Model;
+    mat3 modelInv = mat_ModelInv;
+    if (val_INSTANCED)
+    {
+        model = instances[gl_InstanceID].matrix;
+        modelInv = mat3(instances[gl_InstanceID].matrixInv);
+    }
+    vertOut.normalWS = normalize(inNormal * modelInv);
+    vertOut.fragPosWS = model * vec4(inPos, 1.0);
+    vertOut.materialIdx = val_MATERIAL;
+    gl_Position = mat_ProjView * vertOut.fragPosWS;
+}
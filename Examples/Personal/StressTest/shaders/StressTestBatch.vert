@@ -0,0 +1,37 @@
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout(location = 0) in vec3 inPos;
+layout(location = 1) in vec3 inNormal;
+
+layout(location = 0) out VERTOUT
+{
+    vec3 normalWS;
+    vec4 fragPosWS;
+    flat uint materialIdx;
+}
+vertOut;
+
+struct DrawData
+{
+    mat4 model;
+    mat4 modelInv;
+    uint material;
+};
+
+layout(std430, binding = 5) readonly buffer DrawsData
+{
+    DrawData draws[];
+};
+
+uniform mat4 mat_ProjView;
+
+void main()
+{
+    // baseInstance holds draw index, gl_DrawID is relative to culled commands
+    DrawData draw = draws[gl_BaseInstanceARB];
+    vertOut.normalWS = normalize(inNormal * mat3(draw.modelInv));
+    vertOut.fragPosWS = draw.model * vec4(inPos, 1.0);
+    vertOut.materialIdx = draw.material;
+    gl_Position = mat_ProjView * vertOut.fragPosWS;
+}
@@ -0,0 +1,40 @@
+#version 450 core
+
+layout(location = 0) in vec3 inPos;
+layout(location = 1) in vec3 inNormal;
+layout(location = 5) in uvec4 inBoneIDs;
+layout(location = 6) in vec4 inBoneWeights;
+
+layout(location = 0) out VERTOUT
+{
+    vec3 normalWS;
+    vec4 fragPosWS;
+    flat uint materialIdx;
+}
+vertOut;
+
+layout(std430, binding = 0) readonly buffer BoneMatrices
+{
+    mat4 boneMats[];
+};
+
+uniform mat4 mat_ProjView;
+uniform mat4 mat_Model;
+uniform mat3 mat_ModelInv;
+uniform uint val_MATERIAL;
+
+void main()
+{
+    mat4 boneTransform = mat4(1.0);
+    if ((inBoneWeights[0] + inBoneWeights[1] + inBoneWeights[2] + inBoneWeights[3]) != 0.0)
+    {
+        boneTransform = boneMats[inBoneIDs[0]] * inBoneWeights[0];
+        boneTransform += boneMats[inBoneIDs[1]] * inBoneWeights[1];
+        boneTransform += boneMats[inBoneIDs[2]] * inBoneWeights[2];
+        boneTransform += boneMats[inBoneIDs[3]] * inBoneWeights[3];
+    }
+    vertOut.normalWS = normalize(inNormal * inverse(mat3(boneTransform)) * mat_ModelInv);
+    vertOut.fragPosWS = mat_Model * boneTransform * vec4(inPos, 1.0);
+    vertOut.materialIdx = val_MATERIAL;
+    gl_Position = mat_ProjView * vertOut.fragPosWS;
+}
@@ -0,0 +1,342 @@
+#include "RenderIt.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <imgui.h>
+
+using namespace RenderIt;
+
+/// Measured cost of one sweep step
+struct SweepResult
+{
+    StressSceneConfig config;
+    FrameTimeSummary frameTimes;
+    // CPU time until frame end, without UI & swap
+    double cpuMs = 0.0;
+    // GPU time of top-level passes
+    double gpuMs = 0.0;
+    size_t drawCalls = 0;
+    size_t triangles = 0;
+};
+
+int main(int argc, char **argv)
+{
+    // "StressTest sweep [animated model]" measures doubling scene sizes & exits
+    // "StressTest batch" measures 10k static props drawn one by one, then with static batch
+    bool batchCompare = argc > 1 && std::strcmp(argv[1], "batch") == 0;
+    bool sweep = batchCompare || (argc > 1 && std::strcmp(argv[1], "sweep") == 0);
+    std::string skinnedModelPath = sweep && !batchCompare && argc > 2 ? argv[2] : "";
+
+    std::shared_ptr<AppContext> app;
+    std::shared_ptr<OrbitCamera> cam;
+    std::shared_ptr<InputManager> input;
+    std::shared_ptr<Animator> anim;
+
+    try
+    {
+        app = AppContext::Instance();
+        cam = OrbitCamera::Instance();
+        input = InputManager::Instance();
+        anim = Animator::Instance();
+    }
+    catch (const std::exception &e)
+    {
+        Tools::display_message("Program", e.what(), Tools::MessageType::ERROR);
+    }
+
+    int w{0}, h{0};
+    app->SetWindowTitle("Stress Test");
+    app->displayUI = !sweep;
+    app->EnableCommonGLFeatures();
+    app->SetVsync(!sweep);
+    Tools::set_gl_debug(true);
+
+    // prepare shaders
+    auto vertShader = Tools::read_file_content("./shaders/StressTest.vert");
+    auto skinnedVertShader = Tools::read_file_content("./shaders/StressTestSkinned.vert");
+    auto batchVertShader = Tools::read_file_content("./shaders/StressTestBatch.vert");
+    auto fragShader = Tools::read_file_content("./shaders/StressTest.frag");
+
+    auto shader = std::make_shared<Shader>();
+    shader->AddSource(vertShader, GL_VERTEX_SHADER);
+    shader->AddSource(fragShader, GL_FRAGMENT_SHADER);
+    auto skinnedShader = std::make_shared<Shader>();
+    skinnedShader->AddSource(skinnedVertShader, GL_VERTEX_SHADER);
+    skinnedShader->AddSource(fragShader, GL_FRAGMENT_SHADER);
+    if (!Tools::compile_shaders_parallel({shader.get(), skinnedShader.get()}))
+        return -1;
+    // shader for static batch (multi-draw indirect), needs ARB_shader_draw_parameters
+    auto batchShader = std::make_shared<Shader>();
+    batchShader->AddSource(batchVertShader, GL_VERTEX_SHADER);
+    batchShader->AddSource(fragShader, GL_FRAGMENT_SHADER);
+    bool canBatch = GraphicsDevice::Get().HasShaderDrawParameters() && batchShader->Compile();
+    if (batchCompare && !canBatch)
+    {
+        Tools::display_message("StressTest", "Static batch not supported", Tools::MessageType::ERROR);
+        return -1;
+    }
+
+    // sweep doubles every count per step, batch comparison draws same scene without & with static batch
+    const unsigned warmupFrames = 30, measureFrames = 120;
+    std::vector<StressSceneConfig> sweepConfigs;
+    for (unsigned step = 0; step < (batchCompare ? 2u : 6u); ++step)
+    {
+        StressSceneConfig config;
+        if (batchCompare)
+        {
+            config.staticProps = 10000;
+            config.extent = 100.0f;
+            config.staticBatch = step == 1;
+        }
+        else
+        {
+            auto scale = 1u << step;
+            config.staticProps = 250 * scale;
+            config.instancedMeshes = 1000 * scale;
+            config.skinnedModels = skinnedModelPath.empty() ? 0 : 4 * scale;
+            config.pointLights = 8 * scale;
+            config.transparentObjects = 25 * scale;
+            config.skinnedModelPath = skinnedModelPath;
+            // keep density
+            config.extent = 25.0f * std::sqrt(static_cast<float>(scale));
+        }
+        sweepConfigs.push_back(config);
+    }
+    auto sweepSteps = static_cast<unsigned>(sweepConfigs.size());
+
+    // setup scene
+    auto stress = std::make_unique<StressScene>();
+    stress->Build(sweep ? sweepConfigs.front() : StressSceneConfig());
+    bool autoInstancing = true;
+
+    // CPU occlusion culling, occluders are picked from large static objects after every build
+    auto occlusion = std::make_unique<OcclusionCuller>();
+    bool useOcclusion = false;
+    unsigned occluderBuild = 0;
+
+    // setup camera
+    auto extent = stress->GetConfig().extent;
+    cam->SetPosition(glm::vec3(extent, extent * 0.6f, extent));
+    cam->SetCenter(glm::vec3(0.0f));
+    cam->SetFov(45.0f);
+    cam->SetViewNearFar(0.1f, 1000.0f);
+    cam->SetViewType(CameraViewType::Persp);
+    cam->clearColor = glm::vec4(0.2f, 0.2f, 0.2f, 1.0f);
+
+    auto mView = cam->GetView();
+    auto mProj = cam->GetProj();
+
+    // define UI
+    auto renderUI = [&]() {
+        ImGui::Begin("UI");
+        if (ImGui::BeginTabBar(""))
+        {
+            if (app && ImGui::BeginTabItem("Application"))
+            {
+                app->UI();
+                ImGui::EndTabItem();
+            }
+            if (cam && ImGui::BeginTabItem("Camera"))
+            {
+                cam->UI();
+                ImGui::EndTabItem();
+            }
+            if (stress && ImGui::BeginTabItem("Stress"))
+            {
+                ImGui::Checkbox("Auto Instancing", &autoInstancing);
+                ImGui::Checkbox("Occlusion Culling (CPU)", &useOcclusion);
+                if (useOcclusion && ImGui::TreeNode("Occlusion"))
+                {
+                    occlusion->UI();
+                    ImGui::TreePop();
+                }
+                stress->UI();
+                ImGui::EndTabItem();
+            }
+            ImGui::EndTabBar();
+        }
+        ImGui::End();
+    };
+
+    // define shader configure
+    auto configModelShader = [&](const Model *model, const Shader *shader) {
+        shader->UniformMat4("mat_Model", model->transform.matrix);
+        shader->UniformMat3("mat_ModelInv", glm::mat3(model->transform.matrixInv));
+    };
+
+    // sweep state
+    std::vector<SweepResult> results;
+    SweepResult current;
+    current.config = stress->GetConfig();
+    unsigned sweepStep = 0, sweepFrame = 0, profiledFrames = 0;
+    uint64_t lastProfiled = 0;
+    if (sweep)
+        Profiler::SetEnabled(true);
+
+    app->Start();
+
+    while (!app->WindowShouldClose())
+    {
+        auto tCPUStart = std::chrono::steady_clock::now();
+        auto &scene = stress->GetScene();
+        scene.autoInstancing = autoInstancing;
+        // batched meshes are skipped by Draw, so drop batch if it cannot be drawn
+        if (!canBatch && scene.HasStaticBatch())
+            scene.ResetStaticBatch();
+
+        anim->Update(app->GetDeltaTime());
+
+        // render
+        app->GetWindowSize(w, h);
+        cam->SetWindowAspect(w, h);
+        glViewport(0, 0, w, h);
+        cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        mView = cam->GetView();
+        mProj = cam->GetProj();
+
+        scene.UpdateTransforms();
+        // rasterize occluders on workers while GPU work is submitted
+        const OcclusionCuller *culler = nullptr;
+        if (useOcclusion)
+        {
+            if (occluderBuild != stress->GetBuildCount())
+            {
+                occluderBuild = stress->GetBuildCount();
+                occlusion->ClearOccluders();
+                std::vector<const Model *> models;
+                for (const auto &m : scene.models)
+                    models.push_back(m.get());
+                occlusion->SelectOccluders(models, 2.0f);
+            }
+            occlusion->Begin(mProj * mView);
+            culler = occlusion.get();
+        }
+        stress->BindLights();
+
+        if (canBatch && scene.HasStaticBatch())
+        {
+            RENDER_PASS("StaticBatch");
+            batchShader->Bind();
+            batchShader->UniformMat4("mat_ProjView", mProj * mView);
+            batchShader->UniformVec3("vec_CameraPosWS", cam->GetPosition());
+            scene.DrawStaticBatch(batchShader.get());
+            batchShader->UnBind();
+        }
+
+        if (culler)
+            occlusion->Wait();
+        shader->Bind();
+        shader->UniformMat4("mat_ProjView", mProj * mView);
+        shader->UniformVec3("vec_CameraPosWS", cam->GetPosition());
+        scene.Draw(shader.get(), RenderPass::Opaque, configModelShader, culler);
+        shader->UnBind();
+
+        if (!stress->GetSkinnedModels().empty())
+        {
+            RENDER_PASS("Skinned");
+            skinnedShader->Bind();
+            skinnedShader->UniformMat4("mat_ProjView", mProj * mView);
+            skinnedShader->UniformVec3("vec_CameraPosWS", cam->GetPosition());
+            for (const auto &model : stress->GetSkinnedModels())
+            {
+                anim->UpdateAnimation(model.get());
+                anim->BindBones(0);
+                configModelShader(model.get(), skinnedShader.get());
+                model->Draw(skinnedShader.get());
+            }
+            skinnedShader->UnBind();
+        }
+
+        shader->Bind();
+        scene.Draw(shader.get(), RenderPass::Transparent, configModelShader, culler);
+        shader->UnBind();
+
+        stress->UnBindLights();
+        auto cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tCPUStart).count();
+
+        app->LoopEndFrame(renderUI);
+
+        if (sweep && ++sweepFrame > warmupFrames)
+        {
+            current.cpuMs += cpuMs;
+            // GPU times arrive few frames late, count each resolved frame once
+            const auto &frame = Profiler::Instance()->GetLastFrame();
+            if (frame.gpuResolved && frame.index != lastProfiled)
+            {
+                lastProfiled = frame.index;
+                for (const auto &event : frame.gpuEvents)
+                    if (!event.depth)
+                        current.gpuMs += event.duration * 1e-3;
+                ++profiledFrames;
+            }
+            const auto &stats = RenderStats::Instance()->GetFrameStats();
+            current.drawCalls = stats.drawCalls;
+            current.triangles = stats.triangles;
+
+            if (sweepFrame == warmupFrames + measureFrames)
+            {
+                current.frameTimes = app->GetFrameTimes().Summarize(measureFrames);
+                current.cpuMs /= measureFrames;
+                current.gpuMs /= (std::max)(profiledFrames, 1u);
+                const auto &c = current.config;
+                char line[256];
+                std::snprintf(line, sizeof(line),
+                              "step %u: %u props, %u instanced, %u skinned, %u lights, %u transparent%s | %d draws, "
+                              "%d tris | CPU %.2f ms, GPU %.2f ms, frame p50 %.2f p99 %.2f ms",
+                              sweepStep, c.staticProps, c.instancedMeshes, c.skinnedModels, c.pointLights,
+                              c.transparentObjects, c.staticBatch ? " (batched)" : "",
+                              static_cast<int>(current.drawCalls), static_cast<int>(current.triangles), current.cpuMs,
+                              current.gpuMs, current.frameTimes.p50, current.frameTimes.p99);
+                Tools::display_message("StressTest", line, Tools::MessageType::INFO);
+                results.push_back(current);
+
+                if (++sweepStep == sweepSteps)
+                    break;
+                stress->Build(sweepConfigs[sweepStep]);
+                extent = stress->GetConfig().extent;
+                cam->SetPosition(glm::vec3(extent, extent * 0.6f, extent));
+                current = SweepResult();
+                current.config = stress->GetConfig();
+                sweepFrame = profiledFrames = 0;
+            }
+        }
+
+        // input handling
+        if (input->GetKeyPressed(GLFW_KEY_ESCAPE))
+            break;
+        if (input->GetKeyPressed(GLFW_KEY_F11))
+            app->displayUI = !app->displayUI;
+        input->Update();
+    }
+
+    if (!results.empty())
+    {
+        std::string csvPath = batchCompare ? "stress_batch.csv" : "stress_sweep.csv";
+        std::ofstream file(csvPath);
+        file << "step,static,instanced,skinned,lights,transparent,batch,draws,triangles,cpu_ms,gpu_ms,frame_p50,"
+                "frame_p95,frame_p99,frame_max\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &r = results[i];
+            const auto &c = r.config;
+            file << i << "," << c.staticProps << "," << c.instancedMeshes << "," << c.skinnedModels << ","
+                 << c.pointLights << "," << c.transparentObjects << "," << c.staticBatch << "," << r.drawCalls << ","
+                 << r.triangles << ","
+                 << r.cpuMs << "," << r.gpuMs << "," << r.frameTimes.p50 << "," << r.frameTimes.p95 << ","
+                 << r.frameTimes.p99 << "," << r.frameTimes.max << "\n";
+        }
+        Tools::display_message("StressTest", "Sweep written to " + csvPath, Tools::MessageType::INFO);
+    }
+
+    return 0;
+}
@@ -132,7 +132,7 @@ int main()
         cam->PrepareFrame(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // draw lights
-        lights->DrawLights(mProjView, cam->GetPosition());
+        lights->DrawLights();
 
         shaderCommon->Bind();
         // vertex stage uniforms